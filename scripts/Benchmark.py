@@ -3,19 +3,18 @@ import argparse
 import os
 import subprocess
 import tempfile
-import re
+import json
 import math
 import shutil
 
-MSampleRegex = re.compile(r"\# ([0-9.]+)\/([0-9.]+)\/([0-9.]+)", re.M)
-
 TempDir = None
 
 
 def bench_exe(exe_path, gpu, args):
     tmp_path = os.path.join(TempDir, "_bench.exr")
+    report_path = os.path.join(TempDir, "_bench.json")
     call_args = [exe_path, "--spp",
-                 str(args.spp), "--gpu" if gpu else "--cpu", "-o", tmp_path, args.scene]
+                 str(args.spp), "--gpu" if gpu else "--cpu", "-o", tmp_path, "--bench-json", report_path, args.scene]
 
     if args.verbose:
         print(call_args)
@@ -29,12 +28,21 @@ def bench_exe(exe_path, gpu, args):
     if args.verbose:
         print(result.stdout)
 
-    m = MSampleRegex.findall(result.stdout)
-    if m is None or len(m) != 1:
+    try:
+        with open(report_path, "r") as f:
+            report = json.load(f)
+    except (OSError, json.JSONDecodeError):
+        print(result.stderr)
+        exit(-3)
+
+    # Msamples per second of each iteration
+    samples = report["width"] * report["height"] * report["spi"] * 1e-6
+    msamples = sorted([1000 * samples / ms for ms in report["time"]["iterations_ms"] if ms > 0])
+    if len(msamples) == 0:
         print(result.stderr)
         exit(-3)
 
-    return {"min": float(m[0][0]), "med": float(m[0][1]), "max": float(m[0][2])}
+    return {"min": msamples[0], "med": msamples[len(msamples) // 2], "max": msamples[-1]}
 
 
 def reduce_avg(bench_results):
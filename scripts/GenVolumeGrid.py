@@ -0,0 +1,56 @@
+#!/bin/python3
+# Generate a procedural smoke-like density grid as a Mitsuba style .vol file usable by the 'grid' medium
+
+import argparse
+import struct
+import numpy as np
+from pathlib import Path
+
+
+def generate_density(res, seed):
+    rng = np.random.default_rng(seed)
+    t = (np.arange(res, dtype=np.float32) + 0.5) / res
+    z, y, x = np.meshgrid(t, t, t, indexing='ij')
+
+    # Rising plume which widens towards the top
+    radius = 0.12 + 0.25 * y
+    dist = np.sqrt((x - 0.5) ** 2 + (z - 0.5) ** 2)
+    density = np.clip(1 - dist / radius, 0, 1) * np.clip(4 * (1 - y), 0, 1)
+
+    # Add some octaves of smooth noise
+    noise = np.zeros_like(density)
+    amp = 0.5
+    for octave in range(1, 4):
+        freq = 2 ** (octave + 1)
+        phase = rng.uniform(0, 2 * np.pi, size=3)
+        noise += amp * np.sin(freq * np.pi * x + phase[0]) * np.sin(freq * np.pi * y + phase[1]) * np.sin(freq * np.pi * z + phase[2])
+        amp *= 0.5
+
+    return np.clip(density * (1 + noise), 0, None).astype(np.float32)
+
+
+def write_vol(path, density, bbox):
+    res = density.shape[0]
+    with open(path, 'wb') as f:
+        f.write(b'VOL')
+        f.write(struct.pack('<B', 3))
+        f.write(struct.pack('<i', 1))  # Float32 encoding
+        f.write(struct.pack('<iiii', res, res, res, 1))
+        f.write(struct.pack('<6f', *bbox))
+        # Data is stored in x-y-z order with x varying the fastest
+        f.write(density.tobytes(order='C'))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument('OutputFile', type=Path,
+                        help='Path to export the .vol file')
+    parser.add_argument('--resolution', type=int, default=32,
+                        help='Resolution of the grid in each dimension')
+    parser.add_argument('--seed', type=int, default=42,
+                        help='Seed used for the noise')
+
+    args = parser.parse_args()
+
+    density = generate_density(args.resolution, args.seed)
+    write_vol(args.OutputFile, density, [-1, -1, -1, 1, 1, 1])
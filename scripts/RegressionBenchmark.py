@@ -0,0 +1,203 @@
+# Runs igcli over a list of scenes, collects the machine readable reports and compares them against a baseline.
+# Exits with a non-zero code if any scene regressed beyond the given thresholds.
+#
+# Example:
+#   python3 RegressionBenchmark.py -o current.json
+#   python3 RegressionBenchmark.py -o next.json --baseline current.json -e build-next/bin/igcli
+
+from api.utils import get_root_dir
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+
+def find_executable(root_dir):
+    for path in [root_dir.joinpath("build", "Release", "bin", "igcli"), root_dir.joinpath("build", "bin", "igcli")]:
+        if path.exists():
+            return str(path)
+    return None
+
+
+def get_reference_path(scene_file, ref_dir):
+    # Same lookup as in RunEvaluations.py: Drop '-' sections until a reference is found
+    basename = Path(scene_file).stem
+    for _ in range(3):
+        filenames = [str(p) for p in Path(ref_dir).glob(f"ref-{basename}*.exr")]
+        if len(filenames) > 0:
+            return min(filenames, key=len)
+        if basename.rfind('-') < 0:
+            break
+        basename = basename[:basename.rfind('-')]
+    return None
+
+
+def run_scene(exe, scene_file, ref_dir, tmp_dir, args):
+    name = Path(scene_file).stem
+    out_file = os.path.join(tmp_dir, f"{name}.exr")
+    report_file = os.path.join(tmp_dir, f"{name}.json")
+
+    call_args = [exe, "--spp", str(args.spp), "--gpu" if args.gpu else "--cpu",
+                 "-o", out_file, "--bench-json", report_file, "--no-progress", "--seed", "42"]
+    if args.stats:
+        call_args.append("--stats")
+
+    ref_file = get_reference_path(scene_file, ref_dir) if ref_dir is not None else None
+    if ref_file is not None:
+        call_args += ["--reference", ref_file]
+
+    call_args.append(str(scene_file))
+
+    if args.verbose:
+        print(call_args)
+
+    result = subprocess.run(call_args, capture_output=True, text=True)
+    if result.returncode != 0 or not os.path.exists(report_file):
+        print(f"Failed to run {name}")
+        if args.verbose:
+            print(result.stdout)
+        print(result.stderr)
+        return None
+
+    with open(report_file, "r") as f:
+        return json.load(f)
+
+
+def relative_change(current, baseline):
+    if baseline is None or current is None or baseline == 0:
+        return None
+    return (current - baseline) / baseline
+
+
+def compare(results, baseline, args):
+    # Returns a list of (scene, metric, current, baseline, change) entries which exceeded the thresholds
+    checks = [
+        ("loading_ms", lambda r: r["time"]["loading_ms"], args.time_threshold),
+        ("compile_ms", lambda r: r["time"]["compile_ms"], args.time_threshold),
+        ("iteration_median_ms", lambda r: r["time"]["iteration_median_ms"], args.time_threshold),
+        ("peak_host_memory", lambda r: r["peak_memory"]["host"], args.memory_threshold),
+        ("peak_device_memory", lambda r: r["peak_memory"]["device"], args.memory_threshold),
+        ("error", lambda r: r["error"], args.error_threshold),
+    ]
+
+    regressions = []
+    for scene, current in results.items():
+        if scene not in baseline:
+            print(f"-> Scene {scene} is not part of the baseline")
+            continue
+
+        for metric, getter, threshold in checks:
+            cur = getter(current)
+            base = getter(baseline[scene])
+            change = relative_change(cur, base)
+            if change is not None and change > threshold:
+                regressions.append((scene, metric, cur, base, change))
+
+        # Throughput is better if higher
+        change = relative_change(current["samples_per_second"], baseline[scene]["samples_per_second"])
+        if change is not None and -change > args.time_threshold:
+            regressions.append((scene, "samples_per_second", current["samples_per_second"], baseline[scene]["samples_per_second"], change))
+
+    for scene in baseline:
+        if scene not in results:
+            regressions.append((scene, "missing", None, None, None))
+
+    return regressions
+
+
+def format_value(value, width, precision, scale=1):
+    # Missing values, e.g., from reports of older versions or failed measurements, are printed as n/a
+    if value is None:
+        return f"{'n/a':>{width}}"
+    return f"{value * scale:>{width}.{precision}f}"
+
+
+def print_summary(results):
+    print(f"{'Scene':<32}|{'Load [ms]':>12} |{'Compile [ms]':>13} |{'Iter [ms]':>11} |{'MSamples/s':>11} |{'Peak [MB]':>10} |{'Error':>10}")
+    for scene, r in sorted(results.items()):
+        time = r.get("time", {})
+        memory = r.get("peak_memory", {})
+        error = f"{r['error']:.3e}" if r.get("error") is not None else "n/a"
+        peak = None
+        if memory.get("host") is not None and memory.get("device") is not None:
+            peak = memory["host"] + memory["device"]
+        print(f"{scene:<32}|{format_value(time.get('loading_ms'), 12, 1)} "
+              f"|{format_value(time.get('compile_ms'), 13, 1)} "
+              f"|{format_value(time.get('iteration_median_ms'), 11, 2)} "
+              f"|{format_value(r.get('samples_per_second'), 11, 2, 1e-6)} "
+              f"|{format_value(peak, 10, 1, 1 / (1024 * 1024))} "
+              f"|{error:>10}")
+
+if __name__ == "__main__":
+    root_dir = get_root_dir()
+
+    parser = argparse.ArgumentParser(description="Run a list of scenes with igcli and compare the results against a baseline")
+    parser.add_argument('scenes', nargs='*',
+                        help="Scenes to run. Defaults to all scenes in scenes/evaluation")
+    parser.add_argument('-e', '--executable', type=str,
+                        help="igcli executable to benchmark")
+    parser.add_argument('-o', '--output', type=str,
+                        help="Write the collected results to the given json file")
+    parser.add_argument('-b', '--baseline', type=str,
+                        help="Compare against results of a previous run")
+    parser.add_argument('--reference-dir', type=str, default=str(root_dir.joinpath("scenes", "evaluation", "references")),
+                        help="Directory containing 'ref-<scene>*.exr' reference images")
+    parser.add_argument('--spp', type=int, default=64,
+                        help="Target spp")
+    parser.add_argument('--gpu', action="store_true",
+                        help="Use the gpu instead of the cpu")
+    parser.add_argument('--stats', action="store_true",
+                        help="Acquire stats to report rays per second. Slows down rendering")
+    parser.add_argument('--time-threshold', type=float, default=0.1,
+                        help="Maximum allowed relative increase of load, compile and iteration times")
+    parser.add_argument('--memory-threshold', type=float, default=0.05,
+                        help="Maximum allowed relative increase of peak memory")
+    parser.add_argument('--error-threshold', type=float, default=0.25,
+                        help="Maximum allowed relative increase of the error against the reference")
+    parser.add_argument('--verbose', action="store_true",
+                        help="Print igcli output")
+
+    args = parser.parse_args()
+
+    exe = args.executable if args.executable is not None else find_executable(root_dir)
+    if exe is None:
+        print("No executable to benchmark given")
+        sys.exit(-1)
+
+    scenes = args.scenes if len(args.scenes) > 0 else sorted([str(p) for p in root_dir.joinpath("scenes", "evaluation").glob("*.json")])
+    ref_dir = args.reference_dir if os.path.exists(args.reference_dir) else None
+
+    results = {}
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        for scene in scenes:
+            print(f"Running {Path(scene).stem}...")
+            report = run_scene(os.path.abspath(exe), scene, ref_dir, tmp_dir, args)
+            if report is not None:
+                results[Path(scene).stem] = report
+
+    print_summary(results)
+
+    if args.output is not None:
+        with open(args.output, "w") as f:
+            json.dump(results, f, indent=2)
+
+    if args.baseline is not None:
+        with open(args.baseline, "r") as f:
+            baseline = json.load(f)
+
+        regressions = compare(results, baseline, args)
+        if len(regressions) > 0:
+            print("Regressions:")
+            for scene, metric, cur, base, change in regressions:
+                if metric == "missing":
+                    print(f"-> Scene {scene} failed or was not run")
+                else:
+                    print(f"-> Scene {scene}: {metric} {base} -> {cur} ({change * 100:+.1f}%)")
+            sys.exit(1)
+        print("No regressions found")
+
+    if len(results) != len(scenes):
+        sys.exit(1)
@@ -0,0 +1,18 @@
+#include "Benchmark.h"
+
+#include <filesystem>
+
+namespace IG::Benchmark {
+std::vector<Entry>& registry()
+{
+    static std::vector<Entry> entries;
+    return entries;
+}
+
+Path tempDirectory()
+{
+    const Path dir = std::filesystem::temp_directory_path() / "Ignis" / "benchmark";
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+} // namespace IG::Benchmark
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Timer.h"
+
+#include <functional>
+
+namespace IG::Benchmark {
+/// Fixed seed used for all synthetic inputs to keep runs comparable
+constexpr uint32 Seed = 42;
+
+class State {
+public:
+    inline State(size_t warmup, size_t repetitions)
+        : mWarmup(warmup)
+        , mRepetitions(repetitions)
+        , mItems(0)
+        , mBytes(0)
+    {
+    }
+
+    /// Run `func` after a few warmup iterations multiple times and record the time of each call.
+    /// Everything outside `func` is considered setup and is not measured
+    template <typename Func>
+    inline void run(Func&& func)
+    {
+        for (size_t i = 0; i < mWarmup; ++i)
+            func();
+
+        mTimes.reserve(mTimes.size() + mRepetitions);
+        for (size_t i = 0; i < mRepetitions; ++i) {
+            Timer timer;
+            timer.start();
+            func();
+            mTimes.push_back(std::chrono::duration<double, std::milli>(timer.stop()).count());
+        }
+    }
+
+    /// Number of items (triangles, pixels, ...) processed per call. Used to compute throughput
+    inline void setItemsPerRun(size_t items) { mItems = items; }
+    /// Number of bytes processed per call. Used to compute throughput
+    inline void setBytesPerRun(size_t bytes) { mBytes = bytes; }
+
+    [[nodiscard]] inline const std::vector<double>& times() const { return mTimes; }
+    [[nodiscard]] inline size_t itemsPerRun() const { return mItems; }
+    [[nodiscard]] inline size_t bytesPerRun() const { return mBytes; }
+
+private:
+    const size_t mWarmup;
+    const size_t mRepetitions;
+    size_t mItems;
+    size_t mBytes;
+    std::vector<double> mTimes;
+};
+
+using Function = void (*)(State&);
+
+struct Entry {
+    std::string Name;
+    Function Func;
+};
+
+/// Global list of registered benchmarks
+std::vector<Entry>& registry();
+
+struct Registrar {
+    inline Registrar(const char* name, Function func)
+    {
+        registry().push_back(Entry{ name, func });
+    }
+};
+
+/// Temporary directory used by benchmarks to write intermediate files
+[[nodiscard]] Path tempDirectory();
+} // namespace IG::Benchmark
+
+#define IG_BENCHMARK(name)                                                                             \
+    static void _ig_benchmark_##name(IG::Benchmark::State& state);                                     \
+    static const IG::Benchmark::Registrar _ig_benchmark_registrar_##name(#name, _ig_benchmark_##name); \
+    static void _ig_benchmark_##name(IG::Benchmark::State& state)
@@ -0,0 +1,67 @@
+#include "Benchmark.h"
+#include "bvh/SceneBVHAdapter.h"
+#include "bvh/TriBVHAdapter.h"
+
+#include <random>
+
+namespace IG {
+static TriMesh makeMesh()
+{
+    // ~260k triangles
+    return TriMesh::MakeUVSphere(Vector3f::Zero(), 1, 256, 512);
+}
+
+template <size_t N, size_t M>
+static void benchmarkTriBvh(Benchmark::State& state)
+{
+    const TriMesh mesh = makeMesh();
+    state.setItemsPerRun(mesh.faceCount());
+
+    state.run([&]() {
+        std::vector<typename BvhNTriM<N, M>::Node> nodes;
+        std::vector<typename BvhNTriM<N, M>::Tri> tris;
+        build_bvh<N, M>(mesh, nodes, tris);
+    });
+}
+
+IG_BENCHMARK(bvh_tri_2_1) { benchmarkTriBvh<2, 1>(state); }
+IG_BENCHMARK(bvh_tri_4_4) { benchmarkTriBvh<4, 4>(state); }
+IG_BENCHMARK(bvh_tri_8_4) { benchmarkTriBvh<8, 4>(state); }
+
+template <size_t N>
+static void benchmarkSceneBvh(Benchmark::State& state)
+{
+    constexpr size_t Count = 100000;
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::uniform_real_distribution<float> pos(-100, 100);
+    std::uniform_real_distribution<float> ext(0.1f, 2);
+
+    std::vector<EntityObject> objects(Count);
+    for (size_t i = 0; i < Count; ++i) {
+        const Vector3f center = Vector3f(pos(rnd), pos(rnd), pos(rnd));
+        const Vector3f extent = Vector3f(ext(rnd), ext(rnd), ext(rnd));
+
+        auto& obj      = objects[i];
+        obj.BBox       = BoundingBox(center - extent, center + extent);
+        obj.EntityID   = (int32)i;
+        obj.ShapeID    = 0;
+        obj.MaterialID = 0;
+        obj.User1ID    = 0;
+        obj.User2ID    = 0;
+        obj.Local      = Matrix4f::Identity();
+        obj.Flags      = 0;
+    }
+    state.setItemsPerRun(Count);
+
+    state.run([&]() {
+        std::vector<typename BvhNEnt<N>::Node> nodes;
+        std::vector<EntityLeaf1> objs;
+        build_scene_bvh<N>(nodes, objs, objects);
+    });
+}
+
+IG_BENCHMARK(bvh_scene_2) { benchmarkSceneBvh<2>(state); }
+IG_BENCHMARK(bvh_scene_4) { benchmarkSceneBvh<4>(state); }
+IG_BENCHMARK(bvh_scene_8) { benchmarkSceneBvh<8>(state); }
+} // namespace IG
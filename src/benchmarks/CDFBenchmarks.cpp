@@ -0,0 +1,68 @@
+#include "Benchmark.h"
+#include "CDF.h"
+
+#include <random>
+
+namespace IG {
+static Image makeImage(size_t width, size_t height)
+{
+    Image image = Image::createSolidImage(Vector4f::Zero(), width, height);
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::exponential_distribution<float> dist(1);
+    for (size_t i = 0; i < width * height * image.channels; ++i)
+        image.pixels[i] = dist(rnd);
+    return image;
+}
+
+IG_BENCHMARK(cdf_array)
+{
+    constexpr size_t Count = 1 << 22;
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::exponential_distribution<float> dist(1);
+    std::vector<float> values(Count);
+    for (auto& v : values)
+        v = dist(rnd);
+
+    const Path path = Benchmark::tempDirectory() / "cdf_array.bin";
+    state.setItemsPerRun(Count);
+    state.run([&]() { CDF::computeForArray(values, path); });
+}
+
+IG_BENCHMARK(cdf_image)
+{
+    const Image image = makeImage(2048, 1024);
+    const Path path   = Benchmark::tempDirectory() / "cdf_image.bin";
+
+    state.setItemsPerRun(image.width * image.height);
+    state.run([&]() {
+        size_t slice_conditional, slice_marginal;
+        CDF::computeForImage(image, path, slice_conditional, slice_marginal, true, true);
+    });
+}
+
+IG_BENCHMARK(cdf_image_sat)
+{
+    const Image image = makeImage(2048, 1024);
+    const Path path   = Benchmark::tempDirectory() / "cdf_image_sat.bin";
+
+    state.setItemsPerRun(image.width * image.height);
+    state.run([&]() {
+        size_t size, width, height;
+        CDF::computeForImageSAT(image, path, size, width, height, true, true);
+    });
+}
+
+IG_BENCHMARK(cdf_image_hierachical)
+{
+    const Image image = makeImage(2048, 1024);
+    const Path path   = Benchmark::tempDirectory() / "cdf_image_hierachical.bin";
+
+    state.setItemsPerRun(image.width * image.height);
+    state.run([&]() {
+        size_t size, slice, levels;
+        CDF::computeForImageHierachical(image, path, size, slice, levels, true, true);
+    });
+}
+} // namespace IG
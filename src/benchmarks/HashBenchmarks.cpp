@@ -0,0 +1,37 @@
+#include "Benchmark.h"
+#include "SHA256.h"
+#include "mesh/TriMesh.h"
+
+#include <random>
+
+namespace IG {
+IG_BENCHMARK(sha256)
+{
+    constexpr size_t Size = 64 * 1024 * 1024;
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::vector<uint8> data(Size);
+    for (auto& d : data)
+        d = (uint8)rnd();
+
+    state.setBytesPerRun(Size);
+    state.run([&]() {
+        SHA256 hash;
+        hash.update(data.data(), data.size());
+        const std::string result = hash.final();
+        (void)result;
+    });
+}
+
+// Used by the shape cache to identify meshes
+IG_BENCHMARK(sha256_trimesh)
+{
+    const TriMesh mesh = TriMesh::MakeIcoSphere(Vector3f::Zero(), 1, 7);
+
+    state.setItemsPerRun(mesh.faceCount());
+    state.run([&]() {
+        const std::string result = mesh.computeHash();
+        (void)result;
+    });
+}
+} // namespace IG
@@ -0,0 +1,62 @@
+#include "Benchmark.h"
+#include "Image.h"
+
+#include <random>
+
+namespace IG {
+static Image makeImage(size_t width, size_t height)
+{
+    Image image = Image::createSolidImage(Vector4f::Zero(), width, height);
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::uniform_real_distribution<float> dist(0, 1);
+    for (size_t i = 0; i < width * height * image.channels; ++i)
+        image.pixels[i] = dist(rnd);
+    return image;
+}
+
+IG_BENCHMARK(image_load_exr)
+{
+    const Path path = Benchmark::tempDirectory() / "image.exr";
+    Image image     = makeImage(2048, 1024);
+    if (!image.save(path))
+        throw std::runtime_error("Could not write " + path.generic_string());
+
+    state.setItemsPerRun(image.width * image.height);
+    state.run([&]() {
+        const Image loaded = Image::load(path);
+        (void)loaded;
+    });
+}
+
+IG_BENCHMARK(image_pack)
+{
+    const Image image = makeImage(2048, 1024);
+    state.setItemsPerRun(image.width * image.height);
+
+    std::vector<uint8> packed;
+    state.run([&]() { image.copyToPackedFormat(packed); });
+}
+
+IG_BENCHMARK(image_eval_bicubic)
+{
+    constexpr size_t Count = 1000000;
+
+    const Image image = makeImage(1024, 1024);
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::uniform_real_distribution<float> dist(0, 1);
+    std::vector<Vector2f> uvs(Count);
+    for (auto& uv : uvs)
+        uv = Vector2f(dist(rnd), dist(rnd));
+
+    state.setItemsPerRun(Count);
+    state.run([&]() {
+        Vector4f sum = Vector4f::Zero();
+        for (const auto& uv : uvs)
+            sum += image.eval(uv);
+        if (sum.hasNaN())
+            throw std::runtime_error("Unexpected NaN");
+    });
+}
+} // namespace IG
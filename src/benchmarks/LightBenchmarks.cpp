@@ -0,0 +1,30 @@
+#include "Benchmark.h"
+#include "light/LightHierarchy.h"
+
+#include <random>
+
+namespace IG {
+IG_BENCHMARK(light_hierarchy)
+{
+    constexpr size_t Count = 100000;
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::uniform_real_distribution<float> pos(-100, 100);
+    std::uniform_real_distribution<float> dir(-1, 1);
+    std::exponential_distribution<float> flux(1);
+
+    std::vector<LightHierarchy::Input> inputs(Count);
+    for (size_t i = 0; i < Count; ++i) {
+        auto& input        = inputs[i];
+        input.Position     = Vector3f(pos(rnd), pos(rnd), pos(rnd));
+        input.Direction    = Vector3f(dir(rnd), dir(rnd), dir(rnd) + 2).normalized(); // Always non-zero
+        input.Flux         = flux(rnd);
+        input.HasDirection = i % 4 != 0; // Mix in point lights
+        input.ID           = (int32)i;
+    }
+
+    const Path path = Benchmark::tempDirectory() / "light_hierarchy.bin";
+    state.setItemsPerRun(Count);
+    state.run([&]() { LightHierarchy::build(inputs, path); });
+}
+} // namespace IG
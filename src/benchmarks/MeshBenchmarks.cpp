@@ -0,0 +1,50 @@
+#include "Benchmark.h"
+#include "mesh/ObjFile.h"
+#include "mesh/PlyFile.h"
+
+#include <filesystem>
+
+namespace IG {
+static TriMesh makeMesh()
+{
+    // ~330k triangles
+    return TriMesh::MakeIcoSphere(Vector3f::Zero(), 1, 7);
+}
+
+IG_BENCHMARK(mesh_load_ply)
+{
+    const Path path = Benchmark::tempDirectory() / "mesh.ply";
+    const TriMesh mesh = makeMesh();
+    if (!ply::save(mesh, path))
+        throw std::runtime_error("Could not write " + path.generic_string());
+
+    state.setItemsPerRun(mesh.faceCount());
+    state.setBytesPerRun(std::filesystem::file_size(path));
+    state.run([&]() {
+        const TriMesh loaded = ply::load(path);
+        (void)loaded;
+    });
+}
+
+IG_BENCHMARK(mesh_load_obj)
+{
+    const Path path = Benchmark::tempDirectory() / "mesh.obj";
+    const TriMesh mesh = makeMesh();
+    if (!obj::save(mesh, path))
+        throw std::runtime_error("Could not write " + path.generic_string());
+
+    state.setItemsPerRun(mesh.faceCount());
+    state.setBytesPerRun(std::filesystem::file_size(path));
+    state.run([&]() {
+        const TriMesh loaded = obj::load(path);
+        (void)loaded;
+    });
+}
+
+IG_BENCHMARK(mesh_compute_normals)
+{
+    TriMesh mesh = makeMesh();
+    state.setItemsPerRun(mesh.faceCount());
+    state.run([&]() { mesh.computeVertexNormals(); });
+}
+} // namespace IG
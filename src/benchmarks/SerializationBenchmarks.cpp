@@ -0,0 +1,73 @@
+#include "Benchmark.h"
+#include "mesh/TriMesh.h"
+#include "serialization/VectorSerializer.h"
+
+#include <numeric>
+#include <random>
+
+namespace IG {
+// Similar to the data written by the shape and entity providers
+IG_BENCHMARK(serializer_write_scalars)
+{
+    constexpr size_t Count = 1 << 20;
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::uniform_real_distribution<float> dist(0, 1);
+    std::vector<float> values(Count);
+    for (auto& v : values)
+        v = dist(rnd);
+
+    std::vector<uint8> data;
+    data.reserve(Count * (sizeof(float) + sizeof(uint32)));
+
+    state.setBytesPerRun(Count * (sizeof(float) + sizeof(uint32)));
+    state.run([&]() {
+        data.clear();
+        VectorSerializer serializer(data, false);
+        for (size_t i = 0; i < Count; ++i) {
+            serializer.write(values[i]);
+            serializer.write((uint32)i);
+        }
+    });
+}
+
+IG_BENCHMARK(serializer_write_vector)
+{
+    constexpr size_t Count = 1 << 24;
+
+    std::vector<float> values(Count);
+    std::iota(values.begin(), values.end(), 0.0f);
+
+    std::vector<uint8> data;
+    data.reserve(Count * sizeof(float));
+
+    state.setBytesPerRun(Count * sizeof(float));
+    state.run([&]() {
+        data.clear();
+        VectorSerializer serializer(data, false);
+        serializer.write(values, true);
+    });
+}
+
+// Vertex data is padded to 16 bytes per element
+IG_BENCHMARK(serializer_write_aligned)
+{
+    constexpr size_t Count = 1 << 20;
+
+    std::mt19937 rnd(Benchmark::Seed);
+    std::uniform_real_distribution<float> dist(-1, 1);
+    std::vector<StVector3f> vertices(Count);
+    for (auto& v : vertices)
+        v = StVector3f(dist(rnd), dist(rnd), dist(rnd));
+
+    std::vector<uint8> data;
+    data.reserve(Count * 4 * sizeof(float));
+
+    state.setBytesPerRun(Count * 4 * sizeof(float));
+    state.run([&]() {
+        data.clear();
+        VectorSerializer serializer(data, false);
+        serializer.writeAligned(vertices, 4 * sizeof(float), true);
+    });
+}
+} // namespace IG
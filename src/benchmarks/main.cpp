@@ -0,0 +1,203 @@
+#include "Benchmark.h"
+#include "Logger.h"
+#include "config/Build.h"
+
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+using namespace IG;
+
+struct Summary {
+    std::string Name;
+    size_t Repetitions;
+    double MinMS;
+    double MedianMS;
+    double MeanMS;
+    double StdDevMS;
+    size_t Items;
+    size_t Bytes;
+};
+
+static Summary summarize(const std::string& name, const Benchmark::State& state)
+{
+    std::vector<double> times = state.times();
+    std::sort(times.begin(), times.end());
+
+    Summary summary{ name, times.size(), 0, 0, 0, 0, state.itemsPerRun(), state.bytesPerRun() };
+    if (times.empty())
+        return summary;
+
+    const double mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    double var        = 0;
+    for (double t : times)
+        var += (t - mean) * (t - mean);
+
+    summary.MinMS    = times.front();
+    summary.MedianMS = times.size() % 2 == 1 ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+    summary.MeanMS   = mean;
+    summary.StdDevMS = std::sqrt(var / times.size());
+    return summary;
+}
+
+static inline double perSecond(size_t count, double ms)
+{
+    return ms > 0 ? count / (ms / 1000) : 0;
+}
+
+static void writeJSON(std::ostream& stream, const std::vector<Summary>& summaries, size_t warmup)
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+    // JSON has no representation for nan and inf, therefore non-finite values are written as null
+    const auto writeNumber = [&](double value) {
+        if (std::isfinite(value))
+            writer.Double(value);
+        else
+            writer.Null();
+    };
+
+    const auto writeString = [&](const std::string& str) {
+        writer.String(str.c_str(), (rapidjson::SizeType)str.size());
+    };
+
+    writer.StartObject();
+    writer.Key("version");
+    writeString(Build::getVersionString());
+    writer.Key("git");
+    writeString(Build::getGitString());
+    writer.Key("variant");
+    writeString(Build::getBuildVariant());
+    writer.Key("seed");
+    writer.Uint(Benchmark::Seed);
+    writer.Key("warmup");
+    writer.Uint64(warmup);
+
+    writer.Key("benchmarks");
+    writer.StartArray();
+    for (const auto& s : summaries) {
+        writer.StartObject();
+        writer.Key("name");
+        writeString(s.Name);
+        writer.Key("repetitions");
+        writer.Uint64(s.Repetitions);
+        writer.Key("min_ms");
+        writeNumber(s.MinMS);
+        writer.Key("median_ms");
+        writeNumber(s.MedianMS);
+        writer.Key("mean_ms");
+        writeNumber(s.MeanMS);
+        writer.Key("stddev_ms");
+        writeNumber(s.StdDevMS);
+        writer.Key("items");
+        writer.Uint64(s.Items);
+        writer.Key("items_per_second");
+        writeNumber(perSecond(s.Items, s.MedianMS));
+        writer.Key("bytes");
+        writer.Uint64(s.Bytes);
+        writer.Key("bytes_per_second");
+        writeNumber(perSecond(s.Bytes, s.MedianMS));
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+
+    stream << buffer.GetString() << std::endl;
+}
+
+static void printTable(const std::vector<Summary>& summaries)
+{
+    std::cout << std::left << std::setw(32) << "Benchmark" << std::right
+              << std::setw(12) << "Min [ms]" << std::setw(12) << "Median [ms]" << std::setw(12) << "Mean [ms]" << std::setw(16) << "Throughput" << std::endl;
+    for (const auto& s : summaries) {
+        std::cout << std::left << std::setw(32) << s.Name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << s.MinMS << std::setw(12) << s.MedianMS << std::setw(12) << s.MeanMS;
+
+        if (s.Bytes > 0) {
+            std::stringstream stream;
+            stream << FormatMemory((size_t)perSecond(s.Bytes, s.MedianMS)) << "/s";
+            std::cout << std::setw(16) << stream.str();
+        } else if (s.Items > 0) {
+            std::cout << std::setw(14) << std::setprecision(2) << perSecond(s.Items, s.MedianMS) / 1e6 << "M/s";
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string output;
+    size_t repetitions = 5;
+    size_t warmup      = 1;
+    bool list          = false;
+
+    CLI::App app{ "Ignis micro-benchmarks", argc >= 1 ? argv[0] : "unknown" };
+    argv = app.ensure_utf8(argv);
+
+    app.set_version_flag("--version", Build::getBuildString());
+    app.add_option("-f,--filter", filter, "Only run benchmarks containing the given string");
+    app.add_option("-o,--output", output, "Write results as JSON to the given file. Use '-' to write to stdout");
+    app.add_option("-r,--repetitions", repetitions, "Number of measured repetitions per benchmark")->check(CLI::PositiveNumber);
+    app.add_option("-w,--warmup", warmup, "Number of warmup runs per benchmark")->check(CLI::NonNegativeNumber);
+    app.add_flag("-l,--list", list, "List all benchmarks and exit");
+
+    CLI11_PARSE(app, argc, argv);
+
+    // Only report errors of the runtime, benchmark output should stay clean
+    IG_LOGGER.setVerbosity(L_ERROR);
+
+    std::vector<Benchmark::Entry> entries = Benchmark::registry();
+    std::sort(entries.begin(), entries.end(), [](const Benchmark::Entry& a, const Benchmark::Entry& b) { return a.Name < b.Name; });
+    std::erase_if(entries, [&](const Benchmark::Entry& e) { return e.Name.find(filter) == std::string::npos; });
+
+    if (list) {
+        for (const auto& entry : entries)
+            std::cout << entry.Name << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    const bool toStdout = output == "-";
+
+    std::vector<Summary> summaries;
+    for (const auto& entry : entries) {
+        if (!toStdout)
+            std::cout << "Running " << entry.Name << "..." << std::endl;
+
+        Benchmark::State state(warmup, repetitions);
+        try {
+            entry.Func(state);
+        } catch (const std::exception& e) {
+            std::cerr << "Benchmark " << entry.Name << " failed: " << e.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        summaries.push_back(summarize(entry.Name, state));
+    }
+
+    if (toStdout) {
+        writeJSON(std::cout, summaries, warmup);
+        return EXIT_SUCCESS;
+    }
+
+    printTable(summaries);
+
+    if (!output.empty()) {
+        std::ofstream stream(output);
+        if (!stream) {
+            std::cerr << "Could not open " << output << " for writing" << std::endl;
+            return EXIT_FAILURE;
+        }
+        writeJSON(stream, summaries, warmup);
+    }
+
+    return EXIT_SUCCESS;
+}
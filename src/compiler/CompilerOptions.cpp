@@ -40,6 +40,7 @@ CompilerOptions::CompilerOptions(int argc, char** argv, const std::string& desc)
     app.add_flag("--no-logo", NoLogo, "Do not use show copyright");
 
     app.add_option("-O,--optimization", OptimizationLevel, "Level of optimization applied to shaders. Range is [0, 3]. Level 0 will also add debug information")->default_val(OptimizationLevel);
+    app.add_flag("--server", Server, "Keep running and compile all scripts sent via stdin until it is closed. Used internally by the runtime");
 
     // Add some hidden commandline parameters
     bool listCLI = false;
@@ -16,6 +16,7 @@ public:
     bool NoLogo             = false;
 
     size_t OptimizationLevel = 3;
+    bool Server              = false;
 
     Path InputFile;
 };
@@ -1,11 +1,21 @@
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 
+#ifdef IG_OS_WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "CompilerOptions.h"
 #include "Logger.h"
 #include "device/DeviceManager.h"
 #include "device/ICompilerDevice.h"
 #include "device/IDeviceInterface.h"
+#include "log/LogListener.h"
+#include "shader/CompilerServerProtocol.h"
 
 using namespace IG;
 
@@ -18,18 +28,117 @@ static std::string getInput(std::istream& inputStream)
     return stream.str();
 }
 
+/// Captures the log entries of a single compilation, which are sent back to the runtime
+class CaptureLogListener : public LogListener {
+public:
+    void writeEntry(const LogMessage& msg) override { mLog.append(msg.Message); }
+    inline std::string acquire() { return std::exchange(mLog, {}); }
+
+private:
+    std::string mLog;
+};
+
+/// Only responses are written to the returned stream. Everything else written to stdout is redirected to stderr
+static std::FILE* openResponseStream()
+{
+    std::cout.flush();
+    std::fflush(stdout);
+#ifdef IG_OS_WINDOWS
+    _setmode(_fileno(stdin), _O_BINARY);
+    const int fd = _dup(_fileno(stdout));
+    _dup2(_fileno(stderr), _fileno(stdout));
+    return _fdopen(fd, "wb");
+#else
+    const int fd = dup(STDOUT_FILENO);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+    return fdopen(fd, "wb");
+#endif
+}
+
+static bool readRequest(std::string& command, std::string& payload)
+{
+    std::string header;
+    if (!std::getline(std::cin, header))
+        return false; // Closed by the runtime
+
+    const auto sep = header.find(' ');
+    if (sep == std::string::npos)
+        return false;
+
+    command = header.substr(0, sep);
+    try {
+        payload.resize(std::stoull(header.substr(sep + 1)));
+    } catch (...) {
+        return false;
+    }
+    return (bool)std::cin.read(payload.data(), payload.size());
+}
+
+static int runServer(const CompilerOptions& cmd, const ICompilerDevice& compiler, std::FILE* response)
+{
+    auto capture = std::make_shared<CaptureLogListener>();
+    IG_LOGGER.addListener(capture);
+
+    const ICompilerDevice::Settings settings{
+        .OptimizationLevel = (int)cmd.OptimizationLevel,
+        .Verbose           = IG_LOGGER.verbosity() == L_DEBUG
+    };
+
+    // The library is sent once and shared by all following scripts, the same way ScriptCompiler::prepare does it
+    std::string library;
+    std::string command;
+    std::string payload;
+    while (readRequest(command, payload)) {
+        if (command == CompilerServerProtocol::LibraryCommand) {
+            library = std::move(payload);
+            continue;
+        } else if (command != CompilerServerProtocol::CompileCommand) {
+            IG_LOG(L_ERROR) << "Unknown command '" << command << "'" << std::endl;
+            break;
+        }
+
+        const bool ret = compiler.compile(settings, library + "\n" + payload);
+        if (!ret)
+            IG_LOG(L_ERROR) << "Failed to compile input" << std::endl;
+
+        IG_LOGGER.flush();
+        const std::string log = capture->acquire();
+
+        const std::string header = CompilerServerProtocol::header(ret ? CompilerServerProtocol::SuccessStatus : CompilerServerProtocol::ErrorStatus, log.size());
+        std::fwrite(header.data(), 1, header.size(), response);
+        std::fwrite(log.data(), 1, log.size(), response);
+        std::fflush(response);
+    }
+
+    IG_LOGGER.removeListener(capture);
+    std::fclose(response);
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
     CompilerOptions cmd(argc, argv, "Ignis JIT Compiler");
     if (cmd.ShouldExit)
         return EXIT_SUCCESS;
 
+    // Redirect stdout before anything is logged, as it is used for the responses of the server
+    std::FILE* response = nullptr;
+    if (cmd.Server) {
+        response = openResponseStream();
+        if (response == nullptr) {
+            IG_LOG(L_ERROR) << "Could not open response stream" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     if (!cmd.Quiet && !cmd.NoLogo)
         std::cout << Build::getCopyrightString() << std::endl;
 
     // --------------------------------
     std::string input;
-    if (cmd.InputFile.empty()) {
+    if (cmd.Server) {
+        // Requests are read from std::cin later
+    } else if (cmd.InputFile.empty()) {
         // Read from std::cin
         input = getInput(std::cin);
     } else {
@@ -58,6 +167,9 @@ int main(int argc, char** argv)
     }
 
     // --------------------------------
+    if (cmd.Server)
+        return runServer(cmd, *compilerDevice, response);
+
     const bool ret = compilerDevice->compile(
         ICompilerDevice::Settings{
             .OptimizationLevel = (int)cmd.OptimizationLevel,
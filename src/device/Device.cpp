@@ -3,6 +3,7 @@
 #include "Logger.h"
 #include "RuntimeStructs.h"
 #include "Statistics.h"
+#include "Timeline.h"
 #include "device/ShaderKey.h"
 #include "device/ShallowArray.h"
 #include "table/SceneDatabase.h"
@@ -13,6 +14,7 @@
 #include <anydsl_runtime.hpp>
 
 #include <atomic>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
@@ -33,8 +35,9 @@
 #endif
 #endif
 
-#define _SECTION(type)                                                  \
-    const auto sectionClosure = getThreadData()->stats.section((type)); \
+#define _SECTION(type)                                                    \
+    const auto sectionClosure = getThreadData()->stats.section((type));   \
+    IG_TIMELINE_SCOPE("section", Statistics::getSectionTypeName((type))); \
     IG_UNUSED(sectionClosure)
 
 namespace IG {
@@ -115,8 +118,19 @@ struct DeviceBufferBase {
 using DeviceBuffer = DeviceBufferBase<uint8_t>;
 using DeviceStream = DeviceBufferBase<float>;
 
+/// Cost of the tile currently processed by a CPU worker. It is spread over the pixels of the tile when finished
+struct TileCost {
+    float* Target = nullptr; // Cost AOV, null if not requested
+    int XMin      = 0;
+    int YMin      = 0;
+    int XMax      = 0;
+    int YMax      = 0;
+    std::chrono::steady_clock::time_point Start;
+    size_t Rays        = 0;
+    size_t Invocations = 0;
+};
+
 struct CPUData {
-    std::atomic<size_t> ref_count = 0;
     DeviceStream cpu_primary;
     DeviceStream cpu_secondary;
     TemporaryStorageHostProxy temporary_storage_host;
@@ -124,8 +138,68 @@ struct CPUData {
     ParameterSet* current_local_registry = nullptr;
     ShaderKey current_shader_key         = ShaderKey(0, ShaderType::Device, 0);
     std::unordered_map<ShaderKey, ShaderStats, ShaderKeyHash> shader_stats;
+    TileCost tile_cost;
 };
-thread_local CPUData* tlThreadData = nullptr;
+// --------------------- Math stuff
+static inline unsigned int enableMathMode()
+{
+    // Force flush to zero mode for denormals
+#if defined(__x86_64__) || defined(__amd64__) || defined(_M_X64)
+    const unsigned int prevMathMode = _mm_getcsr();
+    _mm_setcsr(prevMathMode | (_MM_FLUSH_ZERO_ON | _MM_DENORMALS_ZERO_ON));
+    return prevMathMode;
+#else
+    return 0;
+#endif
+}
+
+static inline void restoreMathMode([[maybe_unused]] unsigned int prevMathMode)
+{
+    // Reset mode
+#if defined(__x86_64__) || defined(__amd64__) || defined(_M_X64)
+    _mm_setcsr(prevMathMode);
+#endif
+}
+
+// --------------------- Thread binding
+// Multiple interfaces (one per device instance) can be active at the same time and share the same thread pool.
+// The callbacks from the shaders do not carry the interface, therefore each thread is bound to the interface it is currently working for.
+// A thread might work for multiple interfaces in a nested fashion (e.g., work stealing while waiting), therefore the bindings form a stack.
+class Interface;
+struct ThreadBinding {
+    Interface* Owner;
+    CPUData* Data; // Only acquired if the thread is registered for rendering
+    size_t DataRefCount;
+    size_t RefCount;
+    unsigned int PrevMathMode;
+};
+thread_local std::vector<ThreadBinding> tlBindings;
+
+static inline void bindThread(Interface* owner)
+{
+    if (!tlBindings.empty() && tlBindings.back().Owner == owner)
+        ++tlBindings.back().RefCount;
+    else
+        tlBindings.push_back(ThreadBinding{ owner, nullptr, 0, 1, enableMathMode() });
+}
+
+static inline void unbindThread()
+{
+    IG_ASSERT(!tlBindings.empty(), "Expected bindThread together with unbindThread");
+
+    ThreadBinding& binding = tlBindings.back();
+    if (--binding.RefCount == 0) {
+        IG_ASSERT(binding.Data == nullptr, "Expected thread data to be released before unbinding");
+        restoreMathMode(binding.PrevMathMode);
+        tlBindings.pop_back();
+    }
+}
+
+static inline Interface* currentInterface()
+{
+    IG_ASSERT(!tlBindings.empty(), "Thread is not bound to a device");
+    return tlBindings.back().Owner;
+}
 
 static inline int computeTargetID(const Target& target)
 {
@@ -198,6 +272,7 @@ private:
     DeviceData mDeviceData;
 
     std::mutex mThreadMutex;
+    std::mutex mThreadDataMutex;
     std::vector<std::unique_ptr<CPUData>> mThreadData;
 
     tbb::concurrent_queue<CPUData*> mAvailableThreadData;
@@ -277,6 +352,12 @@ public:
         mCurrentRenderSettings = settings;
         mCurrentParameters     = parameterSet;
 
+        // The rays are only valid for the duration of this render call. Always upload them, as the content might have changed even if the size is the same
+        if (settings.rays) {
+            updateRayList(*settings.rays);
+            mCurrentRenderSettings.rays = nullptr;
+        }
+
         resetFramebufferAccess();
     }
 
@@ -368,7 +449,6 @@ public:
 
     inline void setupThreadData()
     {
-        tlThreadData = nullptr;
         mThreadData.clear();
 
         const size_t req_threads = isGPU() ? 0 : (mSetupSettings.target.threadCount() == 0 ? std::thread::hardware_concurrency() : mSetupSettings.target.threadCount());
@@ -423,34 +503,139 @@ public:
 
     inline void registerThread()
     {
-        if (tlThreadData == nullptr) {
+        bindThread(this);
+
+        ThreadBinding& binding = tlBindings.back();
+        if (binding.Data == nullptr) {
             CPUData* ptr = nullptr;
-            while (!mAvailableThreadData.try_pop(ptr))
-                std::this_thread::yield();
+            if (!mAvailableThreadData.try_pop(ptr)) {
+                // Nested work (e.g., stolen by a waiting thread) might need more than one data block per thread
+                std::lock_guard<std::mutex> _guard(mThreadDataMutex);
+                ptr = mThreadData.emplace_back(std::make_unique<CPUData>()).get();
+            }
 
             if (ptr == nullptr)
                 IG_LOG(L_FATAL) << "Registering thread 0x" << std::hex << std::this_thread::get_id() << " failed!" << std::endl;
-            else
-                tlThreadData = ptr;
+            binding.Data = ptr;
         }
 
-        tlThreadData->ref_count++;
+        ++binding.DataRefCount;
+
+        Timeline::instance().setThreadName("Worker", true);
     }
 
     inline void unregisterThread()
     {
-        IG_ASSERT(tlThreadData != nullptr, "Expected registerThread together with a unregisterThread");
+        IG_ASSERT(!tlBindings.empty() && tlBindings.back().Owner == this && tlBindings.back().Data != nullptr, "Expected registerThread together with a unregisterThread");
 
-        if (tlThreadData->ref_count.fetch_sub(1) == 1) {
-            mAvailableThreadData.push(tlThreadData);
-            tlThreadData = nullptr;
+        ThreadBinding& binding = tlBindings.back();
+        if (--binding.DataRefCount == 0) {
+            mAvailableThreadData.push(binding.Data);
+            binding.Data = nullptr;
         }
+
+        unbindThread();
     }
 
     inline CPUData* getThreadData()
     {
-        IG_ASSERT(tlThreadData != nullptr, "Thread not registered");
-        return tlThreadData;
+        IG_ASSERT(!tlBindings.empty() && tlBindings.back().Data != nullptr, "Thread not registered");
+        return tlBindings.back().Data;
+    }
+
+    inline void beginShaderLaunch(ShaderType type, size_t workload, size_t id)
+    {
+        if (mSetupSettings.AcquireStats)
+            getThreadData()->stats.beginShaderLaunch(type, workload, id);
+
+        auto& timeline = Timeline::instance();
+        if (timeline.isEnabled())
+            timeline.begin("shader", getShaderEventName(type, id));
+
+        if (!isGPU()) {
+            TileCost& cost = getThreadData()->tile_cost;
+            if (cost.Target) {
+                if (type == ShaderType::PrimaryTraversal || type == ShaderType::SecondaryTraversal)
+                    cost.Rays += workload;
+                else
+                    cost.Invocations += workload;
+            }
+        }
+    }
+
+    inline void endShaderLaunch(ShaderType type, size_t id)
+    {
+        if (mSetupSettings.AcquireStats)
+            getThreadData()->stats.endShaderLaunch(type, id);
+
+        auto& timeline = Timeline::instance();
+        if (timeline.isEnabled())
+            timeline.end("shader", getShaderEventName(type, id));
+    }
+
+    // -------------------------------------------------------- Cost
+    inline void beginTile(int xmin, int ymin, int xmax, int ymax)
+    {
+        TileCost& cost = getThreadData()->tile_cost;
+        cost.Target    = nullptr;
+
+        // Techniques with custom work sizes do not map to the framebuffer
+        if (xmax > (int)framebufferWidth() || ymax > (int)framebufferHeight())
+            return;
+
+        const auto it = mAOVs.find(IRenderDevice::CostAOV);
+        if (it == mAOVs.end())
+            return;
+
+        cost.Target      = it->second.Data.data();
+        cost.XMin        = xmin;
+        cost.YMin        = ymin;
+        cost.XMax        = xmax;
+        cost.YMax        = ymax;
+        cost.Rays        = 0;
+        cost.Invocations = 0;
+        cost.Start       = std::chrono::steady_clock::now();
+    }
+
+    inline void endTile()
+    {
+        TileCost& cost = getThreadData()->tile_cost;
+        if (!cost.Target)
+            return;
+
+        const size_t pixels = (size_t)(cost.XMax - cost.XMin) * (size_t)(cost.YMax - cost.YMin);
+        if (pixels > 0) {
+            const double elapsed     = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - cost.Start).count();
+            const float time        = (float)(elapsed / pixels);
+            const float rays        = (float)((double)cost.Rays / pixels);
+            const float invocations = (float)((double)cost.Invocations / pixels);
+
+            // Tiles are disjoint, therefore no synchronization is necessary
+            const size_t width = framebufferWidth();
+            for (int y = cost.YMin; y < cost.YMax; ++y) {
+                for (int x = cost.XMin; x < cost.XMax; ++x) {
+                    float* pixel = &cost.Target[3 * (y * width + x)];
+                    pixel[0] += time;
+                    pixel[1] += rays;
+                    pixel[2] += invocations;
+                }
+            }
+        }
+
+        cost.Target = nullptr;
+    }
+
+    static inline std::string getShaderEventName(ShaderType type, size_t id)
+    {
+        switch (type) {
+        case ShaderType::Hit:
+        case ShaderType::AdvancedShadowHit:
+        case ShaderType::AdvancedShadowMiss:
+        case ShaderType::Callback:
+            return std::string(Statistics::getShaderTypeName(type)) + " @" + std::to_string(id);
+        default:
+            return std::string(Statistics::getShaderTypeName(type));
+        }
     }
 
     inline void setCurrentShader(int workload, const ShaderKey& key, const ShaderOutput<void*>& shader)
@@ -599,47 +784,52 @@ public:
             return std::get<Bvh>(it->second);
     }
 
-    inline const anydsl::Array<StreamRay>& loadRayList()
+    /// Convert the given rays and upload them to the device. Has to be done before rendering, as the list is accessed concurrently while rendering
+    inline void updateRayList(const RayBatch& batch)
     {
         if (mSetupSettings.DebugTrace)
-            IG_LOG(L_DEBUG) << "TRACE> Load Ray List" << std::endl;
+            IG_LOG(L_DEBUG) << "TRACE> Update Ray List" << std::endl;
 
-        size_t count = mCurrentRenderSettings.width;
-        auto& device = mDeviceData;
-        if (device.ray_list.size() == (int64_t)count)
-            return device.ray_list;
+        std::vector<StreamRay> rays(batch.Count);
 
-        IG_ASSERT(mCurrentRenderSettings.rays != nullptr, "Expected list of rays to be available");
+        bool invalid = false;
+        for (size_t i = 0; i < batch.Count; ++i) {
+            const float* org   = batch.Origins + i * batch.Stride;
+            const float* dir   = batch.Directions + i * batch.Stride;
+            const float* range = batch.Ranges ? batch.Ranges + i * batch.RangeStride : nullptr;
 
-        std::vector<StreamRay> rays;
-        rays.reserve(count);
+            float norm = std::sqrt(dir[0] * dir[0] + dir[1] * dir[1] + dir[2] * dir[2]);
+            if (!(norm >= std::numeric_limits<float>::epsilon())) {
+                invalid = true;
+                norm    = 1;
+            }
 
-        for (size_t i = 0; i < count; ++i) {
-            const auto dRay = mCurrentRenderSettings.rays[i];
+            StreamRay& ray = rays[i];
+            ray.org.x      = org[0];
+            ray.org.y      = org[1];
+            ray.org.z      = org[2];
 
-            float norm = dRay.Direction.norm();
-            if (norm < std::numeric_limits<float>::epsilon()) {
-                IG_LOG(L_ERROR) << "Invalid ray given: Ray has zero direction!" << std::endl;
-                norm = 1;
-            }
+            ray.dir.x = dir[0] / norm;
+            ray.dir.y = dir[1] / norm;
+            ray.dir.z = dir[2] / norm;
 
-            // FIXME: Bytewise they are essentially the same...
-            StreamRay ray;
-            ray.org.x = dRay.Origin(0);
-            ray.org.y = dRay.Origin(1);
-            ray.org.z = dRay.Origin(2);
+            ray.tmin = range ? range[0] : 0.0f;
+            ray.tmax = range ? range[1] : std::numeric_limits<float>::max();
+        }
 
-            ray.dir.x = dRay.Direction(0) / norm;
-            ray.dir.y = dRay.Direction(1) / norm;
-            ray.dir.z = dRay.Direction(2) / norm;
+        if (invalid)
+            IG_LOG(L_ERROR) << "Invalid ray given: Ray has zero direction!" << std::endl;
 
-            ray.tmin = dRay.Range(0);
-            ray.tmax = dRay.Range(1);
+        mDeviceData.ray_list = copyToDevice(rays);
+    }
 
-            rays.push_back(ray);
-        }
+    inline const anydsl::Array<StreamRay>& loadRayList()
+    {
+        if (mSetupSettings.DebugTrace)
+            IG_LOG(L_DEBUG) << "TRACE> Load Ray List" << std::endl;
 
-        return device.ray_list = copyToDevice(rays);
+        IG_ASSERT(mDeviceData.ray_list.size() == (int64_t)mCurrentRenderSettings.width, "Expected list of rays to be available");
+        return mDeviceData.ray_list;
     }
 
     template <typename T>
@@ -897,6 +1087,16 @@ public:
         return true;
     }
 
+    inline void copyBufferFromHost(const std::string& buffer_name, const void* src, size_t sizeInBytes)
+    {
+        if (sizeInBytes == 0)
+            return;
+
+        // Will create the buffer if necessary
+        auto& buffer = requestBuffer(buffer_name, (int32_t)sizeInBytes, 0);
+        anydsl_copy(0 /* Host */, src, 0, mDeviceID, buffer.Data.data(), 0, sizeInBytes);
+    }
+
     inline Device::BufferAccessor getBufferForDevice(const std::string& buffer_name)
     {
         auto& buffers = mDeviceData.buffers;
@@ -1022,8 +1222,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Device Shader" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::Device, 1, {});
+        beginShaderLaunch(ShaderType::Device, 1, {});
 
         using Callback = decltype(ig_callback_shader);
         auto callback  = reinterpret_cast<Callback*>(mCurrentShaderSet.DeviceShader.Exec);
@@ -1033,8 +1232,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::Device, {});
+        endShaderLaunch(ShaderType::Device, {});
     }
 
     inline void runTonemapShader(float* in_pixels, uint32_t* device_out_pixels, ::TonemapSettings& settings)
@@ -1042,8 +1240,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Tonemap Shader" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::Tonemap, 1, {});
+        beginShaderLaunch(ShaderType::Tonemap, 1, {});
 
         using Callback = decltype(ig_tonemap_shader);
         auto callback  = reinterpret_cast<Callback*>(mCurrentShaderSet.TonemapShader.Exec);
@@ -1053,8 +1250,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::Tonemap, {});
+        endShaderLaunch(ShaderType::Tonemap, {});
     }
 
     inline ::ImageInfoOutput runImageinfoShader(float* in_pixels, ::ImageInfoSettings& settings)
@@ -1062,8 +1258,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Imageinfo Shader" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::ImageInfo, 1, {});
+        beginShaderLaunch(ShaderType::ImageInfo, 1, {});
 
         using Callback = decltype(ig_imageinfo_shader);
         auto callback  = reinterpret_cast<Callback*>(mCurrentShaderSet.ImageinfoShader.Exec);
@@ -1075,8 +1270,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::ImageInfo, {});
+        endShaderLaunch(ShaderType::ImageInfo, {});
 
         return output;
     }
@@ -1086,8 +1280,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Primary Traversal Shader [S=" << size << "]" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::PrimaryTraversal, size, {});
+        beginShaderLaunch(ShaderType::PrimaryTraversal, size, {});
 
         using Callback = decltype(ig_traversal_shader);
         auto callback  = reinterpret_cast<Callback*>(mCurrentShaderSet.PrimaryTraversalShader.Exec);
@@ -1097,8 +1290,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::PrimaryTraversal, {});
+        endShaderLaunch(ShaderType::PrimaryTraversal, {});
     }
 
     inline void runSecondaryTraversalShader(int size)
@@ -1106,8 +1298,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Secondary Traversal Shader [S=" << size << "]" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::SecondaryTraversal, size, {});
+        beginShaderLaunch(ShaderType::SecondaryTraversal, size, {});
 
         using Callback = decltype(ig_traversal_shader);
         auto callback  = reinterpret_cast<Callback*>(mCurrentShaderSet.SecondaryTraversalShader.Exec);
@@ -1117,8 +1308,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::SecondaryTraversal, {});
+        endShaderLaunch(ShaderType::SecondaryTraversal, {});
     }
 
     inline int runRayGenerationShader(int next_id, int size, int xmin, int ymin, int xmax, int ymax)
@@ -1126,8 +1316,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Ray Generation Shader [S=" << size << ", I=" << next_id << "]" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::RayGeneration, (xmax - xmin) * (ymax - ymin), {});
+        beginShaderLaunch(ShaderType::RayGeneration, (xmax - xmin) * (ymax - ymin), {});
 
         using Callback = decltype(ig_ray_generation_shader);
         auto callback  = reinterpret_cast<Callback*>(mCurrentShaderSet.RayGenerationShader.Exec);
@@ -1137,8 +1326,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::RayGeneration, {});
+        endShaderLaunch(ShaderType::RayGeneration, {});
         return ret;
     }
 
@@ -1147,8 +1335,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Miss Shader [S=" << first << ", E=" << last << "]" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::Miss, last - first, {});
+        beginShaderLaunch(ShaderType::Miss, last - first, {});
 
         using Callback = decltype(ig_miss_shader);
         auto callback  = reinterpret_cast<Callback*>(mCurrentShaderSet.MissShader.Exec);
@@ -1158,8 +1345,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::Miss, {});
+        endShaderLaunch(ShaderType::Miss, {});
     }
 
     inline void runHitShader(int material_id, int first, int last)
@@ -1167,8 +1353,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Hit Shader [M=" << material_id << ", S=" << first << ", E=" << last << "]" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::Hit, last - first, material_id);
+        beginShaderLaunch(ShaderType::Hit, last - first, material_id);
 
         using Callback = decltype(ig_hit_shader);
         IG_ASSERT(material_id >= 0 && material_id < (int)mCurrentShaderSet.HitShaders.size(), "Expected material id for hit shaders to be valid");
@@ -1176,12 +1361,48 @@ public:
         auto callback      = reinterpret_cast<Callback*>(output.Exec);
         IG_ASSERT(callback != nullptr, "Expected hit shader to be valid");
         setCurrentShader(last - first, ShaderKey(mCurrentShaderSet.ID, ShaderType::Hit, (uint32)material_id), output);
+
+        // On the CPU the hit shader is called per entity, which allows a more fine grained profile
+        const bool entityStats = mSetupSettings.AcquireStats && !isGPU() && first < last;
+        const int entity_id    = entityStats ? getStreamComponent<int>(getThreadData()->cpu_primary, offsetof(PrimaryStream, ent_id))[first] : -1;
+        if (entityStats && entity_id >= 0)
+            getThreadData()->stats.beginEntityLaunch((size_t)entity_id, last - first);
+
         callback(&mCurrentDriverSettings, material_id, first, last);
 
+        if (entityStats && entity_id >= 0)
+            getThreadData()->stats.endEntityLaunch((size_t)entity_id);
+
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::Hit, material_id);
+        endShaderLaunch(ShaderType::Hit, material_id);
+
+        if (entityStats)
+            countSpawnedRays(material_id, entity_id, first, last);
+    }
+
+    /// Get a single component of a stream, given by the offset of the respective member pointer in the stream structure
+    template <typename T>
+    static inline const T* getStreamComponent(const DeviceStream& stream, size_t member_offset)
+    {
+        const size_t component = member_offset / sizeof(float*);
+        return reinterpret_cast<const T*>(stream.Data.data() + component * stream.BlockSize);
+    }
+
+    inline void countSpawnedRays(int material_id, int entity_id, int first, int last)
+    {
+        // The ray id is the first component of the ray stream and is negative if no ray was spawned
+        const int* shadow_ids = getStreamComponent<int>(getThreadData()->cpu_secondary, offsetof(SecondaryStream, rays));
+        const int* bounce_ids = getStreamComponent<int>(getThreadData()->cpu_primary, offsetof(PrimaryStream, rays));
+
+        size_t shadow = 0;
+        size_t bounce = 0;
+        for (int i = first; i < last; ++i) {
+            shadow += shadow_ids[i] >= 0 ? 1 : 0;
+            bounce += bounce_ids[i] >= 0 ? 1 : 0;
+        }
+
+        getThreadData()->stats.addSpawnedRays((size_t)material_id, entity_id, shadow, bounce);
     }
 
     inline bool useAdvancedShadowHandling()
@@ -1197,8 +1418,7 @@ public:
             if (mSetupSettings.DebugTrace)
                 IG_LOG(L_DEBUG) << "TRACE> Advanced Hit Shader [I=" << material_id << ", S=" << first << ", E=" << last << "]" << std::endl;
 
-            if (mSetupSettings.AcquireStats)
-                getThreadData()->stats.beginShaderLaunch(ShaderType::AdvancedShadowHit, last - first, material_id);
+            beginShaderLaunch(ShaderType::AdvancedShadowHit, last - first, material_id);
 
             using Callback = decltype(ig_advanced_shadow_shader);
             IG_ASSERT(material_id >= 0 && material_id < (int)mCurrentShaderSet.AdvancedShadowHitShaders.size(), "Expected material id for advanced shadow hit shaders to be valid");
@@ -1210,14 +1430,12 @@ public:
 
             checkDebugOutput();
 
-            if (mSetupSettings.AcquireStats)
-                getThreadData()->stats.endShaderLaunch(ShaderType::AdvancedShadowHit, material_id);
+            endShaderLaunch(ShaderType::AdvancedShadowHit, material_id);
         } else {
             if (mSetupSettings.DebugTrace)
                 IG_LOG(L_DEBUG) << "TRACE> Advanced Miss Shader [I=" << material_id << ", S=" << first << ", E=" << last << "]" << std::endl;
 
-            if (mSetupSettings.AcquireStats)
-                getThreadData()->stats.beginShaderLaunch(ShaderType::AdvancedShadowMiss, last - first, material_id);
+            beginShaderLaunch(ShaderType::AdvancedShadowMiss, last - first, material_id);
 
             using Callback = decltype(ig_advanced_shadow_shader);
             IG_ASSERT(material_id >= 0 && material_id < (int)mCurrentShaderSet.AdvancedShadowMissShaders.size(), "Expected material id for advanced shadow miss shaders to be valid");
@@ -1229,8 +1447,7 @@ public:
 
             checkDebugOutput();
 
-            if (mSetupSettings.AcquireStats)
-                getThreadData()->stats.endShaderLaunch(ShaderType::AdvancedShadowMiss, material_id);
+            endShaderLaunch(ShaderType::AdvancedShadowMiss, material_id);
         }
     }
 
@@ -1246,16 +1463,14 @@ public:
             if (mSetupSettings.DebugTrace)
                 IG_LOG(L_DEBUG) << "TRACE> Callback Shader [T=" << type << "]" << std::endl;
 
-            if (mSetupSettings.AcquireStats)
-                getThreadData()->stats.beginShaderLaunch(ShaderType::Callback, 1, type);
+            beginShaderLaunch(ShaderType::Callback, 1, type);
 
             setCurrentShader(1, ShaderKey(mCurrentShaderSet.ID, ShaderType::Callback, (uint32)type), output);
             callback(&mCurrentDriverSettings);
 
             checkDebugOutput();
 
-            if (mSetupSettings.AcquireStats)
-                getThreadData()->stats.endShaderLaunch(ShaderType::Callback, type);
+            endShaderLaunch(ShaderType::Callback, type);
         }
     }
 
@@ -1266,8 +1481,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Bake Shader" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::Bake, 1, {});
+        beginShaderLaunch(ShaderType::Bake, 1, {});
 
         const auto copy             = mSceneSettings.resource_map;
         mSceneSettings.resource_map = resource_map;
@@ -1282,8 +1496,7 @@ public:
 
         mSceneSettings.resource_map = copy;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::Bake, {});
+        endShaderLaunch(ShaderType::Bake, {});
     }
 
     inline void runPassShader(const ShaderOutput<void*>& shader)
@@ -1293,8 +1506,7 @@ public:
         if (mSetupSettings.DebugTrace)
             IG_LOG(L_DEBUG) << "TRACE> Pass Shader" << std::endl;
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.beginShaderLaunch(ShaderType::Pass, 1, {});
+        beginShaderLaunch(ShaderType::Pass, 1, {});
 
         using Callback = decltype(ig_pass_main);
         auto callback  = reinterpret_cast<Callback*>(shader.Exec);
@@ -1304,8 +1516,7 @@ public:
 
         checkDebugOutput();
 
-        if (mSetupSettings.AcquireStats)
-            getThreadData()->stats.endShaderLaunch(ShaderType::Pass, {});
+        endShaderLaunch(ShaderType::Pass, {});
     }
 
     // ---------------------------------------------------- Framebuffer/AOV stuff
@@ -1508,6 +1719,7 @@ public:
 
     inline Statistics* getFullStats()
     {
+        std::lock_guard<std::mutex> _guard(mThreadDataMutex);
         mMainStats.reset();
         for (const auto& data : mThreadData)
             mMainStats.add(data->stats);
@@ -1515,6 +1727,90 @@ public:
         return &mMainStats;
     }
 
+    inline std::vector<size_t> getMaterialWorkloads()
+    {
+        std::lock_guard<std::mutex> _guard(mThreadDataMutex);
+        std::vector<size_t> workloads;
+        for (const auto& data : mThreadData) {
+            for (const auto& pair : data->shader_stats) {
+                if (pair.first.type() != ShaderType::Hit)
+                    continue;
+
+                const size_t mat_id = pair.first.subID();
+                if (workloads.size() <= mat_id)
+                    workloads.resize(mat_id + 1, 0);
+                workloads[mat_id] += pair.second.workload_count;
+            }
+        }
+        return workloads;
+    }
+
+    template <typename T>
+    static inline size_t byteSize(const anydsl::Array<T>& array)
+    {
+        return (size_t)array.size() * sizeof(T);
+    }
+
+    template <typename T>
+    static inline size_t byteSize(const ShallowArray<T>& array)
+    {
+        return byteSize(array.device_data()); // Host data is owned by the scene database
+    }
+
+    inline MemoryUsage getMemoryUsage()
+    {
+        // Everything allocated with the device id is host memory on the CPU
+        const MemoryLocation location = isGPU() ? MemoryLocation::Device : MemoryLocation::Host;
+
+        MemoryUsage usage;
+        {
+            std::lock_guard<std::mutex> _guard(mThreadMutex);
+            const auto& device = mDeviceData;
+
+            for (const auto& p : device.dyntables)
+                usage.add(MemoryUsage::getTableCategory(p.first), location, byteSize(p.second.LookupEntries) + byteSize(p.second.Data));
+            for (const auto& p : device.fixtables)
+                usage.add(MemoryUsage::getTableCategory(p.first), location, byteSize(p.second.Data));
+
+            for (const auto& p : device.bvh_ents) {
+                std::visit([&](const auto& bvh) { usage.add(MemoryCategory::BVH, location, byteSize(bvh.Nodes) + byteSize(bvh.Objs)); }, p.second);
+            }
+
+            for (const auto& p : device.images)
+                usage.add(MemoryCategory::Images, location, byteSize(p.second.Data));
+            for (const auto& p : device.packed_images)
+                usage.add(MemoryCategory::Images, location, byteSize(p.second.Data));
+
+            for (const auto& p : device.buffers)
+                usage.add(MemoryCategory::Buffers, location, byteSize(p.second.Data));
+
+            for (const auto& stream : device.primary)
+                usage.add(MemoryCategory::Streams, location, byteSize(stream.Data));
+            for (const auto& stream : device.secondary)
+                usage.add(MemoryCategory::Streams, location, byteSize(stream.Data));
+            usage.add(MemoryCategory::Streams, location, byteSize(device.ray_list));
+            usage.add(MemoryCategory::Streams, MemoryLocation::Host, byteSize(device.temporary_storage_host.ray_begins) + byteSize(device.temporary_storage_host.ray_ends));
+
+            for (const auto& p : device.aovs)
+                usage.add(MemoryCategory::Framebuffer, location, byteSize(p.second));
+            usage.add(MemoryCategory::Framebuffer, location, byteSize(device.film_pixels) + byteSize(device.tonemap_pixels));
+        }
+
+        {
+            std::lock_guard<std::mutex> _guard(mThreadDataMutex);
+            for (const auto& data : mThreadData) {
+                usage.add(MemoryCategory::Streams, MemoryLocation::Host, byteSize(data->cpu_primary.Data) + byteSize(data->cpu_secondary.Data));
+                usage.add(MemoryCategory::Streams, MemoryLocation::Host, byteSize(data->temporary_storage_host.ray_begins) + byteSize(data->temporary_storage_host.ray_ends));
+            }
+        }
+
+        usage.add(MemoryCategory::Framebuffer, MemoryLocation::Host, byteSize(mHostFramebuffer.Data));
+        for (const auto& p : mAOVs)
+            usage.add(MemoryCategory::Framebuffer, MemoryLocation::Host, byteSize(p.second.Data));
+
+        return usage;
+    }
+
     // Access parameters
     int getParameterInt(const char* name, int def, bool global)
     {
@@ -1605,34 +1901,13 @@ public:
 };
 
 const Image Interface::MissingImage = Image::createSolidImage(Vector4f(1, 0, 1, 1));
-static std::unique_ptr<Interface> sInterface;
-
-// --------------------- Math stuff
-[[maybe_unused]] thread_local unsigned int stPrevMathMode = 0;
-static inline void enableMathMode()
-{
-    // Force flush to zero mode for denormals
-#if defined(__x86_64__) || defined(__amd64__) || defined(_M_X64)
-    stPrevMathMode = _mm_getcsr();
-    _mm_setcsr(stPrevMathMode | (_MM_FLUSH_ZERO_ON | _MM_DENORMALS_ZERO_ON));
-#endif
-}
-
-static inline void disableMathMode()
-{
-    // Reset mode
-#if defined(__x86_64__) || defined(__amd64__) || defined(_M_X64)
-    _mm_setcsr(stPrevMathMode);
-#endif
-}
 
 // --------------------- Device
 Device::Device(const Device::SetupSettings& settings)
 {
-    IG_ASSERT(sInterface == nullptr, "Only a single instance allowed!");
-    sInterface = std::make_unique<Interface>(this, settings);
+    mInterface = std::make_unique<Interface>(this, settings);
 
-    IG_LOG(L_INFO) << "Using device " << anydsl_device_name(sInterface->deviceID()) << std::endl;
+    IG_LOG(L_INFO) << "Using device " << anydsl_device_name(mInterface->deviceID()) << std::endl;
 
     if (settings.target.isCPU() && settings.target.vectorWidth() > 1)
         IG_LOG(L_WARNING) << "CPU device with vector width > 1 is experimental and might crash!" << std::endl;
@@ -1640,138 +1915,153 @@ Device::Device(const Device::SetupSettings& settings)
 
 Device::~Device()
 {
-    sInterface.reset();
+    mInterface.reset();
 }
 
-Target Device::target() const { return sInterface->target(); }
+Target Device::target() const { return mInterface->target(); }
 
-size_t Device::framebufferWidth() const { return sInterface->framebufferWidth(); }
+size_t Device::framebufferWidth() const { return mInterface->framebufferWidth(); }
 
-size_t Device::framebufferHeight() const { return sInterface->framebufferHeight(); }
+size_t Device::framebufferHeight() const { return mInterface->framebufferHeight(); }
 
-bool Device::isInteractive() const { return sInterface->isInteractive(); }
+bool Device::isInteractive() const { return mInterface->isInteractive(); }
 
 void Device::assignScene(const SceneSettings& settings)
 {
-    sInterface->assignScene(settings);
+    mInterface->assignScene(settings);
 }
 
-static inline void enterDevice()
+static inline void enterDevice(Interface* instance)
 {
-    enableMathMode();
-    sInterface->registerThread();
-    sInterface->ensureFramebuffer();
+    instance->registerThread();
+    instance->ensureFramebuffer();
 }
 
-static inline void leaveDevice()
+static inline void leaveDevice(Interface* instance)
 {
-    sInterface->unregisterThread();
-    disableMathMode();
+    instance->unregisterThread();
 }
 
 void Device::render(const TechniqueVariantShaderSet& shaderSet, const Device::RenderSettings& settings, ParameterSet* parameterSet)
 {
-    enterDevice();
+    enterDevice(mInterface.get());
 
-    sInterface->updateForRender(shaderSet, settings, parameterSet);
+    mInterface->updateForRender(shaderSet, settings, parameterSet);
 
-    sInterface->ensureFramebuffer();
-    sInterface->runDeviceShader();
+    mInterface->ensureFramebuffer();
+    mInterface->runDeviceShader();
 
-    leaveDevice();
+    leaveDevice(mInterface.get());
 }
 
 void Device::resize(size_t width, size_t height)
 {
-    sInterface->resizeFramebuffer(width, height);
+    mInterface->resizeFramebuffer(width, height);
 }
 
 void Device::releaseAll()
 {
-    sInterface->releaseAll();
+    mInterface->releaseAll();
 }
 
 Device::AOVAccessor Device::getFramebufferForHost(const std::string& name, bool sync)
 {
-    sInterface->registerThread();
-    const auto acc = sInterface->getAOVImageForHost(name, sync);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    const auto acc = mInterface->getAOVImageForHost(name, sync);
+    mInterface->unregisterThread();
     return acc;
 }
 
 Device::AOVAccessor Device::getFramebufferForDevice(const std::string& name, bool sync)
 {
-    sInterface->registerThread();
-    const auto acc = sInterface->getAOVImageForDevice(name, sync);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    const auto acc = mInterface->getAOVImageForDevice(name, sync);
+    mInterface->unregisterThread();
     return acc;
 }
 
 void Device::clearAllFramebuffer()
 {
-    sInterface->registerThread();
-    sInterface->clearAllAOVs();
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    mInterface->clearAllAOVs();
+    mInterface->unregisterThread();
 }
 
 void Device::clearFramebuffer(const std::string& name)
 {
-    sInterface->registerThread();
-    sInterface->clearAOV(name);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    mInterface->clearAOV(name);
+    mInterface->unregisterThread();
 }
 
 void Device::syncFramebufferHostToDevice(const std::string& name)
 {
-    sInterface->registerThread();
-    sInterface->mapAOVToDevice(name, false);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    mInterface->mapAOVToDevice(name, false);
+    mInterface->unregisterThread();
 }
 
 void Device::syncAllFramebufferHostToDevice()
 {
-    sInterface->registerThread();
-    sInterface->mapAllAOVToDevice(false);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    mInterface->mapAllAOVToDevice(false);
+    mInterface->unregisterThread();
 }
 
 size_t Device::getBufferSizeInBytes(const std::string& name)
 {
-    sInterface->registerThread();
-    const size_t size = sInterface->getBufferSize(name);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    const size_t size = mInterface->getBufferSize(name);
+    mInterface->unregisterThread();
     return size;
 }
 
 bool Device::copyBufferToHost(const std::string& name, void* dst, size_t maxSizeByte)
 {
-    sInterface->registerThread();
-    const auto successful = sInterface->copyBufferToHost(name, dst, maxSizeByte);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    const auto successful = mInterface->copyBufferToHost(name, dst, maxSizeByte);
+    mInterface->unregisterThread();
     return successful;
 }
 
 Device::BufferAccessor Device::getBufferForDevice(const std::string& name)
 {
-    sInterface->registerThread();
-    const auto acc = sInterface->getBufferForDevice(name);
-    sInterface->unregisterThread();
+    mInterface->registerThread();
+    const auto acc = mInterface->getBufferForDevice(name);
+    mInterface->unregisterThread();
     return acc;
 }
 
+void Device::copyBufferFromHost(const std::string& name, const void* src, size_t sizeInBytes)
+{
+    mInterface->registerThread();
+    mInterface->copyBufferFromHost(name, src, sizeInBytes);
+    mInterface->unregisterThread();
+}
+
 const Statistics* Device::getStatistics()
 {
-    return sInterface->getFullStats();
+    return mInterface->getFullStats();
+}
+
+std::vector<size_t> Device::getMaterialWorkloads()
+{
+    return mInterface->getMaterialWorkloads();
+}
+
+MemoryUsage Device::getMemoryUsage()
+{
+    return mInterface->getMemoryUsage();
 }
 
 void Device::tonemap(uint32_t* out_pixels, const TonemapSettings& driver_settings)
 {
-    enterDevice();
+    enterDevice(mInterface.get());
 
-    const auto acc   = sInterface->getAOVImageForDevice(driver_settings.AOV);
+    const auto acc   = mInterface->getAOVImageForDevice(driver_settings.AOV);
     float* in_pixels = acc.Data;
 
-    uint32_t* device_out_pixels = sInterface->isGPU() ? sInterface->getTonemapImageGPU() : out_pixels;
+    uint32_t* device_out_pixels = mInterface->isGPU() ? mInterface->getTonemapImageGPU() : out_pixels;
 
     ::TonemapSettings settings;
     settings.method          = (int)driver_settings.Method;
@@ -1780,21 +2070,21 @@ void Device::tonemap(uint32_t* out_pixels, const TonemapSettings& driver_setting
     settings.exposure_factor = driver_settings.ExposureFactor;
     settings.exposure_offset = driver_settings.ExposureOffset;
 
-    sInterface->runTonemapShader(in_pixels, device_out_pixels, settings);
+    mInterface->runTonemapShader(in_pixels, device_out_pixels, settings);
 
-    if (sInterface->isGPU()) {
-        size_t size = sInterface->framebufferSize();
-        anydsl_copy(sInterface->deviceID(), device_out_pixels, 0, 0 /* Host */, out_pixels, 0, sizeof(uint32_t) * size);
+    if (mInterface->isGPU()) {
+        size_t size = mInterface->framebufferSize();
+        anydsl_copy(mInterface->deviceID(), device_out_pixels, 0, 0 /* Host */, out_pixels, 0, sizeof(uint32_t) * size);
     }
 
-    leaveDevice();
+    leaveDevice(mInterface.get());
 }
 
 ImageInfoOutput Device::imageinfo(const ImageInfoSettings& driver_settings)
 {
-    enterDevice();
+    enterDevice(mInterface.get());
 
-    const auto acc   = sInterface->getAOVImageForDevice(driver_settings.AOV);
+    const auto acc   = mInterface->getAOVImageForDevice(driver_settings.AOV);
     float* in_pixels = acc.Data;
 
     ::ImageInfoSettings settings;
@@ -1807,7 +2097,7 @@ ImageInfoOutput Device::imageinfo(const ImageInfoSettings& driver_settings)
     settings.acquire_error_stats = driver_settings.AcquireErrorStats;
     settings.acquire_histogram   = driver_settings.AcquireHistogram;
 
-    ::ImageInfoOutput output = sInterface->runImageinfoShader(in_pixels, settings);
+    ::ImageInfoOutput output = mInterface->runImageinfoShader(in_pixels, settings);
 
     ImageInfoOutput driver_output;
     driver_output.Min      = output.min;
@@ -1820,27 +2110,27 @@ ImageInfoOutput Device::imageinfo(const ImageInfoSettings& driver_settings)
     driver_output.NaNCount = output.nan_counter;
     driver_output.NegCount = output.neg_counter;
 
-    leaveDevice();
+    leaveDevice(mInterface.get());
 
     return driver_output;
 }
 
 void Device::bake(const ShaderOutput<void*>& shader, const std::vector<std::string>* resource_map, float* output)
 {
-    enterDevice();
+    enterDevice(mInterface.get());
 
-    sInterface->runBakeShader(shader, resource_map, output);
+    mInterface->runBakeShader(shader, resource_map, output);
 
-    leaveDevice();
+    leaveDevice(mInterface.get());
 }
 
 void Device::runPass(const ShaderOutput<void*>& shader)
 {
-    enterDevice();
+    enterDevice(mInterface.get());
 
-    sInterface->runPassShader(shader);
+    mInterface->runPassShader(shader);
 
-    leaveDevice();
+    leaveDevice(mInterface.get());
 }
 
 template <typename T>
@@ -1859,52 +2149,52 @@ inline void get_stream(T* dev_stream, DeviceStream& stream, size_t min_component
 
 } // namespace IG
 
-using IG::sInterface;
+using IG::currentInterface;
 extern "C" {
 IG_EXPORT void ignis_get_film_data(float** pixels, int* width, int* height)
 {
-    *pixels = sInterface->getMainFramebuffer();
-    *width  = (int)sInterface->framebufferWidth();
-    *height = (int)sInterface->framebufferHeight();
+    *pixels = currentInterface()->getMainFramebuffer();
+    *width  = (int)currentInterface()->framebufferWidth();
+    *height = (int)currentInterface()->framebufferHeight();
 }
 
 IG_EXPORT void ignis_get_aov_image(const char* name, float** aov_pixels)
 {
-    *aov_pixels = sInterface->getAOVImageForDevice(name).Data;
+    *aov_pixels = currentInterface()->getAOVImageForDevice(name).Data;
 }
 
 IG_EXPORT void ignis_get_work_info(WorkInfo* info)
 {
-    if (sInterface->currentDriverSettings().width > 0 && sInterface->currentDriverSettings().height > 0) {
-        info->width  = (int)sInterface->currentDriverSettings().width;
-        info->height = (int)sInterface->currentDriverSettings().height;
+    if (currentInterface()->currentDriverSettings().width > 0 && currentInterface()->currentDriverSettings().height > 0) {
+        info->width  = (int)currentInterface()->currentDriverSettings().width;
+        info->height = (int)currentInterface()->currentDriverSettings().height;
     } else {
-        info->width  = (int)sInterface->framebufferWidth();
-        info->height = (int)sInterface->framebufferHeight();
+        info->width  = (int)currentInterface()->framebufferWidth();
+        info->height = (int)currentInterface()->framebufferHeight();
     }
 
-    info->advanced_shadows                = sInterface->useAdvancedShadowHandling() && sInterface->currentRenderSettings().info.ShadowHandlingMode == IG::ShadowHandlingMode::Advanced;
-    info->advanced_shadows_with_materials = sInterface->useAdvancedShadowHandling() && sInterface->currentRenderSettings().info.ShadowHandlingMode == IG::ShadowHandlingMode::AdvancedWithMaterials;
-    info->framebuffer_locked              = sInterface->currentRenderSettings().info.LockFramebuffer;
+    info->advanced_shadows                = currentInterface()->useAdvancedShadowHandling() && currentInterface()->currentRenderSettings().info.ShadowHandlingMode == IG::ShadowHandlingMode::Advanced;
+    info->advanced_shadows_with_materials = currentInterface()->useAdvancedShadowHandling() && currentInterface()->currentRenderSettings().info.ShadowHandlingMode == IG::ShadowHandlingMode::AdvancedWithMaterials;
+    info->framebuffer_locked              = currentInterface()->currentRenderSettings().info.LockFramebuffer;
 }
 
 IG_EXPORT void ignis_load_bvh2_ent(const char* prim_type, Node2** nodes, EntityLeaf1** objs)
 {
-    auto& bvh = sInterface->loadEntityBVH<IG::Bvh2Ent, Node2>(prim_type);
+    auto& bvh = currentInterface()->loadEntityBVH<IG::Bvh2Ent, Node2>(prim_type);
     *nodes    = const_cast<Node2*>(bvh.Nodes.ptr());
     *objs     = const_cast<EntityLeaf1*>(bvh.Objs.ptr());
 }
 
 IG_EXPORT void ignis_load_bvh4_ent(const char* prim_type, Node4** nodes, EntityLeaf1** objs)
 {
-    auto& bvh = sInterface->loadEntityBVH<IG::Bvh4Ent, Node4>(prim_type);
+    auto& bvh = currentInterface()->loadEntityBVH<IG::Bvh4Ent, Node4>(prim_type);
     *nodes    = const_cast<Node4*>(bvh.Nodes.ptr());
     *objs     = const_cast<EntityLeaf1*>(bvh.Objs.ptr());
 }
 
 IG_EXPORT void ignis_load_bvh8_ent(const char* prim_type, Node8** nodes, EntityLeaf1** objs)
 {
-    auto& bvh = sInterface->loadEntityBVH<IG::Bvh8Ent, Node8>(prim_type);
+    auto& bvh = currentInterface()->loadEntityBVH<IG::Bvh8Ent, Node8>(prim_type);
     *nodes    = const_cast<Node8*>(bvh.Nodes.ptr());
     *objs     = const_cast<EntityLeaf1*>(bvh.Objs.ptr());
 }
@@ -1922,25 +2212,25 @@ static inline DynTableData assignDynTable(const IG::DynTableProxy& tbl)
 
 IG_EXPORT void ignis_load_dyntable(const char* name, DynTableData* dtb)
 {
-    auto& proxy = sInterface->loadDyntable(name);
+    auto& proxy = currentInterface()->loadDyntable(name);
     *dtb        = assignDynTable(proxy);
 }
 
 IG_EXPORT void ignis_load_fixtable(const char* name, uint8_t** data, int32_t* size)
 {
-    auto& buf = sInterface->loadFixtable(name);
+    auto& buf = currentInterface()->loadFixtable(name);
     *data     = const_cast<uint8_t*>(buf.Data.data());
     *size     = (int32_t)buf.Data.size();
 }
 
 IG_EXPORT void ignis_load_rays(StreamRay** list)
 {
-    *list = const_cast<StreamRay*>(sInterface->loadRayList().data());
+    *list = const_cast<StreamRay*>(currentInterface()->loadRayList().data());
 }
 
 IG_EXPORT void ignis_load_image(const char* file, float** pixels, int32_t* width, int32_t* height, int32_t expected_channels)
 {
-    auto& img = sInterface->loadImage(file, expected_channels);
+    auto& img = currentInterface()->loadImage(file, expected_channels);
     *pixels   = const_cast<float*>(img.Data.data());
     *width    = (int32_t)img.Width;
     *height   = (int32_t)img.Height;
@@ -1948,12 +2238,12 @@ IG_EXPORT void ignis_load_image(const char* file, float** pixels, int32_t* width
 
 IG_EXPORT void ignis_load_image_by_id(int32_t id, float** pixels, int32_t* width, int32_t* height, int32_t expected_channels)
 {
-    return ignis_load_image(sInterface->lookupResource(id).c_str(), pixels, width, height, expected_channels);
+    return ignis_load_image(currentInterface()->lookupResource(id).c_str(), pixels, width, height, expected_channels);
 }
 
 IG_EXPORT void ignis_load_packed_image(const char* file, uint8_t** pixels, int32_t* width, int32_t* height, int32_t expected_channels, bool linear)
 {
-    auto& img = sInterface->loadPackedImage(file, expected_channels, linear);
+    auto& img = currentInterface()->loadPackedImage(file, expected_channels, linear);
     *pixels   = const_cast<uint8_t*>(img.Data.data());
     *width    = (int32_t)img.Width;
     *height   = (int32_t)img.Height;
@@ -1961,192 +2251,223 @@ IG_EXPORT void ignis_load_packed_image(const char* file, uint8_t** pixels, int32
 
 IG_EXPORT void ignis_load_packed_image_by_id(int32_t id, uint8_t** pixels, int32_t* width, int32_t* height, int32_t expected_channels, bool linear)
 {
-    return ignis_load_packed_image(sInterface->lookupResource(id).c_str(), pixels, width, height, expected_channels, linear);
+    return ignis_load_packed_image(currentInterface()->lookupResource(id).c_str(), pixels, width, height, expected_channels, linear);
 }
 
 IG_EXPORT void ignis_load_buffer(const char* file, uint8_t** data, int32_t* size)
 {
-    auto& img = sInterface->loadBuffer(file);
+    auto& img = currentInterface()->loadBuffer(file);
     *data     = const_cast<uint8_t*>(img.Data.data());
     *size     = (int32_t)img.Data.size();
 }
 
 IG_EXPORT void ignis_load_buffer_by_id(int32_t id, uint8_t** data, int32_t* size)
 {
-    return ignis_load_buffer(sInterface->lookupResource(id).c_str(), data, size);
+    return ignis_load_buffer(currentInterface()->lookupResource(id).c_str(), data, size);
 }
 
 IG_EXPORT void ignis_request_buffer(const char* name, uint8_t** data, int size, int flags)
 {
-    auto& buffer = sInterface->requestBuffer(name, size, flags);
+    auto& buffer = currentInterface()->requestBuffer(name, size, flags);
     *data        = const_cast<uint8_t*>(buffer.Data.data());
 }
 
 IG_EXPORT void ignis_dbg_dump_buffer(const char* name, const char* filename)
 {
-    sInterface->dumpBuffer(name, filename);
+    currentInterface()->dumpBuffer(name, filename);
 }
 
 IG_EXPORT void ignis_get_temporary_storage_host(TemporaryStorageHost* temp)
 {
-    const auto& data          = sInterface->getTemporaryStorageHost();
+    const auto& data          = currentInterface()->getTemporaryStorageHost();
     temp->ray_begins          = const_cast<int32_t*>(data.ray_begins.data());
     temp->ray_ends            = const_cast<int32_t*>(data.ray_ends.data());
-    temp->entity_per_material = const_cast<int32_t*>(sInterface->sceneSettings().entity_per_material->data());
+    temp->entity_per_material = const_cast<int32_t*>(currentInterface()->sceneSettings().entity_per_material->data());
 }
 
 IG_EXPORT void ignis_get_primary_stream(int id, PrimaryStream* primary, int size)
 {
-    auto& stream = sInterface->getPrimaryStream(id, size);
+    auto& stream = currentInterface()->getPrimaryStream(id, size);
     IG::get_stream(primary, stream, IG::MinPrimaryStreamSize);
 }
 
 IG_EXPORT void ignis_get_primary_stream_const(int id, PrimaryStream* primary)
 {
-    auto& stream = sInterface->getPrimaryStream(id);
+    auto& stream = currentInterface()->getPrimaryStream(id);
     IG::get_stream(primary, stream, IG::MinPrimaryStreamSize);
 }
 
 IG_EXPORT void ignis_get_secondary_stream(int id, SecondaryStream* secondary, int size)
 {
-    auto& stream = sInterface->getSecondaryStream(id, size);
+    auto& stream = currentInterface()->getSecondaryStream(id, size);
     IG::get_stream(secondary, stream, IG::MinSecondaryStreamSize);
 }
 
 IG_EXPORT void ignis_get_secondary_stream_const(int id, SecondaryStream* secondary)
 {
-    auto& stream = sInterface->getSecondaryStream(id);
+    auto& stream = currentInterface()->getSecondaryStream(id);
     IG::get_stream(secondary, stream, IG::MinSecondaryStreamSize);
 }
 
 IG_EXPORT void ignis_gpu_swap_primary_streams()
 {
-    sInterface->swapGPUPrimaryStreams();
+    currentInterface()->swapGPUPrimaryStreams();
 }
 
 IG_EXPORT void ignis_gpu_swap_secondary_streams()
 {
-    sInterface->swapGPUSecondaryStreams();
+    currentInterface()->swapGPUSecondaryStreams();
+}
+
+IG_EXPORT void* ignis_get_context()
+{
+    return currentInterface();
 }
 
-IG_EXPORT void ignis_register_thread()
+IG_EXPORT void ignis_register_thread(void* context)
 {
-    IG::enableMathMode();
-    sInterface->registerThread();
+    static_cast<IG::Interface*>(context)->registerThread();
 }
 
 IG_EXPORT void ignis_unregister_thread()
 {
-    sInterface->unregisterThread();
-    IG::disableMathMode();
+    currentInterface()->unregisterThread();
+}
+
+IG_EXPORT void ignis_enter_context(void* context)
+{
+    IG::bindThread(static_cast<IG::Interface*>(context));
+}
+
+IG_EXPORT void ignis_leave_context()
+{
+    IG::unbindThread();
+}
+
+IG_EXPORT void ignis_begin_tile(int xmin, int ymin, int xmax, int ymax)
+{
+    currentInterface()->beginTile(xmin, ymin, xmax, ymax);
+}
+
+IG_EXPORT void ignis_end_tile()
+{
+    currentInterface()->endTile();
 }
 
 IG_EXPORT void ignis_handle_traverse_primary(int size)
 {
-    sInterface->runPrimaryTraversalShader(size);
+    currentInterface()->runPrimaryTraversalShader(size);
 }
 
 IG_EXPORT void ignis_handle_traverse_secondary(int size)
 {
-    sInterface->runSecondaryTraversalShader(size);
+    currentInterface()->runSecondaryTraversalShader(size);
 }
 
 IG_EXPORT int ignis_handle_ray_generation(int next_id, int size, int xmin, int ymin, int xmax, int ymax)
 {
-    return sInterface->runRayGenerationShader(next_id, size, xmin, ymin, xmax, ymax);
+    return currentInterface()->runRayGenerationShader(next_id, size, xmin, ymin, xmax, ymax);
 }
 
 IG_EXPORT void ignis_handle_miss_shader(int first, int last)
 {
-    sInterface->runMissShader(first, last);
+    currentInterface()->runMissShader(first, last);
 }
 
 IG_EXPORT void ignis_handle_hit_shader(int entity_id, int first, int last)
 {
-    sInterface->runHitShader(entity_id, first, last);
+    currentInterface()->runHitShader(entity_id, first, last);
 }
 
 IG_EXPORT void ignis_handle_advanced_shadow_shader(int material_id, int first, int last, bool is_hit)
 {
-    if (sInterface->currentRenderSettings().info.ShadowHandlingMode == IG::ShadowHandlingMode::Advanced)
-        sInterface->runAdvancedShadowShader(0 /* Fix to 0 */, first, last, is_hit);
+    if (currentInterface()->currentRenderSettings().info.ShadowHandlingMode == IG::ShadowHandlingMode::Advanced)
+        currentInterface()->runAdvancedShadowShader(0 /* Fix to 0 */, first, last, is_hit);
     else
-        sInterface->runAdvancedShadowShader(material_id, first, last, is_hit);
+        currentInterface()->runAdvancedShadowShader(material_id, first, last, is_hit);
 }
 
 IG_EXPORT void ignis_handle_callback_shader(int type)
 {
-    sInterface->runCallbackShader(type);
+    currentInterface()->runCallbackShader(type);
 }
 
 // Registry stuff
 IG_EXPORT int ignis_get_parameter_i32(const char* name, int32_t def, bool global)
 {
-    return sInterface->getParameterInt(name, def, global);
+    return currentInterface()->getParameterInt(name, def, global);
 }
 
 IG_EXPORT float ignis_get_parameter_f32(const char* name, float def, bool global)
 {
-    return sInterface->getParameterFloat(name, def, global);
+    return currentInterface()->getParameterFloat(name, def, global);
 }
 
 IG_EXPORT void ignis_get_parameter_vector(const char* name, float defX, float defY, float defZ, float* x, float* y, float* z, bool global)
 {
-    sInterface->getParameterVector(name, defX, defY, defZ, *x, *y, *z, global);
+    currentInterface()->getParameterVector(name, defX, defY, defZ, *x, *y, *z, global);
 }
 
 IG_EXPORT void ignis_get_parameter_color(const char* name, float defR, float defG, float defB, float defA, float* r, float* g, float* b, float* a, bool global)
 {
-    sInterface->getParameterColor(name, defR, defG, defB, defA, *r, *g, *b, *a, global);
+    currentInterface()->getParameterColor(name, defR, defG, defB, defA, *r, *g, *b, *a, global);
 }
 
 IG_EXPORT const char* ignis_get_parameter_string(const char* name, const char* def, bool global)
 {
-    return sInterface->getParameterString(name, def, global);
+    return currentInterface()->getParameterString(name, def, global);
 }
 
 IG_EXPORT void ignis_set_parameter_i32(const char* name, int32_t value, bool global)
 {
-    sInterface->setParameterInt(name, value, global);
+    currentInterface()->setParameterInt(name, value, global);
 }
 
 IG_EXPORT void ignis_set_parameter_f32(const char* name, float value, bool global)
 {
-    sInterface->setParameterFloat(name, value, global);
+    currentInterface()->setParameterFloat(name, value, global);
 }
 
 IG_EXPORT void ignis_set_parameter_vector(const char* name, float valueX, float valueY, float valueZ, bool global)
 {
-    sInterface->setParameterVector(name, valueX, valueY, valueZ, global);
+    currentInterface()->setParameterVector(name, valueX, valueY, valueZ, global);
 }
 
 IG_EXPORT void ignis_set_parameter_color(const char* name, float valueR, float valueG, float valueB, float valueA, bool global)
 {
-    sInterface->setParameterColor(name, valueR, valueG, valueB, valueA, global);
+    currentInterface()->setParameterColor(name, valueR, valueG, valueB, valueA, global);
 }
 
 // Stats
 IG_EXPORT void ignis_stats_begin_section(int32_t id)
 {
-    if (!sInterface->hasStatisticAquisition())
+    auto& timeline = IG::Timeline::instance();
+    if (timeline.isEnabled())
+        timeline.begin("section", IG::Statistics::getSectionTypeName((IG::SectionType)id));
+
+    if (!currentInterface()->hasStatisticAquisition())
         return;
 
-    sInterface->getThreadData()->stats.beginSection((IG::SectionType)id);
+    currentInterface()->getThreadData()->stats.beginSection((IG::SectionType)id);
 }
 
 IG_EXPORT void ignis_stats_end_section(int32_t id)
 {
-    if (!sInterface->hasStatisticAquisition())
+    auto& timeline = IG::Timeline::instance();
+    if (timeline.isEnabled())
+        timeline.end("section", IG::Statistics::getSectionTypeName((IG::SectionType)id));
+
+    if (!currentInterface()->hasStatisticAquisition())
         return;
 
-    sInterface->getThreadData()->stats.endSection((IG::SectionType)id);
+    currentInterface()->getThreadData()->stats.endSection((IG::SectionType)id);
 }
 
 IG_EXPORT void ignis_stats_add(int32_t id, int32_t value)
 {
-    if (!sInterface->hasStatisticAquisition())
+    if (!currentInterface()->hasStatisticAquisition())
         return;
 
-    sInterface->getThreadData()->stats.increase((IG::Quantity)id, static_cast<uint64_t>(value));
+    currentInterface()->getThreadData()->stats.increase((IG::Quantity)id, static_cast<uint64_t>(value));
 }
 }
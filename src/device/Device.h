@@ -3,6 +3,7 @@
 #include "device/IRenderDevice.h"
 
 namespace IG {
+class Interface;
 class Device : public IRenderDevice {
 public:
     explicit Device(const SetupSettings& settings);
@@ -29,13 +30,19 @@ public:
     [[nodiscard]] size_t getBufferSizeInBytes(const std::string& name) override;
     [[nodiscard]] bool copyBufferToHost(const std::string& name, void* buffer, size_t maxSizeByte) override;
     [[nodiscard]] BufferAccessor getBufferForDevice(const std::string& name) override;
+    void copyBufferFromHost(const std::string& name, const void* buffer, size_t sizeInBytes) override;
 
     [[nodiscard]] const Statistics* getStatistics() override;
+    [[nodiscard]] std::vector<size_t> getMaterialWorkloads() override;
+    [[nodiscard]] MemoryUsage getMemoryUsage() override;
 
     void tonemap(uint32_t*, const TonemapSettings&) override;
     [[nodiscard]] ImageInfoOutput imageinfo(const ImageInfoSettings&) override;
     void bake(const ShaderOutput<void*>& shader, const std::vector<std::string>* resource_map, float* output) override;
 
     void runPass(const ShaderOutput<void*>& shader) override;
+
+private:
+    std::unique_ptr<Interface> mInterface;
 };
 } // namespace IG
\ No newline at end of file
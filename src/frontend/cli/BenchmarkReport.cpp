@@ -0,0 +1,185 @@
+#include "BenchmarkReport.h"
+#include "Image.h"
+#include "Logger.h"
+#include "config/Build.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
+namespace IG {
+std::optional<double> computeImageError(const Path& image, const Path& reference)
+{
+    Image img, ref;
+    try {
+        img = Image::load(image);
+        ref = Image::load(reference);
+    } catch (const ImageLoadException& e) {
+        IG_LOG(L_ERROR) << e.what() << std::endl;
+        return std::nullopt;
+    }
+
+    if (!img.isValid() || !ref.isValid())
+        return std::nullopt;
+
+    if (img.width != ref.width || img.height != ref.height) {
+        IG_LOG(L_ERROR) << "Reference " << reference << " has size " << ref.width << "x" << ref.height
+                        << " but the result has size " << img.width << "x" << img.height << std::endl;
+        return std::nullopt;
+    }
+
+    // Alpha is ignored and mono images are compared against the first channel only
+    const size_t channels = std::min<size_t>(3, std::min(img.channels, ref.channels));
+    const size_t pixels   = img.width * img.height;
+
+    std::vector<double> errors(pixels * channels);
+    for (size_t i = 0; i < pixels; ++i) {
+        for (size_t c = 0; c < channels; ++c) {
+            const float a = img.pixels[i * img.channels + c];
+            const float b = ref.pixels[i * ref.channels + c];
+
+            const double v = std::isfinite(a) ? a : 0.0;
+            const double e = b != 0 ? (v - b) / b : v; // Relative error, or absolute error for zero reference pixels
+            errors[i * channels + c] = e * e;
+        }
+    }
+
+    if (errors.empty())
+        return 0.0;
+
+    std::vector<double> sorted = errors;
+    const size_t k             = std::min(sorted.size() - 1, (size_t)(0.99 * (sorted.size() - 1)));
+    std::nth_element(sorted.begin(), sorted.begin() + k, sorted.end());
+    const double max = sorted[k];
+
+    double sum = 0;
+    for (double e : errors)
+        sum += std::min(e, max);
+    return sum / errors.size();
+}
+
+bool writeBenchmarkReport(const BenchmarkReport& report, const Path& path)
+{
+    std::ofstream stream(path);
+    if (!stream)
+        return false;
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+    // JSON has no representation for nan and inf, therefore non-finite values are written as null
+    const auto writeNumber = [&](double value) {
+        if (std::isfinite(value))
+            writer.Double(value);
+        else
+            writer.Null();
+    };
+
+    const auto writeOptional = [&](const auto& value) {
+        if (value.has_value())
+            writeNumber((double)value.value());
+        else
+            writer.Null();
+    };
+
+    const auto writeString = [&](const std::string& str) {
+        writer.String(str.c_str(), (rapidjson::SizeType)str.size());
+    };
+
+    std::vector<double> sorted = report.IterationMS;
+    std::sort(sorted.begin(), sorted.end());
+    const double medianMS = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+    const double minMS    = sorted.empty() ? 0 : sorted.front();
+    const double maxMS    = sorted.empty() ? 0 : sorted.back();
+
+    const double renderSec = report.RenderMS / 1000;
+    const double samples   = (double)report.Width * report.Height * report.SPP;
+
+    writer.StartObject();
+    writer.Key("version");
+    writeString(Build::getVersionString());
+    writer.Key("git");
+    writeString(Build::getGitString());
+    writer.Key("scene");
+    writeString(report.Scene.generic_string());
+    writer.Key("target");
+    writeString(report.Target);
+    writer.Key("width");
+    writer.Uint64(report.Width);
+    writer.Key("height");
+    writer.Uint64(report.Height);
+    writer.Key("spi");
+    writer.Uint64(report.SPI);
+    writer.Key("spp");
+    writer.Uint64(report.SPP);
+
+    writer.Key("time");
+    writer.StartObject();
+    writer.Key("loading_ms");
+    writeNumber(report.TotalLoadingMS);
+    writer.Key("loader_ms");
+    writeNumber(report.Loading.LoaderMS);
+    writer.Key("assign_ms");
+    writeNumber(report.Loading.AssignMS);
+    writer.Key("compile_ms");
+    writeNumber(report.Loading.CompileMS);
+    writer.Key("render_ms");
+    writeNumber(report.RenderMS);
+    writer.Key("saving_ms");
+    writeNumber(report.SavingMS);
+    writer.Key("iteration_min_ms");
+    writeNumber(minMS);
+    writer.Key("iteration_median_ms");
+    writeNumber(medianMS);
+    writer.Key("iteration_max_ms");
+    writeNumber(maxMS);
+    writer.Key("iterations_ms");
+    writer.StartArray();
+    for (double ms : report.IterationMS)
+        writeNumber(ms);
+    writer.EndArray();
+    writer.EndObject();
+
+    writer.Key("samples_per_second");
+    writeNumber(renderSec > 0 ? samples / renderSec : 0.0);
+    writer.Key("rays");
+    writeOptional(report.Rays);
+    writer.Key("rays_per_second");
+    if (report.Rays.has_value() && renderSec > 0)
+        writeNumber(report.Rays.value() / renderSec);
+    else
+        writer.Null();
+
+    writer.Key("peak_memory");
+    writer.StartObject();
+    for (size_t i = 0; i < (size_t)MemoryCategory::_COUNT; ++i) {
+        const MemoryCategory category = (MemoryCategory)i;
+        const std::string_view name   = MemoryUsage::getCategoryName(category);
+        writer.Key(name.data(), (rapidjson::SizeType)name.size());
+        writer.StartArray();
+        writer.Uint64(report.PeakMemory.get(category, MemoryLocation::Host));
+        writer.Uint64(report.PeakMemory.get(category, MemoryLocation::Device));
+        writer.EndArray();
+    }
+    writer.Key("host");
+    writer.Uint64(report.PeakMemory.total(MemoryLocation::Host));
+    writer.Key("device");
+    writer.Uint64(report.PeakMemory.total(MemoryLocation::Device));
+    writer.EndObject();
+
+    writer.Key("reference");
+    if (report.Reference.empty())
+        writer.Null();
+    else
+        writeString(report.Reference.generic_string());
+    writer.Key("error");
+    writeOptional(report.Error);
+    writer.EndObject();
+
+    stream << buffer.GetString() << std::endl;
+    return (bool)stream;
+}
+} // namespace IG
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "MemoryUsage.h"
+#include "RuntimeStructs.h"
+
+namespace IG {
+/// Machine readable summary of a single rendering session used for regression benchmarks
+struct BenchmarkReport {
+    Path Scene;
+    std::string Target;
+    size_t Width  = 0;
+    size_t Height = 0;
+    size_t SPI    = 0;
+    size_t SPP    = 0;
+
+    double TotalLoadingMS = 0; // Includes runtime creation
+    LoadTimings Loading;
+    std::vector<double> IterationMS;
+    double RenderMS = 0;
+    double SavingMS = 0;
+
+    std::optional<uint64> Rays; // Only available if statistics were acquired
+    MemoryUsage PeakMemory;
+
+    Path Reference;
+    std::optional<double> Error;
+};
+
+/// Compute the relative mean squared error of the color channels, clamped at the 99th percentile.
+/// Same metric as used in scripts/RunEvaluations.py. Returns nothing if the images could not be loaded or do not match
+[[nodiscard]] std::optional<double> computeImageError(const Path& image, const Path& reference);
+
+bool writeBenchmarkReport(const BenchmarkReport& report, const Path& path);
+} // namespace IG
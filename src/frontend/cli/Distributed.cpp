@@ -0,0 +1,465 @@
+#include "Distributed.h"
+#include "ExternalProcess.h"
+#include "Logger.h"
+#include "ProgramOptions.h"
+#include "Runtime.h"
+#include "RuntimeInfo.h"
+#include "Socket.h"
+#include "device/IRenderDevice.h"
+#include "serialization/VectorSerializer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+namespace IG {
+// The distributed rendering splits the iterations (and therefore the samples) of a frame into disjoint ranges.
+// As the iteration is part of the random seed, each range is decorrelated and the accumulated framebuffers can simply be added.
+enum class MessageType : uint32 {
+    Hello     = 0, // Worker -> Coordinator: Worker is ready
+    Work      = 1, // Coordinator -> Worker: Range of iterations to render
+    Done      = 2, // Coordinator -> Worker: No work left, worker should exit
+    Result    = 3, // Worker -> Coordinator: Checkpoint containing the accumulated range
+    Heartbeat = 4  // Worker -> Coordinator: Worker still makes progress on the current range
+};
+
+constexpr int ConnectRetries       = 60;
+constexpr int ConnectRetryDelayMS  = 1000;
+constexpr int AcceptTimeoutMS      = 500;
+constexpr int HandshakeTimeoutMS   = 10000;
+constexpr size_t ChunksPerWorker   = 4;
+constexpr int HeartbeatIntervalMS  = 5000;
+constexpr int ShutdownGraceMS      = 10000;
+constexpr const char* LocalAddress = "127.0.0.1";
+
+static inline bool sendType(Socket& socket, MessageType type)
+{
+    std::vector<uint8> data;
+    VectorSerializer serializer(data, false);
+    serializer.write((uint32)type);
+    return socket.sendMessage(data);
+}
+
+static inline bool parseAddress(const std::string& address, std::string& host, uint16& port)
+{
+    const size_t pos = address.rfind(':');
+    if (pos == std::string::npos || pos == 0 || pos + 1 >= address.size())
+        return false;
+
+    try {
+        const int value = std::stoi(address.substr(pos + 1));
+        if (value <= 0 || value > 65535)
+            return false;
+        port = (uint16)value;
+    } catch (...) {
+        return false;
+    }
+
+    host = address.substr(0, pos);
+    return true;
+}
+
+bool runDistributedWorker(Runtime& runtime, const std::string& address)
+{
+    std::string host;
+    uint16 port = 0;
+    if (!parseAddress(address, host, port)) {
+        IG_LOG(L_ERROR) << "Invalid coordinator address '" << address << "'. Expected host:port" << std::endl;
+        return false;
+    }
+
+    // The coordinator might not be listening yet
+    Socket socket;
+    for (int i = 0; i < ConnectRetries && !socket.isValid(); ++i) {
+        socket = Socket::connect(host, port);
+        if (!socket.isValid())
+            std::this_thread::sleep_for(std::chrono::milliseconds(ConnectRetryDelayMS));
+    }
+
+    if (!socket.isValid()) {
+        IG_LOG(L_ERROR) << "Could not connect to coordinator " << address << std::endl;
+        return false;
+    }
+
+    if (!sendType(socket, MessageType::Hello)) {
+        IG_LOG(L_ERROR) << "Could not establish communication with coordinator " << address << std::endl;
+        return false;
+    }
+
+    IG_LOG(L_INFO) << "Connected to coordinator " << address << std::endl;
+
+    std::vector<uint8> data;
+    while (true) {
+        if (!socket.receiveMessage(data)) {
+            IG_LOG(L_ERROR) << "Lost connection to coordinator " << address << std::endl;
+            return false;
+        }
+
+        VectorSerializer input(data, true);
+        uint32 type = 0;
+        input.read(type);
+
+        if (type == (uint32)MessageType::Done)
+            break;
+
+        if (type != (uint32)MessageType::Work) {
+            IG_LOG(L_ERROR) << "Received unknown message from coordinator" << std::endl;
+            return false;
+        }
+
+        uint64 start = 0;
+        uint64 count = 0;
+        input.read(start);
+        input.read(count);
+
+        IG_LOG(L_DEBUG) << "Rendering iterations [" << start << ", " << start + count << ")" << std::endl;
+
+        // Heartbeats are only sent after finished iterations, such that a hanging worker is detected by the coordinator
+        auto lastHeartbeat = std::chrono::steady_clock::now();
+
+        runtime.resetToIteration(start);
+        for (uint64 i = 0; i < count; ++i) {
+            runtime.step(true);
+
+            const auto now = std::chrono::steady_clock::now();
+            if (i + 1 < count && now - lastHeartbeat >= std::chrono::milliseconds(HeartbeatIntervalMS)) {
+                lastHeartbeat = now;
+                if (!sendType(socket, MessageType::Heartbeat)) {
+                    IG_LOG(L_ERROR) << "Lost connection to coordinator " << address << std::endl;
+                    return false;
+                }
+            }
+        }
+
+        std::vector<uint8> result;
+        VectorSerializer output(result, false);
+        output.write((uint32)MessageType::Result);
+        runtime.createCheckpoint().write(output);
+
+        if (!socket.sendMessage(result)) {
+            IG_LOG(L_ERROR) << "Lost connection to coordinator " << address << std::endl;
+            return false;
+        }
+    }
+
+    IG_LOG(L_INFO) << "Coordinator finished rendering" << std::endl;
+    return true;
+}
+
+/// Buffers which are not accumulated over iterations are taken from the first result only, similar to the adaptive sampler in Runtime::step
+static inline bool isAccumulatedAOV(const std::string& name)
+{
+    return name != "Denoised" && name != IRenderDevice::CostAOV && !Runtime::isSingleUseAOV(name);
+}
+
+struct WorkItem {
+    size_t Start;
+    size_t Count;
+};
+
+class Coordinator {
+public:
+    inline Coordinator(Runtime& runtime, size_t iterations, size_t chunk, int timeout_ms)
+        : mRuntime(runtime)
+        , mTimeoutMS(timeout_ms)
+        , mRemaining(0)
+        , mConnections(0)
+        , mMergedSamples(0)
+        , mHasMerged(false)
+    {
+        for (size_t start = 0; start < iterations; start += chunk) {
+            mQueue.push_back(WorkItem{ start, std::min(chunk, iterations - start) });
+            ++mRemaining;
+        }
+    }
+
+    inline void serve(Socket socket)
+    {
+        // The hello is sent right after connecting. This is independent of the worker timeout, which might be disabled,
+        // as otherwise an arbitrary client connecting to the port would block the coordinator forever
+        std::vector<uint8> data;
+        if (socket.receiveMessage(data, HandshakeTimeoutMS)) {
+            VectorSerializer input(data, true);
+            uint32 type = 0;
+            input.read(type);
+            if (type == (uint32)MessageType::Hello)
+                work(socket);
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        --mConnections;
+        mCondition.notify_all();
+    }
+
+    inline void connected()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mConnections;
+    }
+
+    inline bool isFinished()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mRemaining == 0;
+    }
+
+    inline size_t connections()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mConnections;
+    }
+
+    inline size_t mergedSamples()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMergedSamples;
+    }
+
+    /// Stop all waiting connections, e.g., after all workers failed
+    inline void abort()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueue.clear();
+        mRemaining = 0;
+        mCondition.notify_all();
+    }
+
+    inline const Checkpoint& result() const { return mMerged; }
+
+private:
+    inline void work(Socket& socket)
+    {
+        std::vector<uint8> data;
+        while (true) {
+            WorkItem item{};
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [&]() { return !mQueue.empty() || mRemaining == 0; });
+                if (mRemaining == 0)
+                    break;
+
+                item = mQueue.front();
+                mQueue.pop_front();
+            }
+
+            {
+                data.clear();
+                VectorSerializer output(data, false);
+                output.write((uint32)MessageType::Work);
+                output.write((uint64)item.Start);
+                output.write((uint64)item.Count);
+            }
+
+            Checkpoint checkpoint;
+            bool success = socket.sendMessage(data);
+            while (success) {
+                // A worker not reporting back within the timeout is considered hung
+                if (!socket.receiveMessage(data, mTimeoutMS)) {
+                    success = false;
+                    break;
+                }
+
+                VectorSerializer input(data, true);
+                uint32 type = 0;
+                input.read(type);
+                if (type == (uint32)MessageType::Heartbeat)
+                    continue;
+
+                success = type == (uint32)MessageType::Result && checkpoint.read(input) && merge(checkpoint, item);
+                break;
+            }
+
+            if (!success) {
+                IG_LOG(L_WARNING) << "Worker failed on iterations [" << item.Start << ", " << item.Start + item.Count << "). Reassigning work" << std::endl;
+                socket.close(); // The worker will notice and stop, if it is still alive
+                std::lock_guard<std::mutex> lock(mMutex);
+                mQueue.push_back(item);
+                mCondition.notify_all();
+                return;
+            }
+        }
+
+        sendType(socket, MessageType::Done);
+    }
+
+    inline bool isCompatible(const Checkpoint& checkpoint) const
+    {
+        return checkpoint.Width == mRuntime.framebufferWidth()
+               && checkpoint.Height == mRuntime.framebufferHeight()
+               && checkpoint.Technique == mRuntime.technique()
+               && checkpoint.Camera == mRuntime.camera()
+               && checkpoint.Buffers.contains(std::string{});
+    }
+
+    inline bool merge(const Checkpoint& checkpoint, const WorkItem& item)
+    {
+        if (!isCompatible(checkpoint)) {
+            IG_LOG(L_ERROR) << "Worker rendered an incompatible scene. Make sure all workers use the same scene and options" << std::endl;
+            return false;
+        }
+
+        if (checkpoint.Seed != mRuntime.seed())
+            IG_LOG(L_WARNING) << "Worker uses seed " << checkpoint.Seed << " instead of " << mRuntime.seed() << std::endl;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mHasMerged) {
+            mMerged           = checkpoint;
+            mMerged.Iteration = item.Count;
+            mMerged.Frame     = mRuntime.currentFrameCount();
+            mMerged.Seed      = mRuntime.seed();
+            mHasMerged        = true;
+        } else {
+            for (const auto& [name, buffer] : checkpoint.Buffers) {
+                auto it = mMerged.Buffers.find(name);
+                if (it == mMerged.Buffers.end()) {
+                    mMerged.Buffers[name] = buffer;
+                } else if (isAccumulatedAOV(name)) {
+                    // Accumulated buffers are not normalized, therefore adding them weights each range by its number of iterations
+                    std::vector<float>& dst = it->second;
+                    for (size_t i = 0; i < dst.size(); ++i)
+                        dst[i] += buffer[i];
+                }
+            }
+            mMerged.Iteration += item.Count;
+            mMerged.SampleCount += checkpoint.SampleCount;
+        }
+
+        mMergedSamples = mMerged.SampleCount;
+        --mRemaining;
+        mCondition.notify_all();
+        return true;
+    }
+
+    Runtime& mRuntime;
+    const int mTimeoutMS;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::deque<WorkItem> mQueue;
+    size_t mRemaining;
+    size_t mConnections;
+    size_t mMergedSamples;
+
+    Checkpoint mMerged;
+    bool mHasMerged;
+};
+
+/// Forward all arguments to the local workers except the coordinator specific ones
+static std::vector<std::string> workerParameters(int argc, char** argv, uint16 port)
+{
+    static const std::vector<std::string> Skip = { "--workers", "--port", "--chunk-spp", "--worker-timeout" };
+
+    std::vector<std::string> parameters;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+
+        bool skip = false;
+        for (const auto& option : Skip) {
+            if (arg == option) {
+                skip = true;
+                ++i; // Skip value as well
+                break;
+            } else if (arg.starts_with(option + "=")) {
+                skip = true;
+                break;
+            }
+        }
+
+        if (!skip)
+            parameters.push_back(arg);
+    }
+
+    parameters.emplace_back("--connect");
+    parameters.emplace_back(std::string(LocalAddress) + ":" + std::to_string(port));
+    return parameters;
+}
+
+bool runDistributedCoordinator(Runtime& runtime, const ProgramOptions& cmd, size_t iterations, int argc, char** argv,
+                               const std::function<void(size_t)>& progress)
+{
+    Socket listener = Socket::listen(cmd.DistributedPort.value_or(0));
+    if (!listener.isValid())
+        return false;
+
+    const uint16 port = listener.port();
+    IG_LOG(L_INFO) << "Waiting for workers on port " << port << std::endl;
+
+    const size_t spi     = runtime.samplesPerIteration();
+    const size_t workers = std::max<size_t>(1, cmd.DistributedWorkers);
+    const size_t chunk   = cmd.DistributedChunkSPP > 0
+                               ? std::max<size_t>(1, cmd.DistributedChunkSPP / spi)
+                               : std::max<size_t>(1, iterations / (workers * ChunksPerWorker));
+
+    const int timeout_ms = cmd.DistributedTimeout == 0 ? -1 : (int)std::min<size_t>(cmd.DistributedTimeout * 1000, std::numeric_limits<int>::max());
+    Coordinator coordinator(runtime, iterations, chunk, timeout_ms);
+
+    // Launch local workers
+    std::vector<std::unique_ptr<ExternalProcess>> processes;
+    if (cmd.DistributedWorkers > 0) {
+        const Path logDir = std::filesystem::temp_directory_path() / "Ignis";
+        std::filesystem::create_directories(logDir);
+
+        const auto parameters = workerParameters(argc, argv, port);
+        for (size_t i = 0; i < cmd.DistributedWorkers; ++i) {
+            const Path logFile = logDir / ("worker_" + std::to_string(port) + "_" + std::to_string(i) + ".log");
+            auto process       = std::make_unique<ExternalProcess>("worker_" + std::to_string(i), RuntimeInfo::executablePath(), parameters, logFile);
+            if (!process->start()) {
+                IG_LOG(L_ERROR) << "Could not start local worker " << i << std::endl;
+                continue;
+            }
+            processes.emplace_back(std::move(process));
+        }
+    }
+
+    const auto anyProcessRunning = [&]() {
+        for (const auto& process : processes) {
+            if (process->isRunning())
+                return true;
+        }
+        return false;
+    };
+
+    std::vector<std::thread> threads;
+    bool failed = false;
+    while (!coordinator.isFinished()) {
+        Socket connection = listener.accept(AcceptTimeoutMS);
+        if (connection.isValid()) {
+            coordinator.connected();
+            threads.emplace_back([&coordinator, socket = std::move(connection)]() mutable { coordinator.serve(std::move(socket)); });
+        }
+
+        progress(coordinator.mergedSamples());
+
+        // Without remote workers, there is nobody left to take over the work
+        if (!cmd.DistributedPort.has_value() && coordinator.connections() == 0 && !anyProcessRunning() && !coordinator.isFinished()) {
+            IG_LOG(L_ERROR) << "All workers failed. See the logs in " << (std::filesystem::temp_directory_path() / "Ignis") << std::endl;
+            coordinator.abort();
+            failed = true;
+        }
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    // Local workers which timed out might still hang
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ShutdownGraceMS);
+    for (auto& process : processes) {
+        while (process->isRunning() && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(AcceptTimeoutMS / 10));
+
+        if (process->isRunning()) {
+            IG_LOG(L_WARNING) << "Terminating unresponsive local worker" << std::endl;
+            process->terminate();
+        }
+        process->waitForFinish();
+    }
+
+    if (failed)
+        return false;
+
+    progress(coordinator.mergedSamples());
+    return runtime.restoreCheckpoint(coordinator.result());
+}
+} // namespace IG
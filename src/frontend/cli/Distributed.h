@@ -0,0 +1,18 @@
+#pragma once
+
+#include "IG_Config.h"
+
+#include <functional>
+
+namespace IG {
+class Runtime;
+class ProgramOptions;
+
+/// Render the work items given by the coordinator at the given address (host:port) until the coordinator signals the end
+bool runDistributedWorker(Runtime& runtime, const std::string& address);
+
+/// Split the given iterations into work items rendered by local and remote worker processes.
+/// The partial results are merged and restored into the framebuffer of the given runtime. Work of failed workers is reassigned
+bool runDistributedCoordinator(Runtime& runtime, const ProgramOptions& cmd, size_t iterations, int argc, char** argv,
+                               const std::function<void(size_t)>& progress);
+} // namespace IG
@@ -0,0 +1,277 @@
+#include "Socket.h"
+#include "Logger.h"
+
+#if defined(IG_OS_LINUX) || defined(IG_OS_APPLE)
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using SocketHandle = int;
+#define IG_CLOSE_SOCKET ::close
+#define IG_POLL ::poll
+#ifdef IG_OS_APPLE
+#define IG_SEND_FLAGS 0 // MSG_NOSIGNAL is not available, SO_NOSIGPIPE is set on the socket instead
+#else
+#define IG_SEND_FLAGS MSG_NOSIGNAL
+#endif
+
+#elif defined(IG_OS_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#include <WinSock2.h>
+#include <WS2tcpip.h>
+
+using SocketHandle = SOCKET;
+#define IG_CLOSE_SOCKET ::closesocket
+#define IG_POLL ::WSAPoll
+#define IG_SEND_FLAGS 0
+
+#else
+#error Socket implementation missing
+#endif
+
+namespace IG {
+#ifdef IG_OS_WINDOWS
+struct WinSockContext {
+    bool Valid;
+    inline WinSockContext()
+    {
+        WSADATA data;
+        Valid = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        if (!Valid)
+            IG_LOG(L_ERROR) << "Could not initialize WinSock" << std::endl;
+    }
+    inline ~WinSockContext()
+    {
+        if (Valid)
+            WSACleanup();
+    }
+};
+
+static inline void ensureInit()
+{
+    static WinSockContext context;
+}
+#else
+static inline void ensureInit() {}
+#endif
+
+static inline SocketHandle native(intptr_t handle) { return (SocketHandle)handle; }
+
+// Setup a connected socket
+static inline void configure(SocketHandle handle)
+{
+    // Messages are large and exchanged in a request-response pattern, therefore disable Nagle's algorithm
+    int nodelay = 1;
+    ::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, (const char*)&nodelay, sizeof(nodelay));
+
+#ifdef IG_OS_APPLE
+    // A closed connection has to be reported as error instead of terminating the process
+    int nosigpipe = 1;
+    ::setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &nosigpipe, sizeof(nosigpipe));
+#endif
+}
+
+// Messages are prefixed by their size. This limits the damage of a corrupted stream
+constexpr uint64 MaxMessageSize = 16ull * 1024 * 1024 * 1024;
+
+Socket::Socket()
+    : mHandle(InvalidHandle)
+{
+}
+
+Socket::Socket(intptr_t handle)
+    : mHandle(handle)
+{
+}
+
+Socket::~Socket()
+{
+    close();
+}
+
+Socket::Socket(Socket&& other)
+    : mHandle(other.mHandle)
+{
+    other.mHandle = InvalidHandle;
+}
+
+Socket& Socket::operator=(Socket&& other)
+{
+    if (this != &other) {
+        close();
+        mHandle       = other.mHandle;
+        other.mHandle = InvalidHandle;
+    }
+    return *this;
+}
+
+void Socket::close()
+{
+    if (mHandle != InvalidHandle) {
+        IG_CLOSE_SOCKET(native(mHandle));
+        mHandle = InvalidHandle;
+    }
+}
+
+Socket Socket::listen(uint16 port)
+{
+    ensureInit();
+
+    SocketHandle handle = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (handle == native(InvalidHandle)) {
+        IG_LOG(L_ERROR) << "Could not create socket" << std::endl;
+        return Socket();
+    }
+
+    Socket socket((intptr_t)handle);
+
+    int reuse = 1;
+    ::setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(port);
+
+    if (::bind(handle, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+        IG_LOG(L_ERROR) << "Could not bind socket to port " << port << std::endl;
+        return Socket();
+    }
+
+    if (::listen(handle, SOMAXCONN) != 0) {
+        IG_LOG(L_ERROR) << "Could not listen on port " << port << std::endl;
+        return Socket();
+    }
+
+    return socket;
+}
+
+Socket Socket::connect(const std::string& host, uint16 port)
+{
+    ensureInit();
+
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+
+    addrinfo* result        = nullptr;
+    const std::string sport = std::to_string(port);
+    if (::getaddrinfo(host.c_str(), sport.c_str(), &hints, &result) != 0) {
+        IG_LOG(L_ERROR) << "Could not resolve host " << host << std::endl;
+        return Socket();
+    }
+
+    Socket socket;
+    for (addrinfo* it = result; it; it = it->ai_next) {
+        SocketHandle handle = ::socket(it->ai_family, it->ai_socktype, it->ai_protocol);
+        if (handle == native(InvalidHandle))
+            continue;
+
+        if (::connect(handle, it->ai_addr, (int)it->ai_addrlen) == 0) {
+            socket = Socket((intptr_t)handle);
+            break;
+        }
+
+        IG_CLOSE_SOCKET(handle);
+    }
+    ::freeaddrinfo(result);
+
+    if (socket.isValid())
+        configure(native(socket.mHandle));
+
+    return socket;
+}
+
+Socket Socket::accept(int timeout_ms)
+{
+    if (!isValid())
+        return Socket();
+
+    pollfd fd{};
+    fd.fd     = native(mHandle);
+    fd.events = POLLIN;
+    if (IG_POLL(&fd, 1, timeout_ms) <= 0 || !(fd.revents & POLLIN))
+        return Socket();
+
+    SocketHandle handle = ::accept(native(mHandle), nullptr, nullptr);
+    if (handle == native(InvalidHandle))
+        return Socket();
+
+    configure(handle);
+    return Socket((intptr_t)handle);
+}
+
+uint16 Socket::port() const
+{
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    if (!isValid() || ::getsockname(native(mHandle), (sockaddr*)&addr, &len) != 0)
+        return 0;
+    return ntohs(addr.sin_port);
+}
+
+bool Socket::sendRaw(const uint8* data, size_t size)
+{
+    size_t total = 0;
+    while (total < size) {
+        const int chunk  = (int)std::min<size_t>(size - total, 1 << 30);
+        const auto count = ::send(native(mHandle), (const char*)data + total, chunk, IG_SEND_FLAGS);
+        if (count <= 0)
+            return false;
+        total += (size_t)count;
+    }
+    return true;
+}
+
+bool Socket::receiveRaw(uint8* data, size_t size, int timeout_ms)
+{
+    size_t total = 0;
+    while (total < size) {
+        if (timeout_ms >= 0) {
+            pollfd fd{};
+            fd.fd     = native(mHandle);
+            fd.events = POLLIN;
+            if (IG_POLL(&fd, 1, timeout_ms) <= 0)
+                return false; // Timeout or error
+        }
+
+        const int chunk  = (int)std::min<size_t>(size - total, 1 << 30);
+        const auto count = ::recv(native(mHandle), (char*)data + total, chunk, 0);
+        if (count <= 0)
+            return false;
+        total += (size_t)count;
+    }
+    return true;
+}
+
+bool Socket::sendMessage(const std::vector<uint8>& data)
+{
+    if (!isValid())
+        return false;
+
+    const uint64 size = data.size();
+    return sendRaw(reinterpret_cast<const uint8*>(&size), sizeof(size)) && sendRaw(data.data(), data.size());
+}
+
+bool Socket::receiveMessage(std::vector<uint8>& data, int timeout_ms)
+{
+    if (!isValid())
+        return false;
+
+    uint64 size = 0;
+    if (!receiveRaw(reinterpret_cast<uint8*>(&size), sizeof(size), timeout_ms))
+        return false;
+
+    if (size > MaxMessageSize) {
+        IG_LOG(L_ERROR) << "Received message with invalid size " << size << std::endl;
+        return false;
+    }
+
+    data.resize(size);
+    return receiveRaw(data.data(), data.size(), timeout_ms);
+}
+} // namespace IG
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "IG_Config.h"
+
+namespace IG {
+/// Minimal blocking TCP socket exchanging length-prefixed messages
+class Socket {
+public:
+    Socket();
+    ~Socket();
+
+    Socket(const Socket&)            = delete;
+    Socket& operator=(const Socket&) = delete;
+    Socket(Socket&& other);
+    Socket& operator=(Socket&& other);
+
+    /// Listen on all interfaces at the given port. Port 0 lets the system choose a free port
+    [[nodiscard]] static Socket listen(uint16 port);
+    /// Connect to the given host and port
+    [[nodiscard]] static Socket connect(const std::string& host, uint16 port);
+
+    /// Wait for a new connection. Returns an invalid socket if no connection was established within the timeout
+    [[nodiscard]] Socket accept(int timeout_ms);
+
+    /// The local port the socket is bound to
+    [[nodiscard]] uint16 port() const;
+    [[nodiscard]] inline bool isValid() const { return mHandle != InvalidHandle; }
+
+    bool sendMessage(const std::vector<uint8>& data);
+    /// Receive a full message. Fails if no data arrived within the timeout. A negative timeout waits forever
+    bool receiveMessage(std::vector<uint8>& data, int timeout_ms = -1);
+
+    void close();
+
+private:
+    static constexpr intptr_t InvalidHandle = -1;
+
+    explicit Socket(intptr_t handle);
+
+    bool sendRaw(const uint8* data, size_t size);
+    bool receiveRaw(uint8* data, size_t size, int timeout_ms);
+
+    intptr_t mHandle;
+};
+} // namespace IG
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "IG_Config.h"
+#include "Logger.h"
 
 #include <iomanip>
 
@@ -53,6 +54,7 @@ public:
 
     inline void end()
     {
+        IG_LOGGER.flush(); // Pending log entries should not overwrite the progress
         if (mBeautify && !mFirstTime)
             std::cout << REMOVE_LAST_LINE;
         std::cout << "Done" << std::setw(120) << " " << std::endl;
@@ -74,6 +76,8 @@ public:
         const auto fullDurationAfterFirst = std::chrono::duration_cast<std::chrono::seconds>(now - mStartAfterFirst);
 
         if ((uint64)duration.count() >= mUpdateCycleSeconds) {
+            IG_LOGGER.flush(); // Pending log entries should not overwrite the progress
+
             double progress = 0;
             if (mTargetSamples != 0)
                 progress = currentSamples / double(mTargetSamples);
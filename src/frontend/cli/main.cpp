@@ -1,4 +1,6 @@
+#include "BenchmarkReport.h"
 #include "CameraProxy.h"
+#include "Distributed.h"
 #include "Logger.h"
 #include "ProgramOptions.h"
 #include "Runtime.h"
@@ -6,6 +8,9 @@
 #include "Timer.h"
 #include "config/Build.h"
 
+#include <fstream>
+#include <future>
+
 using namespace IG;
 
 struct SectionTimer {
@@ -68,16 +73,29 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
-    if (cmd.RenderTime.value_or(0) <= 0 && cmd.SPP.value_or(0) <= 0) {
-        IG_LOG(L_ERROR) << "No valid spp count or render time given" << std::endl;
+    if (!cmd.isDistributedWorker() && cmd.RenderTime.value_or(0) <= 0 && cmd.SPP.value_or(0) <= 0 && !cmd.TargetError.has_value()) {
+        IG_LOG(L_ERROR) << "No valid spp count, render time or target error given" << std::endl;
         return EXIT_FAILURE;
     }
 
-    if (cmd.Output.empty()) {
+    if (!cmd.isDistributedWorker() && cmd.Output.empty()) {
         IG_LOG(L_ERROR) << "No output file given" << std::endl;
         return EXIT_FAILURE;
     }
 
+    if (cmd.isDistributedCoordinator()) {
+        if (cmd.SPP.value_or(0) <= 0) {
+            IG_LOG(L_ERROR) << "Distributed rendering requires a valid spp count" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (cmd.TargetError.has_value() || !cmd.Resume.empty()) {
+            IG_LOG(L_ERROR) << "Distributed rendering does not support adaptive sampling or resuming from a checkpoint" << std::endl;
+            return EXIT_FAILURE;
+        }
+        if (cmd.Denoise)
+            IG_LOG(L_WARNING) << "Denoising is not applied in distributed rendering" << std::endl;
+    }
+
     SectionTimer timer_all;
     SectionTimer timer_loading;
     timer_all.start();
@@ -105,45 +123,108 @@ int main(int argc, char** argv)
     orientation.Up   = cmd.UpVector().value_or(orientation.Up);
     runtime->setCameraOrientation(orientation);
 
+    if (cmd.isDistributedWorker())
+        return runDistributedWorker(*runtime, cmd.DistributedConnect) ? EXIT_SUCCESS : EXIT_FAILURE;
+
     const size_t SPI          = runtime->samplesPerIteration();
     const size_t desired_iter = static_cast<size_t>(std::ceil(cmd.SPP.value_or(0) / (float)SPI));
 
     if (cmd.SPP.has_value() && (cmd.SPP.value() % SPI) != 0)
         IG_LOG(L_WARNING) << "Given spp " << cmd.SPP.value() << " is not a multiple of the spi " << SPI << ". Using spp " << desired_iter * SPI << " instead" << std::endl;
 
+    if (!cmd.Resume.empty()) {
+        Checkpoint checkpoint;
+        if (!checkpoint.load(cmd.Resume) || !runtime->restoreCheckpoint(checkpoint)) {
+            IG_LOG(L_ERROR) << "Could not resume from checkpoint " << cmd.Resume << std::endl;
+            return EXIT_FAILURE;
+        }
+        IG_LOG(L_INFO) << "Resuming from checkpoint " << cmd.Resume << " with " << runtime->currentSampleCount() << " samples" << std::endl;
+    }
+
     StatusObserver observer(!cmd.NoColor, 2, desired_iter * SPI /* Approx */, cmd.RenderTime.value_or(0));
     observer.begin();
 
     IG_LOG(L_INFO) << "Started rendering..." << std::endl;
 
     std::vector<double> samples_sec;
+    std::vector<double> iteration_ms;
+
+    // Checkpoints are captured synchronously but written in the background. A checkpoint is skipped if the previous one is still being written
+    std::future<bool> checkpoint_writer;
+    auto last_checkpoint = std::chrono::high_resolution_clock::now();
 
     SectionTimer timer_render;
-    while (true) {
+    if (cmd.isDistributedCoordinator()) {
+        timer_render.start();
+        const bool success = runDistributedCoordinator(*runtime, cmd, desired_iter, argc, argv, [&](size_t samples) {
+            if (!cmd.NoProgress)
+                observer.update(samples);
+        });
+        timer_render.stop();
+
+        if (!success) {
+            IG_LOG(L_ERROR) << "Distributed rendering failed" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    while (!cmd.isDistributedCoordinator() && (desired_iter == 0 || runtime->currentIterationCount() < desired_iter)) {
         if (!cmd.NoProgress)
             observer.update(runtime->currentSampleCount());
 
         auto ticks = std::chrono::high_resolution_clock::now();
 
         timer_render.start();
-        runtime->step(samples_sec.size() != desired_iter - 1);
+        runtime->step(runtime->currentIterationCount() + 1 != desired_iter);
         timer_render.stop();
 
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - ticks).count();
+        const double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - ticks).count();
 
-        samples_sec.emplace_back(1000.0 * double(SPI * runtime->framebufferWidth() * runtime->framebufferHeight()) / double(elapsed_ms));
-        if (desired_iter > 0 && samples_sec.size() == desired_iter)
+        iteration_ms.emplace_back(elapsed_ms);
+        samples_sec.emplace_back(1000.0 * double(SPI * runtime->framebufferWidth() * runtime->framebufferHeight()) / elapsed_ms);
+        if (cmd.RenderTime.has_value() && timer_render.duration_ms / 1000 > cmd.RenderTime.value())
             break;
-        else if (cmd.RenderTime.has_value() && timer_render.duration_ms / 1000 > cmd.RenderTime.value())
+        else if (runtime->isConverged()) {
+            IG_LOG(L_INFO) << "All pixels reached the target error after " << runtime->currentIterationCount() << " iterations" << std::endl;
+            if (cmd.Denoise) {
+                // The denoiser only runs on the last iteration. As all pixels are converged, this iteration does not trace any rays
+                runtime->step(false);
+            }
             break;
+        }
+
+        if (cmd.CheckpointInterval.has_value()) {
+            const auto now = std::chrono::high_resolution_clock::now();
+            if (now - last_checkpoint >= std::chrono::seconds(cmd.CheckpointInterval.value())
+                && (!checkpoint_writer.valid() || checkpoint_writer.wait_for(std::chrono::seconds(0)) == std::future_status::ready)) {
+                last_checkpoint   = now;
+                checkpoint_writer = std::async(std::launch::async, [checkpoint = runtime->createCheckpoint(), path = cmd.Checkpoint]() { return checkpoint.save(path); });
+            }
+        }
     }
 
     if (!cmd.NoProgress)
         observer.end();
 
+    // An asynchronous denoiser might still be busy or only has a result of an earlier iteration
+    if (cmd.Denoise)
+        runtime->finishDenoiser();
+
+    if (checkpoint_writer.valid())
+        checkpoint_writer.wait();
+
+    // Write a final checkpoint, such that the rendering can be continued with a higher sample count
+    if (!cmd.Checkpoint.empty()) {
+        if (runtime->createCheckpoint().save(cmd.Checkpoint))
+            IG_LOG(L_INFO) << "Checkpoint saved to " << cmd.Checkpoint << std::endl;
+        else
+            IG_LOG(L_ERROR) << "Failed to save checkpoint " << cmd.Checkpoint << std::endl;
+    }
+
     SectionTimer timer_saving;
     timer_saving.start();
-    if (!runtime->saveFramebuffer(cmd.Output))
+    const bool saved = runtime->saveFramebuffer(cmd.Output);
+    if (!saved)
         IG_LOG(L_ERROR) << "Failed to save EXR file " << cmd.Output << std::endl;
     else
         IG_LOG(L_INFO) << "Result saved to " << cmd.Output << std::endl;
@@ -151,17 +232,61 @@ int main(int argc, char** argv)
 
     timer_all.stop();
 
+    std::optional<double> error;
+    if (saved && !cmd.Reference.empty()) {
+        error = computeImageError(cmd.Output, cmd.Reference);
+        if (error.has_value())
+            IG_LOG(L_INFO) << "Error against reference: " << error.value() << std::endl;
+        else
+            IG_LOG(L_ERROR) << "Could not compare result against reference " << cmd.Reference << std::endl;
+    }
+
+    if (!cmd.BenchmarkFile.empty()) {
+        BenchmarkReport report;
+        report.Scene          = cmd.InputScene;
+        report.Target         = runtime->target().toString();
+        report.Width          = runtime->framebufferWidth();
+        report.Height         = runtime->framebufferHeight();
+        report.SPI            = SPI;
+        report.SPP            = runtime->currentSampleCount();
+        report.TotalLoadingMS = (double)timer_loading.duration_ms;
+        report.Loading        = runtime->loadTimings();
+        report.IterationMS    = iteration_ms;
+        report.RenderMS       = (double)timer_render.duration_ms;
+        report.SavingMS       = (double)timer_saving.duration_ms;
+        report.PeakMemory     = runtime->peakMemoryUsage();
+        report.Reference      = cmd.Reference;
+        report.Error          = error;
+
+        if (auto stats = runtime->statistics())
+            report.Rays = stats->quantity(Quantity::CameraRayCount) + stats->quantity(Quantity::ShadowRayCount) + stats->quantity(Quantity::BounceRayCount);
+
+        if (writeBenchmarkReport(report, cmd.BenchmarkFile))
+            IG_LOG(L_INFO) << "Benchmark report saved to " << cmd.BenchmarkFile << std::endl;
+        else
+            IG_LOG(L_ERROR) << "Could not write benchmark report to " << cmd.BenchmarkFile << std::endl;
+    }
+
     auto stats = runtime->statistics();
     if (stats) {
         IG_LOG(L_INFO)
-            << stats->dump(timer_all.duration_ms, runtime->currentIterationCount(), cmd.AcquireFullStats)
+            << stats->dump(timer_all.duration_ms, runtime->currentIterationCount(), cmd.AcquireFullStats, &runtime->statisticNames())
             << "  Iterations: " << runtime->currentIterationCount() << std::endl
             << "  SPP: " << runtime->currentSampleCount() << std::endl
             << "  SPI: " << SPI << std::endl
             << "  Time: " << beautiful_time(timer_all.duration_ms) << std::endl
             << "    Loading> " << beautiful_time(timer_loading.duration_ms) << std::endl
             << "    Render>  " << beautiful_time(timer_render.duration_ms) << std::endl
-            << "    Saving>  " << beautiful_time(timer_saving.duration_ms) << std::endl;
+            << "    Saving>  " << beautiful_time(timer_saving.duration_ms) << std::endl
+            << runtime->memoryUsage().dump(&runtime->peakMemoryUsage());
+
+        if (!cmd.StatsFile.empty()) {
+            std::ofstream stream(cmd.StatsFile);
+            if (stream)
+                stream << stats->dumpJSON(timer_all.duration_ms, runtime->currentIterationCount(), &runtime->statisticNames()) << std::endl;
+            else
+                IG_LOG(L_ERROR) << "Could not write stats to " << cmd.StatsFile << std::endl;
+        }
     }
 
     runtime.reset();
@@ -7,7 +7,7 @@
 namespace IG {
 static const std::map<std::string, LogLevel> LogLevelMap{ { "fatal", L_FATAL }, { "error", L_ERROR }, { "warning", L_WARNING }, { "info", L_INFO }, { "debug", L_DEBUG } };
 static const std::map<std::string, SPPMode> SPPModeMap{ { "fixed", SPPMode::Fixed }, { "capped", SPPMode::Capped }, { "continuous", SPPMode::Continuous } };
-static const std::map<std::string, RuntimeOptions::SpecializationMode> SpecializationModeMap{ { "default", RuntimeOptions::SpecializationMode::Default }, { "force", RuntimeOptions::SpecializationMode::Force }, { "disable", RuntimeOptions::SpecializationMode::Disable } };
+static const std::map<std::string, RuntimeOptions::SpecializationMode> SpecializationModeMap{ { "default", RuntimeOptions::SpecializationMode::Default }, { "force", RuntimeOptions::SpecializationMode::Force }, { "disable", RuntimeOptions::SpecializationMode::Disable }, { "profile", RuntimeOptions::SpecializationMode::Profile } };
 
 static void handleListPExprVariables()
 {
@@ -99,13 +99,32 @@ ProgramOptions::ProgramOptions(int argc, char** argv, ApplicationType type, cons
             "--realtime", [&]() { this->SPPMode = SPPMode::Continuous; SPI = 1; SPP = 1; },
             "Same as setting SPPMode='Continuous', SPI=1 and SPP=1 to emulate realtime rendering");
     }
-    if (type == ApplicationType::CLI)
+    if (type == ApplicationType::CLI) {
         app.add_option("--time", RenderTime, "Instead of spp, specify the maximum time in seconds to render")->excludes("--spp");
+        app.add_option("--target-error", TargetError, "Enable adaptive sampling and stop rendering if all pixels reached the given relative error. The spp count or render time is used as an upper limit if given");
+        app.add_option("--adaptive-tile-size", AdaptiveTileSize, "Size of the tiles used to decide convergence in adaptive sampling. Set to 1 to decide per pixel")->default_val(AdaptiveTileSize);
+        app.add_option("--adaptive-min-iterations", AdaptiveMinIterations, "Minimum number of iterations before a tile can converge in adaptive sampling")->default_val(AdaptiveMinIterations);
+        app.add_option("--checkpoint", Checkpoint, "Path of the checkpoint file periodically written while rendering. Defaults to the output path with the extension .ckpt");
+        app.add_option("--checkpoint-interval", CheckpointInterval, "Write a checkpoint of the accumulated framebuffer every given seconds. The checkpoint is written in the background");
+        app.add_option("--resume", Resume, "Resume rendering from the given checkpoint. The spp count includes the already rendered samples")->check(CLI::ExistingFile);
+
+        app.add_option("--workers", DistributedWorkers, "Distribute the rendering to the given number of local worker processes. The spp count is split into chunks which are merged afterwards");
+        app.add_option("--port", DistributedPort, "Accept workers on the given port to distribute the rendering to other machines. Workers are started with --connect");
+        app.add_option("--connect", DistributedConnect, "Run as a worker for the coordinator at the given address (host:port). The same scene has to be given");
+        app.add_option("--chunk-spp", DistributedChunkSPP, "Number of samples per work item in distributed rendering. Set to 0 to detect automatically")->default_val(DistributedChunkSPP);
+        app.add_option("--worker-timeout", DistributedTimeout, "Seconds a worker may not report progress in distributed rendering before its work is reassigned to another worker. Set to 0 to wait forever")->default_val(DistributedTimeout);
+
+        app.add_option("--bench-json", BenchmarkFile, "Write load, shader compile and per iteration render times, throughput, peak memory and the error against the reference as json to the given file");
+        app.add_option("--reference", Reference, "Reference image to compute the relative error of the result against. The error is part of the benchmark report")->check(CLI::ExistingFile);
+    }
 
     app.add_option("--seed", Seed, "Seed for the random generators. Depending on the technique this will enforce reproducibility");
 
     app.add_flag("--stats", AcquireStats, "Acquire useful stats alongside rendering. Will be dumped at the end of the rendering session");
     app.add_flag("--stats-full", AcquireFullStats, "Acquire all stats alongside rendering. Will be dumped at the end of the rendering session");
+    app.add_option("--stats-json", StatsFile, "Acquire all stats alongside rendering and write them, including per material and per entity costs, as json to the given file");
+    app.add_option("--max-memory", MaxMemory, "Abort loading if the memory required by the scene exceeds the given limit in megabytes. A breakdown per category is reported. Zero disables the limit");
+    app.add_option("--timeline", Timeline, "Record a timeline of loading, shader compilation and rendering and write it to the given file in the Chrome trace format (viewable in Perfetto)");
 
     app.add_flag("--debug-trace", DebugTrace, "Dump information regarding calls on the device. Will slow down execution and produce a lot of output!");
 
@@ -123,7 +142,7 @@ ProgramOptions::ProgramOptions(int argc, char** argv, ApplicationType type, cons
     app.add_option("--shader-threads", ShaderCompileThreads, "Number of threads to use to compile large shaders. Set to 0 to detect automatically")->default_val(ShaderCompileThreads);
 
     app.add_flag("--add-env-light", AddExtraEnvLight, "Add additional constant environment light. This is automatically done for glTF scenes without any lights");
-    app.add_option("--specialization", Specialization, "Set the type of specialization. Force will increase compile time drastically for potential runtime optimization.")->transform(EnumValidator(SpecializationModeMap, CLI::ignore_case))->default_str("default");
+    app.add_option("--specialization", Specialization, "Set the type of specialization. Force will increase compile time drastically for potential runtime optimization. Profile specializes the materials hit most often in a previous run and records a new profile next to the scene cache.")->transform(EnumValidator(SpecializationModeMap, CLI::ignore_case))->default_str("default");
     app.add_flag_callback(
         "--force-specialization", [&]() { this->Specialization = RuntimeOptions::SpecializationMode::Force; },
         "Enforce specialization for parameters in shading tree. This will increase compile time drastically for potential runtime optimization");
@@ -134,6 +153,9 @@ ProgramOptions::ProgramOptions(int argc, char** argv, ApplicationType type, cons
     if (type != ApplicationType::Trace) {
         app.add_flag("--no-std-aovs", NoStdAOVs, "Disable standard AOVs. This will prevent the usage of the denoiser");
         app.add_flag("--denoise", Denoise, "Apply denoiser if available");
+        app.add_flag("--cost-aov", CostAOV, "Record the render time in microseconds, traced rays and shaded rays per pixel into the 'Cost' AOV. Only available on the CPU");
+        app.add_flag("--denoise-async", DenoiseAsync, "Run the denoiser in a background thread. The denoised output lags behind by a few iterations");
+        app.add_option("--denoise-max-memory", DenoiseMaxMemory, "Upper bound of the memory used by the denoiser in megabytes. Large images are denoised in tiles. Zero disables the limit");
     }
 
     if (type == ApplicationType::Trace) {
@@ -143,8 +165,12 @@ ProgramOptions::ProgramOptions(int argc, char** argv, ApplicationType type, cons
         app.add_option("-o,--output", Output, "Writes the output image to a file");
     }
 
-    if (type == ApplicationType::View)
+    if (type == ApplicationType::View) {
         app.add_option("--dpi", DPI, "Optional scaling factor for the UI. If not set, it will be acquired automatically");
+        app.add_option("--target-frametime", TargetFrameTime, "Target duration of an iteration in milliseconds while the camera moves. The resolution is reduced temporarily to reach it. Set to 0 to disable")->default_val(TargetFrameTime);
+        app.add_option("--min-resolution-scale", MinResolutionScale, "Lower bound of the resolution scale used while the camera moves")->check(CLI::Range(0.05f, 1.0f))->default_val(MinResolutionScale);
+        app.add_flag("--hot-reload", HotReload, "Allow reloading changed materials and textures from the scene file with F5. Only the affected shaders are recompiled");
+    }
 
     // Add user entries
     app.add_option(
@@ -274,6 +300,8 @@ ProgramOptions::ProgramOptions(int argc, char** argv, ApplicationType type, cons
     try {
         if (!Output.is_absolute())
             Output = std::filesystem::absolute(Output);
+        if (Checkpoint.empty() && CheckpointInterval.has_value() && !Output.empty())
+            Checkpoint = Path(Output).replace_extension(".ckpt");
     } catch (...) {
         // Ignore it
     }
@@ -320,7 +348,7 @@ void ProgramOptions::populate(RuntimeOptions& options) const
     options.IsInteractive = Type == ApplicationType::View;
 
     options.Target           = Target;
-    options.AcquireStats     = AcquireStats || AcquireFullStats;
+    options.AcquireStats     = AcquireStats || AcquireFullStats || !StatsFile.empty();
     options.DebugTrace       = DebugTrace;
     options.DumpShader       = DumpShader || DumpFullShader;
     options.DumpShaderFull   = DumpFullShader;
@@ -339,13 +367,24 @@ void ProgramOptions::populate(RuntimeOptions& options) const
     options.Specialization   = Specialization;
 
     options.DisableStandardAOVs  = NoStdAOVs;
+    options.EnableCostAOV        = CostAOV;
+    options.MaxMemoryMB          = MaxMemory;
+    options.EnableHotReload      = HotReload;
     options.Denoiser.Enabled     = Denoise;
     options.Denoiser.HighQuality = !options.IsInteractive;
+    options.Denoiser.Async       = DenoiseAsync;
+    options.Denoiser.MaxMemoryMB = DenoiseMaxMemory;
+
+    options.AdaptiveSampling.Enabled       = TargetError.has_value();
+    options.AdaptiveSampling.TargetError   = TargetError.value_or(options.AdaptiveSampling.TargetError);
+    options.AdaptiveSampling.TileSize      = (uint32)std::max<size_t>(1, AdaptiveTileSize);
+    options.AdaptiveSampling.MinIterations = (uint32)AdaptiveMinIterations;
 
     options.EnableCache = !NoCache;
     options.CacheDir    = CacheDir;
 
     options.ScriptDir               = ScriptDir;
+    options.TimelineFile            = Timeline;
     options.ShaderOptimizationLevel = std::min<size_t>(3, ShaderOptimizationLevel);
     options.ShaderCompileThreads    = ShaderCompileThreads;
 
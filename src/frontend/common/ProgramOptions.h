@@ -63,6 +63,8 @@ public:
     bool AcquireStats     = false;
     bool AcquireFullStats = false;
     bool DebugTrace       = false;
+    Path StatsFile; // Enables stats and writes them as json
+    size_t MaxMemory = 0; // In MB, zero disables the limit
 
     bool DumpShader       = false;
     bool DumpFullShader   = false;
@@ -73,8 +75,31 @@ public:
 
     RuntimeOptions::SpecializationMode Specialization = RuntimeOptions::SpecializationMode::Default;
 
-    bool NoStdAOVs = false;
-    bool Denoise   = false;
+    bool NoStdAOVs          = false;
+    bool Denoise            = false;
+    bool DenoiseAsync       = false;
+    bool CostAOV            = false;
+    size_t DenoiseMaxMemory = 0; // In MB, zero disables the limit
+
+    std::optional<float> TargetError; // Enables adaptive sampling
+    size_t AdaptiveTileSize      = 8;
+    size_t AdaptiveMinIterations = 4;
+
+    Path Checkpoint;                          // Defaults to the output path with .ckpt extension
+    std::optional<size_t> CheckpointInterval; // In seconds, enables checkpoints
+    Path Resume;
+
+    size_t DistributedWorkers = 0;         // Number of local worker processes to launch
+    std::optional<uint16> DistributedPort; // Port to accept remote workers on
+    std::string DistributedConnect;        // Address (host:port) of the coordinator. Enables worker mode
+    size_t DistributedChunkSPP = 0;        // Number of samples per work item. Set to 0 to detect automatically
+    size_t DistributedTimeout  = 600;      // Seconds without progress after which a worker is considered hung. Set to 0 to disable
+
+    Path BenchmarkFile; // Writes a machine readable report of the rendering session
+    Path Reference;     // Reference image to compute the error of the result against
+
+    inline bool isDistributedCoordinator() const { return DistributedWorkers > 0 || DistributedPort.has_value(); }
+    inline bool isDistributedWorker() const { return !DistributedConnect.empty(); }
 
     bool NoCache = false;
     Path CacheDir;
@@ -87,10 +112,14 @@ public:
     Path InputRay;
 
     Path ScriptDir;
+    Path Timeline; // Enables the timeline recorder
 
     ParameterSet UserEntries;
 
     std::optional<float> DPI; // Only used for UI
+    float TargetFrameTime    = 50;    // Only used for UI. Zero disables dynamic resolution
+    float MinResolutionScale = 0.25f; // Only used for UI
+    bool HotReload           = false; // Only used for UI
 
     void populate(RuntimeOptions& options) const;
 };
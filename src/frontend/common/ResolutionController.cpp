@@ -0,0 +1,45 @@
+#include "ResolutionController.h"
+
+#include <algorithm>
+
+namespace IG {
+// Time without any motion until full resolution is restored
+constexpr auto StillDuration = std::chrono::milliseconds(250);
+// The scale is quantized to prevent resizing the framebuffer after each iteration due to small timing fluctuations
+constexpr float ScaleSteps = 16;
+
+ResolutionController::ResolutionController(float targetFrameTimeMS, float minScale)
+    : mTargetFrameTime(std::max(0.0f, targetFrameTimeMS))
+    , mMinScale(std::clamp(minScale, 0.05f, 1.0f))
+    , mFullFrameTime(0)
+    , mLastMotion()
+{
+}
+
+void ResolutionController::notifyMotion(Clock::time_point now)
+{
+    mLastMotion = now;
+}
+
+void ResolutionController::reportIteration(float scale, float durationMS)
+{
+    if (scale <= 0 || durationMS <= 0)
+        return;
+
+    // The cost of an iteration is approximately proportional to the number of pixels
+    const float estimate = durationMS / (scale * scale);
+    mFullFrameTime       = mFullFrameTime <= 0 ? estimate : (0.7f * mFullFrameTime + 0.3f * estimate);
+}
+
+float ResolutionController::scale(Clock::time_point now) const
+{
+    if (!isEnabled() || mFullFrameTime <= mTargetFrameTime)
+        return 1;
+
+    if (now - mLastMotion > StillDuration)
+        return 1;
+
+    const float scale = std::sqrt(mTargetFrameTime / mFullFrameTime);
+    return std::clamp(std::floor(scale * ScaleSteps) / ScaleSteps, mMinScale, 1.0f);
+}
+} // namespace IG
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "IG_Config.h"
+
+#include <chrono>
+
+namespace IG {
+/// Controls the internal resolution of the framebuffer to keep the viewer interactive on slow devices.
+/// While the camera moves, the resolution is reduced such that a single iteration fits into the target frame time.
+/// Once the camera stands still for a short while, full resolution is restored and the image refines as usual.
+class ResolutionController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @param targetFrameTimeMS Desired duration of an iteration while moving. Zero disables the controller
+    /// @param minScale Lower bound for the resolution scale per axis
+    ResolutionController(float targetFrameTimeMS, float minScale);
+
+    /// Notify about a change of the camera or the scene
+    inline void notifyMotion() { notifyMotion(Clock::now()); }
+    /// Notify about a change of the camera or the scene at the given point in time
+    void notifyMotion(Clock::time_point now);
+    /// Report the duration of an iteration rendered with the given scale
+    void reportIteration(float scale, float durationMS);
+
+    /// Scale per axis which should be used for the next iteration
+    [[nodiscard]] inline float scale() const { return scale(Clock::now()); }
+    /// Scale per axis which should be used for an iteration started at the given point in time
+    [[nodiscard]] float scale(Clock::time_point now) const;
+
+    [[nodiscard]] inline bool isEnabled() const { return mTargetFrameTime > 0; }
+
+private:
+    const float mTargetFrameTime;
+    const float mMinScale;
+
+    float mFullFrameTime; // Estimated duration of an iteration at full resolution
+    Clock::time_point mLastMotion;
+};
+} // namespace IG
@@ -5,7 +5,7 @@
 
 namespace IG {
 static const std::map<std::string, LogLevel> LogLevelMap{ { "fatal", L_FATAL }, { "error", L_ERROR }, { "warning", L_WARNING }, { "info", L_INFO }, { "debug", L_DEBUG } };
-static const std::map<std::string, RuntimeOptions::SpecializationMode> SpecializationModeMap{ { "default", RuntimeOptions::SpecializationMode::Default }, { "force", RuntimeOptions::SpecializationMode::Force }, { "disable", RuntimeOptions::SpecializationMode::Disable } };
+static const std::map<std::string, RuntimeOptions::SpecializationMode> SpecializationModeMap{ { "default", RuntimeOptions::SpecializationMode::Default }, { "force", RuntimeOptions::SpecializationMode::Force }, { "disable", RuntimeOptions::SpecializationMode::Disable }, { "profile", RuntimeOptions::SpecializationMode::Profile } };
 
 static void handleListCLIOptions(const CLI::App& app)
 {
@@ -42,6 +42,8 @@ ExplorerOptions::ExplorerOptions(int argc, char** argv, const std::string& desc)
     app.add_option("--width", WindowWidth, "Set initial window width");
     app.add_option("--height", WindowHeight, "Set initial window height");
     app.add_option("--dpi", DPI, "Optional scaling factor for the UI. If not set, it will be acquired automatically");
+    app.add_option("--target-frametime", TargetFrameTime, "Target duration of an iteration in milliseconds while the camera moves. The resolution is reduced temporarily to reach it. Set to 0 to disable")->default_val(TargetFrameTime);
+    app.add_option("--min-resolution-scale", MinResolutionScale, "Lower bound of the resolution scale used while the camera moves")->check(CLI::Range(0.05f, 1.0f))->default_val(MinResolutionScale);
 
     app.add_flag("--stats", AcquireStats, "Acquire useful stats alongside rendering. Will be dumped at the end of the rendering session");
     app.add_flag("--stats-full", AcquireFullStats, "Acquire all stats alongside rendering. Will be dumped at the end of the rendering session");
@@ -58,7 +60,7 @@ ExplorerOptions::ExplorerOptions(int argc, char** argv, const std::string& desc)
     app.add_option("-O,--shader-optimization", ShaderOptimizationLevel, "Level of optimization applied to shaders. Range is [0, 3]. Level 0 will also add debug information")->default_val(ShaderOptimizationLevel);
     app.add_option("--shader-threads", ShaderCompileThreads, "Number of threads to use to compile large shaders. Set to 0 to detect automatically")->default_val(ShaderCompileThreads);
 
-    app.add_option("--specialization", Specialization, "Set the type of specialization. Force will increase compile time drastically for potential runtime optimization.")->transform(EnumValidator(SpecializationModeMap, CLI::ignore_case))->default_str("default");
+    app.add_option("--specialization", Specialization, "Set the type of specialization. Force will increase compile time drastically for potential runtime optimization. Profile specializes the materials hit most often in a previous run and records a new profile next to the scene cache.")->transform(EnumValidator(SpecializationModeMap, CLI::ignore_case))->default_str("default");
     app.add_flag_callback(
         "--force-specialization", [&]() { this->Specialization = RuntimeOptions::SpecializationMode::Force; },
         "Enforce specialization for parameters in shading tree. This will increase compile time drastically for potential runtime optimization");
@@ -25,6 +25,9 @@ public:
 
     std::optional<float> DPI; // Only used for UI
 
+    float TargetFrameTime    = 50; // Zero disables dynamic resolution
+    float MinResolutionScale = 0.25f;
+
     bool AcquireStats     = false;
     bool AcquireFullStats = false;
     bool DebugTrace       = false;
@@ -4,6 +4,7 @@
 #include "ColorbarGizmo.h"
 #include "ExplorerOptions.h"
 #include "Logger.h"
+#include "ResolutionController.h"
 #include "Runtime.h"
 #include "ShaderGenerator.h"
 #include "extra/OIDN.h"
@@ -41,6 +42,8 @@ public:
         , mRequestReset(false)
         , mInternalViewWidth(1024)
         , mInternalViewHeight(1024)
+        , mResolution(opts.TargetFrameTime, opts.MinResolutionScale)
+        , mResolutionScale(1)
         , mColorbar()
         , mShowColorbar(true)
         , mUseDenoiser(OIDN::hasGPU()) // Enable denoiser by default if GPU is available, else it has too much of a performance impact
@@ -129,11 +132,19 @@ public:
         if (!mLoading && mRuntime) {
             const auto start = std::chrono::high_resolution_clock::now();
             if (mRequestReset) {
+                mResolution.notifyMotion();
                 mRuntime->setCameraOrientation(mCurrentCamera.asOrientation());
                 mRuntime->reset();
                 mRequestReset = false;
             }
+
+            // The passes read the framebuffer size from the settings, therefore a reduced internal view is stretched to the canvas
+            applyResolutionScale(mResolution.scale());
+
+            const auto stepStart = std::chrono::high_resolution_clock::now();
             mRuntime->step(!mUseDenoiser);
+            const auto stepEnd = std::chrono::high_resolution_clock::now();
+            mResolution.reportIteration(mResolutionScale, std::chrono::duration<float, std::milli>(stepEnd - stepStart).count());
 
             ImGui::SetNextWindowSize(ImVec2(400, 400), ImGuiCond_FirstUseEver);
             ImGui::SetNextWindowDockID(Application::getMainWindowDockID(), ImGuiCond_FirstUseEver);
@@ -259,8 +270,7 @@ public:
         mInternalViewWidth  = width;
         mInternalViewHeight = height;
 
-        if (mRuntime)
-            mRuntime->resizeFramebuffer(width, height);
+        applyResolutionScale(mResolutionScale);
     }
 
     inline std::pair<size_t, size_t> internalViewSize() const
@@ -281,6 +291,19 @@ public:
     inline RenderWidget::SkyModel currrentSkyModel() const { return mSkyModel; }
 
 private:
+    /// Resize the framebuffer of the runtime to the internal view scaled by the given factor per axis
+    void applyResolutionScale(float scale)
+    {
+        mResolutionScale = scale;
+        if (!mRuntime)
+            return;
+
+        const size_t width  = std::max<size_t>(1, (size_t)std::round(mInternalViewWidth * scale));
+        const size_t height = std::max<size_t>(1, (size_t)std::round(mInternalViewHeight * scale));
+        if (width != mRuntime->framebufferWidth() || height != mRuntime->framebufferHeight())
+            mRuntime->resizeFramebuffer(width, height);
+    }
+
     void handleInput()
     {
         if (!mRuntime)
@@ -659,6 +682,9 @@ private:
     size_t mInternalViewWidth;
     size_t mInternalViewHeight;
 
+    ResolutionController mResolution;
+    float mResolutionScale;
+
     ColorbarGizmo mColorbar;
     bool mShowColorbar;
 
@@ -1,11 +1,15 @@
 #include "Runtime.h"
 #include "Image.h"
 #include "Logger.h"
+#include "RenderQueue.h"
 
 IG_BEGIN_IGNORE_WARNINGS
 #include <nanobind/eigen/dense.h>
 #include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
 #include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/map.h>
+#include <nanobind/stl/optional.h>
 #include <nanobind/stl/pair.h>
 #include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
@@ -24,8 +28,132 @@ static void flush_io()
     std::cerr.flush();
 }
 
+using RayArray   = nb::ndarray<const float, nb::shape<-1, 6>, nb::c_contig, nb::device::cpu>;
+using Vec3Array  = nb::ndarray<const float, nb::shape<-1, 3>, nb::c_contig, nb::device::cpu>;
+using RangeArray = nb::ndarray<const float, nb::shape<-1, 2>, nb::c_contig, nb::device::cpu>;
+using TraceArray = nb::ndarray<nb::numpy, float, nb::shape<-1, 3>>;
+
+// Trace the rays given by the function without holding the GIL and return the result either as copy owned by python or as view into the framebuffer.
+// The view has no owner, as the framebuffer is released when leaving the `with` block of the runtime, and is overwritten by the next call to trace
+template <typename TraceFunc>
+static TraceArray trace_rays(Runtime& r, size_t count, bool copy, const TraceFunc& traceFunc)
+{
+    float* data = nullptr;
+    {
+        nb::gil_scoped_release release;
+        traceFunc();
+
+        data = r.getFramebufferForHost(std::string{}).Data;
+        if (copy) {
+            float* buffer = new float[count * 3];
+            std::memcpy(buffer, data, sizeof(float) * count * 3);
+            data = buffer;
+        }
+    }
+
+    size_t shape[] = { count, 3ul };
+    if (!copy)
+        return TraceArray(data, 2, shape, nb::handle());
+
+    nb::capsule owner(data, [](void* p) noexcept { delete[] static_cast<float*>(p); });
+    return TraceArray(data, 2, shape, owner);
+}
+
+static inline TraceArray trace_batch(Runtime& r, const RayBatch& batch, bool copy)
+{
+    return trace_rays(r, batch.Count, copy, [&]() { r.trace(batch); });
+}
+
+static std::map<std::string, std::pair<size_t, size_t>> memory_to_map(const MemoryUsage& usage)
+{
+    std::map<std::string, std::pair<size_t, size_t>> map;
+    for (size_t i = 0; i < (size_t)MemoryCategory::_COUNT; ++i) {
+        const MemoryCategory category = (MemoryCategory)i;
+        map[std::string(MemoryUsage::getCategoryName(category))] = { usage.get(category, MemoryLocation::Host), usage.get(category, MemoryLocation::Device) };
+    }
+    return map;
+}
+
+// Python has no notion of std::future, therefore wrap it into a handle which can be polled and waited on.
+// Waiting releases the GIL, such that other python threads can prepare further work in the meantime
+template <typename T>
+class FutureWrap {
+    std::shared_future<T> mFuture;
+
+public:
+    explicit FutureWrap(std::future<T>&& future)
+        : mFuture(future.share())
+    {
+    }
+
+    bool done() const { return mFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+    // Will rethrow errors occured while executing the work
+    decltype(auto) get() const
+    {
+        {
+            nb::gil_scoped_release release;
+            mFuture.wait();
+        }
+        return mFuture.get();
+    }
+};
+
+using RenderFuture   = FutureWrap<void>;
+using SnapshotFuture = FutureWrap<FramebufferSnapshot>;
+
+// Queues hold a plain reference to their runtime. The wrapper owning the runtime has to stop all queues working on it before it is destroyed
+class RenderQueueWrap;
+static std::mutex sQueueMutex;
+static std::unordered_multimap<const Runtime*, RenderQueueWrap*> sQueues;
+
+class RenderQueueWrap : public RenderQueue {
+    const Runtime* mRuntime;
+
+public:
+    explicit RenderQueueWrap(Runtime& runtime)
+        : RenderQueue(runtime)
+        , mRuntime(&runtime)
+    {
+        std::lock_guard<std::mutex> _guard(sQueueMutex);
+        sQueues.emplace(mRuntime, this);
+    }
+
+    ~RenderQueueWrap()
+    {
+        unregister();
+    }
+
+    static void stopAll(const Runtime* runtime)
+    {
+        // The lock is held while stopping, such that no queue is destroyed concurrently.
+        // The queue objects stay alive as long as Python references them, only the worker threads are stopped
+        std::lock_guard<std::mutex> _guard(sQueueMutex);
+        const auto range = sQueues.equal_range(runtime);
+        for (auto it = range.first; it != range.second; ++it) {
+            it->second->mRuntime = nullptr;
+            it->second->stop();
+        }
+        sQueues.erase(runtime);
+    }
+
+private:
+    void unregister()
+    {
+        std::lock_guard<std::mutex> _guard(sQueueMutex);
+        const auto range = sQueues.equal_range(mRuntime);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == this) {
+                sQueues.erase(it);
+                break;
+            }
+        }
+    }
+};
+
+// Each wrapper owns its own runtime. Multiple runtimes can be used at the same time
 class RuntimeWrap {
-    static std::unique_ptr<Runtime> sInstance;
+    std::unique_ptr<Runtime> mInstance;
 
     RuntimeOptions mOptions;
     std::string mSource;
@@ -66,15 +194,19 @@ public:
     Runtime* instance()
     {
         // Only return instance if the class created it
-        if (mCreated && sInstance)
-            return sInstance.get();
+        if (mCreated && mInstance)
+            return mInstance.get();
 
         return create();
     }
 
     void shutdown()
     {
-        sInstance.reset();
+        if (mInstance) {
+            nb::gil_scoped_release release; // The running task might take a while
+            RenderQueueWrap::stopAll(mInstance.get());
+        }
+        mInstance.reset();
         flush_io();
         // Do not reset `mCreated`! The class should create the runtime only once
     }
@@ -82,36 +214,35 @@ public:
 private:
     Runtime* create()
     {
-        if (sInstance) {
-            IG_LOG(L_ERROR) << "Trying to create multiple runtime instances!" << std::endl;
+        if (mInstance) {
+            IG_LOG(L_ERROR) << "Trying to create the runtime multiple times!" << std::endl;
             return nullptr;
         }
 
-        sInstance = std::make_unique<Runtime>(mOptions);
+        mInstance = std::make_unique<Runtime>(mOptions);
 
         if (mScene) {
-            if (!sInstance->loadFromScene(mScene)) {
-                sInstance.reset();
+            if (!mInstance->loadFromScene(mScene)) {
+                mInstance.reset();
                 return nullptr;
             }
         } else if (mSource.empty()) {
-            if (!sInstance->loadFromFile(mPath)) {
-                sInstance.reset();
+            if (!mInstance->loadFromFile(mPath)) {
+                mInstance.reset();
                 return nullptr;
             }
         } else {
-            if (!sInstance->loadFromString(mSource, mPath)) {
-                sInstance.reset();
+            if (!mInstance->loadFromString(mSource, mPath)) {
+                mInstance.reset();
                 return nullptr;
             }
         }
 
         mCreated = true;
-        return sInstance.get();
+        return mInstance.get();
     }
 };
 
-std::unique_ptr<Runtime> RuntimeWrap::sInstance;
 void runtime_module(nb::module_& m)
 {
     // Logger IO stuff
@@ -153,7 +284,16 @@ void runtime_module(nb::module_& m)
         .def(nb::init<>())
         .def_rw("Enabled", &DenoiserSettings::Enabled, "Enable or disable the denoiser")
         .def_rw("HighQuality", &DenoiserSettings::HighQuality, "Set True if denoiser should be high quality or interactive")
-        .def_rw("Prefilter", &DenoiserSettings::Prefilter, "Set True if normal and albedo layer should be prefiltered");
+        .def_rw("Prefilter", &DenoiserSettings::Prefilter, "Set True if normal and albedo layer should be prefiltered")
+        .def_rw("Async", &DenoiserSettings::Async, "Set True if the denoiser should run in a background thread. The result lags behind by a few iterations")
+        .def_rw("MaxMemoryMB", &DenoiserSettings::MaxMemoryMB, "Upper bound of the memory used by the denoiser in megabytes. Zero disables the limit");
+
+    nb::class_<AdaptiveSamplingSettings>(m, "AdaptiveSamplingSettings", "Settings for adaptive sampling")
+        .def(nb::init<>())
+        .def_rw("Enabled", &AdaptiveSamplingSettings::Enabled, "Enable or disable adaptive sampling")
+        .def_rw("TargetError", &AdaptiveSamplingSettings::TargetError, "Relative error a tile has to reach to be considered converged")
+        .def_rw("MinIterations", &AdaptiveSamplingSettings::MinIterations, "Minimum number of iterations before a tile can converge")
+        .def_rw("TileSize", &AdaptiveSamplingSettings::TileSize, "Size of the tiles the convergence is decided on");
 
     auto opts = nb::class_<RuntimeOptions>(m, "RuntimeOptions", "Options to customize runtime behaviour")
         .def(nb::init<>())
@@ -165,6 +305,7 @@ void runtime_module(nb::module_& m)
         .def_rw("DumpRegistryFull", &RuntimeOptions::DumpRegistryFull, "Dump the complete registry into the standard io")
         .def_rw("DebugTrace", &RuntimeOptions::DebugTrace, "Dump trace information into the logger. Huge negative performance impact")
         .def_rw("AcquireStats", &RuntimeOptions::AcquireStats, "Set True if statistical data should be acquired while rendering")
+        .def_rw("TimelineFile", &RuntimeOptions::TimelineFile, "Record a timeline and write it in the Chrome trace format to the given file when the runtime is destroyed")
         .def_rw("SPI", &RuntimeOptions::SPI, "The requested sample per iteration. Can be 0 to set automatically")
         .def_rw("Seed", &RuntimeOptions::Seed, "Seed for the random generators")
         .def_rw("OverrideCamera", &RuntimeOptions::OverrideCamera, "Type of camera to use instead of the one used by the scene")
@@ -172,8 +313,12 @@ void runtime_module(nb::module_& m)
         .def_rw("OverrideFilmSize", &RuntimeOptions::OverrideFilmSize, "Type of film size to use instead of the one used by the scene")
         .def_rw("EnableTonemapping", &RuntimeOptions::EnableTonemapping, "Set True if any of the two tonemapping functions ``tonemap`` and ``imageinfo`` is to be used")
         .def_rw("Denoiser", &RuntimeOptions::Denoiser, "Settings for the denoiser")
+        .def_rw("AdaptiveSampling", &RuntimeOptions::AdaptiveSampling, "Settings for adaptive sampling")
         .def_rw("WarnUnused", &RuntimeOptions::WarnUnused, "Set False if you want to ignore warnings about unused property entries")
         .def_rw("DisableStandardAOVs", &RuntimeOptions::DisableStandardAOVs, "Disable standard normal and albedo aovs")
+        .def_rw("EnableCostAOV", &RuntimeOptions::EnableCostAOV, "Record the render cost per tile into the 'Cost' aov. Only available on the CPU")
+        .def_rw("MaxMemoryMB", &RuntimeOptions::MaxMemoryMB, "Fail loading if the memory usage exceeds the given limit in megabytes. Zero disables the limit")
+        .def_rw("EnableHotReload", &RuntimeOptions::EnableHotReload, "Keep the loader state after loading, such that changed materials and textures can be reloaded with ``reloadFromFile`` or ``reloadFromScene``")
         .def_rw("ShaderOptimizationLevel", &RuntimeOptions::ShaderOptimizationLevel, "Level of optimization for shaders")
         .def_rw("ShaderCompileThreads", &RuntimeOptions::ShaderCompileThreads, "Number of threads to use for compiling shaders")
         .def_rw("Specialization", &RuntimeOptions::Specialization)
@@ -185,7 +330,8 @@ void runtime_module(nb::module_& m)
     nb::enum_<RuntimeOptions::SpecializationMode>(opts, "SpecializationMode", "Enum holding shader specialization modes")
         .value("Default", RuntimeOptions::SpecializationMode::Default)
         .value("Force", RuntimeOptions::SpecializationMode::Force)
-        .value("Disable", RuntimeOptions::SpecializationMode::Disable);
+        .value("Disable", RuntimeOptions::SpecializationMode::Disable)
+        .value("Profile", RuntimeOptions::SpecializationMode::Profile);
 
     nb::class_<Ray>(m, "Ray", "Single ray traced into the scene")
         .def_static("__init__", [](Ray* ray, const Vector3f& org, const Vector3f& dir) { new (ray) Ray{ org, dir, Vector2f(0, FltMax) }; })
@@ -222,12 +368,37 @@ void runtime_module(nb::module_& m)
     // TODO: Add option to insert new "texture" as parameter for Python Interchange with proper device handling
     nb::class_<Runtime>(m, "Runtime", "Renderer runtime allowing control of simulation and access to results")
         .def("step", &Runtime::step, nb::arg("ignoreDenoiser") = false)
-        .def("trace", [](Runtime& r, const std::vector<Ray>& rays) {
-            r.trace(rays);
-            size_t shape[] = { rays.size(), 3ul };
-            return nb::ndarray<nb::numpy, float, nb::shape<-1, 3>>(r.getFramebufferForHost(std::string{}).Data, 2, shape, nb::handle());
-        })
+        .def(
+            "trace", [](Runtime& r, const std::vector<Ray>& rays) { return trace_rays(r, rays.size(), true, [&]() { r.trace(rays); }); },
+            nb::arg("rays"), "Trace a list of rays. The result is a copy")
+        .def(
+            "trace", [](Runtime& r, RayArray rays, bool copy) {
+                RayBatch batch;
+                batch.Count      = rays.shape(0);
+                batch.Origins    = rays.data();
+                batch.Directions = rays.data() + 3;
+                batch.Stride     = 6;
+                return trace_batch(r, batch, copy); },
+            nb::arg("rays"), nb::arg("copy") = true, "Trace rays given as (N,6) array of origins and directions without copying. The result is a copy, unless copy is False. The view into the framebuffer is only valid until the next call to trace and while the runtime is alive")
+        .def(
+            "trace", [](Runtime& r, Vec3Array origins, Vec3Array directions, std::optional<RangeArray> ranges, bool copy) {
+                if (origins.shape(0) != directions.shape(0) || (ranges.has_value() && ranges->shape(0) != origins.shape(0)))
+                    throw nb::buffer_error("Incompatible buffers: Origins, directions and ranges must have the same number of rays");
+
+                RayBatch batch;
+                batch.Count      = origins.shape(0);
+                batch.Origins    = origins.data();
+                batch.Directions = directions.data();
+                batch.Ranges     = ranges.has_value() ? ranges->data() : nullptr;
+                return trace_batch(r, batch, copy); },
+            nb::arg("origins"), nb::arg("directions"), nb::arg("ranges").none() = nb::none(), nb::arg("copy") = true, "Trace rays given as (N,3) arrays of origins and directions and optional (N,2) ranges without copying. The result is a copy, unless copy is False. The view into the framebuffer is only valid until the next call to trace and while the runtime is alive")
         .def("reset", &Runtime::reset, "Reset internal counters etc. This should be used if data (like camera orientation) has changed. Frame counter will NOT be reset")
+        .def("reloadFromFile", &Runtime::reloadFromFile, "Reload changed materials and textures from file and recompile only the affected shaders. Requires ``EnableHotReload``. Returns False if a full reload is required")
+        .def("reloadFromScene", &Runtime::reloadFromScene, "Reload changed materials and textures from the given scene and recompile only the affected shaders. Requires ``EnableHotReload``. Returns False if a full reload is required")
+        .def(
+            "memoryUsage", [](const Runtime& r) { return memory_to_map(r.memoryUsage()); }, "Bytes currently allocated per category as (host, device) pairs")
+        .def(
+            "peakMemoryUsage", [](const Runtime& r) { return memory_to_map(r.peakMemoryUsage()); }, "Peak bytes allocated per category as (host, device) pairs")
         .def(
             "getFramebufferForHost", [](const Runtime& r, const std::string& aov) {
                 const size_t width  = r.framebufferWidth();
@@ -296,6 +467,8 @@ void runtime_module(nb::module_& m)
         .def_prop_ro("InitialCameraOrientation", &Runtime::initialCameraOrientation)
         .def_prop_ro("IterationCount", &Runtime::currentIterationCount)
         .def_prop_ro("SampleCount", &Runtime::currentSampleCount)
+        .def_prop_ro("IsConverged", &Runtime::isConverged)
+        .def_prop_ro("ActivePixelCount", &Runtime::activePixelCount)
         .def_prop_ro("FrameCount", &Runtime::currentFrameCount)
         .def("incFrameCount", &Runtime::incFrameCount)
         .def_prop_ro("FramebufferWidth", &Runtime::framebufferWidth)
@@ -311,6 +484,40 @@ void runtime_module(nb::module_& m)
         .def_prop_ro_static("AvailableCameraTypes", &Runtime::getAvailableCameraTypes)
         .def_prop_ro_static("AvailableTechniqueTypes", &Runtime::getAvailableTechniqueTypes);
 
+    nb::class_<RenderFuture>(m, "RenderFuture", "Handle to queued work")
+        .def("done", &RenderFuture::done, "True if the work is finished")
+        .def("wait", &RenderFuture::get, "Wait until the work is finished");
+
+    nb::class_<SnapshotFuture>(m, "SnapshotFuture", "Handle to a queued framebuffer snapshot")
+        .def("done", &SnapshotFuture::done, "True if the snapshot is available")
+        .def(
+            "get", [](const SnapshotFuture& f) {
+                const FramebufferSnapshot& snapshot = f.get();
+
+                float* data = new float[snapshot.Data.size()];
+                std::memcpy(data, snapshot.Data.data(), sizeof(float) * snapshot.Data.size());
+                nb::capsule owner(data, [](void* p) noexcept { delete[] static_cast<float*>(p); });
+
+                size_t shape[] = { snapshot.Data.empty() ? 0 : snapshot.Height, snapshot.Width, 3ul };
+                return nb::ndarray<nb::numpy, float, nb::shape<-1, -1, 3>>(data, 3, shape, owner); },
+            "Wait for the snapshot and return the accumulated (not normalized) framebuffer")
+        .def_prop_ro("Iteration", [](const SnapshotFuture& f) { return f.get().Iteration; }, "Iteration count the snapshot was taken at")
+        .def_prop_ro("SampleCount", [](const SnapshotFuture& f) { return f.get().SampleCount; }, "Sample count the snapshot was taken at");
+
+    nb::class_<RenderQueueWrap>(m, "RenderQueue", "Executes work on a runtime in a separate thread. The runtime should not be accessed directly while work is pending. "
+                                                                "Pending work is dropped when the owning runtime is shut down")
+        .def(nb::init<Runtime&>(), nb::keep_alive<1, 2>())
+        .def(
+            "step", [](RenderQueueWrap& q, size_t iterations, bool ignoreDenoiser) { return RenderFuture(q.step(iterations, ignoreDenoiser)); },
+            nb::arg("iterations") = 1, nb::arg("ignoreDenoiser") = false, "Queue the given number of iterations")
+        .def(
+            "snapshot", [](RenderQueueWrap& q, const std::string& aov) { return SnapshotFuture(q.snapshot(aov)); },
+            nb::arg("aov") = "", "Queue a copy of the framebuffer, which is consistent even if further iterations are queued")
+        .def("cancel", [](RenderQueueWrap& q) { q.cancel(); }, "Drop all work not yet started")
+        .def("wait", [](RenderQueueWrap& q) { q.wait(); }, nb::call_guard<nb::gil_scoped_release>(), "Wait until all queued work is finished")
+        .def_prop_ro("PendingCount", [](const RenderQueueWrap& q) { return q.pendingCount(); })
+        .def_prop_ro("IsIdle", [](const RenderQueueWrap& q) { return q.isIdle(); });
+
     nb::class_<RuntimeWrap>(m, "RuntimeWrap", "Wrapper around the runtime used for proper runtime loading and shutdown")
         .def("__enter__", &RuntimeWrap::enter, nb::rv_policy::reference_internal)
         .def("__exit__", &RuntimeWrap::exit, "type"_a.none(), "value"_a.none(), "traceback"_a.none())
@@ -17,8 +17,11 @@ static std::vector<Ray> read_input(std::istream& is, bool print_prefix)
 {
     std::vector<Ray> rays;
     while (true) {
-        if (print_prefix)
-            std::cout << ">> ";
+        if (print_prefix) {
+            // Log entries are written by a background thread and would interleave with the prompt otherwise
+            IG_LOGGER.flush();
+            std::cout << ">> " << std::flush;
+        }
 
         std::string line;
         if (!std::getline(is, line) || line.empty())
@@ -146,6 +149,7 @@ int main(int argc, char** argv)
 
         // Extract data
         if (cmd.Output.empty()) {
+            IG_LOGGER.flush();
             write_output(std::cout, accum_data.data(), rays.size(), runtime->currentIterationCount());
         } else {
             std::ofstream stream(cmd.Output, firstRound ? std::ofstream::out : (std::ofstream::out | std::ofstream::app));
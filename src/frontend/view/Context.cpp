@@ -64,7 +64,8 @@ public:
     bool LockInteraction                    = false;
     bool ZoomIsScale                        = false;
 
-    size_t Width = 0, Height = 0;
+    size_t Width = 0, Height = 0;             // Size of the window
+    size_t RenderWidth = 0, RenderHeight = 0; // Size of the framebuffer, which might be reduced while interacting
 
     // Stats
     LuminanceInfo LastLum;
@@ -125,14 +126,38 @@ public:
 
         IG_LOG(L_INFO) << "Resizing to " << width << "x" << height << std::endl;
 
-        Runtime->resizeFramebuffer((size_t)width, (size_t)height);
+        // The framebuffer is resized in applyResolutionScale, as the runtime might be busy
         Width  = width;
         Height = height;
-        setupTextureBuffer((size_t)width, (size_t)height);
 
         ui::notifyResize(Window, Renderer);
     }
 
+    bool applyResolutionScale(float scale)
+    {
+        const size_t width  = std::max<size_t>(1, (size_t)std::round(Width * scale));
+        const size_t height = std::max<size_t>(1, (size_t)std::round(Height * scale));
+        if (width == RenderWidth && height == RenderHeight)
+            return false;
+
+        Runtime->resizeFramebuffer(width, height);
+        RenderWidth  = width;
+        RenderHeight = height;
+        setupTextureBuffer(width, height);
+        return true;
+    }
+
+    // Map window coordinates to framebuffer coordinates. Returns false if outside the framebuffer
+    [[nodiscard]] inline bool mapToFramebuffer(int& x, int& y) const
+    {
+        if (x < 0 || x >= (int)Width || y < 0 || y >= (int)Height)
+            return false;
+
+        x = std::min((int)RenderWidth - 1, (int)(x * RenderWidth / Width));
+        y = std::min((int)RenderHeight - 1, (int)(y * RenderHeight / Height));
+        return true;
+    }
+
     [[nodiscard]] inline std::string currentAOVName() const
     {
         if (CurrentAOV == 0)
@@ -261,6 +286,8 @@ public:
                 case SDLK_F4:
                     ShowProperties = !ShowProperties;
                     break;
+                case SDLK_F5:
+                    return Context::InputResult::Reload;
                 case SDLK_F11:
                     if (io.KeyCtrl)
                         ScreenshotRequest = ScreenshotRequestMode::Full;
@@ -521,9 +548,6 @@ public:
         }
 
         LastCameraPose = CameraPose(cam);
-        if (Running && ZoomIsScale)
-            Runtime->setParameter("__camera_scale", DefaultCameraScale * CurrentZoom);
-
         return reset ? Context::InputResult::Reset : Context::InputResult::Continue;
     }
 
@@ -559,6 +583,9 @@ public:
 
     void updateSurface()
     {
+        if (Running && ZoomIsScale)
+            Runtime->setParameter("__camera_scale", DefaultCameraScale * CurrentZoom);
+
         const std::string aov_name = currentAOVName();
         analyzeLuminance();
 
@@ -573,7 +600,7 @@ public:
                              .ExposureFactor = ToneMapping_Automatic ? 1 / LastLum.Est : std::pow(2.0f, ToneMapping_Exposure),
                              .ExposureOffset = ToneMapping_Automatic ? 0 : ToneMapping_Offset });
 
-        SDL_UpdateTexture(Texture, nullptr, buf, static_cast<int>(Width * sizeof(uint32_t)));
+        SDL_UpdateTexture(Texture, nullptr, buf, static_cast<int>(RenderWidth * sizeof(uint32_t)));
     }
 
     [[nodiscard]] inline RGB getFilmData(size_t width, size_t height, uint32_t x, uint32_t y)
@@ -688,11 +715,13 @@ public:
                 int mouse_x, mouse_y;
                 SDL_GetMouseState(&mouse_x, &mouse_y);
                 RGB rgb{ 0, 0, 0 };
-                if (mouse_x >= 0 && mouse_x < (int)Width && mouse_y >= 0 && mouse_y < (int)Height)
-                    rgb = getFilmData(Width, Height, (uint32)mouse_x, (uint32)mouse_y);
+                if (mapToFramebuffer(mouse_x, mouse_y))
+                    rgb = getFilmData(RenderWidth, RenderHeight, (uint32)mouse_x, (uint32)mouse_y);
 
                 ImGui::Text("Iter %zu", Runtime->currentIterationCount());
                 ImGui::Text("SPP  %zu", Runtime->currentSampleCount());
+                if (RenderWidth != Width || RenderHeight != Height)
+                    ImGui::Text("Preview %zux%zu", RenderWidth, RenderHeight);
                 if (Parent->mSPPMode == SPPMode::Continuous)
                     ImGui::Text("Frame %zu", Runtime->currentFrameCount());
                 ImGui::Text("Cursor  (%f, %f, %f)", rgb.r, rgb.g, rgb.b);
@@ -702,7 +731,7 @@ public:
 
                 // Draw informative section
                 if (LastLum.InfCount > 0 || LastLum.NaNCount > 0 || LastLum.NegCount > 0) {
-                    const size_t pixel_comp_count = Width * Height * 3;
+                    const size_t pixel_comp_count = RenderWidth * RenderHeight * 3;
                     ImGui::PushStyleColor(ImGuiCol_Text, IM_COL32(200, 0, 0, 255));
                     if (LastLum.InfCount > 0)
                         ImGui::Text("Infinite %7.3f%%", 100 * LastLum.InfCount / (float)pixel_comp_count);
@@ -721,7 +750,7 @@ public:
                 ImPlot::PushStyleVar(ImPlotStyleVar_PlotPadding, ImVec2(0, 0));
                 if (ImPlot::BeginPlot("Histogram", ImVec2((int)HIST_W, 100), ImPlotFlags_NoTitle | ImPlotFlags_NoInputs | ImPlotFlags_NoMouseText | ImPlotFlags_NoBoxSelect | ImPlotFlags_NoMenus)) {
                     ImPlot::SetupAxes(nullptr, nullptr, ImPlotAxisFlags_NoDecorations, ImPlotAxisFlags_NoLabel | ImPlotAxisFlags_NoTickLabels);
-                    ImPlot::SetupAxesLimits(0, (double)HISTOGRAM_SIZE, 0, static_cast<double>(Width * Height), ImPlotCond_Always);
+                    ImPlot::SetupAxesLimits(0, (double)HISTOGRAM_SIZE, 0, static_cast<double>(RenderWidth * RenderHeight), ImPlotCond_Always);
                     ImPlot::SetupFinish();
 
                     constexpr double BarWidth = 0.67;
@@ -863,8 +892,9 @@ public:
         if (ShowInspector) {
             int mouse_x, mouse_y;
             SDL_GetMouseState(&mouse_x, &mouse_y);
+            mapToFramebuffer(mouse_x, mouse_y);
             const auto acc = currentPixels();
-            ui_inspect_image(mouse_x, mouse_y, Width, Height, Runtime->currentIterationCount() == 0 ? 1.0f : 1.0f / Runtime->currentIterationCount(), acc.Data, Buffer.data());
+            ui_inspect_image(mouse_x, mouse_y, RenderWidth, RenderHeight, Runtime->currentIterationCount() == 0 ? 1.0f : 1.0f / Runtime->currentIterationCount(), acc.Data, Buffer.data());
         }
 
         return result;
@@ -891,6 +921,8 @@ Context::Context(SPPMode sppmode, Runtime* runtime, bool showDebug, float dpi)
     mInternal->Parent        = this;
     mInternal->Width         = runtime->framebufferWidth();
     mInternal->Height        = runtime->framebufferHeight();
+    mInternal->RenderWidth   = mInternal->Width;
+    mInternal->RenderHeight  = mInternal->Height;
     mInternal->ShowDebugMode = showDebug;
     mInternal->ZoomIsScale   = runtime->camera() == "orthogonal";
 
@@ -917,7 +949,10 @@ Context::Context(SPPMode sppmode, Runtime* runtime, bool showDebug, float dpi)
         throw std::runtime_error("Could not setup UI");
     }
 
-    if (!mInternal->setupTextureBuffer(mInternal->Width, mInternal->Height))
+    // Reduced framebuffers are stretched to the window, which looks better with linear filtering
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "linear");
+
+    if (!mInternal->setupTextureBuffer(mInternal->RenderWidth, mInternal->RenderHeight))
         throw std::runtime_error("Could not setup UI");
 
     ui::setup(mInternal->Window, mInternal->Renderer, false, dpi);
@@ -985,6 +1020,8 @@ static void handleHelp()
 - *F3* to toggle the interaction lock. 
 - *F4* to toggle the properties window.
   If enabled, no view changing interaction is possible.
+- *F5* to reload changed materials and textures from the scene file.
+  Only available if started with *--hot-reload*.
 - *F11* to save a snapshot of the current rendering. HDR information will be preserved.
   Use with *Strg/Ctrl* to make a LDR screenshot of the current render including UI and tonemapping.  
   The image will be saved in the current working directory.
@@ -1061,6 +1098,11 @@ Context::UpdateResult Context::update()
     return result;
 }
 
+bool Context::applyResolutionScale(float scale)
+{
+    return mInternal->applyResolutionScale(scale);
+}
+
 void Context::setTravelSpeed(float v)
 {
     mInternal->CurrentTravelSpeed = std::max(1e-5f, v);
@@ -30,6 +30,7 @@ public:
         Resume,   // Resume the rendering
         Pause,    // Pause the rendering
         Reset,    // Reset the rendering
+        Reload,   // Reload changed materials and textures from the scene file
         Quit      // Quit the application
     };
     [[nodiscard]] InputResult handleInput(CameraProxy& cam);
@@ -38,8 +39,13 @@ public:
         Continue, // Continue, nothing of importance changed
         Reset     // Reset the rendering
     };
+    /// Tonemap and present the current framebuffer together with the UI. The runtime must not be busy
     [[nodiscard]] UpdateResult update();
 
+    /// Resize the framebuffer to the given fraction of the window size. Returns true if the framebuffer changed, which also resets the runtime.
+    /// The runtime must not be busy
+    bool applyResolutionScale(float scale);
+
     [[nodiscard]] inline DebugMode currentDebugMode() const { return mDebugMode; }
 
     void setTravelSpeed(float v);
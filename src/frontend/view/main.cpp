@@ -2,12 +2,16 @@
 #include "Context.h"
 #include "Logger.h"
 #include "ProgramOptions.h"
+#include "RenderQueue.h"
+#include "ResolutionController.h"
 #include "Runtime.h"
 #include "RuntimeInfo.h"
 #include "Timer.h"
 #include "UI.h"
 #include "config/Build.h"
 
+#include <fstream>
+
 using namespace IG;
 
 struct SectionTimer {
@@ -126,6 +130,16 @@ int main(int argc, char** argv)
 
     auto lastDebugMode = ui->currentDebugMode();
 
+    // Iterations are rendered in a separate thread, such that the window stays responsive while an iteration is in flight.
+    // The runtime is only accessed by the main thread if no iteration is pending
+    RenderQueue queue(*runtime);
+    std::future<void> pending;
+    float pendingScale = 1;
+    auto pendingStart  = std::chrono::high_resolution_clock::now();
+
+    ResolutionController resolution(cmd.SPPMode == SPPMode::Fixed && desired_iter != 0 ? 0.0f : cmd.TargetFrameTime, cmd.MinResolutionScale);
+    float currentScale = 1;
+
     IG_LOG(L_INFO) << "Started rendering..." << std::endl;
 
     bool running     = true;
@@ -135,11 +149,13 @@ int main(int argc, char** argv)
     size_t totalIter = 0; // Total number of iterations, without ever reseting
     std::vector<double> samples_stats;
 
-    bool request_reset = false;
+    bool request_reset  = false;
+    bool request_camera = false;
+    bool request_reload = false;
 
     SectionTimer timer_input;
     SectionTimer timer_ui;
-    SectionTimer timer_render;
+    size_t render_duration_ms = 0;
     while (!done) {
         timer_input.start();
         const auto input_result = ui->handleInput(camera);
@@ -154,94 +170,130 @@ int main(int argc, char** argv)
             running = false;
             break;
         case Context::InputResult::Reset:
-            runtime->setCameraOrientation(camera.asOrientation());
-            request_reset = true;
+            request_camera = true;
+            request_reset  = true;
+            resolution.notifyMotion();
+            break;
+        case Context::InputResult::Reload:
+            request_reload = true;
             break;
         default:
             break;
         }
-
-        if (lastDebugMode != ui->currentDebugMode()) {
-            runtime->setParameter("__debug_mode", (int)ui->currentDebugMode());
-            request_reset = true;
-            lastDebugMode = ui->currentDebugMode();
-        }
         timer_input.stop();
 
-        if (running) {
-            if (cmd.SPPMode != SPPMode::Capped || runtime->currentIterationCount() < desired_iter) {
-                if (cmd.SPPMode == SPPMode::Continuous && runtime->currentIterationCount() >= desired_iter) {
-                    runtime->reset();
-                    runtime->incFrameCount(); // Not affected by reset
-                    request_reset = false;
-                } else if (request_reset) {
-                    runtime->reset();
-                    request_reset = false;
-                }
-
-                const auto ticks = std::chrono::high_resolution_clock::now();
-
-                timer_render.start();
-                runtime->step();
-                ++totalIter;
-                timer_render.stop();
-
-                const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - ticks).count();
-
-                if (cmd.SPPMode == SPPMode::Fixed && desired_iter != 0) {
-                    samples_stats.emplace_back(1000.0 * double(SPI * runtime->framebufferWidth() * runtime->framebufferHeight()) / double(elapsed_ms));
-                    if (samples_stats.size() == desired_iter)
-                        break;
-                }
-
-                frames++;
-                timing += elapsed_ms;
-                if (frames > 10 || timing >= 2000) {
-                    const double frames_sec  = double(frames) * 1000.0 / double(timing);
-                    const double samples_sec = (runtime->currentIterationCount() == 0) ? 0.0 : frames_sec * runtime->currentSampleCount() / (float)runtime->currentIterationCount();
-
-                    std::ostringstream os;
-                    os << "Ignis [" << frames_sec << " FPS, "
-                       << samples_sec << " SPS, "
-                       << runtime->currentSampleCount() << " "
-                       << "sample" << (runtime->currentSampleCount() > 1 ? "s" : "") << "]";
-                    ui->setTitle(os.str());
-
-                    frames = 0;
-                    timing = 0;
-                }
-            } else {
-                std::ostringstream os;
-                os << "Ignis [Capped, "
-                   << runtime->currentSampleCount() << " "
-                   << "sample" << (runtime->currentSampleCount() > 1 ? "s" : "") << "]";
-                ui->setTitle(os.str());
+        if (pending.valid()) {
+            // Keep handling input while the iteration is in flight, but do not spin
+            if (pending.wait_for(std::chrono::milliseconds(2)) != std::future_status::ready)
+                continue;
+
+            pending.get();
+            ++totalIter;
+
+            const auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - pendingStart).count();
+            render_duration_ms += elapsed_ms;
+            resolution.reportIteration(pendingScale, (float)elapsed_ms);
+
+            if (cmd.SPPMode == SPPMode::Fixed && desired_iter != 0) {
+                samples_stats.emplace_back(1000.0 * double(SPI * runtime->framebufferWidth() * runtime->framebufferHeight()) / double(std::max<int64_t>(1, elapsed_ms)));
+                if (samples_stats.size() == desired_iter)
+                    break;
             }
-        } else {
+
             frames++;
+            timing += elapsed_ms;
+            if (frames > 10 || timing >= 2000) {
+                const double frames_sec  = double(frames) * 1000.0 / double(std::max<uint64_t>(1, timing));
+                const double samples_sec = (runtime->currentIterationCount() == 0) ? 0.0 : frames_sec * runtime->currentSampleCount() / (float)runtime->currentIterationCount();
 
-            if (input_result == Context::InputResult::Pause || frames > 100) {
                 std::ostringstream os;
-                os << "Ignis [Paused, "
+                os << "Ignis [" << frames_sec << " FPS, "
+                   << samples_sec << " SPS, "
                    << runtime->currentSampleCount() << " "
                    << "sample" << (runtime->currentSampleCount() > 1 ? "s" : "") << "]";
                 ui->setTitle(os.str());
+
                 frames = 0;
                 timing = 0;
             }
         }
 
+        // From here on the runtime is idle and can be accessed
+        if (lastDebugMode != ui->currentDebugMode()) {
+            runtime->setParameter("__debug_mode", (int)ui->currentDebugMode());
+            request_reset = true;
+            lastDebugMode = ui->currentDebugMode();
+        }
+
         timer_ui.start();
         switch (ui->update()) {
         case Context::UpdateResult::Reset:
             request_reset = true;
+            resolution.notifyMotion();
             break;
         default:
             break;
         }
         timer_ui.stop();
+
+        if (request_camera) {
+            runtime->setCameraOrientation(camera.asOrientation());
+            request_camera = false;
+        }
+
+        if (request_reload) {
+            if (!cmd.HotReload)
+                IG_LOG(L_WARNING) << "Reloading requires the viewer to be started with --hot-reload" << std::endl;
+            else if (runtime->reloadFromFile(cmd.InputScene))
+                request_reset = true;
+            else
+                IG_LOG(L_WARNING) << "Could not reload " << cmd.InputScene << ". Restart the viewer to apply the changes" << std::endl;
+            request_reload = false;
+        }
+
+        // Resizing resets the framebuffer, therefore only do it after the current result was presented
+        currentScale = resolution.scale();
+        if (ui->applyResolutionScale(currentScale))
+            request_reset = false; // Already reset
+
+        if (!running) {
+            frames++;
+
+            if (input_result == Context::InputResult::Pause || frames > 100) {
+                std::ostringstream os;
+                os << "Ignis [Paused, "
+                   << runtime->currentSampleCount() << " "
+                   << "sample" << (runtime->currentSampleCount() > 1 ? "s" : "") << "]";
+                ui->setTitle(os.str());
+                frames = 0;
+                timing = 0;
+            }
+            continue;
+        }
+
+        if (cmd.SPPMode != SPPMode::Capped || runtime->currentIterationCount() < desired_iter) {
+            if (cmd.SPPMode == SPPMode::Continuous && runtime->currentIterationCount() >= desired_iter) {
+                runtime->reset();
+                runtime->incFrameCount(); // Not affected by reset
+                request_reset = false;
+            } else if (request_reset) {
+                runtime->reset();
+                request_reset = false;
+            }
+
+            pendingScale = currentScale;
+            pendingStart = std::chrono::high_resolution_clock::now();
+            pending      = queue.step();
+        } else {
+            std::ostringstream os;
+            os << "Ignis [Capped, "
+               << runtime->currentSampleCount() << " "
+               << "sample" << (runtime->currentSampleCount() > 1 ? "s" : "") << "]";
+            ui->setTitle(os.str());
+        }
     }
 
+    queue.wait();
     ui.reset();
 
     SectionTimer timer_saving;
@@ -259,7 +311,7 @@ int main(int argc, char** argv)
     auto stats = runtime->statistics();
     if (stats) {
         IG_LOG(L_INFO)
-            << stats->dump(timer_all.duration_ms, totalIter, cmd.AcquireFullStats)
+            << stats->dump(timer_all.duration_ms, totalIter, cmd.AcquireFullStats, &runtime->statisticNames())
             << "  Iterations: " << runtime->currentIterationCount() << " (total: " << totalIter << ")" << std::endl
             << "  SPP: " << runtime->currentSampleCount() << std::endl
             << "  SPI: " << SPI << std::endl
@@ -267,8 +319,17 @@ int main(int argc, char** argv)
             << "    Loading> " << beautiful_time(timer_loading.duration_ms) << std::endl
             << "    Input>   " << beautiful_time(timer_input.duration_ms) << std::endl
             << "    UI>      " << beautiful_time(timer_ui.duration_ms) << std::endl
-            << "    Render>  " << beautiful_time(timer_render.duration_ms) << std::endl
-            << "    Saving>  " << beautiful_time(timer_saving.duration_ms) << std::endl;
+            << "    Render>  " << beautiful_time(render_duration_ms) << std::endl
+            << "    Saving>  " << beautiful_time(timer_saving.duration_ms) << std::endl
+            << runtime->memoryUsage().dump(&runtime->peakMemoryUsage());
+
+        if (!cmd.StatsFile.empty()) {
+            std::ofstream stream(cmd.StatsFile);
+            if (stream)
+                stream << stats->dumpJSON(timer_all.duration_ms, totalIter, &runtime->statisticNames()) << std::endl;
+            else
+                IG_LOG(L_ERROR) << "Could not write stats to " << cmd.StatsFile << std::endl;
+        }
     }
 
     runtime.reset();
@@ -0,0 +1,202 @@
+#include "AdaptiveSampler.h"
+#include "Logger.h"
+#include "device/IRenderDevice.h"
+
+IG_BEGIN_IGNORE_WARNINGS
+#include <tbb/blocked_range.h>
+#include <tbb/blocked_range2d.h>
+#include <tbb/combinable.h>
+#include <tbb/parallel_for.h>
+IG_END_IGNORE_WARNINGS
+
+namespace IG {
+static inline float luminance(const float* rgb)
+{
+    return 0.2126f * rgb[0] + 0.7152f * rgb[1] + 0.0722f * rgb[2];
+}
+
+template <typename Func>
+static inline void parallel_pixels(size_t count, Func func)
+{
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, count),
+                      [&](tbb::blocked_range<size_t> r) {
+                          for (size_t i = r.begin(); i < r.end(); ++i)
+                              func(i);
+                      });
+}
+
+AdaptiveSampler::AdaptiveSampler(const AdaptiveSamplingSettings& settings, size_t width, size_t height)
+    : mSettings(settings)
+    , mWidth(width)
+    , mHeight(height)
+    , mDisabled(false)
+    , mActivePixels(width * height)
+    , mMaxError(0)
+{
+}
+
+void AdaptiveSampler::reset(IRenderDevice* device, size_t width, size_t height)
+{
+    mWidth  = width;
+    mHeight = height;
+
+    const size_t pixels = mWidth * mHeight;
+    mPrevious.assign(pixels, 0.0f);
+    mSum.assign(pixels, 0.0f);
+    mSumSquared.assign(pixels, 0.0f);
+    mCount.assign(pixels, 0);
+    mSamples.assign(pixels, 0);
+    mMask.assign(pixels, 0);
+
+    mActivePixels = pixels;
+    mMaxError     = 0;
+
+    uploadMask(device);
+}
+
+void AdaptiveSampler::uploadMask(IRenderDevice* device)
+{
+    device->copyBufferFromHost(MaskBufferName, mMask.data(), mMask.size() * sizeof(int32));
+}
+
+void AdaptiveSampler::resume(IRenderDevice* device)
+{
+    reset(device, device->framebufferWidth(), device->framebufferHeight());
+
+    const float* color = device->getFramebufferForHost({}).Data;
+    if (!color)
+        return;
+
+    parallel_pixels(mWidth * mHeight, [&](size_t i) { mPrevious[i] = luminance(&color[3 * i]); });
+}
+
+void AdaptiveSampler::update(IRenderDevice* device, size_t iteration, size_t spi, const std::vector<std::string>& fill_aovs)
+{
+    IG_ASSERT(iteration > 0, "Expected update to be called after an iteration");
+
+    if (device->framebufferWidth() != mWidth || device->framebufferHeight() != mHeight || mMask.size() != mWidth * mHeight)
+        reset(device, device->framebufferWidth(), device->framebufferHeight());
+
+    const size_t pixels = mWidth * mHeight;
+
+    // Fill skipped pixels with their current estimate: (n-1) * mean + mean = n * mean
+    if (iteration > 1 && mActivePixels < pixels) {
+        const float factor = 1.0f / (iteration - 1);
+
+        const auto fill = [&](const std::string& name) {
+            float* data = device->getFramebufferForHost(name).Data;
+            if (!data)
+                return;
+
+            parallel_pixels(pixels, [&](size_t i) {
+                if (mMask[i] == 0)
+                    return;
+                for (size_t c = 0; c < 3; ++c)
+                    data[3 * i + c] += data[3 * i + c] * factor;
+            });
+            device->syncFramebufferHostToDevice(name);
+        };
+
+        fill({});
+        for (const auto& aov : fill_aovs)
+            fill(aov);
+    }
+
+    // Update statistics of the iteration estimates
+    const float* color = device->getFramebufferForHost({}).Data;
+    IG_ASSERT(color, "Expected valid framebuffer");
+
+    parallel_pixels(pixels, [&](size_t i) {
+        const float current = luminance(&color[3 * i]);
+        if (mMask[i] == 0) {
+            const float x = current - mPrevious[i];
+            mSum[i] += x;
+            mSumSquared[i] += x * x;
+            mCount[i] += 1;
+            mSamples[i] += (uint32)spi;
+        }
+        mPrevious[i] = current;
+    });
+
+    // Compute error per tile
+    const size_t tileSize = std::max<size_t>(1, mSettings.TileSize);
+    const size_t tilesX   = (mWidth + tileSize - 1) / tileSize;
+    const size_t tilesY   = (mHeight + tileSize - 1) / tileSize;
+
+    std::vector<float> variance(pixels, 0.0f);
+    tbb::combinable<size_t> activeCount([] { return size_t(0); });
+    tbb::combinable<float> maxError([] { return 0.0f; });
+
+    tbb::parallel_for(tbb::blocked_range2d<size_t>(0, tilesY, 0, tilesX),
+                      [&](const tbb::blocked_range2d<size_t>& r) {
+                          for (size_t ty = r.rows().begin(); ty < r.rows().end(); ++ty) {
+                              for (size_t tx = r.cols().begin(); tx < r.cols().end(); ++tx) {
+                                  const size_t x0 = tx * tileSize;
+                                  const size_t y0 = ty * tileSize;
+                                  const size_t x1 = std::min(mWidth, x0 + tileSize);
+                                  const size_t y1 = std::min(mHeight, y0 + tileSize);
+
+                                  float tileError = 0;
+                                  bool wasActive  = false;
+                                  for (size_t y = y0; y < y1; ++y) {
+                                      for (size_t x = x0; x < x1; ++x) {
+                                          const size_t i = y * mWidth + x;
+                                          wasActive |= mMask[i] == 0;
+
+                                          const float k = (float)mCount[i];
+                                          if (k < 2) {
+                                              tileError = std::numeric_limits<float>::infinity();
+                                              continue;
+                                          }
+
+                                          const float mean     = mSum[i] / k;
+                                          const float var      = std::max(0.0f, (mSumSquared[i] - mSum[i] * mean) / (k - 1));
+                                          const float varMean  = var / k;
+                                          const float relError = std::sqrt(varMean) / std::max(mean, 1e-3f);
+                                          variance[i]          = varMean;
+                                          tileError            = std::max(tileError, relError);
+                                      }
+                                  }
+
+                                  if (!wasActive)
+                                      continue; // Converged tiles stay converged
+
+                                  const bool converged = !mDisabled
+                                                         && iteration >= std::max<size_t>(2, mSettings.MinIterations)
+                                                         && tileError <= mSettings.TargetError;
+
+                                  for (size_t y = y0; y < y1; ++y) {
+                                      for (size_t x = x0; x < x1; ++x)
+                                          mMask[y * mWidth + x] = converged ? 1 : 0;
+                                  }
+
+                                  if (!converged) {
+                                      activeCount.local() += (x1 - x0) * (y1 - y0);
+                                      if (std::isfinite(tileError))
+                                          maxError.local() = std::max(maxError.local(), tileError);
+                                  }
+                              }
+                          }
+                      });
+
+    mActivePixels = activeCount.combine(std::plus<size_t>());
+    mMaxError     = maxError.combine([](float a, float b) { return std::max(a, b); });
+
+    // Write informative AOVs. These are not normalized by the iteration count
+    if (float* data = device->getFramebufferForHost(VarianceAOV, false).Data) {
+        parallel_pixels(pixels, [&](size_t i) {
+            data[3 * i + 0] = data[3 * i + 1] = data[3 * i + 2] = variance[i];
+        });
+        device->syncFramebufferHostToDevice(VarianceAOV);
+    }
+
+    if (float* data = device->getFramebufferForHost(SampleCountAOV, false).Data) {
+        parallel_pixels(pixels, [&](size_t i) {
+            data[3 * i + 0] = data[3 * i + 1] = data[3 * i + 2] = (float)mSamples[i];
+        });
+        device->syncFramebufferHostToDevice(SampleCountAOV);
+    }
+
+    uploadMask(device);
+}
+} // namespace IG
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "RuntimeSettings.h"
+
+namespace IG {
+class IRenderDevice;
+
+/// Estimates the per-pixel error between iterations and marks converged tiles, which will be skipped by the ray generation.
+/// Skipped pixels are filled with their current estimate, such that the usual normalization by the iteration count stays valid.
+class IG_LIB AdaptiveSampler {
+public:
+    static constexpr const char* MaskBufferName = "__adaptive_mask";
+    static constexpr const char* VarianceAOV    = "Variance";
+    static constexpr const char* SampleCountAOV = "EffectiveSPP";
+
+    AdaptiveSampler(const AdaptiveSamplingSettings& settings, size_t width, size_t height);
+
+    /// Reset all estimates and mark all pixels as active. Will also upload the mask to the device
+    void reset(IRenderDevice* device, size_t width, size_t height);
+
+    /// Use the current framebuffer as starting point for the estimates, e.g., after restoring a checkpoint
+    void resume(IRenderDevice* device);
+
+    /// Update estimates after an iteration. The iteration count includes the current iteration
+    /// @param fill_aovs List of AOVs which are accumulated over iterations and have to be filled for skipped pixels
+    void update(IRenderDevice* device, size_t iteration, size_t spi, const std::vector<std::string>& fill_aovs);
+
+    /// True if the technique is incompatible with adaptive sampling. Convergence will never be signaled
+    inline void disable() { mDisabled = true; }
+
+    [[nodiscard]] inline size_t activePixelCount() const { return mActivePixels; }
+    [[nodiscard]] inline bool isConverged() const { return !mDisabled && mActivePixels == 0; }
+    /// Maximum relative error of all active tiles estimated in the last update
+    [[nodiscard]] inline float maxError() const { return mMaxError; }
+
+private:
+    void uploadMask(IRenderDevice* device);
+
+    const AdaptiveSamplingSettings mSettings;
+    size_t mWidth;
+    size_t mHeight;
+    bool mDisabled;
+
+    // Per pixel statistics of the luminance of each iteration estimate
+    std::vector<float> mPrevious; // Framebuffer luminance after the last update
+    std::vector<float> mSum;
+    std::vector<float> mSumSquared;
+    std::vector<uint32> mCount;   // Number of iterations the pixel was sampled
+    std::vector<uint32> mSamples; // Number of samples the pixel was sampled
+
+    std::vector<int32> mMask; // Non-zero if converged
+    size_t mActivePixels;
+    float mMaxError;
+};
+} // namespace IG
@@ -0,0 +1,132 @@
+#include "BlueNoise.h"
+#include "serialization/FileSerializer.h"
+
+#include <random>
+
+namespace IG {
+constexpr float BlueNoiseSigma = 1.9f;
+
+/// Rank all pixels of a size x size torus with the void-and-cluster method by Ulichney
+static std::vector<size_t> voidAndCluster(size_t size, uint32 seed)
+{
+    const size_t count = size * size;
+
+    // Gaussian energy contributed by a point as function of the toroidal offset
+    std::vector<float> kernel(count);
+    for (size_t y = 0; y < size; ++y) {
+        for (size_t x = 0; x < size; ++x) {
+            const float dx       = (float)std::min(x, size - x);
+            const float dy       = (float)std::min(y, size - y);
+            kernel[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2 * BlueNoiseSigma * BlueNoiseSigma));
+        }
+    }
+
+    std::vector<bool> pattern(count, false);
+    std::vector<float> energy(count, 0.0f);
+
+    const auto toggle = [&](size_t p) {
+        pattern[p]       = !pattern[p];
+        const float sign = pattern[p] ? 1.0f : -1.0f;
+        const size_t px  = p % size;
+        const size_t py  = p / size;
+        for (size_t y = 0; y < size; ++y) {
+            const size_t ky = (y + size - py) % size;
+            for (size_t x = 0; x < size; ++x)
+                energy[y * size + x] += sign * kernel[ky * size + (x + size - px) % size];
+        }
+    };
+
+    const auto tightestCluster = [&]() {
+        size_t best = 0;
+        float value = -std::numeric_limits<float>::infinity();
+        for (size_t p = 0; p < count; ++p) {
+            if (pattern[p] && energy[p] > value) {
+                value = energy[p];
+                best  = p;
+            }
+        }
+        return best;
+    };
+
+    const auto largestVoid = [&]() {
+        size_t best = 0;
+        float value = std::numeric_limits<float>::infinity();
+        for (size_t p = 0; p < count; ++p) {
+            if (!pattern[p] && energy[p] < value) {
+                value = energy[p];
+                best  = p;
+            }
+        }
+        return best;
+    };
+
+    // Start with a random pattern of minority pixels
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> dist(0, count - 1);
+    const size_t initialCount = std::max<size_t>(1, count / 10);
+    for (size_t ones = 0; ones < initialCount;) {
+        const size_t p = dist(rng);
+        if (!pattern[p]) {
+            toggle(p);
+            ++ones;
+        }
+    }
+
+    // Distribute the pattern evenly by moving the tightest cluster into the largest void until it converges
+    for (size_t i = 0; i < count; ++i) {
+        const size_t cluster = tightestCluster();
+        toggle(cluster);
+        const size_t hole = largestVoid();
+        toggle(hole);
+        if (hole == cluster)
+            break;
+    }
+
+    const std::vector<bool> initialPattern = pattern;
+    const std::vector<float> initialEnergy = energy;
+
+    // Rank the initial pattern by removing the tightest clusters first
+    std::vector<size_t> ranks(count);
+    for (size_t rank = initialCount; rank > 0; --rank) {
+        const size_t cluster = tightestCluster();
+        toggle(cluster);
+        ranks[cluster] = rank - 1;
+    }
+
+    // Rank the remaining pixels by filling the largest voids first.
+    // Filling the largest void is equivalent to removing the tightest cluster of the inverted pattern, therefore this covers the second half as well
+    pattern = initialPattern;
+    energy  = initialEnergy;
+    for (size_t rank = initialCount; rank < count; ++rank) {
+        const size_t hole = largestVoid();
+        toggle(hole);
+        ranks[hole] = rank;
+    }
+
+    return ranks;
+}
+
+std::vector<float> BlueNoise::generateMask(size_t size)
+{
+    const size_t count = size * size;
+
+    // Different seeds give (nearly) uncorrelated channels
+    const auto ranks0 = voidAndCluster(size, 0);
+    const auto ranks1 = voidAndCluster(size, 1);
+
+    std::vector<float> mask(2 * count);
+    for (size_t p = 0; p < count; ++p) {
+        mask[2 * p + 0] = (ranks0[p] + 0.5f) / count;
+        mask[2 * p + 1] = (ranks1[p] + 0.5f) / count;
+    }
+    return mask;
+}
+
+void BlueNoise::computeMask(size_t size, const Path& out)
+{
+    const auto mask = generateMask(size);
+
+    FileSerializer serializer(out, false);
+    serializer.write(mask, true);
+}
+} // namespace IG
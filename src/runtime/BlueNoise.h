@@ -0,0 +1,13 @@
+#pragma once
+
+#include "IG_Config.h"
+
+namespace IG {
+class IG_LIB BlueNoise {
+public:
+    /// Generate a tileable size x size blue-noise mask with two uncorrelated channels per pixel.
+    /// The values are uniformly distributed in [0, 1) and stored interleaved as floats
+    static std::vector<float> generateMask(size_t size);
+    static void computeMask(size_t size, const Path& out);
+};
+} // namespace IG
@@ -3,7 +3,7 @@
 #include "Image.h"
 
 namespace IG {
-class CDF {
+class IG_LIB CDF {
 public:
     static void computeForArray(const std::vector<float>& values, const Path& out);
     static void computeForImage(const Image& image, const Path& out,
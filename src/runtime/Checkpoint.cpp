@@ -0,0 +1,109 @@
+#include "Checkpoint.h"
+#include "Logger.h"
+#include "serialization/FileSerializer.h"
+
+namespace IG {
+constexpr uint32 CheckpointMagic   = 0x4B434749; // IGCK
+constexpr uint32 CheckpointVersion = 1;
+
+void Checkpoint::write(Serializer& serializer) const
+{
+    serializer.write(CheckpointMagic);
+    serializer.write(CheckpointVersion);
+    serializer.write(Width);
+    serializer.write(Height);
+    serializer.write(Iteration);
+    serializer.write(SampleCount);
+    serializer.write(Frame);
+    serializer.write(Seed);
+    serializer.write(Technique);
+    serializer.write(Camera);
+
+    serializer.write((uint64)Buffers.size());
+    for (const auto& [name, buffer] : Buffers) {
+        serializer.write(name);
+        serializer.write(buffer);
+    }
+}
+
+bool Checkpoint::read(Serializer& serializer)
+{
+    uint32 magic   = 0;
+    uint32 version = 0;
+    serializer.read(magic);
+    serializer.read(version);
+    if (magic != CheckpointMagic) {
+        IG_LOG(L_ERROR) << "Given data is not a checkpoint" << std::endl;
+        return false;
+    }
+    if (version != CheckpointVersion) {
+        IG_LOG(L_ERROR) << "Checkpoint has unsupported version " << version << std::endl;
+        return false;
+    }
+
+    serializer.read(Width);
+    serializer.read(Height);
+    serializer.read(Iteration);
+    serializer.read(SampleCount);
+    serializer.read(Frame);
+    serializer.read(Seed);
+    serializer.read(Technique);
+    serializer.read(Camera);
+
+    uint64 count = 0;
+    serializer.read(count);
+
+    const size_t expected = Width * Height * 3;
+    Buffers.clear();
+    for (uint64 i = 0; i < count; ++i) {
+        std::string name;
+        std::vector<float> buffer;
+        serializer.read(name);
+        serializer.read(buffer);
+
+        if (buffer.size() != expected) {
+            IG_LOG(L_ERROR) << "Checkpoint has buffer '" << name << "' with invalid size" << std::endl;
+            return false;
+        }
+        Buffers[name] = std::move(buffer);
+    }
+
+    return true;
+}
+
+bool Checkpoint::save(const Path& path) const
+{
+    Path tmp_path = path;
+    tmp_path += ".tmp";
+
+    {
+        FileSerializer serializer(tmp_path, false);
+        if (!serializer.isValid()) {
+            IG_LOG(L_ERROR) << "Could not open " << tmp_path << " for writing a checkpoint" << std::endl;
+            return false;
+        }
+
+        write(serializer);
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp_path, path, ec);
+    if (ec) {
+        IG_LOG(L_ERROR) << "Could not write checkpoint " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool Checkpoint::load(const Path& path)
+{
+    FileSerializer serializer(path, true);
+    if (!serializer.isValid()) {
+        IG_LOG(L_ERROR) << "Could not open checkpoint " << path << std::endl;
+        return false;
+    }
+
+    return read(serializer);
+}
+} // namespace IG
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "IG_Config.h"
+
+namespace IG {
+class Serializer;
+
+/// Snapshot of an ongoing rendering session. The accumulated (not normalized) framebuffer and all AOVs are stored together with the counters,
+/// such that rendering can be continued later on. The random seeds stay decorrelated as the iteration counter continues.
+struct IG_LIB Checkpoint {
+    uint64 Width       = 0;
+    uint64 Height      = 0;
+    uint64 Iteration   = 0;
+    uint64 SampleCount = 0;
+    uint64 Frame       = 0;
+    uint64 Seed        = 0;
+    std::string Technique;
+    std::string Camera;
+    /// Accumulated buffers with three channels per pixel. The empty name denotes the actual framebuffer
+    std::unordered_map<std::string, std::vector<float>> Buffers;
+
+    /// Write to the given serializer
+    void write(Serializer& serializer) const;
+    /// Read from the given serializer. Returns false if the data is not a valid checkpoint
+    [[nodiscard]] bool read(Serializer& serializer);
+
+    /// Save to the given path. The file is written to a temporary file first and replaced afterwards, such that a crash does not corrupt previous checkpoints
+    bool save(const Path& path) const;
+    /// Load from the given path. Returns false if the file is not a valid checkpoint
+    [[nodiscard]] bool load(const Path& path);
+};
+} // namespace IG
@@ -6,7 +6,9 @@
 #include <thread>
 
 #ifdef IG_OS_LINUX
+#include <csignal>
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -30,24 +32,41 @@ constexpr int InvalidPipe = -1;
 constexpr int PipeRead    = 0;
 constexpr int PipeWrite   = 1;
 
+// Only async-signal-safe calls are allowed in the forked child. Especially the logger must not be used,
+// as its background thread only exists in the parent and flushing would wait forever
+[[noreturn]] static void childFailure(const char* msg)
+{
+    const char* reason = std::strerror(errno);
+    const auto print   = [](const char* str) { [[maybe_unused]] const auto _ = write(STDERR_FILENO, str, std::strlen(str)); };
+    print(msg);
+    print(": ");
+    print(reason);
+    print("\n");
+    _exit(127);
+}
+
 class ExternalProcessInternal {
 public:
     const Path exePath;
     const std::vector<std::string> cmdParameters;
     const Path logFile;
+    const bool persistent;
 
     pid_t pid;
     mutable int exit_code;
 
     int stdIn[2];
+    int stdOut[2]; // Only used if persistent
 
-    inline ExternalProcessInternal(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile)
+    inline ExternalProcessInternal(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile, bool persistent)
         : exePath(exe)
         , cmdParameters(parameters)
         , logFile(logFile)
+        , persistent(persistent)
         , pid(-1)
         , exit_code(-1)
         , stdIn{ InvalidPipe, InvalidPipe }
+        , stdOut{ InvalidPipe, InvalidPipe }
     {
         IG_UNUSED(name);
     }
@@ -56,6 +75,8 @@ public:
     {
         if (stdIn[PipeWrite] != InvalidPipe)
             close(stdIn[PipeWrite]);
+        if (stdOut[PipeRead] != InvalidPipe)
+            close(stdOut[PipeRead]);
 
         // Remove empty logs
         if (std::filesystem::file_size(logFile) == 0)
@@ -70,6 +91,11 @@ public:
             return false;
         }
 
+        if (persistent && pipe(stdOut) < 0) {
+            IG_LOG(L_ERROR) << "Initializing stdout for process " << exePath << " failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+
         int tmpOut = open(logFile.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
         if (tmpOut < 0) {
             IG_LOG(L_ERROR) << "Getting file handle for temporary file for process " << exePath << " failed: " << std::strerror(errno) << std::endl;
@@ -93,31 +119,27 @@ public:
 
             // Redirect stdin
             if (dup2(stdIn[PipeRead], STDIN_FILENO) == -1)
-                IG_LOG(L_FATAL) << "dup2 for stdin of process failed: " << std::strerror(errno) << std::endl;
+                childFailure("dup2 for stdin of process failed");
 
-            // // Redirect stdout
-            if (dup2(tmpOut, STDOUT_FILENO) == -1)
-                IG_LOG(L_FATAL) << "dup2 for stdout of process failed: " << std::strerror(errno) << std::endl;
+            // Redirect stdout
+            if (dup2(persistent ? stdOut[PipeWrite] : tmpOut, STDOUT_FILENO) == -1)
+                childFailure("dup2 for stdout of process failed");
 
             // Redirect stderr
             if (dup2(tmpOut, STDERR_FILENO) == -1)
-                IG_LOG(L_FATAL) << "dup2 for stderr of process failed: " << std::strerror(errno) << std::endl;
+                childFailure("dup2 for stderr of process failed");
 
             // all these are for use by parent only
             close(stdIn[PipeRead]);
             close(stdIn[PipeWrite]);
+            if (persistent) {
+                close(stdOut[PipeRead]);
+                close(stdOut[PipeWrite]);
+            }
             close(tmpOut);
 
-            if (execv(parameters[0], (char**)parameters) == -1)
-                IG_LOG(L_FATAL) << "fork/exec of process failed: " << std::strerror(errno) << std::endl;
-
-            std::exit(-1);
-
-#if IG_CC_MSC
-            __assume(false);
-#else // GCC, Clang
-            __builtin_unreachable();
-#endif
+            execv(parameters[0], (char**)parameters);
+            childFailure("fork/exec of process failed");
         } else {
             // -> Parent process
             delete[] parameters;
@@ -125,6 +147,10 @@ public:
             // Close unnecessary handles
             close(stdIn[PipeRead]);
             stdIn[PipeRead] = InvalidPipe;
+            if (persistent) {
+                close(stdOut[PipeWrite]);
+                stdOut[PipeWrite] = InvalidPipe;
+            }
             close(tmpOut);
 
             // Check for error
@@ -171,6 +197,12 @@ public:
         // std::this_thread::sleep_for(20ms);
     }
 
+    inline void terminate()
+    {
+        if (pid != -1)
+            ::kill(pid, SIGKILL);
+    }
+
     inline void waitForFinish()
     {
         if (pid == -1)
@@ -188,26 +220,82 @@ public:
 
     inline bool sendOnce(const std::string& data)
     {
-        if (pid == -1)
+        const bool ok = send(data);
+        closeInput();
+        return ok;
+    }
+
+    inline bool send(const std::string& data)
+    {
+        if (pid == -1 || stdIn[PipeWrite] == InvalidPipe)
             return false;
 
+        // Block SIGPIPE for this thread, such that writing to a terminated process returns an error instead of terminating the caller
+        sigset_t pipeSet;
+        sigset_t oldSet;
+        sigemptyset(&pipeSet);
+        sigaddset(&pipeSet, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &pipeSet, &oldSet);
+
         size_t written = 0;
         while (written < data.size()) {
             size_t toWrite = data.size() - written;
             int result     = write(stdIn[PipeWrite], data.c_str() + written, toWrite);
             if (result < 0) {
+                if (errno == EINTR)
+                    continue;
+                if (errno == EPIPE) {
+                    // Consume the pending signal before unblocking it again
+                    const timespec noWait{ 0, 0 };
+                    sigtimedwait(&pipeSet, nullptr, &noWait);
+                }
                 IG_LOG(L_ERROR) << "write for " << exePath << " (" << pid << " | " << logFile << ") failed: " << std::strerror(errno) << std::endl;
                 break;
             }
             written += (size_t)result;
         }
 
-        close(stdIn[PipeWrite]);
-        stdIn[PipeWrite] = InvalidPipe;
-
+        pthread_sigmask(SIG_SETMASK, &oldSet, nullptr);
         return written >= data.size();
     }
 
+    inline bool receive(size_t size, std::string& data)
+    {
+        if (pid == -1 || stdOut[PipeRead] == InvalidPipe)
+            return false;
+
+        data.resize(size);
+        size_t received = 0;
+        while (received < size) {
+            const auto result = read(stdOut[PipeRead], data.data() + received, size - received);
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                return false; // Error or end of stream, most likely as the process terminated
+            received += (size_t)result;
+        }
+        return true;
+    }
+
+    inline bool receiveLine(std::string& line)
+    {
+        line.clear();
+        std::string c;
+        while (receive(1, c)) {
+            if (c[0] == '\n')
+                return true;
+            line += c[0];
+        }
+        return false;
+    }
+
+    inline void closeInput()
+    {
+        if (stdIn[PipeWrite] != InvalidPipe)
+            close(stdIn[PipeWrite]);
+        stdIn[PipeWrite] = InvalidPipe;
+    }
+
     inline std::string receiveOnce()
     {
         if (pid == -1)
@@ -238,16 +326,19 @@ public:
     const Path exePath;
     const std::vector<std::string> cmdParameters;
     const Path logFile;
+    const bool persistent;
 
     PROCESS_INFORMATION pi;
 
     HANDLE stdInWr    = INVALID_HANDLE_VALUE;
     HANDLE stdOutFile = INVALID_HANDLE_VALUE;
+    HANDLE stdOutRd   = INVALID_HANDLE_VALUE; // Only used if persistent
 
-    inline ExternalProcessInternal(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile)
+    inline ExternalProcessInternal(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile, bool persistent)
         : exePath(exe)
         , cmdParameters(parameters)
         , logFile(logFile)
+        , persistent(persistent)
     {
         IG_UNUSED(name);
 
@@ -269,6 +360,9 @@ public:
         if (stdInWr != INVALID_HANDLE_VALUE)
             CloseHandle(stdInWr);
 
+        if (stdOutRd != INVALID_HANDLE_VALUE)
+            CloseHandle(stdOutRd);
+
         // Remove empty logs
         if (std::filesystem::file_size(logFile) == 0)
             std::filesystem::remove(logFile);
@@ -317,12 +411,25 @@ public:
             return false;
         }
 
+        HANDLE stdOutWr = INVALID_HANDLE_VALUE;
+        if (persistent) {
+            if (!CreatePipe(&stdOutRd, &stdOutWr, &saAttr, 0)) {
+                IG_LOG(L_ERROR) << "CreatePipe failed: " << std::system_category().message(GetLastError()) << std::endl;
+                return false;
+            }
+
+            if (!SetHandleInformation(stdOutRd, HANDLE_FLAG_INHERIT, 0)) {
+                IG_LOG(L_ERROR) << "SetHandleInformation failed: " << std::system_category().message(GetLastError()) << std::endl;
+                return false;
+            }
+        }
+
         // Setup process
         STARTUPINFOW si;
         ZeroMemory(&si, sizeof(si));
         si.cb         = sizeof(si);
         si.hStdError  = stdOutFile;
-        si.hStdOutput = stdOutFile;
+        si.hStdOutput = persistent ? stdOutWr : stdOutFile;
         si.hStdInput  = stdInRd;
         si.dwFlags |= STARTF_USESTDHANDLES;
 
@@ -353,6 +460,9 @@ public:
         if (stdInRd != INVALID_HANDLE_VALUE)
             CloseHandle(stdInRd);
 
+        if (stdOutWr != INVALID_HANDLE_VALUE)
+            CloseHandle(stdOutWr);
+
         return true;
     }
 
@@ -379,6 +489,12 @@ public:
         //     IG_LOG(L_ERROR) << "WaitForInputIdle failed: " << std::system_category().message(GetLastError()) << std::endl;
     }
 
+    inline void terminate()
+    {
+        if (!TerminateProcess(pi.hProcess, 1))
+            IG_LOG(L_ERROR) << "TerminateProcess failed: " << std::system_category().message(GetLastError()) << std::endl;
+    }
+
     inline void waitForFinish()
     {
         if (WaitForSingleObject(pi.hProcess, INFINITE) == WAIT_FAILED)
@@ -387,6 +503,19 @@ public:
 
     inline bool sendOnce(const std::string& data)
     {
+        const bool ok = send(data);
+
+        // Close to signalize pipe finished!
+        closeInput();
+
+        return ok;
+    }
+
+    inline bool send(const std::string& data)
+    {
+        if (stdInWr == INVALID_HANDLE_VALUE)
+            return false;
+
         size_t written = 0;
         while (written < data.size()) {
             DWORD dwWrite   = (DWORD)(data.size() - written);
@@ -398,12 +527,42 @@ public:
             written += dwWritten;
         }
 
-        // Close to signalize pipe finished!
+        return written >= data.size();
+    }
+
+    inline bool receive(size_t size, std::string& data)
+    {
+        if (stdOutRd == INVALID_HANDLE_VALUE)
+            return false;
+
+        data.resize(size);
+        size_t received = 0;
+        while (received < size) {
+            DWORD dwRead = 0;
+            if (!ReadFile(stdOutRd, data.data() + received, (DWORD)(size - received), &dwRead, NULL) || dwRead == 0)
+                return false; // Error or end of stream, most likely as the process terminated
+            received += dwRead;
+        }
+        return true;
+    }
+
+    inline bool receiveLine(std::string& line)
+    {
+        line.clear();
+        std::string c;
+        while (receive(1, c)) {
+            if (c[0] == '\n')
+                return true;
+            line += c[0];
+        }
+        return false;
+    }
+
+    inline void closeInput()
+    {
         if (stdInWr != INVALID_HANDLE_VALUE)
             CloseHandle(stdInWr);
         stdInWr = INVALID_HANDLE_VALUE;
-
-        return written >= data.size();
     }
 
     inline std::string receiveOnce()
@@ -432,8 +591,8 @@ public:
 
 // -----------------------------------------------------------------------------------
 
-ExternalProcess::ExternalProcess(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile)
-    : mInternal(new ExternalProcessInternal(name, exe, parameters, logFile))
+ExternalProcess::ExternalProcess(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile, bool persistent)
+    : mInternal(new ExternalProcessInternal(name, exe, parameters, logFile, persistent))
 {
 }
 
@@ -475,6 +634,14 @@ void ExternalProcess::waitForFinish()
     mInternal->waitForFinish();
 }
 
+void ExternalProcess::terminate()
+{
+    if (!isRunning())
+        return;
+
+    mInternal->terminate();
+}
+
 bool ExternalProcess::sendOnce(const std::string& data)
 {
     if (mInternal)
@@ -486,4 +653,25 @@ std::string ExternalProcess::receiveOnce()
 {
     return mInternal ? mInternal->receiveOnce() : std::string{};
 }
+
+bool ExternalProcess::send(const std::string& data)
+{
+    return mInternal ? mInternal->send(data) : false;
+}
+
+bool ExternalProcess::receive(size_t size, std::string& data)
+{
+    return mInternal ? mInternal->receive(size, data) : false;
+}
+
+bool ExternalProcess::receiveLine(std::string& line)
+{
+    return mInternal ? mInternal->receiveLine(line) : false;
+}
+
+void ExternalProcess::closeInput()
+{
+    if (mInternal)
+        mInternal->closeInput();
+}
 } // namespace IG
\ No newline at end of file
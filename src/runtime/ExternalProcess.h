@@ -3,9 +3,10 @@
 #include "IG_Config.h"
 
 namespace IG {
-class ExternalProcess {
+class IG_LIB ExternalProcess {
 public:
-    ExternalProcess(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile);
+    /// If persistent, stdout of the process is connected to a pipe instead of the log file, such that data can be exchanged multiple times. Stderr is still written to the log file
+    ExternalProcess(const std::string& name, const Path& exe, const std::vector<std::string>& parameters, const Path& logFile, bool persistent = false);
     ~ExternalProcess();
 
     [[nodiscard]] bool start();
@@ -15,11 +16,20 @@ public:
 
     void waitForInit();
     void waitForFinish();
+    /// Forcefully stop the process. Use waitForFinish afterwards to release its resources
+    void terminate();
 
     // Both functions can only be used once!
     bool sendOnce(const std::string& data);
     std::string receiveOnce();
 
+    // Only available for persistent processes. The functions block until all data is transferred or the process terminated
+    bool send(const std::string& data);
+    bool receive(size_t size, std::string& data);
+    bool receiveLine(std::string& line);
+    /// Close stdin of the process, which signals the end of input
+    void closeInput();
+
 private:
     std::unique_ptr<class ExternalProcessInternal> mInternal;
 };
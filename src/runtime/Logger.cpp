@@ -1,9 +1,17 @@
 #include "Logger.h"
 #include "log/ConsoleLogListener.h"
+#include "log/LogQueue.h"
 
 #include <iostream>
 
 namespace IG {
+// Entries are formatted into thread local streams. Multiple streams are required if an entry is logged while formatting another entry
+struct ThreadLocalStreams {
+    std::vector<std::unique_ptr<std::ostringstream>> Streams;
+    size_t Depth = 0;
+};
+static thread_local ThreadLocalStreams sLocalStreams;
+
 Logger::Logger()
     : mConsoleLogListener(std::make_shared<ConsoleLogListener>(true))
 #ifdef IG_DEBUG
@@ -12,24 +20,43 @@ Logger::Logger()
     , mVerbosity(L_INFO)
 #endif
     , mQuiet(false)
-    , mEmptyStreamBuf(*this, true)
-    , mEmptyStream(&mEmptyStreamBuf)
-    , mStreamBuf(*this, false)
-    , mStream(&mStreamBuf)
+    , mEmptyStream(nullptr)
+    , mQueue(std::make_unique<LogQueue>())
+    , mAsynchronous(true)
+    , mPushed(0)
+    , mRunning(false)
 {
     addListener(mConsoleLogListener);
 }
 
-Logger& Logger::operator=(const Logger& other)
+Logger::~Logger()
 {
-    if (this == &other)
-        return *this;
+    // Entries logged during shutdown, e.g., by other static objects, are written directly
+    mAsynchronous.store(false, std::memory_order_relaxed);
+
+    if (mRunning.load(std::memory_order_acquire)) {
+        LogEntry* entry = new LogEntry();
+        entry->Type     = LogEntry::EntryType::Stop;
+        mQueue->push(entry);
+        mPushed.fetch_add(1, std::memory_order_release);
+        mPushed.notify_one();
+        mThread.join();
+
+        // Nobody would process flush requests anymore
+        mRunning.store(false, std::memory_order_release);
+    }
+
+    // Write entries pushed after the background thread stopped. No other thread is expected to log at this point
+    while (LogEntry* entry = mQueue->pop()) {
+        if (entry->Type == LogEntry::EntryType::Message)
+            dispatch(LogMessage{ entry->Level, entry->Time, entry->Thread, entry->Message });
+        else if (entry->Type == LogEntry::EntryType::Flush)
+            entry->Done.set_value();
+        delete entry;
+    }
 
-    mVerbosity          = other.mVerbosity;
-    mQuiet              = other.mQuiet;
-    mConsoleLogListener = other.mConsoleLogListener;
-    mListener           = other.mListener;
-    return *this;
+    for (const auto& listener : mListener)
+        listener->flush();
 }
 
 Logger& Logger::instance()
@@ -73,45 +100,149 @@ bool Logger::isUsingAnsiTerminal() const
     return mConsoleLogListener->isUsingAnsi();
 }
 
+void Logger::setAsynchronous(bool b)
+{
+    if (!b)
+        flush();
+    mAsynchronous.store(b, std::memory_order_relaxed);
+}
+
 void Logger::addListener(const std::shared_ptr<LogListener>& listener)
 {
+    std::lock_guard<std::mutex> guard(mListenerMutex);
     mListener.push_back(listener);
 }
 
 void Logger::removeListener(const std::shared_ptr<LogListener>& listener)
 {
+    std::lock_guard<std::mutex> guard(mListenerMutex);
     mListener.erase(std::remove(mListener.begin(), mListener.end(), listener), mListener.end());
 }
 
-std::ostream& Logger::startEntry(LogLevel level)
+std::ostringstream& Logger::beginEntry()
 {
-    if ((int)level < (int)verbosity())
-        return mEmptyStream;
+    auto& local = sLocalStreams;
+    if (local.Depth >= local.Streams.size())
+        local.Streams.push_back(std::make_unique<std::ostringstream>());
+
+    auto& stream = *local.Streams[local.Depth++];
+
+    // Reset formatting changed by previous entries
+    stream.clear();
+    stream.flags(std::ios_base::dec | std::ios_base::skipws);
+    stream.precision(6);
+    stream.width(0);
+    stream.fill(' ');
+    return stream;
+}
 
-    for (const auto& listener : mListener)
-        listener->startEntry(level);
+void Logger::endEntry(LogLevel level, std::ostringstream& stream)
+{
+    --sLocalStreams.Depth;
+
+    std::string message = std::move(stream).str();
+    stream.str(std::string());
 
-    return mStream;
+    if (!isAsynchronous()) {
+        std::lock_guard<std::mutex> guard(mListenerMutex);
+        dispatch(LogMessage{ level, std::chrono::system_clock::now(), std::this_thread::get_id(), message });
+        return;
+    }
+
+    // Start the background thread on first use instead of construction, as the logger might be used while loading the library
+    if (!mRunning.load(std::memory_order_acquire)) {
+        std::call_once(mThreadOnce, [this]() {
+            mThread   = std::thread([this]() { processQueue(); });
+            mThreadID = mThread.get_id();
+            mRunning.store(true, std::memory_order_release);
+        });
+    }
+
+    LogEntry* entry = new LogEntry();
+    entry->Level    = level;
+    entry->Time     = std::chrono::system_clock::now();
+    entry->Thread   = std::this_thread::get_id();
+    entry->Message  = std::move(message);
+    mQueue->push(entry);
+    mPushed.fetch_add(1, std::memory_order_release);
+    mPushed.notify_one();
+
+    // Make sure errors are visible before the application possibly terminates
+    if (level >= L_ERROR)
+        flush();
 }
 
-void Logger::closeExtraConsole()
+void Logger::flush()
 {
-    mConsoleLogListener->closeExtraConsole();
+    if (!mRunning.load(std::memory_order_acquire))
+        return;
+
+    LogEntry* entry = new LogEntry();
+    entry->Type     = LogEntry::EntryType::Flush;
+
+    auto done = entry->Done.get_future();
+    mQueue->push(entry);
+    mPushed.fetch_add(1, std::memory_order_release);
+    mPushed.notify_one();
+
+    if (std::this_thread::get_id() != mThreadID)
+        done.wait();
 }
 
-void Logger::openConsole()
+void Logger::dispatch(const LogMessage& msg)
 {
-    mConsoleLogListener->openConsole();
+    for (const auto& listener : mListener)
+        listener->writeEntry(msg);
+}
+
+void Logger::flushListeners()
+{
+    std::lock_guard<std::mutex> guard(mListenerMutex);
+    for (const auto& listener : mListener)
+        listener->flush();
 }
 
-std::streambuf::int_type Logger::StreamBuf::overflow(std::streambuf::int_type c)
+void Logger::processQueue()
 {
-    if (mIgnore)
-        return 0;
+    uint64 processed = 0;
+    while (true) {
+        const uint64 pushed = mPushed.load(std::memory_order_acquire);
+        if (processed == pushed) {
+            flushListeners();
+            mPushed.wait(pushed, std::memory_order_acquire);
+            continue;
+        }
+
+        LogEntry* entry = mQueue->pop();
+        if (entry == nullptr) {
+            // A producer is in the middle of pushing
+            std::this_thread::yield();
+            continue;
+        }
+        ++processed;
+
+        const auto type = entry->Type;
+        if (type == LogEntry::EntryType::Message) {
+            std::lock_guard<std::mutex> guard(mListenerMutex);
+            dispatch(LogMessage{ entry->Level, entry->Time, entry->Thread, entry->Message });
+        } else if (type == LogEntry::EntryType::Flush) {
+            flushListeners();
+            entry->Done.set_value();
+        }
+        delete entry;
+
+        if (type == LogEntry::EntryType::Stop)
+            break;
+    }
+}
 
-    for (const auto& listener : mLogger.mListener)
-        listener->writeEntry((char)c);
+void Logger::closeExtraConsole()
+{
+    mConsoleLogListener->closeExtraConsole();
+}
 
-    return 0;
+void Logger::openConsole()
+{
+    mConsoleLogListener->openConsole();
 }
-} // namespace IG
\ No newline at end of file
+} // namespace IG
@@ -2,12 +2,19 @@
 
 #include "IG_Config.h"
 
+#include <atomic>
 #include <chrono>
 #include <mutex>
-#include <streambuf>
+#include <sstream>
+#include <thread>
 #include <tuple>
 #include <vector>
 
+/// Entries below this level are removed at compile time. Set via the CMake variable IG_LOG_MIN_LEVEL
+#ifndef IG_LOG_MIN_LEVEL
+#define IG_LOG_MIN_LEVEL 0
+#endif
+
 namespace IG {
 enum LogLevel {
     L_DEBUG = 0,
@@ -17,68 +24,73 @@ enum LogLevel {
     L_FATAL
 };
 
+/// A single formatted entry as passed to the listeners
+struct LogMessage {
+    LogLevel Level;
+    std::chrono::system_clock::time_point Time;
+    std::thread::id Thread;
+    std::string_view Message;
+};
+
 class LogListener;
 class ConsoleLogListener;
+class LogQueue;
 class IG_LIB Logger {
 public:
-    class StreamBuf final : public std::streambuf {
-    public:
-        inline StreamBuf(Logger& logger, bool ignore)
-            : std::streambuf()
-            , mLogger(logger)
-            , mIgnore(ignore)
-        {
-        }
-        std::streambuf::int_type overflow(std::streambuf::int_type c);
-
-    private:
-        Logger& mLogger;
-        bool mIgnore;
-    };
-
-    // A closure used to make calls threadsafe. Never capture the ostream, else threadsafety is not guaranteed
+    /// A closure collecting a single entry. The entry is formatted into a thread local buffer without any locking
+    /// and handed to the background thread when the closure is destroyed. Never capture the ostream beyond the lifetime of the closure
     class LogClosure {
     public:
         inline explicit LogClosure(Logger& logger)
             : mLogger(logger)
-            , mStarted(false)
+            , mLevel(L_INFO)
+            , mStream(nullptr)
         {
         }
 
         inline ~LogClosure()
         {
-            if (mStarted)
-                mLogger.mMutex.unlock();
+            if (mStream)
+                mLogger.endEntry(mLevel, *mStream);
         }
 
+        LogClosure(const LogClosure&)            = delete;
+        LogClosure& operator=(const LogClosure&) = delete;
+
         inline std::ostream& log(LogLevel level)
         {
-            if ((int)level >= (int)mLogger.verbosity()) {
-                // Only lock if verbosity is high enough,
-                // else nothing will be output anyway
-                mStarted = true;
-                mLogger.mMutex.lock();
-            }
-            return mLogger.startEntry(level);
+            if (mStream || !isEnabled(level))
+                return mLogger.mEmptyStream;
+
+            mLevel  = level;
+            mStream = &mLogger.beginEntry();
+            return *mStream;
         }
 
     private:
         Logger& mLogger;
-        bool mStarted;
+        LogLevel mLevel;
+        std::ostringstream* mStream;
+    };
+
+    /// Used by IG_LOG to turn the stream expression into a statement
+    struct Voidify {
+        inline void operator&(std::ostream&) {}
     };
 
     Logger();
-    ~Logger() = default;
+    ~Logger();
 
-    Logger& operator=(const Logger&);
+    Logger(const Logger&)            = delete;
+    Logger& operator=(const Logger&) = delete;
 
     static const char* levelString(LogLevel l);
 
     void addListener(const std::shared_ptr<LogListener>& listener);
     void removeListener(const std::shared_ptr<LogListener>& listener);
 
-    inline void setVerbosity(LogLevel level) { mVerbosity = level; }
-    inline LogLevel verbosity() const { return mVerbosity; }
+    inline void setVerbosity(LogLevel level) { mVerbosity.store(level, std::memory_order_relaxed); }
+    inline LogLevel verbosity() const { return mVerbosity.load(std::memory_order_relaxed); }
 
     void setQuiet(bool b);
     inline bool isQuiet() const { return mQuiet; }
@@ -86,18 +98,26 @@ public:
     void enableAnsiTerminal(bool b);
     bool isUsingAnsiTerminal() const;
 
+    /// Entries are passed to the listeners by a background thread by default.
+    /// Disable to write all entries directly on the calling thread
+    void setAsynchronous(bool b);
+    inline bool isAsynchronous() const { return mAsynchronous.load(std::memory_order_relaxed); }
+
+    /// Block until all pending entries were written by the listeners.
+    /// Entries with level L_ERROR and above are always flushed immediately
+    void flush();
+
     /// Close any additional console started due to the console subsystem (only relevant on Windows)
     void closeExtraConsole();
     /// Open a new console if none exists. Currently only supported on Windows
     void openConsole();
 
-    std::ostream& startEntry(LogLevel level);
-
     static Logger& instance();
 
-    static inline std::ostream& log(LogLevel level)
+    /// True if entries of the given level are written at all. Used to skip formatting of disabled entries
+    [[nodiscard]] static inline bool isEnabled(LogLevel level)
     {
-        return instance().startEntry(level);
+        return (int)level >= IG_LOG_MIN_LEVEL && (int)level >= (int)instance().verbosity();
     }
 
     static inline LogClosure threadsafe()
@@ -106,18 +126,28 @@ public:
     }
 
 private:
+    std::ostringstream& beginEntry();
+    void endEntry(LogLevel level, std::ostringstream& stream);
+    void dispatch(const LogMessage& msg);
+    void flushListeners();
+    void processQueue();
+
     std::vector<std::shared_ptr<LogListener>> mListener;
     std::shared_ptr<ConsoleLogListener> mConsoleLogListener;
+    std::mutex mListenerMutex; // Only guards the listeners, producers never lock
 
-    LogLevel mVerbosity;
+    std::atomic<LogLevel> mVerbosity;
     bool mQuiet;
 
-    StreamBuf mEmptyStreamBuf;
     std::ostream mEmptyStream;
 
-    StreamBuf mStreamBuf;
-    std::ostream mStream;
-    std::mutex mMutex;
+    std::unique_ptr<LogQueue> mQueue;
+    std::atomic<bool> mAsynchronous;
+    std::atomic<uint64> mPushed; // Number of entries pushed into the queue
+    std::thread mThread;
+    std::thread::id mThreadID;
+    std::once_flag mThreadOnce;
+    std::atomic<bool> mRunning;
 };
 
 template <typename T>
@@ -272,5 +302,5 @@ std::ostream& operator<<(std::ostream& os, const std::chrono::duration<Rep, Peri
 } // namespace IG
 
 #define IG_LOGGER (IG::Logger::instance())
-#define IG_LOG_UNSAFE(l) (IG::Logger::log((l)))
-#define IG_LOG(l) (IG::Logger::threadsafe().log((l)))
+// Formatting is skipped entirely if the level is disabled
+#define IG_LOG(l) !IG::Logger::isEnabled((l)) ? (void)0 : IG::Logger::Voidify() & IG::Logger::threadsafe().log((l))
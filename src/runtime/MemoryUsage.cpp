@@ -0,0 +1,106 @@
+#include "MemoryUsage.h"
+#include "Logger.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace IG {
+MemoryUsage::MemoryUsage()
+    : mBytes()
+{
+    for (auto& entry : mBytes)
+        std::fill(entry.begin(), entry.end(), 0);
+}
+
+size_t MemoryUsage::total(MemoryLocation location) const
+{
+    size_t sum = 0;
+    for (const auto& entry : mBytes)
+        sum += entry[(size_t)location];
+    return sum;
+}
+
+size_t MemoryUsage::total() const
+{
+    return total(MemoryLocation::Host) + total(MemoryLocation::Device);
+}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other)
+{
+    for (size_t i = 0; i < mBytes.size(); ++i) {
+        for (size_t j = 0; j < mBytes[i].size(); ++j)
+            mBytes[i][j] += other.mBytes[i][j];
+    }
+    return *this;
+}
+
+void MemoryUsage::max(const MemoryUsage& other)
+{
+    for (size_t i = 0; i < mBytes.size(); ++i) {
+        for (size_t j = 0; j < mBytes[i].size(); ++j)
+            mBytes[i][j] = std::max(mBytes[i][j], other.mBytes[i][j]);
+    }
+}
+
+std::string MemoryUsage::dump(const MemoryUsage* peak) const
+{
+    constexpr int NameWidth  = 14;
+    constexpr int ValueWidth = 12;
+
+    const auto format = [](size_t bytes) {
+        std::stringstream bstream;
+        bstream << FormatMemory(bytes);
+        return bstream.str();
+    };
+
+    std::stringstream stream;
+    const auto row = [&](const std::string_view& name, size_t host, size_t device, size_t peakHost, size_t peakDevice) {
+        stream << "  |-" << std::left << std::setw(NameWidth) << name << std::right
+               << " Host " << std::setw(ValueWidth) << format(host)
+               << " | Device " << std::setw(ValueWidth) << format(device);
+        if (peak)
+            stream << " | Peak " << std::setw(ValueWidth) << format(peakHost) << " / " << std::setw(ValueWidth) << format(peakDevice);
+        stream << std::endl;
+    };
+
+    stream << "  Memory:" << std::endl;
+    for (size_t i = 0; i < (size_t)MemoryCategory::_COUNT; ++i) {
+        const MemoryCategory category = (MemoryCategory)i;
+        row(getCategoryName(category),
+            get(category, MemoryLocation::Host), get(category, MemoryLocation::Device),
+            peak ? peak->get(category, MemoryLocation::Host) : 0, peak ? peak->get(category, MemoryLocation::Device) : 0);
+    }
+    row("Total",
+        total(MemoryLocation::Host), total(MemoryLocation::Device),
+        peak ? peak->total(MemoryLocation::Host) : 0, peak ? peak->total(MemoryLocation::Device) : 0);
+
+    return stream.str();
+}
+
+std::string_view MemoryUsage::getCategoryName(MemoryCategory category)
+{
+    switch (category) {
+    case MemoryCategory::SceneTables:
+        return "SceneTables";
+    case MemoryCategory::BVH:
+        return "BVH";
+    case MemoryCategory::Images:
+        return "Images";
+    case MemoryCategory::Buffers:
+        return "Buffers";
+    case MemoryCategory::Streams:
+        return "Streams";
+    case MemoryCategory::Framebuffer:
+        return "Framebuffer";
+    case MemoryCategory::Denoiser:
+        return "Denoiser";
+    default:
+        return "Unknown";
+    }
+}
+
+MemoryCategory MemoryUsage::getTableCategory(const std::string_view& name)
+{
+    return name.find("bvh") != std::string_view::npos ? MemoryCategory::BVH : MemoryCategory::SceneTables;
+}
+} // namespace IG
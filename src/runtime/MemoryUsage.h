@@ -0,0 +1,58 @@
+#pragma once
+
+#include "IG_Config.h"
+
+namespace IG {
+enum class MemoryCategory {
+    SceneTables = 0, // DynTables and FixTables of the scene database
+    BVH,             // Scene and shape bvhs
+    Images,          // Image cache of the device
+    Buffers,         // Buffers requested via requestBuffer
+    Streams,         // Ray streams and temporary storage
+    Framebuffer,     // Framebuffer and AOVs including host copies
+    Denoiser,        // Buffers used by the denoiser. Internal scratch memory of the denoiser is not included
+
+    _COUNT
+};
+
+enum class MemoryLocation {
+    Host = 0,
+    Device,
+
+    _COUNT
+};
+
+/// Number of bytes allocated per category on the host and the device
+class IG_LIB MemoryUsage {
+public:
+    MemoryUsage();
+
+    inline void add(MemoryCategory category, MemoryLocation location, size_t bytes)
+    {
+        mBytes[(size_t)category][(size_t)location] += bytes;
+    }
+
+    [[nodiscard]] inline size_t get(MemoryCategory category, MemoryLocation location) const
+    {
+        return mBytes[(size_t)category][(size_t)location];
+    }
+
+    [[nodiscard]] size_t total(MemoryLocation location) const;
+    [[nodiscard]] size_t total() const;
+
+    MemoryUsage& operator+=(const MemoryUsage& other);
+
+    /// Keep the maximum of each entry
+    void max(const MemoryUsage& other);
+
+    /// Dump a table with all categories, optionally alongside the given peak usage
+    [[nodiscard]] std::string dump(const MemoryUsage* peak = nullptr) const;
+
+    [[nodiscard]] static std::string_view getCategoryName(MemoryCategory category);
+    /// Tables of the scene database containing bvhs (e.g., 'trimesh_primbvh') are accounted as bvh
+    [[nodiscard]] static MemoryCategory getTableCategory(const std::string_view& name);
+
+private:
+    std::array<std::array<size_t, (size_t)MemoryLocation::_COUNT>, (size_t)MemoryCategory::_COUNT> mBytes;
+};
+} // namespace IG
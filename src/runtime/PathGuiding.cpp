@@ -0,0 +1,144 @@
+#include "PathGuiding.h"
+#include "Logger.h"
+#include "container/SDTree.h"
+#include "device/IRenderDevice.h"
+
+namespace IG {
+struct GuidingRecord {
+    float Position[3];
+    int32 Stamp;
+    float Direction[3];
+    float InvPdf;
+    float Throughput[3];
+    float Unused0;
+    float Radiance[3];
+    float Unused1;
+};
+static_assert(sizeof(GuidingRecord) == 16 * sizeof(float), "Expected record to match the layout of artic/sampler/path_guiding.art");
+
+// Cylindrical mapping, has to match pg_dir_to_canonical
+static inline Vector2f dirToCanonical(const Vector3f& dir)
+{
+    const float cosTheta = std::clamp(dir.z(), -1.0f, 1.0f);
+    float u              = std::atan2(dir.y(), dir.x()) / (2 * Pi);
+    if (u < 0)
+        u += 1;
+    return Vector2f(std::clamp(u, 0.0f, 1 - FltEps), std::clamp((cosTheta + 1) / 2, 0.0f, 1 - FltEps));
+}
+
+PathGuiding::PathGuiding(const PathGuidingSettings& settings, const BoundingBox& sceneBBox)
+    : mSettings(settings)
+    , mBoundingBox(sceneBBox)
+    , mStamp(0)
+    , mPass(0)
+    , mPassIterations(0)
+    , mTrainedIterations(0)
+{
+}
+
+PathGuiding::~PathGuiding() = default;
+
+void PathGuiding::reset(IRenderDevice* device)
+{
+    // Slightly enlarge the box to keep points on the boundary inside
+    BoundingBox bbox = mBoundingBox;
+    bbox.inflate(1e-3f);
+
+    mTree              = std::make_unique<SDTree>(bbox);
+    mStamp             = 1; // The record buffer is initialized with zeros, which never matches a valid stamp
+    mPass              = 0;
+    mPassIterations    = 0;
+    mTrainedIterations = 0;
+
+    // Empty tree, which disables guiding
+    std::vector<int32> header(SDTree::HeaderSize, 0);
+    device->copyBufferFromHost(TreeBufferName, header.data(), header.size() * sizeof(int32));
+
+    std::vector<GuidingRecord> records(std::max<size_t>(1, mSettings.TrainingPaths * mSettings.MaxDepth));
+    std::memset(records.data(), 0, records.size() * sizeof(GuidingRecord));
+    device->copyBufferFromHost(RecordBufferName, records.data(), records.size() * sizeof(GuidingRecord));
+
+    uploadState(device);
+}
+
+void PathGuiding::uploadState(IRenderDevice* device)
+{
+    const std::array<int32, 4> state = {
+        mStamp,
+        isTraining() ? (int32)mSettings.TrainingPaths : 0,
+        (int32)mSettings.MaxDepth,
+        0
+    };
+    device->copyBufferFromHost(StateBufferName, state.data(), state.size() * sizeof(int32));
+}
+
+void PathGuiding::uploadTree(IRenderDevice* device)
+{
+    const auto data = mTree->serialize();
+    device->copyBufferFromHost(TreeBufferName, data.data(), data.size() * sizeof(int32));
+}
+
+void PathGuiding::update(IRenderDevice* device)
+{
+    if (!isTraining() || !mTree)
+        return;
+
+    const size_t maxDepth = mSettings.MaxDepth;
+    std::vector<GuidingRecord> records(mSettings.TrainingPaths * maxDepth);
+    if (records.empty() || !device->copyBufferToHost(RecordBufferName, records.data(), records.size() * sizeof(GuidingRecord))) {
+        IG_LOG(L_ERROR) << "Could not access path guiding records" << std::endl;
+        return;
+    }
+
+    // Each slot contains the vertices of one path. Records are processed in slot order to keep the training deterministic
+    for (size_t slot = 0; slot < mSettings.TrainingPaths; ++slot) {
+        GuidingRecord* path = &records[slot * maxDepth];
+
+        size_t length = 0;
+        while (length < maxDepth && path[length].Stamp == mStamp)
+            ++length;
+
+        // Contributions arriving after a vertex arrive at all previous vertices as well
+        for (size_t k = length; k > 1; --k) {
+            for (int c = 0; c < 3; ++c)
+                path[k - 2].Radiance[c] += path[k - 1].Radiance[c];
+        }
+
+        for (size_t k = 0; k < length; ++k) {
+            const GuidingRecord& record = path[k];
+            if (record.InvPdf <= 0) // Delta directions can not be guided
+                continue;
+
+            // Divide by the throughput up to and including the vertex to get the incident radiance
+            Vector3f radiance = Vector3f::Zero();
+            for (int c = 0; c < 3; ++c)
+                radiance[c] = record.Throughput[c] > 0 ? record.Radiance[c] / record.Throughput[c] : 0.0f;
+
+            const float value = (radiance.x() + radiance.y() + radiance.z()) / 3 * record.InvPdf;
+            if (!std::isfinite(value) || value < 0)
+                continue;
+
+            const Vector3f pos = Vector3f(record.Position[0], record.Position[1], record.Position[2]);
+            const Vector3f dir = Vector3f(record.Direction[0], record.Direction[1], record.Direction[2]);
+            mTree->lookup(pos).Building.record(dirToCanonical(dir), value);
+        }
+    }
+
+    ++mStamp;
+    ++mPassIterations;
+    ++mTrainedIterations;
+
+    const size_t passLength = size_t(1) << mPass;
+    if (mPassIterations >= passLength || !isTraining()) {
+        mTree->refine(mSettings.SpatialThreshold * std::sqrt((float)passLength), mSettings.DirectionalThreshold);
+        uploadTree(device);
+
+        IG_LOG(L_DEBUG) << "Path guiding pass " << mPass << " finished with " << mTree->leafCount() << " spatial leaves" << std::endl;
+
+        ++mPass;
+        mPassIterations = 0;
+    }
+
+    uploadState(device);
+}
+} // namespace IG
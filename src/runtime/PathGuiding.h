@@ -0,0 +1,49 @@
+#pragma once
+
+#include "math/BoundingBox.h"
+#include "technique/TechniqueInfo.h"
+
+namespace IG {
+class IRenderDevice;
+class SDTree;
+
+/// Learns the incident radiance with a spatial-directional tree (SD-tree) as proposed in "Practical Path Guiding for Efficient Light-Transport Simulation" by Müller et al.
+/// A subset of the paths records its vertices on the device, which are consumed after each iteration. After each training pass the tree is refined and uploaded to the device.
+/// Each pass lasts twice as many iterations as the previous one. The training is deterministic, as each training path owns a fixed slot in the record buffer.
+///
+/// Layout of the buffers shared with artic/sampler/path_guiding.art, all entries are 32 bit:
+/// - Tree: [bbox min (3), valid (1), bbox max (3), unused (1)] followed by the spatial nodes [axis, offset of first child] (leaves have axis -1 and the offset of their directional root)
+///   followed by the directional nodes [energy (4), child offsets (4)] (zero marks a leaf)
+/// - State: [stamp, training slots, max depth, unused]
+/// - Records: [position (3), stamp, direction (3), inverse pdf, throughput (3), unused, radiance (3), unused] per vertex, with max depth vertices per slot
+class IG_LIB PathGuiding {
+public:
+    static constexpr const char* TreeBufferName   = "__guiding_tree";
+    static constexpr const char* StateBufferName  = "__guiding_state";
+    static constexpr const char* RecordBufferName = "__guiding_records";
+
+    PathGuiding(const PathGuidingSettings& settings, const BoundingBox& sceneBBox);
+    ~PathGuiding();
+
+    /// Drop everything learned so far and upload an empty tree, which disables guiding until the first pass is finished
+    void reset(IRenderDevice* device);
+
+    /// Consume the vertices recorded in the last iteration. Will rebuild and upload the tree at the end of a training pass
+    void update(IRenderDevice* device);
+
+    [[nodiscard]] inline bool isTraining() const { return mTrainedIterations < mSettings.TrainingIterations; }
+
+private:
+    void uploadTree(IRenderDevice* device);
+    void uploadState(IRenderDevice* device);
+
+    const PathGuidingSettings mSettings;
+    const BoundingBox mBoundingBox;
+    std::unique_ptr<SDTree> mTree;
+
+    int32 mStamp;
+    size_t mPass;
+    size_t mPassIterations; // Iterations already done in the current pass
+    size_t mTrainedIterations;
+};
+} // namespace IG
@@ -0,0 +1,150 @@
+#include "RenderQueue.h"
+#include "Runtime.h"
+
+namespace IG {
+RenderQueue::RenderQueue(Runtime& runtime)
+    : mRuntime(runtime)
+    , mRunning(0)
+    , mStop(false)
+{
+    mThread = std::thread([this]() { run(); });
+}
+
+RenderQueue::~RenderQueue()
+{
+    {
+        std::lock_guard<std::mutex> _guard(mMutex);
+        mStop = true;
+    }
+    mWorkAvailable.notify_all();
+
+    if (mThread.joinable())
+        mThread.join();
+}
+
+void RenderQueue::stop()
+{
+    std::deque<std::packaged_task<void()>> dropped;
+    {
+        std::lock_guard<std::mutex> _guard(mMutex);
+        mStop = true;
+        dropped.swap(mTasks);
+    }
+    mWorkAvailable.notify_all();
+    mWorkDone.notify_all();
+
+    // The worker finishes the running task and returns as no work is left
+    if (mThread.joinable())
+        mThread.join();
+}
+
+void RenderQueue::run()
+{
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkAvailable.wait(lock, [this]() { return mStop || !mTasks.empty(); });
+            if (mTasks.empty())
+                return; // Stopped and all pending work is done
+
+            task = std::move(mTasks.front());
+            mTasks.pop_front();
+            ++mRunning;
+        }
+
+        task(); // Exceptions are stored in the corresponding future
+
+        {
+            std::lock_guard<std::mutex> _guard(mMutex);
+            --mRunning;
+        }
+        mWorkDone.notify_all();
+    }
+}
+
+template <typename T>
+std::future<T> RenderQueue::enqueue(std::function<T(Runtime&)> func)
+{
+    // packaged_task<void()> can not return values, therefore wrap the actual task and forward its future
+    auto inner  = std::make_shared<std::packaged_task<T(Runtime&)>>(std::move(func));
+    auto future = inner->get_future();
+
+    {
+        std::lock_guard<std::mutex> _guard(mMutex);
+        if (mStop)
+            return future; // The worker is gone, dropping the task breaks the promise
+
+        mTasks.emplace_back([this, inner]() { (*inner)(mRuntime); });
+    }
+    mWorkAvailable.notify_one();
+
+    return future;
+}
+
+std::future<void> RenderQueue::step(size_t iterations, bool ignoreDenoiser)
+{
+    return enqueue<void>([=](Runtime& runtime) {
+        for (size_t i = 0; i < iterations && !runtime.isConverged(); ++i)
+            runtime.step(ignoreDenoiser || i + 1 < iterations); // Only the last iteration has to be denoised
+    });
+}
+
+std::future<std::vector<float>> RenderQueue::trace(std::vector<Ray> rays)
+{
+    return enqueue<std::vector<float>>([rays = std::move(rays)](Runtime& runtime) {
+        std::vector<float> data;
+        runtime.trace(rays, data);
+        return data;
+    });
+}
+
+std::future<FramebufferSnapshot> RenderQueue::snapshot(const std::string& aov)
+{
+    return enqueue<FramebufferSnapshot>([aov](Runtime& runtime) {
+        FramebufferSnapshot snapshot;
+        snapshot.Width       = runtime.framebufferWidth();
+        snapshot.Height      = runtime.framebufferHeight();
+        snapshot.Iteration   = runtime.currentIterationCount();
+        snapshot.SampleCount = runtime.currentSampleCount();
+
+        const float* data = runtime.getFramebufferForHost(aov).Data;
+        if (data)
+            snapshot.Data = std::vector<float>(data, data + snapshot.Width * snapshot.Height * 3);
+        return snapshot;
+    });
+}
+
+std::future<Checkpoint> RenderQueue::checkpoint()
+{
+    return enqueue<Checkpoint>([](Runtime& runtime) { return runtime.createCheckpoint(); });
+}
+
+std::future<void> RenderQueue::submit(std::function<void(Runtime&)> func)
+{
+    return enqueue<void>(std::move(func));
+}
+
+void RenderQueue::cancel()
+{
+    std::deque<std::packaged_task<void()>> dropped;
+    {
+        std::lock_guard<std::mutex> _guard(mMutex);
+        dropped.swap(mTasks);
+    }
+    mWorkDone.notify_all();
+    // The dropped tasks are destroyed here without being executed, which breaks their promises
+}
+
+void RenderQueue::wait()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mWorkDone.wait(lock, [this]() { return mTasks.empty() && mRunning == 0; });
+}
+
+size_t RenderQueue::pendingCount() const
+{
+    std::lock_guard<std::mutex> _guard(mMutex);
+    return mTasks.size() + mRunning;
+}
+} // namespace IG
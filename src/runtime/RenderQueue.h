@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Checkpoint.h"
+#include "RuntimeStructs.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace IG {
+class Runtime;
+
+/// Copy of a single framebuffer taken between two iterations
+struct FramebufferSnapshot {
+    size_t Width       = 0;
+    size_t Height      = 0;
+    size_t Iteration   = 0;
+    size_t SampleCount = 0;
+    std::vector<float> Data; // Accumulated (not normalized) values with three channels per pixel
+};
+
+/// Executes work on a runtime in a separate thread, such that the caller is not blocked while rendering.
+/// Work is executed in submission order. All access to the runtime has to go through the queue while work is pending,
+/// snapshots are therefore taken in between iterations and are consistent.
+class IG_LIB RenderQueue {
+    IG_CLASS_NON_COPYABLE(RenderQueue);
+    IG_CLASS_NON_MOVEABLE(RenderQueue);
+
+public:
+    explicit RenderQueue(Runtime& runtime);
+    /// Will finish all pending work before returning, unless the queue was stopped
+    ~RenderQueue();
+
+    /// Queue the given number of iterations. Stops early if the runtime converged
+    std::future<void> step(size_t iterations = 1, bool ignoreDenoiser = false);
+    /// Queue a single iteration in tracing mode. The future contains three values per ray
+    std::future<std::vector<float>> trace(std::vector<Ray> rays);
+    /// Queue a copy of the given framebuffer. The empty name denotes the actual framebuffer
+    std::future<FramebufferSnapshot> snapshot(const std::string& aov = {});
+    /// Queue a copy of the framebuffer, all AOVs and the counters
+    std::future<Checkpoint> checkpoint();
+    /// Queue arbitrary work on the runtime
+    std::future<void> submit(std::function<void(Runtime&)> func);
+
+    /// Drop all work not yet started. The corresponding futures will throw a broken promise error
+    void cancel();
+    /// Wait until all queued work is done
+    void wait();
+    /// Drop all work not yet started, wait for the running task and stop the worker thread.
+    /// The runtime is not accessed afterwards, work queued later is dropped immediately
+    void stop();
+
+    /// Number of tasks queued or running
+    [[nodiscard]] size_t pendingCount() const;
+    [[nodiscard]] inline bool isIdle() const { return pendingCount() == 0; }
+
+private:
+    void run();
+
+    template <typename T>
+    std::future<T> enqueue(std::function<T(Runtime&)> func);
+
+    Runtime& mRuntime;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mWorkAvailable;
+    std::condition_variable mWorkDone;
+    std::deque<std::packaged_task<void()>> mTasks;
+    size_t mRunning;
+    bool mStop;
+
+    std::thread mThread;
+};
+} // namespace IG
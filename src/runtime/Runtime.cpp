@@ -2,10 +2,13 @@
 #include "Image.h"
 #include "Logger.h"
 #include "RuntimeInfo.h"
+#include "SpecializationProfile.h"
 #include "StringUtils.h"
+#include "Timeline.h"
 #include "device/DeviceManager.h"
 #include "device/IDeviceInterface.h"
 #include "loader/LoaderCamera.h"
+#include "loader/LoaderEntity.h"
 #include "loader/Parser.h"
 #include "shader/ShaderManager.h"
 
@@ -68,6 +71,30 @@ static inline void setup_camera(LoaderOptions& lopts, const RuntimeOptions& opts
     lopts.CameraType = camera_type;
 }
 
+static inline size_t getShaderCompileThreadCount(const RuntimeOptions& opts)
+{
+    size_t threads = opts.ShaderCompileThreads;
+    if (threads == 0)
+        threads = std::thread::hardware_concurrency() / 2; // Using the compiler might be a heavy task, therefore only use half of the cpu count. TODO: Make this smarter?
+
+    if (threads > 1) {
+        if (RuntimeInfo::igcPath().empty()) {
+            IG_LOG(L_WARNING) << "Could not find " << RuntimeInfo::igcPath() << ". Falling back to single threaded shader compilation" << std::endl;
+            threads = 1;
+        } else {
+            IG_LOG(L_DEBUG) << "Using compiler at " << RuntimeInfo::igcPath() << std::endl;
+        }
+    }
+
+    return std::max<size_t>(1, threads);
+}
+
+static inline std::unique_ptr<ShaderManager> createShaderManager(ScriptCompiler* compiler, const RuntimeOptions& opts)
+{
+    const ShaderDumpVerbosity verbosity = opts.DumpShaderFull ? ShaderDumpVerbosity::Full : (opts.DumpShader ? ShaderDumpVerbosity::Light : ShaderDumpVerbosity::None);
+    return std::make_unique<ShaderManager>(compiler, getShaderCompileThreadCount(opts), verbosity);
+}
+
 static inline size_t recommendSPI(const Target& target, size_t width, size_t height, bool interactive)
 {
     // The "best" case was measured with a 1000 x 1000. It does depend on the scene content though, but thats ignored here
@@ -78,6 +105,12 @@ static inline size_t recommendSPI(const Target& target, size_t width, size_t hei
     return std::max<size_t>(1, std::min<size_t>(64, spi));
 }
 
+bool Runtime::isSingleUseAOV(const std::string& name)
+{
+    // TODO: Add flags for single use AOVs
+    return name == "Normals" || name == "Albedo" || name == AdaptiveSampler::VarianceAOV || name == AdaptiveSampler::SampleCountAOV;
+}
+
 Runtime::Runtime(const RuntimeOptions& opts)
     : mOptions(opts)
     , mDatabase()
@@ -95,6 +128,11 @@ Runtime::Runtime(const RuntimeOptions& opts)
     , mTechniqueVariants()
     , mTechniqueVariantShaderSets()
 {
+    if (!mOptions.TimelineFile.empty()) {
+        Timeline::instance().enable();
+        Timeline::instance().setThreadName("Main", true);
+    }
+
     checkCacheDirectory();
 
     // Get device
@@ -143,6 +181,13 @@ Runtime::Runtime(const RuntimeOptions& opts)
 
 Runtime::~Runtime()
 {
+    if (mSpecializationProfile)
+        saveSpecializationProfile();
+
+    if (!mOptions.TimelineFile.empty()) {
+        if (Timeline::instance().write(mOptions.TimelineFile))
+            IG_LOG(L_INFO) << "Timeline written to " << mOptions.TimelineFile << std::endl;
+    }
 }
 
 void Runtime::checkCacheDirectory()
@@ -179,7 +224,10 @@ bool Runtime::loadFromFile(const Path& path)
     try {
         const auto startParser = std::chrono::high_resolution_clock::now();
         SceneParser parser;
-        auto scene = parser.loadFromFile(path);
+        auto scene = [&]() {
+            IG_TIMELINE_SCOPE("loader", "Parse scene");
+            return parser.loadFromFile(path);
+        }();
         IG_LOG(L_DEBUG) << "Parsing scene took " << (std::chrono::high_resolution_clock::now() - startParser) << std::endl;
         if (scene == nullptr)
             return false;
@@ -231,32 +279,136 @@ bool Runtime::loadFromScene(const Scene* scene)
     }
 }
 
+bool Runtime::reloadFromFile(const Path& path)
+{
+    IG_LOG(L_DEBUG) << "Parsing scene file for reload" << std::endl;
+    try {
+        SceneParser parser;
+        auto scene = [&]() {
+            IG_TIMELINE_SCOPE("loader", "Parse scene");
+            return parser.loadFromFile(path);
+        }();
+        if (scene == nullptr)
+            return false;
+
+        if (mOptions.AddExtraEnvLight)
+            scene->addConstantEnvLight();
+
+        return reload(scene.get());
+    } catch (const std::runtime_error& err) {
+        IG_LOG(L_ERROR) << "Reloading error: " << err.what() << std::endl;
+        return false;
+    }
+}
+
+bool Runtime::reloadFromScene(const Scene* scene)
+{
+    if (scene == nullptr) {
+        IG_LOG(L_ERROR) << "Reloading error: Given scene pointer is null" << std::endl;
+        return false;
+    }
+
+    try {
+        return reload(scene);
+    } catch (const std::runtime_error& err) {
+        IG_LOG(L_ERROR) << "Reloading error: " << err.what() << std::endl;
+        return false;
+    }
+}
+
+void Runtime::setupSpecializationProfile(LoaderOptions& lopts)
+{
+    if (lopts.CachePath.empty()) {
+        IG_LOG(L_WARNING) << "Specialization profiles require a cache directory. Using default specialization instead" << std::endl;
+        return;
+    }
+
+    mSpecializationProfileFile = lopts.CachePath / "specialization_profile.json";
+
+    // Use the profile of the previous run and record a new one for the next run. Varying parameters of the previous run stay varying
+    auto profile = SpecializationProfile::load(mSpecializationProfileFile);
+    if (profile && profile->hasMaterials()) {
+        IG_LOG(L_INFO) << "Using specialization profile " << mSpecializationProfileFile << std::endl;
+        lopts.Profile = std::make_shared<SpecializationProfile>(*profile);
+    } else {
+        IG_LOG(L_INFO) << "No specialization profile recorded yet. Using default specialization" << std::endl;
+    }
+
+    mSpecializationProfile = std::make_shared<SpecializationProfile>(profile.value_or(SpecializationProfile()));
+
+    std::vector<std::string> names;
+    for (const auto& pair : lopts.Scene->parameters())
+        names.push_back(pair.first);
+    mSpecializationProfile->trackParameters(names);
+}
+
+void Runtime::saveSpecializationProfile()
+{
+    if (!mDevice)
+        return;
+
+    const auto workloads = mDevice->getMaterialWorkloads();
+
+    size_t total = 0;
+    std::unordered_map<std::string, size_t> materials;
+    for (size_t i = 0; i < workloads.size() && i < mStatisticNames.Materials.size(); ++i) {
+        materials[mStatisticNames.Materials[i]] += workloads[i];
+        total += workloads[i];
+    }
+
+    if (total == 0)
+        return; // Nothing was rendered, keep the previous profile
+
+    mSpecializationProfile->setMaterialWorkloads(materials);
+
+    try {
+        std::filesystem::create_directories(mSpecializationProfileFile.parent_path()); // The cache might have been removed if it was empty
+    } catch (const std::filesystem::filesystem_error&) {
+        IG_LOG(L_ERROR) << "Could not create directory for specialization profile " << mSpecializationProfileFile << std::endl;
+        return;
+    }
+
+    if (mSpecializationProfile->save(mSpecializationProfileFile))
+        IG_LOG(L_INFO) << "Specialization profile written to " << mSpecializationProfileFile << std::endl;
+}
+
 LoaderOptions Runtime::loaderOptions() const
 {
     LoaderOptions lopts;
-    lopts.FilePath            = Path{};
-    lopts.EnableCache         = mOptions.EnableCache;
-    lopts.CachePath           = mOptions.CacheDir;
-    lopts.Target              = mOptions.Target;
-    lopts.IsTracer            = mOptions.IsTracer;
-    lopts.Scene               = nullptr;
-    lopts.Specialization      = mOptions.Specialization;
-    lopts.DisableStandardAOVs = mOptions.DisableStandardAOVs;
-    lopts.EnableTonemapping   = mOptions.EnableTonemapping;
-    lopts.Denoiser            = mOptions.Denoiser;
-    lopts.Denoiser.Enabled    = !mOptions.IsTracer && mOptions.Denoiser.Enabled && hasDenoiser();
-    lopts.Compiler            = mCompiler.get();
-    lopts.Device              = mDevice.get();
+    lopts.FilePath                 = Path{};
+    lopts.EnableCache              = mOptions.EnableCache;
+    lopts.CachePath                = mOptions.CacheDir;
+    lopts.Target                   = mOptions.Target;
+    lopts.IsTracer                 = mOptions.IsTracer;
+    lopts.Scene                    = nullptr;
+    lopts.Specialization           = mOptions.Specialization;
+    lopts.DisableStandardAOVs      = mOptions.DisableStandardAOVs;
+    lopts.EnableTonemapping        = mOptions.EnableTonemapping;
+    lopts.Denoiser                 = mOptions.Denoiser;
+    lopts.Denoiser.Enabled         = !mOptions.IsTracer && mOptions.Denoiser.Enabled && hasDenoiser();
+    lopts.AdaptiveSampling         = mOptions.AdaptiveSampling;
+    lopts.AdaptiveSampling.Enabled = !mOptions.IsTracer && mOptions.AdaptiveSampling.Enabled;
+    lopts.Compiler                 = mCompiler.get();
+    lopts.Device                   = mDevice.get();
     return lopts;
 }
 
 bool Runtime::load(const Path& path, const Scene* scene)
 {
+    // Keep a private copy of the scene to compare against when reloading, as the given scene might be changed in place by the caller
+    if (mOptions.EnableHotReload) {
+        mScene = std::make_unique<Scene>(scene->clone());
+        scene  = mScene.get();
+    }
+
     LoaderOptions lopts = loaderOptions();
     lopts.FilePath      = path;
     lopts.Scene         = scene;
     lopts.CachePath     = mOptions.CacheDir.empty() ? (path.parent_path() / ("ignis_cache_" + path.stem().generic_string())) : mOptions.CacheDir;
 
+    if (mOptions.Specialization == RuntimeOptions::SpecializationMode::Profile)
+        setupSpecializationProfile(lopts);
+
     // Print a warning if denoiser was requested but none is available
     if (mOptions.Denoiser.Enabled && !lopts.Denoiser.Enabled && !mOptions.IsTracer && !hasDenoiser())
         IG_LOG(L_WARNING) << "Trying to use denoiser but no denoiser is available" << std::endl;
@@ -283,13 +435,25 @@ bool Runtime::load(const Path& path, const Scene* scene)
     lopts.SamplesPerIteration = mSamplesPerIteration;
     IG_LOG(L_DEBUG) << "Recommended samples per iteration = " << mSamplesPerIteration << std::endl;
 
+    // Start compiling shaders while the remaining ones are still generated
+    mShaderManager       = createShaderManager(mCompiler.get(), mOptions);
+    lopts.ShaderCallback = [this](size_t variant, const std::string& name, const std::string& function, const std::string& script) {
+        mShaderManager->submit("v" + std::to_string(variant) + " " + name, script, function);
+    };
+
     IG_LOG(L_DEBUG) << "Loading scene" << std::endl;
     const auto startLoader = std::chrono::high_resolution_clock::now();
 
-    auto ctx = Loader::load(lopts);
-    if (!ctx)
+    auto ctx = [&]() {
+        IG_TIMELINE_SCOPE("loader", "Load scene");
+        return Loader::load(lopts);
+    }();
+    if (!ctx) {
+        mShaderManager.reset();
         return false;
+    }
     mDatabase = std::move(ctx->Database);
+    mLoadTimings.LoaderMS = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startLoader).count();
     IG_LOG(L_DEBUG) << "Loading scene took " << (std::chrono::high_resolution_clock::now() - startLoader) << std::endl;
 
     mCameraName               = ctx->Options.CameraType;
@@ -303,18 +467,48 @@ bool Runtime::load(const Path& path, const Scene* scene)
     if (mOptions.Denoiser.Enabled)
         mTechniqueInfo.EnabledAOVs.emplace_back("Denoised");
 
+    if (mOptions.EnableCostAOV && !mOptions.IsTracer) {
+        if (mOptions.Target.isCPU())
+            mTechniqueInfo.EnabledAOVs.emplace_back(IRenderDevice::CostAOV);
+        else
+            IG_LOG(L_WARNING) << "The cost AOV is only available on the CPU" << std::endl;
+    }
+
+    const bool useAdaptiveSampling = !mOptions.IsTracer && mOptions.AdaptiveSampling.Enabled;
+    if (useAdaptiveSampling) {
+        mTechniqueInfo.EnabledAOVs.emplace_back(AdaptiveSampler::VarianceAOV);
+        mTechniqueInfo.EnabledAOVs.emplace_back(AdaptiveSampler::SampleCountAOV);
+    }
+
     // Setup array of number of entities per material
     mEntityPerMaterial.clear();
     mEntityPerMaterial.reserve(ctx->Materials.size());
     for (const auto& mat : ctx->Materials)
         mEntityPerMaterial.emplace_back((int)mat.Count);
 
+    // Keep names around to make statistics readable
+    mStatisticNames.Materials.clear();
+    mStatisticNames.Materials.reserve(ctx->Materials.size());
+    for (const auto& mat : ctx->Materials)
+        mStatisticNames.Materials.emplace_back(mat.name());
+    mStatisticNames.Entities = ctx->Entities->entityNames();
+
     // Merge global registry
     mGlobalRegistry.mergeFrom(ctx->GlobalRegistry);
 
+    // Keep the loader state to regenerate shaders affected by later changes
+    if (mOptions.EnableHotReload) {
+        // Only changed shaders are compiled when reloading, which is known after generating them
+        ctx->Options.ShaderCallback = nullptr;
+        mLoaderContext              = std::make_unique<LoaderContext>(std::move(*ctx));
+    }
+
     // Free memory from loader context
     ctx.reset();
 
+    if (!checkMemoryLimit(estimateMemoryUsage(), "estimated after loading"))
+        return false;
+
     // Preload camera orientation
     setCameraOrientation(mInitialCameraOrientation);
     bool res = setupScene();
@@ -328,6 +522,125 @@ bool Runtime::load(const Path& path, const Scene* scene)
     if (mOptions.Denoiser.Enabled && !mOptions.DisableStandardAOVs)
         mDenoiser = std::make_unique<OIDN>(this);
 
+    mPeakMemoryUsage = memoryUsage();
+    if (!checkMemoryLimit(mPeakMemoryUsage, "after setting up the scene"))
+        return false;
+
+    if (useAdaptiveSampling) {
+        mAdaptiveSampler = std::make_unique<AdaptiveSampler>(mOptions.AdaptiveSampling, mFilmWidth, mFilmHeight);
+        mAdaptiveSampler->reset(mDevice.get(), mFilmWidth, mFilmHeight);
+
+        // Techniques generating their own rays or splatting to arbitrary pixels can not skip converged pixels
+        const bool compatible = std::all_of(mTechniqueInfo.Variants.begin(), mTechniqueInfo.Variants.end(), [](const TechniqueVariantInfo& info) {
+            return !info.OverrideCameraGenerator && !info.OverrideWidth.has_value() && !info.OverrideHeight.has_value();
+        });
+        if (!compatible) {
+            IG_LOG(L_WARNING) << "Technique '" << mTechniqueName << "' is not compatible with adaptive sampling. Rendering all pixels instead" << std::endl;
+            mAdaptiveSampler->disable();
+        }
+    }
+
+    if (mTechniqueInfo.PathGuiding.has_value() && !mOptions.IsTracer) {
+        mPathGuiding = std::make_unique<PathGuiding>(mTechniqueInfo.PathGuiding.value(), mDatabase.SceneBBox);
+        mPathGuiding->reset(mDevice.get());
+    }
+
+    return true;
+}
+
+bool Runtime::reload(const Scene* scene)
+{
+    if (!mLoaderContext) {
+        IG_LOG(L_ERROR) << "Reloading requires the runtime to be created with hot reload enabled" << std::endl;
+        return false;
+    }
+
+    IG_TIMELINE_SCOPE("loader", "Reload scene");
+    const auto startReload = std::chrono::high_resolution_clock::now();
+
+    // The loader state works on the database and the shader sources of the runtime while regenerating
+    LoaderContext& ctx    = *mLoaderContext;
+    const auto regenerate = [&](const Scene* target, ParameterSet& registry) {
+        ctx.TechniqueVariants = mTechniqueVariants;
+        std::swap(ctx.Database, mDatabase);
+        const auto result = Loader::reload(ctx, target, registry);
+        std::swap(ctx.Database, mDatabase);
+        return result;
+    };
+
+    auto next = std::make_unique<Scene>(scene->clone());
+    ParameterSet registry;
+    if (regenerate(next.get(), registry) != Loader::ReloadResult::Updated) {
+        ctx.TechniqueVariants.clear();
+        return false;
+    }
+
+    // Only compile shaders with a changed source. Unchanged shaders only get the new local registry
+    std::vector<TechniqueVariantShaderSet> shaderSets = mTechniqueVariantShaderSets;
+
+    mShaderManager    = createShaderManager(mCompiler.get(), mOptions);
+    size_t recompiled = 0;
+    const auto update = [&](size_t i, const std::string& name, const std::string& function, const ShaderOutput<std::string>& prev, const ShaderOutput<std::string>& source, ShaderOutput<void*>& compiled) {
+        if (source.Exec == prev.Exec) {
+            compiled.LocalRegistry = source.LocalRegistry;
+            return;
+        }
+
+        mShaderManager->add("v" + std::to_string(i) + " " + name,
+                            ShaderManager::ShaderEntry{
+                                .Source   = &source,
+                                .Function = function,
+                                .Compiled = &compiled,
+                            });
+        ++recompiled;
+    };
+
+    for (size_t i = 0; i < ctx.TechniqueVariants.size(); ++i) {
+        const auto& prev    = mTechniqueVariants[i];
+        const auto& variant = ctx.TechniqueVariants[i];
+        auto& shaders       = shaderSets[i];
+
+        for (size_t j = 0; j < variant.HitShaders.size(); ++j)
+            update(i, "hit shader " + std::to_string(j), "ig_hit_shader", prev.HitShaders[j], variant.HitShaders[j], shaders.HitShaders[j]);
+        for (size_t j = 0; j < variant.AdvancedShadowHitShaders.size(); ++j)
+            update(i, "advanced shadow hit shader " + std::to_string(j), "ig_advanced_shadow_shader", prev.AdvancedShadowHitShaders[j], variant.AdvancedShadowHitShaders[j], shaders.AdvancedShadowHitShaders[j]);
+        for (size_t j = 0; j < variant.AdvancedShadowMissShaders.size(); ++j)
+            update(i, "advanced shadow miss shader " + std::to_string(j), "ig_advanced_shadow_shader", prev.AdvancedShadowMissShaders[j], variant.AdvancedShadowMissShaders[j], shaders.AdvancedShadowMissShaders[j]);
+        for (size_t j = 0; j < variant.CallbackShaders.size(); ++j) {
+            if (!variant.CallbackShaders[j].Exec.empty())
+                update(i, "callback " + std::to_string(j), "ig_callback_shader", prev.CallbackShaders[j], variant.CallbackShaders[j], shaders.CallbackShaders[j]);
+        }
+    }
+
+    if (recompiled > 0) {
+        IG_TIMELINE_SCOPE("compile", "Recompile shaders");
+        if (!mShaderManager->compile()) {
+            mShaderManager.reset();
+
+            // Bring the loader state back to the scene matching the shaders still in use
+            ParameterSet unused;
+            if (regenerate(mScene.get(), unused) != Loader::ReloadResult::Updated) {
+                IG_LOG(L_ERROR) << "Could not restore the previous scene. Disabling hot reload" << std::endl;
+                mLoaderContext.reset();
+            } else {
+                ctx.TechniqueVariants.clear();
+            }
+            return false;
+        }
+    }
+    mShaderManager.reset();
+
+    // Swap the shaders. This is safe, as no iteration is in flight while the runtime is accessed
+    mTechniqueVariants          = std::move(ctx.TechniqueVariants);
+    mTechniqueVariantShaderSets = std::move(shaderSets);
+    mResourceMap                = ctx.generateResourceMap(); // The device keeps a pointer to the map, new resources are appended only
+    mScene                      = std::move(next);
+    ctx.TechniqueVariants.clear();
+
+    mGlobalRegistry.mergeFrom(registry, true);
+    reset();
+
+    IG_LOG(L_INFO) << "Reloaded scene with " << recompiled << " recompiled shaders in " << (std::chrono::high_resolution_clock::now() - startReload) << std::endl;
     return true;
 }
 
@@ -343,8 +656,13 @@ void Runtime::step(bool ignoreDenoiser)
         return;
     }
 
+    IG_TIMELINE_SCOPE("render", "Iteration " + std::to_string(mCurrentIteration));
+
     handleTime();
 
+    if (mSpecializationProfile)
+        mSpecializationProfile->recordParameters(mGlobalRegistry);
+
     if (mTechniqueInfo.VariantSelector) {
         const auto active = mTechniqueInfo.VariantSelector(mCurrentIteration);
 
@@ -357,12 +675,38 @@ void Runtime::step(bool ignoreDenoiser)
             stepVariant((int)i);
     }
 
-    if (mDenoiser && !ignoreDenoiser)
-        mDenoiser->run(mDevice.get());
+    if (mAdaptiveSampler) {
+        std::vector<std::string> fill_aovs;
+        for (const auto& aov : mTechniqueInfo.EnabledAOVs) {
+            // The cost is measured, not estimated, therefore skipped pixels have no cost
+            if (aov != "Denoised" && aov != IRenderDevice::CostAOV && !isSingleUseAOV(aov))
+                fill_aovs.emplace_back(aov);
+        }
+        mAdaptiveSampler->update(mDevice.get(), mCurrentIteration + 1, mTechniqueInfo.ComputeSPI(mCurrentIteration, mSamplesPerIteration), fill_aovs);
+    }
+
+    if (mPathGuiding)
+        mPathGuiding->update(mDevice.get());
+
+    if (mDenoiser && !ignoreDenoiser) {
+        IG_TIMELINE_SCOPE("render", "Denoise");
+        mDenoiser->run(mDevice.get(), mCurrentIteration + 1);
+    }
+
+    updateMemoryUsage();
 
     ++mCurrentIteration;
 }
 
+void Runtime::finishDenoiser()
+{
+    if (!mDenoiser || mCurrentIteration == 0)
+        return;
+
+    IG_TIMELINE_SCOPE("render", "Denoise");
+    mDenoiser->finish(mDevice.get(), mCurrentIteration);
+}
+
 void Runtime::stepVariant(size_t variant)
 {
     IG_ASSERT(variant < mTechniqueVariants.size(), "Expected technique variant to be well selected");
@@ -387,6 +731,20 @@ void Runtime::stepVariant(size_t variant)
 }
 
 void Runtime::trace(const std::vector<Ray>& rays)
+{
+    static_assert(sizeof(Ray) == 8 * sizeof(float), "Expected Ray to be tightly packed");
+
+    RayBatch batch;
+    batch.Count       = rays.size();
+    batch.Origins     = rays.empty() ? nullptr : rays.front().Origin.data();
+    batch.Directions  = rays.empty() ? nullptr : rays.front().Direction.data();
+    batch.Ranges      = rays.empty() ? nullptr : rays.front().Range.data();
+    batch.Stride      = sizeof(Ray) / sizeof(float);
+    batch.RangeStride = sizeof(Ray) / sizeof(float);
+    trace(batch);
+}
+
+void Runtime::trace(const RayBatch& rays)
 {
     if (!mOptions.IsTracer) {
         IG_LOG(L_ERROR) << "Trying to use trace() in a camera driver!" << std::endl;
@@ -400,6 +758,9 @@ void Runtime::trace(const std::vector<Ray>& rays)
 
     handleTime();
 
+    if (mSpecializationProfile)
+        mSpecializationProfile->recordParameters(mGlobalRegistry);
+
     if (mTechniqueInfo.VariantSelector) {
         const auto& active = mTechniqueInfo.VariantSelector(mCurrentIteration);
         for (const auto& ind : active)
@@ -409,6 +770,8 @@ void Runtime::trace(const std::vector<Ray>& rays)
             traceVariant(rays, i);
     }
 
+    updateMemoryUsage();
+
     ++mCurrentIteration;
 }
 
@@ -422,7 +785,7 @@ void Runtime::trace(const std::vector<Ray>& rays, std::vector<float>& data)
     std::memcpy(data.data(), data_ptr, sizeof(float) * data.size());
 }
 
-void Runtime::traceVariant(const std::vector<Ray>& rays, size_t variant)
+void Runtime::traceVariant(const RayBatch& rays, size_t variant)
 {
     IG_ASSERT(variant < mTechniqueVariants.size(), "Expected technique variant to be well selected");
     const auto& info = mTechniqueInfo.Variants[variant];
@@ -430,9 +793,9 @@ void Runtime::traceVariant(const std::vector<Ray>& rays, size_t variant)
     // IG_LOG(L_DEBUG) << "Tracing iteration " << mCurrentIteration << ", variant " << variant << std::endl;
 
     IRenderDevice::RenderSettings settings;
-    settings.rays      = rays.data();
+    settings.rays      = &rays;
     settings.spi       = info.GetSPI(mSamplesPerIteration);
-    settings.width     = rays.size();
+    settings.width     = rays.Count;
     settings.height    = 1;
     settings.info      = info;
     settings.iteration = mCurrentIteration;
@@ -493,14 +856,88 @@ void Runtime::reset()
     clearFramebuffer();
     mCurrentIteration   = 0;
     mCurrentSampleCount = 0;
+
+    if (mAdaptiveSampler)
+        mAdaptiveSampler->reset(mDevice.get(), mFilmWidth, mFilmHeight);
+    if (mPathGuiding)
+        mPathGuiding->reset(mDevice.get());
+    if (mDenoiser)
+        mDenoiser->reset();
     // No mCurrentFrameCount
 }
 
+void Runtime::resetToIteration(size_t iteration)
+{
+    reset();
+    mCurrentIteration = iteration;
+}
+
 const Statistics* Runtime::statistics() const
 {
     return mOptions.AcquireStats ? mDevice->getStatistics() : nullptr;
 }
 
+static inline void addDatabaseMemoryUsage(MemoryUsage& usage, const SceneDatabase& database, MemoryLocation location)
+{
+    for (const auto& p : database.DynTables)
+        usage.add(MemoryUsage::getTableCategory(p.first), location, p.second.data().size() + p.second.lookups().size() * sizeof(LookupEntry));
+    for (const auto& p : database.FixTables)
+        usage.add(MemoryUsage::getTableCategory(p.first), location, p.second.data().size());
+    for (const auto& p : database.SceneBVHs)
+        usage.add(MemoryCategory::BVH, location, p.second.Nodes.size() + p.second.Leaves.size());
+}
+
+MemoryUsage Runtime::memoryUsage() const
+{
+    MemoryUsage usage;
+    addDatabaseMemoryUsage(usage, mDatabase, MemoryLocation::Host);
+    if (mDevice)
+        usage += mDevice->getMemoryUsage();
+    if (mDenoiser)
+        mDenoiser->addMemoryUsage(usage);
+    return usage;
+}
+
+MemoryUsage Runtime::estimateMemoryUsage() const
+{
+    // Images, buffers and streams are only known while rendering
+    MemoryUsage usage;
+    addDatabaseMemoryUsage(usage, mDatabase, MemoryLocation::Host);
+    if (mOptions.Target.isGPU())
+        addDatabaseMemoryUsage(usage, mDatabase, MemoryLocation::Device);
+
+    const size_t framebufferBytes = mFilmWidth * mFilmHeight * 3 * sizeof(float) * (mTechniqueInfo.EnabledAOVs.size() + 1);
+    usage.add(MemoryCategory::Framebuffer, MemoryLocation::Host, framebufferBytes);
+    if (mOptions.Target.isGPU())
+        usage.add(MemoryCategory::Framebuffer, MemoryLocation::Device, framebufferBytes);
+
+    return usage;
+}
+
+void Runtime::updateMemoryUsage()
+{
+    const MemoryUsage usage = memoryUsage();
+    mPeakMemoryUsage.max(usage);
+
+    // The limit is only enforced while loading, afterwards it is reported once
+    if (!mMemoryLimitExceeded && !checkMemoryLimit(usage, "while rendering"))
+        mMemoryLimitExceeded = true;
+}
+
+bool Runtime::checkMemoryLimit(const MemoryUsage& usage, const std::string_view& stage) const
+{
+    if (mOptions.MaxMemoryMB == 0)
+        return true;
+
+    const size_t limit = mOptions.MaxMemoryMB * 1024 * 1024;
+    if (usage.total() <= limit)
+        return true;
+
+    IG_LOG(L_ERROR) << "Memory usage of " << FormatMemory(usage.total()) << " " << stage << " exceeds the limit of " << FormatMemory(limit) << std::endl
+                    << usage.dump();
+    return false;
+}
+
 static void dumpRegistries(std::ostream& stream, const std::string& name, const ShaderOutput<void*>& shader)
 {
     if (shader.Exec == nullptr || shader.LocalRegistry == nullptr || shader.LocalRegistry->empty())
@@ -538,7 +975,12 @@ bool Runtime::setupScene()
     settings.entity_per_material = &mEntityPerMaterial;
 
     IG_LOG(L_DEBUG) << "Assign scene to device" << std::endl;
-    mDevice->assignScene(settings);
+    {
+        IG_TIMELINE_SCOPE("loader", "Assign scene");
+        const auto startAssign = std::chrono::high_resolution_clock::now();
+        mDevice->assignScene(settings);
+        mLoadTimings.AssignMS = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startAssign).count();
+    }
 
     if (IG_LOGGER.verbosity() <= L_DEBUG) {
         if (mOptions.DumpRegistry) {
@@ -581,7 +1023,8 @@ bool Runtime::setupScene()
     if (IG_LOGGER.verbosity() <= L_DEBUG) {
         if (mOptions.DumpRegistryFull) {
             for (size_t i = 0; i < mTechniqueVariantShaderSets.size(); ++i) {
-                auto& stream = IG_LOG_UNSAFE(L_DEBUG);
+                auto closure = Logger::threadsafe();
+                auto& stream = closure.log(L_DEBUG);
                 stream << "Local Variant [" << i << "] Registries:" << std::endl;
                 dumpRegistries(stream, mTechniqueVariantShaderSets.at(i));
             }
@@ -595,22 +1038,8 @@ bool Runtime::setupScene()
 
 bool Runtime::compileShaders()
 {
-    size_t threads = mOptions.ShaderCompileThreads;
-    if (threads == 0)
-        threads = std::thread::hardware_concurrency() / 2; // Using the compiler might be a heavy task, therefore only use half of the cpu count. TODO: Make this smarter?
-
-    if (threads > 1) {
-        if (RuntimeInfo::igcPath().empty()) {
-            IG_LOG(L_WARNING) << "Could not find " << RuntimeInfo::igcPath() << ". Falling back to single threaded shader compilation" << std::endl;
-            threads = 1;
-        } else {
-            IG_LOG(L_DEBUG) << "Using compiler at " << RuntimeInfo::igcPath() << std::endl;
-        }
-    }
-
-    threads = std::max<size_t>(1, threads);
-
-    ShaderManager manager;
+    IG_ASSERT(mShaderManager, "Expected shader manager to be created while loading");
+    ShaderManager& manager    = *mShaderManager;
     const auto registerShader = [&](size_t i, const std::string& name, const std::string& function, const ShaderOutput<std::string>* source, ShaderOutput<void*>* compiled) {
         const std::string id = "v" + std::to_string(i) + " " + name;
         manager.add(id,
@@ -659,9 +1088,12 @@ bool Runtime::compileShaders()
         }
     }
 
+    IG_TIMELINE_SCOPE("compile", "Compile shaders");
     const auto startJIT = std::chrono::high_resolution_clock::now();
-    const bool result   = manager.compile(mCompiler.get(), threads, mOptions.DumpShaderFull ? ShaderDumpVerbosity::Full : (mOptions.DumpShader ? ShaderDumpVerbosity::Light : ShaderDumpVerbosity::None));
+    const bool result   = manager.compile();
+    mShaderManager.reset();
 
+    mLoadTimings.CompileMS = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startJIT).count();
     IG_LOG(L_DEBUG) << "Compiling shaders took " << (std::chrono::high_resolution_clock::now() - startJIT) << std::endl;
 
     return result;
@@ -733,6 +1165,86 @@ std::vector<std::string> Runtime::getAvailableCameraTypes()
     return Loader::getAvailableCameraTypes();
 }
 
+Checkpoint Runtime::createCheckpoint() const
+{
+    Checkpoint checkpoint;
+    checkpoint.Width       = framebufferWidth();
+    checkpoint.Height      = framebufferHeight();
+    checkpoint.Iteration   = currentIterationCount();
+    checkpoint.SampleCount = currentSampleCount();
+    checkpoint.Frame       = currentFrameCount();
+    checkpoint.Seed        = seed();
+    checkpoint.Technique   = technique();
+    checkpoint.Camera      = camera();
+
+    const size_t size = checkpoint.Width * checkpoint.Height * 3;
+    const auto copy   = [&](const std::string& name) {
+        const float* data = getFramebufferForHost(name).Data;
+        if (data)
+            checkpoint.Buffers[name] = std::vector<float>(data, data + size);
+    };
+
+    copy({});
+    for (const auto& aov : aovs())
+        copy(aov);
+
+    return checkpoint;
+}
+
+bool Runtime::restoreCheckpoint(const Checkpoint& checkpoint)
+{
+    if (checkpoint.Width != framebufferWidth() || checkpoint.Height != framebufferHeight()) {
+        IG_LOG(L_ERROR) << "Checkpoint has resolution " << checkpoint.Width << "x" << checkpoint.Height
+                        << " but framebuffer has " << framebufferWidth() << "x" << framebufferHeight() << std::endl;
+        return false;
+    }
+
+    if (checkpoint.Technique != technique() || checkpoint.Camera != camera()) {
+        IG_LOG(L_ERROR) << "Checkpoint was created with technique '" << checkpoint.Technique << "' and camera '" << checkpoint.Camera
+                        << "', but scene uses technique '" << technique() << "' and camera '" << camera() << "'" << std::endl;
+        return false;
+    }
+
+    if (!checkpoint.Buffers.contains(std::string{})) {
+        IG_LOG(L_ERROR) << "Checkpoint does not contain a framebuffer" << std::endl;
+        return false;
+    }
+
+    if (checkpoint.Seed != seed())
+        IG_LOG(L_WARNING) << "Checkpoint was created with seed " << checkpoint.Seed << " but current seed is " << seed() << std::endl;
+
+    reset();
+
+    const size_t size  = checkpoint.Width * checkpoint.Height * 3;
+    const auto restore = [&](const std::string& name) {
+        const auto it = checkpoint.Buffers.find(name);
+        if (it == checkpoint.Buffers.end()) {
+            IG_LOG(L_WARNING) << "Checkpoint does not contain AOV '" << name << "'. Resuming with an empty AOV" << std::endl;
+            return;
+        }
+
+        float* data = getFramebufferForHost(name).Data;
+        if (!data)
+            return;
+
+        std::copy_n(it->second.data(), size, data);
+        mDevice->syncFramebufferHostToDevice(name);
+    };
+
+    restore({});
+    for (const auto& aov : aovs())
+        restore(aov);
+
+    if (mAdaptiveSampler)
+        mAdaptiveSampler->resume(mDevice.get());
+
+    // The iteration counter is part of the random seed, therefore continuing it keeps the new samples decorrelated
+    mCurrentIteration   = checkpoint.Iteration;
+    mCurrentSampleCount = checkpoint.SampleCount;
+    mCurrentFrame       = checkpoint.Frame;
+    return true;
+}
+
 void Runtime::setCameraOrientation(const CameraOrientation& orientation)
 {
     setParameter("__camera_eye", orientation.Eye);
@@ -806,8 +1318,8 @@ bool Runtime::saveFramebuffer(const Path& path) const
         const std::string aov_name = aov == 0 ? std::string{} : aovs[aov - 1];
 
         float scale = currentIterationCount() > 0 ? 1.0f / currentIterationCount() : 1.0f;
-        if (aov_name == "Normals" || aov_name == "Albedo")
-            scale = 1; // TODO: Add flags for single use AOVs
+        if (isSingleUseAOV(aov_name))
+            scale = 1;
 
         const auto acc   = getFramebufferForHost(aov_name);
         const float* src = acc.Data;
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "AdaptiveSampler.h"
+#include "Checkpoint.h"
 #include "ParameterDescSet.h"
 #include "ParameterSet.h"
+#include "PathGuiding.h"
 #include "RenderPass.h"
 #include "RuntimeSettings.h"
 #include "RuntimeStructs.h"
@@ -44,14 +47,29 @@ public:
     /// @param scene Valid scene
     [[nodiscard]] bool loadFromScene(const Scene* scene);
 
+    /// Reload changed bsdfs and textures from file. Only the affected hit, advanced shadow and callback shaders are regenerated and recompiled,
+    /// everything else (e.g., BVHs, images and unaffected shaders) stays resident. Requires hot reload to be enabled in the options.
+    /// Returns false if reloading failed or the scene changed in a way which requires a full reload, in which case the current scene is kept
+    [[nodiscard]] bool reloadFromFile(const Path& path);
+
+    /// Reload changed bsdfs and textures from an already present scene. See reloadFromFile for more information
+    /// @param scene Valid scene
+    [[nodiscard]] bool reloadFromScene(const Scene* scene);
+
     /// Do a single iteration in non-tracing mode
     void step(bool ignoreDenoiser = false);
+    /// Make sure the denoised AOV is up to date with the current iteration. Waits for a pending asynchronous denoiser job. Nothing is done if the denoiser is disabled
+    void finishDenoiser();
     /// Do a single iteration in tracing mode and return values in data
     void trace(const std::vector<Ray>& rays, std::vector<float>& data);
     /// Do a single iteration in tracing mode. Output will be in the framebuffer
     void trace(const std::vector<Ray>& rays);
+    /// Do a single iteration in tracing mode with rays given as a view on external memory. Output will be in the framebuffer
+    void trace(const RayBatch& rays);
     /// Reset internal counters etc. This should be used if data (like camera orientation) has changed. Frame counter will NOT be reset
     void reset();
+    /// Reset and continue with the given iteration. The iteration is part of the random seed, which allows rendering disjoint sample ranges in multiple processes
+    void resetToIteration(size_t iteration);
 
     /// A utility function to speed up tonemapping
     /// out_pixels should be of size width*height!
@@ -96,12 +114,28 @@ public:
     /// Return seed used for the random generator
     [[nodiscard]] inline size_t seed() const { return mOptions.Seed; }
 
+    /// Return true if adaptive sampling is enabled and all pixels reached the target error
+    [[nodiscard]] inline bool isConverged() const { return mAdaptiveSampler && mAdaptiveSampler->isConverged(); }
+    /// Return number of pixels not yet converged. Returns the number of all pixels if adaptive sampling is disabled
+    [[nodiscard]] inline size_t activePixelCount() const { return mAdaptiveSampler ? mAdaptiveSampler->activePixelCount() : mFilmWidth * mFilmHeight; }
+
     /// Increase frame count (only used in interactive/realtime sessions)
     inline void incFrameCount() { mCurrentFrame++; }
 
     /// Return pointer to structure containing statistics
     [[nodiscard]] const Statistics* statistics() const;
 
+    /// Return names of materials and entities used to annotate the statistics
+    [[nodiscard]] inline const StatisticNames& statisticNames() const { return mStatisticNames; }
+
+    /// Return the memory currently allocated on the host and the device per category
+    [[nodiscard]] MemoryUsage memoryUsage() const;
+    /// Return the peak memory per category observed after loading and each iteration
+    [[nodiscard]] inline const MemoryUsage& peakMemoryUsage() const { return mPeakMemoryUsage; }
+
+    /// Return the time spent loading, assigning and compiling the current scene
+    [[nodiscard]] inline const LoadTimings& loadTimings() const { return mLoadTimings; }
+
     /// Returns the name of the loaded technique
     [[nodiscard]] inline const std::string& technique() const { return mTechniqueName; }
 
@@ -156,6 +190,11 @@ public:
     /// Save the current framebuffer as a multilayered exr file with metadata attached
     bool saveFramebuffer(const Path& path) const;
 
+    /// Capture the accumulated framebuffer, all AOVs and the counters. This copies all data, such that the checkpoint can be saved asynchronously
+    [[nodiscard]] Checkpoint createCheckpoint() const;
+    /// Restore the accumulated framebuffer, all AOVs and the counters from a checkpoint. Returns false if the checkpoint is not compatible
+    bool restoreCheckpoint(const Checkpoint& checkpoint);
+
     /// The initial camera orientation the scene was loaded with. Can be used to reset in later iterations
     [[nodiscard]] inline CameraOrientation initialCameraOrientation() const { return mInitialCameraOrientation; }
     /// Set internal parameters for the camera orientation. This is only a convenient wrapper around multiple setParameter calls
@@ -166,6 +205,9 @@ public:
     /// True if denoising can be applied
     [[nodiscard]] static bool hasDenoiser();
 
+    /// True if the AOV is not accumulated over iterations and therefore not normalized by the iteration count
+    [[nodiscard]] static bool isSingleUseAOV(const std::string& name);
+
     /// True if the scene has entries in the `parameters` section
     [[nodiscard]] inline bool hasSceneParameters() const { return !sceneParameterDesc().empty(); }
     [[nodiscard]] inline const ParameterDescSet sceneParameterDesc() const { return mSceneParameterDesc; }
@@ -186,11 +228,17 @@ public:
 private:
     void checkCacheDirectory();
     bool load(const Path& path, const Scene* scene);
+    bool reload(const Scene* scene);
     bool setupScene();
     bool compileShaders();
     void stepVariant(size_t variant);
-    void traceVariant(const std::vector<Ray>& rays, size_t variant);
+    void traceVariant(const RayBatch& rays, size_t variant);
     void handleTime();
+    void setupSpecializationProfile(LoaderOptions& lopts);
+    void saveSpecializationProfile();
+    [[nodiscard]] MemoryUsage estimateMemoryUsage() const;
+    void updateMemoryUsage();
+    [[nodiscard]] bool checkMemoryLimit(const MemoryUsage& usage, const std::string_view& stage) const;
 
     const RuntimeOptions mOptions;
 
@@ -200,8 +248,17 @@ private:
 
     std::unique_ptr<ScriptCompiler> mCompiler;
     std::unique_ptr<IRenderDevice> mDevice;
+    std::unique_ptr<class ShaderManager> mShaderManager; // Only available while loading
+
+    std::unique_ptr<Scene> mScene;                 // Only available if hot reload is enabled
+    std::unique_ptr<LoaderContext> mLoaderContext; // Only available if hot reload is enabled
+
+    std::shared_ptr<class SpecializationProfile> mSpecializationProfile; // Only available if the specialization mode is profile
+    Path mSpecializationProfileFile;
 
     std::unique_ptr<OIDN> mDenoiser;
+    std::unique_ptr<AdaptiveSampler> mAdaptiveSampler;
+    std::unique_ptr<PathGuiding> mPathGuiding;
 
     size_t mSamplesPerIteration;
 
@@ -222,6 +279,10 @@ private:
 
     std::vector<std::string> mResourceMap;
     std::vector<int> mEntityPerMaterial;
+    StatisticNames mStatisticNames;
+    MemoryUsage mPeakMemoryUsage;
+    LoadTimings mLoadTimings;
+    bool mMemoryLimitExceeded = false;
 
     std::vector<TechniqueVariant> mTechniqueVariants;
     std::vector<TechniqueVariantShaderSet> mTechniqueVariantShaderSets; // Compiled shaders
@@ -10,6 +10,7 @@
 #include <climits>
 #include <dlfcn.h>
 #include <mach-o/dyld.h>
+#include <unistd.h>
 #elif defined(IG_OS_WINDOWS)
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -218,6 +219,15 @@ Path RuntimeInfo::cacheDirectory()
 #endif
 }
 
+uint64 RuntimeInfo::processID()
+{
+#if defined(IG_OS_LINUX) || defined(IG_OS_APPLE)
+    return (uint64)getpid();
+#else
+    return (uint64)GetCurrentProcessId();
+#endif
+}
+
 size_t RuntimeInfo::sizeOfDirectory(const Path& dir)
 {
     if (!std::filesystem::exists(dir))
@@ -24,6 +24,9 @@ public:
     /// Path to a folder containing cache files. This directory must be modifiable.
     [[nodiscard]] static Path cacheDirectory();
 
+    /// Identifier of the current process.
+    [[nodiscard]] static uint64 processID();
+
     /// Computes the size of the directory recursively (with all files inside of it).
     [[nodiscard]] static size_t sizeOfDirectory(const Path& dir);
 
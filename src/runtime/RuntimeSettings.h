@@ -4,9 +4,18 @@
 
 namespace IG {
 struct DenoiserSettings {
-    bool Enabled     = false; // Enables the denoiser
-    bool HighQuality = true;
-    bool Prefilter   = false;
+    bool Enabled       = false; // Enables the denoiser
+    bool HighQuality   = true;
+    bool Prefilter     = false;
+    bool Async         = false; // Denoise in a background thread. The result is published a few iterations later
+    size_t MaxMemoryMB = 0;     // Upper bound of the memory used by the denoiser. The image is denoised in tiles if required. Zero disables the limit
+};
+
+struct AdaptiveSamplingSettings {
+    bool Enabled         = false; // Enables adaptive sampling
+    float TargetError    = 0.01f; // Relative error a tile has to reach to be considered converged
+    uint32 MinIterations = 4;     // Minimum number of iterations before a tile can converge
+    uint32 TileSize      = 8;     // Size of the tiles the convergence is decided on. Set to 1 to decide per pixel
 };
 
 struct RuntimeOptions {
@@ -19,6 +28,7 @@ struct RuntimeOptions {
     bool DumpRegistryFull  = false;
     bool AcquireStats      = false;
     bool DebugTrace        = false; // Show debug information regarding the calls on the device
+    Path TimelineFile      = {};    // Record a timeline of the session and write it in the Chrome trace format to the given file on destruction
     uint32 SPI             = 0;     // Detect automatically
 
     size_t Seed = 0;
@@ -40,14 +50,19 @@ struct RuntimeOptions {
     enum class SpecializationMode {
         Default = 0, // Depending on the parameter it will be embedded or not.
         Force,       // Enforce specialization of generated shader for all parameters. This will increase compile time
-        Disable      // Disables specialization of generated shader for all parameters except structural.
+        Disable,     // Disables specialization of generated shader for all parameters except structural.
+        Profile      // Specialize frequently hit materials and keep the others generic, based on the profile recorded by a previous run in the cache directory. Behaves like Default if no profile exists
     };
     SpecializationMode Specialization = SpecializationMode::Default;
 
     bool WarnUnused = true; // Warn about unused properties. They might indicate a typo or similar.
 
     bool DisableStandardAOVs = false; // Disable standard AOVs (e.g., Normal, Albedo)
+    bool EnableCostAOV       = false; // Record the render cost per tile into the 'Cost' AOV. Only available on the CPU
+    size_t MaxMemoryMB       = 0;     // Fail loading if the (estimated) memory usage exceeds the given limit in megabytes. Zero disables the limit
+    bool EnableHotReload     = false; // Keep the loader state after loading, such that changed materials and textures can be reloaded without a full reload
     DenoiserSettings Denoiser;
+    AdaptiveSamplingSettings AdaptiveSampling;
 
     inline static RuntimeOptions makeDefault(bool trace = false)
     {
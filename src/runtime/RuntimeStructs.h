@@ -36,9 +36,27 @@ struct ImageInfoOutput {
     int NegCount;
 };
 
+/// Time spent in the stages of loading a scene, in milliseconds
+struct LoadTimings {
+    double LoaderMS  = 0; // Parsing the scene and generating the shaders
+    double AssignMS  = 0; // Assigning the scene to the device
+    double CompileMS = 0; // Compiling the shaders
+};
+
 struct Ray {
     Vector3f Origin;
     Vector3f Direction;
     Vector2f Range;
 };
+
+/// Non-owning view of a list of rays stored in plain float arrays, e.g., external buffers.
+/// Allows rays to be traced without converting them into a list of Ray first
+struct RayBatch {
+    size_t Count            = 0;
+    const float* Origins    = nullptr; // Three floats per ray
+    const float* Directions = nullptr; // Three floats per ray
+    const float* Ranges     = nullptr; // Optional two floats (tmin, tmax) per ray. Full range [0, inf) is used if not given
+    size_t Stride           = 3;       // Number of floats between two consecutive origins or directions
+    size_t RangeStride      = 2;       // Number of floats between two consecutive ranges
+};
 } // namespace IG
\ No newline at end of file
@@ -3,7 +3,7 @@
 #include "IG_Config.h"
 
 namespace IG {
-class SHA256 {
+class IG_LIB SHA256 {
 public:
     SHA256();
 
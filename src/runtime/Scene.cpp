@@ -27,6 +27,35 @@ void Scene::addFrom(const Scene& other)
         mFilm = other.mFilm;
 }
 
+static std::shared_ptr<SceneObject> cloneObject(const std::shared_ptr<SceneObject>& obj)
+{
+    return obj ? std::make_shared<SceneObject>(*obj) : nullptr;
+}
+
+Scene Scene::clone() const
+{
+    Scene scene;
+    for (const auto& tex : mTextures)
+        scene.addTexture(tex.first, cloneObject(tex.second));
+    for (const auto& bsdf : mBSDFs)
+        scene.addBSDF(bsdf.first, cloneObject(bsdf.second));
+    for (const auto& light : mLights)
+        scene.addLight(light.first, cloneObject(light.second));
+    for (const auto& medium : mMedia)
+        scene.addMedium(medium.first, cloneObject(medium.second));
+    for (const auto& shape : mShapes)
+        scene.addShape(shape.first, cloneObject(shape.second));
+    for (const auto& ent : mEntities)
+        scene.addEntity(ent.first, cloneObject(ent.second));
+    for (const auto& param : mParameters)
+        scene.addParameter(param.first, cloneObject(param.second));
+
+    scene.mTechnique = cloneObject(mTechnique);
+    scene.mCamera    = cloneObject(mCamera);
+    scene.mFilm      = cloneObject(mFilm);
+    return scene;
+}
+
 void Scene::addConstantEnvLight()
 {
     if (mLights.count("__env") == 0) {
@@ -47,7 +76,8 @@ static void warnUnused(const std::string& prefix, const SceneObject& obj)
     if (unusedCount == 0)
         return;
 
-    auto& stream = IG_LOG(L_WARNING);
+    auto closure = Logger::threadsafe();
+    auto& stream = closure.log(L_WARNING);
     stream << prefix << " has ";
     if (unusedCount == 1)
         stream << "one unused property: [";
@@ -51,6 +51,9 @@ public:
     /// Add all information from other to this scene, replacing present information
     void addFrom(const Scene& other);
 
+    /// Copy of this scene with all objects copied as well, instead of sharing them
+    [[nodiscard]] Scene clone() const;
+
     void addConstantEnvLight();
 
     void warnUnusedProperties() const;
@@ -63,6 +63,20 @@ public:
     inline bool hasProperty(const std::string& key) const { return mProperties.count(key) > 0; }
     inline const std::unordered_map<std::string, SceneProperty>& properties() const { return mProperties; }
 
+    /// True if both objects have the same type and properties. The usage flags are ignored
+    inline bool isEqual(const SceneObject& other) const
+    {
+        if (mType != other.mType || mPluginType != other.mPluginType || mBaseDir != other.mBaseDir || mProperties.size() != other.mProperties.size())
+            return false;
+
+        for (const auto& pair : mProperties) {
+            const auto it = other.mProperties.find(pair.first);
+            if (it == other.mProperties.end() || !pair.second.isEqual(it->second))
+                return false;
+        }
+        return true;
+    }
+
 private:
     Type mType;
     std::string mPluginType;
@@ -2,6 +2,7 @@
 
 #include "IG_Config.h"
 
+#include <atomic>
 #include <functional>
 #include <string>
 #include <variant>
@@ -262,12 +263,32 @@ public:
         return p;
     }
 
+    // Properties are queried by parallel shader generation tasks, therefore the flag is accessed atomically
     inline void markUsed(bool b = true)
     {
-        mUsed = b;
+        std::atomic_ref<bool>(mUsed).store(b, std::memory_order_relaxed);
     }
 
-    inline bool isUsed() const { return mUsed; }
+    inline bool isUsed() const { return std::atomic_ref<bool>(const_cast<bool&>(mUsed)).load(std::memory_order_relaxed); }
+
+    /// True if both properties have the same type and value. The usage flag is ignored
+    inline bool isEqual(const SceneProperty& other) const
+    {
+        if (mType != other.mType || mData.index() != other.mData.index())
+            return false;
+        if (mType == PT_NONE)
+            return true;
+
+        const auto equal = [&](const auto& a) -> bool {
+            using T       = std::decay_t<decltype(a)>;
+            const auto& b = std::get<T>(other.mData);
+            if constexpr (std::is_same_v<T, Transformf>)
+                return a.matrix() == b.matrix();
+            else
+                return a == b;
+        };
+        return std::visit(equal, mData);
+    }
 
 private:
     inline explicit SceneProperty(Type type)
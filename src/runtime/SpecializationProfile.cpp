@@ -0,0 +1,186 @@
+#include "SpecializationProfile.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#define RAPIDJSON_HAS_STDSTRING 1
+#include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/prettywriter.h>
+
+namespace IG {
+constexpr int ProfileVersion = 1;
+
+SpecializationProfile::SpecializationProfile()
+    : mHasLastParameters(false)
+{
+}
+
+void SpecializationProfile::setMaterialWorkloads(const std::unordered_map<std::string, size_t>& workloads)
+{
+    mMaterialWorkloads = workloads;
+    updateHotMaterials();
+}
+
+bool SpecializationProfile::isHotMaterial(const std::string& name) const
+{
+    return mHotMaterials.contains(name);
+}
+
+void SpecializationProfile::updateHotMaterials()
+{
+    mHotMaterials.clear();
+
+    std::vector<std::pair<std::string, size_t>> sorted(mMaterialWorkloads.begin(), mMaterialWorkloads.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    size_t total = 0;
+    for (const auto& pair : sorted)
+        total += pair.second;
+
+    // Add the most frequently hit materials until they cover the requested fraction of the workload
+    const size_t threshold = (size_t)std::ceil(total * (double)HotWorkloadFraction);
+    size_t covered         = 0;
+    for (const auto& pair : sorted) {
+        if (covered >= threshold || pair.second == 0)
+            break;
+        mHotMaterials.insert(pair.first);
+        covered += pair.second;
+    }
+}
+
+void SpecializationProfile::trackParameters(const std::vector<std::string>& names)
+{
+    mTrackedParameters = names;
+    mHasLastParameters = false;
+}
+
+template <typename Map>
+static inline bool hasChanged(const Map& current, const Map& last, const std::string& name)
+{
+    const auto a = current.find(name);
+    const auto b = last.find(name);
+    if (a == current.end() || b == last.end())
+        return a != current.end() || b != last.end();
+    return a->second != b->second;
+}
+
+void SpecializationProfile::recordParameters(const ParameterSet& registry)
+{
+    if (mTrackedParameters.empty())
+        return;
+
+    if (mHasLastParameters) {
+        for (const auto& name : mTrackedParameters) {
+            if (mVaryingParameters.contains(name))
+                continue;
+
+            if (hasChanged(registry.IntParameters, mLastParameters.IntParameters, name)
+                || hasChanged(registry.FloatParameters, mLastParameters.FloatParameters, name)
+                || hasChanged(registry.VectorParameters, mLastParameters.VectorParameters, name)
+                || hasChanged(registry.ColorParameters, mLastParameters.ColorParameters, name))
+                mVaryingParameters.insert(name);
+        }
+    }
+
+    // Only keep the tracked parameters around, as the registry might contain large amounts of internal parameters
+    mLastParameters = ParameterSet();
+    for (const auto& name : mTrackedParameters) {
+        if (const auto it = registry.IntParameters.find(name); it != registry.IntParameters.end())
+            mLastParameters.IntParameters[name] = it->second;
+        if (const auto it = registry.FloatParameters.find(name); it != registry.FloatParameters.end())
+            mLastParameters.FloatParameters[name] = it->second;
+        if (const auto it = registry.VectorParameters.find(name); it != registry.VectorParameters.end())
+            mLastParameters.VectorParameters[name] = it->second;
+        if (const auto it = registry.ColorParameters.find(name); it != registry.ColorParameters.end())
+            mLastParameters.ColorParameters[name] = it->second;
+    }
+    mHasLastParameters = true;
+}
+
+bool SpecializationProfile::isVaryingParameter(const std::string& name) const
+{
+    return mVaryingParameters.contains(name);
+}
+
+std::optional<SpecializationProfile> SpecializationProfile::load(const Path& file)
+{
+    if (!std::filesystem::exists(file))
+        return std::nullopt; // No profile was recorded yet
+
+    std::ifstream ifs(file);
+    if (!ifs.good()) {
+        IG_LOG(L_ERROR) << "Could not open file '" << file << "'" << std::endl;
+        return std::nullopt;
+    }
+
+    rapidjson::IStreamWrapper isw(ifs);
+
+    rapidjson::Document doc;
+    if (doc.ParseStream(isw).HasParseError()) {
+        IG_LOG(L_ERROR) << "JSON[" << doc.GetErrorOffset() << "]: " << rapidjson::GetParseError_En(doc.GetParseError()) << std::endl;
+        return std::nullopt;
+    }
+
+    if (!doc.IsObject()) {
+        IG_LOG(L_ERROR) << "JSON: Expected root element to be an object" << std::endl;
+        return std::nullopt;
+    }
+
+    if (!doc.HasMember("version") || !doc["version"].IsInt() || doc["version"].GetInt() != ProfileVersion) {
+        IG_LOG(L_WARNING) << "Ignoring specialization profile " << file << " with unknown version" << std::endl;
+        return std::nullopt;
+    }
+
+    SpecializationProfile profile;
+    if (doc.HasMember("materials") && doc["materials"].IsObject()) {
+        const auto& materials = doc["materials"];
+        for (auto it = materials.MemberBegin(); it != materials.MemberEnd(); ++it) {
+            if (it->value.IsUint64())
+                profile.mMaterialWorkloads[it->name.GetString()] = (size_t)it->value.GetUint64();
+        }
+    }
+
+    if (doc.HasMember("varying_parameters") && doc["varying_parameters"].IsArray()) {
+        for (const auto& param : doc["varying_parameters"].GetArray()) {
+            if (param.IsString())
+                profile.mVaryingParameters.insert(param.GetString());
+        }
+    }
+
+    profile.updateHotMaterials();
+    return profile;
+}
+
+bool SpecializationProfile::save(const Path& file) const
+{
+    std::ofstream ofs(file);
+    if (!ofs.good()) {
+        IG_LOG(L_ERROR) << "Could not open file '" << file << "'" << std::endl;
+        return false;
+    }
+
+    rapidjson::Document doc;
+    doc.SetObject();
+    doc.AddMember("version", ProfileVersion, doc.GetAllocator());
+
+    rapidjson::Value materials(rapidjson::kObjectType);
+    for (const auto& pair : mMaterialWorkloads)
+        materials.AddMember(rapidjson::StringRef(pair.first), (uint64_t)pair.second, doc.GetAllocator());
+    doc.AddMember("materials", materials, doc.GetAllocator());
+
+    rapidjson::Value parameters(rapidjson::kArrayType);
+    for (const auto& name : mVaryingParameters)
+        parameters.PushBack(rapidjson::StringRef(name), doc.GetAllocator());
+    doc.AddMember("varying_parameters", parameters, doc.GetAllocator());
+
+    rapidjson::OStreamWrapper osw(ofs);
+    rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(osw);
+    doc.Accept(writer);
+    return true;
+}
+} // namespace IG
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "ParameterSet.h"
+
+#include <unordered_set>
+
+namespace IG {
+/// Shading behaviour recorded in a previous run, used to decide which materials and parameters are worth specializing
+class IG_LIB SpecializationProfile {
+public:
+    /// Fraction of the total hit workload covered by the hot materials
+    static constexpr float HotWorkloadFraction = 0.9f;
+
+    SpecializationProfile();
+
+    /// Replace the recorded workload per material. Materials are identified by their name
+    void setMaterialWorkloads(const std::unordered_map<std::string, size_t>& workloads);
+    /// True if the material is one of the most frequently hit materials. Unknown materials are always cold
+    bool isHotMaterial(const std::string& name) const;
+    inline bool hasMaterials() const { return !mMaterialWorkloads.empty(); }
+
+    /// Only the given global parameters are tracked by recordParameters
+    void trackParameters(const std::vector<std::string>& names);
+    /// Compare the tracked parameters with the values of the previous call and mark changed ones as varying
+    void recordParameters(const ParameterSet& registry);
+    bool isVaryingParameter(const std::string& name) const;
+
+    [[nodiscard]] static std::optional<SpecializationProfile> load(const Path& file);
+    bool save(const Path& file) const;
+
+private:
+    void updateHotMaterials();
+
+    std::unordered_map<std::string, size_t> mMaterialWorkloads;
+    std::unordered_set<std::string> mHotMaterials;
+    std::unordered_set<std::string> mVaryingParameters;
+
+    std::vector<std::string> mTrackedParameters;
+    ParameterSet mLastParameters;
+    bool mHasLastParameters;
+};
+} // namespace IG
@@ -2,6 +2,9 @@
 #include "Logger.h"
 #include <sstream>
 
+#include <rapidjson/prettywriter.h>
+#include <rapidjson/stringbuffer.h>
+
 namespace IG {
 Statistics::Statistics()
     : mQuantities()
@@ -25,6 +28,35 @@ void Statistics::endShaderLaunch(ShaderType type, size_t id)
     stats->elapsed += std::chrono::duration_cast<duration_t>(stats->timer.stop());
 }
 
+void Statistics::beginEntityLaunch(size_t entity, size_t workload)
+{
+    ShaderStats& stats = mEntityStats[entity];
+    stats.timer.start();
+    stats.count++;
+    stats.workload += workload;
+    stats.max_workload = std::max(stats.max_workload, workload);
+    stats.min_workload = std::min(stats.min_workload, workload);
+}
+
+void Statistics::endEntityLaunch(size_t entity)
+{
+    ShaderStats& stats = mEntityStats[entity];
+    stats.elapsed += std::chrono::duration_cast<duration_t>(stats.timer.stop());
+}
+
+void Statistics::addSpawnedRays(size_t material, int entity, size_t shadow, size_t bounce)
+{
+    ShaderStats& matStats = mHitStats[material];
+    matStats.shadow_rays += shadow;
+    matStats.bounce_rays += bounce;
+
+    if (entity >= 0) {
+        ShaderStats& entStats = mEntityStats[(size_t)entity];
+        entStats.shadow_rays += shadow;
+        entStats.bounce_rays += bounce;
+    }
+}
+
 void Statistics::beginSection(SectionType type)
 {
     SectionStats& stats = mSections[(size_t)type];
@@ -45,6 +77,8 @@ Statistics::ShaderStats& Statistics::ShaderStats::operator+=(const Statistics::S
     workload += other.workload;
     max_workload = std::max(max_workload, other.max_workload);
     min_workload = std::min(min_workload, other.min_workload);
+    shadow_rays += other.shadow_rays;
+    bounce_rays += other.bounce_rays;
 
     return *this;
 }
@@ -72,6 +106,8 @@ void Statistics::add(const Statistics& other)
         mAdvancedShadowMissStats[pair.first] += pair.second;
     for (const auto& pair : other.mCallbackStats)
         mCallbackStats[pair.first] += pair.second;
+    for (const auto& pair : other.mEntityStats)
+        mEntityStats[pair.first] += pair.second;
     mTonemapStats += other.mTonemapStats;
     mImageInfoStats += other.mImageInfoStats;
 
@@ -148,10 +184,26 @@ private:
     std::vector<std::vector<std::string>> mData;
 };
 
-std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
+static std::string getStatisticName(const std::vector<std::string>* names, size_t id)
+{
+    std::string label = "@" + std::to_string(id);
+    if (names && id < names->size() && !names->at(id).empty())
+        label += " " + names->at(id);
+    return label;
+}
+
+template <typename T>
+static std::vector<std::pair<size_t, T>> sortedByElapsed(const std::map<size_t, T>& map)
+{
+    std::vector<std::pair<size_t, T>> list(map.begin(), map.end());
+    std::stable_sort(list.begin(), list.end(), [](const auto& a, const auto& b) { return a.second.elapsed > b.second.elapsed; });
+    return list;
+}
+
+std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose, const StatisticNames* names) const
 {
     DumpTable table;
-    const auto dumpInline = [&](const std::string& name, size_t count, duration_t elapsed, float percentage = -1, size_t max_workload = 0, size_t min_workload = 0, bool skip_iter = false) {
+    const auto dumpInline = [&](const std::string& name, size_t count, duration_t elapsed, float percentage = -1, size_t max_workload = 0, size_t min_workload = 0, bool skip_iter = false, const std::string& extra = {}) {
         std::vector<std::string> cols;
         cols.emplace_back(name);
 
@@ -177,6 +229,8 @@ std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
                 cols.emplace_back(bstream.str());
             }
         }
+        if (!extra.empty())
+            cols.emplace_back(extra);
         table.addRow(std::move(cols));
     };
 
@@ -185,7 +239,13 @@ std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
     };
 
     const auto dumpStatsDetail = [&](const std::string& name, const ShaderStats& stats, size_t total_workload) {
-        dumpInline(name, stats.count, stats.elapsed, static_cast<float>(double(stats.workload) / double(total_workload)), stats.max_workload, stats.min_workload);
+        std::string spawned;
+        if (stats.shadow_rays > 0 || stats.bounce_rays > 0) {
+            std::stringstream bstream;
+            bstream << "(shadow " << stats.shadow_rays << ", bounce " << stats.bounce_rays << ") spawned";
+            spawned = bstream.str();
+        }
+        dumpInline(name, stats.count, stats.elapsed, static_cast<float>(double(stats.workload) / double(total_workload)), stats.max_workload, stats.min_workload, false, spawned);
     };
 
     const auto dumpSectionStats = [&](const std::string& name, const SectionStats& stats, bool skipIter = true) {
@@ -228,8 +288,16 @@ std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
     dumpStats("  |-Hits", totalHits);
 
     if (verbose) {
-        for (const auto& pair : mHitStats)
-            dumpStatsDetail("  ||-@" + std::to_string(pair.first), pair.second, totalHits.workload);
+        // Most expensive materials first
+        for (const auto& pair : sortedByElapsed(mHitStats))
+            dumpStatsDetail("  ||-" + getStatisticName(names ? &names->Materials : nullptr, pair.first), pair.second, totalHits.workload);
+    }
+
+    if (verbose && !mEntityStats.empty()) {
+        const ShaderStats totalEntities = sumMap(mEntityStats);
+        table.addRow({ "  |-Entities" });
+        for (const auto& pair : sortedByElapsed(mEntityStats))
+            dumpStatsDetail("  ||-" + getStatisticName(names ? &names->Entities : nullptr, pair.first), pair.second, totalEntities.workload);
     }
 
     if (!mAdvancedShadowHitStats.empty() || !mAdvancedShadowMissStats.empty()) {
@@ -292,6 +360,110 @@ std::string Statistics::dump(size_t totalMS, size_t iter, bool verbose) const
     return table.print(false, true);
 }
 
+std::string Statistics::dumpJSON(size_t totalMS, size_t iter, const StatisticNames* names) const
+{
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+
+    const auto writeStats = [&](const ShaderStats& stats) {
+        writer.Key("count");
+        writer.Uint64(stats.count);
+        writer.Key("elapsed_ms");
+        writer.Double(std::chrono::duration<double, std::milli>(stats.elapsed).count());
+        writer.Key("workload");
+        writer.Uint64(stats.workload);
+        writer.Key("min_workload");
+        writer.Uint64(stats.count > 0 ? stats.min_workload : 0);
+        writer.Key("max_workload");
+        writer.Uint64(stats.max_workload);
+    };
+
+    const auto writeShader = [&](ShaderType type, const ShaderStats& stats) {
+        if (stats.count == 0)
+            return;
+        writer.Key(getShaderTypeName(type).data());
+        writer.StartObject();
+        writeStats(stats);
+        writer.EndObject();
+    };
+
+    const auto writeList = [&](const char* key, const std::map<size_t, ShaderStats>& map, const std::vector<std::string>* list, bool spawned) {
+        writer.Key(key);
+        writer.StartArray();
+        for (const auto& pair : sortedByElapsed(map)) {
+            writer.StartObject();
+            writer.Key("id");
+            writer.Uint64(pair.first);
+            if (list && pair.first < list->size()) {
+                writer.Key("name");
+                writer.String(list->at(pair.first).c_str());
+            }
+            writeStats(pair.second);
+            if (spawned) {
+                writer.Key("shadow_rays");
+                writer.Uint64(pair.second.shadow_rays);
+                writer.Key("bounce_rays");
+                writer.Uint64(pair.second.bounce_rays);
+            }
+            writer.EndObject();
+        }
+        writer.EndArray();
+    };
+
+    writer.StartObject();
+    writer.Key("total_ms");
+    writer.Uint64(totalMS);
+    writer.Key("iterations");
+    writer.Uint64(iter);
+
+    writer.Key("shaders");
+    writer.StartObject();
+    writeShader(ShaderType::Device, mDeviceStats);
+    writeShader(ShaderType::PrimaryTraversal, mPrimaryTraversalStats);
+    writeShader(ShaderType::SecondaryTraversal, mSecondaryTraversalStats);
+    writeShader(ShaderType::RayGeneration, mRayGenerationStats);
+    writeShader(ShaderType::Miss, mMissStats);
+    writeShader(ShaderType::ImageInfo, mImageInfoStats);
+    writeShader(ShaderType::Tonemap, mTonemapStats);
+    writeShader(ShaderType::Bake, mBakeStats);
+    writer.EndObject();
+
+    writeList("materials", mHitStats, names ? &names->Materials : nullptr, true);
+    writeList("entities", mEntityStats, names ? &names->Entities : nullptr, true);
+    writeList("advanced_shadow_hits", mAdvancedShadowHitStats, names ? &names->Materials : nullptr, false);
+    writeList("advanced_shadow_misses", mAdvancedShadowMissStats, names ? &names->Materials : nullptr, false);
+    writeList("callbacks", mCallbackStats, nullptr, false);
+
+    writer.Key("sections");
+    writer.StartObject();
+    for (size_t i = 0; i < mSections.size(); ++i) {
+        const auto& stats = mSections[i];
+        if (stats.count == 0)
+            continue;
+        writer.Key(getSectionTypeName((SectionType)i).data());
+        writer.StartObject();
+        writer.Key("count");
+        writer.Uint64(stats.count);
+        writer.Key("elapsed_ms");
+        writer.Double(std::chrono::duration<double, std::milli>(stats.elapsed).count());
+        writer.EndObject();
+    }
+    writer.EndObject();
+
+    writer.Key("quantities");
+    writer.StartObject();
+    writer.Key("camera_rays");
+    writer.Uint64(mQuantities[(size_t)Quantity::CameraRayCount]);
+    writer.Key("shadow_rays");
+    writer.Uint64(mQuantities[(size_t)Quantity::ShadowRayCount]);
+    writer.Key("bounce_rays");
+    writer.Uint64(mQuantities[(size_t)Quantity::BounceRayCount]);
+    writer.EndObject();
+
+    writer.EndObject();
+    return buffer.GetString();
+}
+
 Statistics::ShaderStats* Statistics::getStats(ShaderType type, size_t id)
 {
     switch (type) {
@@ -322,4 +494,90 @@ Statistics::ShaderStats* Statistics::getStats(ShaderType type, size_t id)
         return &mBakeStats;
     }
 }
+
+std::string_view Statistics::getShaderTypeName(ShaderType type)
+{
+    switch (type) {
+    case ShaderType::Device:
+        return "Device";
+    case ShaderType::PrimaryTraversal:
+        return "PrimaryTraversal";
+    case ShaderType::SecondaryTraversal:
+        return "SecondaryTraversal";
+    case ShaderType::RayGeneration:
+        return "RayGeneration";
+    case ShaderType::Hit:
+        return "Hit";
+    case ShaderType::Miss:
+        return "Miss";
+    case ShaderType::AdvancedShadowHit:
+        return "AdvancedShadowHit";
+    case ShaderType::AdvancedShadowMiss:
+        return "AdvancedShadowMiss";
+    case ShaderType::Callback:
+        return "Callback";
+    case ShaderType::Tonemap:
+        return "Tonemap";
+    case ShaderType::Glare:
+        return "Glare";
+    case ShaderType::ImageInfo:
+        return "ImageInfo";
+    case ShaderType::Bake:
+        return "Bake";
+    case ShaderType::Pass:
+        return "Pass";
+    default:
+        return "Unknown";
+    }
+}
+
+std::string_view Statistics::getSectionTypeName(SectionType type)
+{
+    switch (type) {
+    case SectionType::GPUSortPrimary:
+        return "GPUSortPrimary";
+    case SectionType::GPUSortSecondary:
+        return "GPUSortSecondary";
+    case SectionType::GPUCompactPrimary:
+        return "GPUCompactPrimary";
+    case SectionType::GPUSortPrimaryReset:
+        return "GPUSortPrimaryReset";
+    case SectionType::GPUSortPrimaryCount:
+        return "GPUSortPrimaryCount";
+    case SectionType::GPUSortPrimaryScan:
+        return "GPUSortPrimaryScan";
+    case SectionType::GPUSortPrimarySort:
+        return "GPUSortPrimarySort";
+    case SectionType::GPUSortPrimaryCollapse:
+        return "GPUSortPrimaryCollapse";
+    case SectionType::ImageInfoPercentile:
+        return "ImageInfoPercentile";
+    case SectionType::ImageInfoError:
+        return "ImageInfoError";
+    case SectionType::ImageInfoHistogram:
+        return "ImageInfoHistogram";
+    case SectionType::ImageLoading:
+        return "ImageLoading";
+    case SectionType::PackedImageLoading:
+        return "PackedImageLoading";
+    case SectionType::BufferLoading:
+        return "BufferLoading";
+    case SectionType::BufferRequests:
+        return "BufferRequests";
+    case SectionType::BufferReleases:
+        return "BufferReleases";
+    case SectionType::FramebufferUpdate:
+        return "FramebufferUpdate";
+    case SectionType::AOVUpdate:
+        return "AOVUpdate";
+    case SectionType::TonemapUpdate:
+        return "TonemapUpdate";
+    case SectionType::FramebufferHostUpdate:
+        return "FramebufferHostUpdate";
+    case SectionType::AOVHostUpdate:
+        return "AOVHostUpdate";
+    default:
+        return "Unknown";
+    }
+}
 } // namespace IG
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "Timer.h"
 
@@ -63,6 +64,12 @@ enum class Quantity {
     _COUNT
 };
 
+/// Optional names used to make material and entity ids in the statistics human readable
+struct StatisticNames {
+    std::vector<std::string> Materials;
+    std::vector<std::string> Entities;
+};
+
 class IG_LIB Statistics {
 public:
     Statistics();
@@ -75,6 +82,12 @@ public:
     void beginShaderLaunch(ShaderType type, size_t workload, size_t id);
     void endShaderLaunch(ShaderType type, size_t id);
 
+    /// Time spent shading hits on the given entity. Only available on the CPU
+    void beginEntityLaunch(size_t entity, size_t workload);
+    void endEntityLaunch(size_t entity);
+    /// Record secondary rays spawned by hits on the given material and entity. A negative entity only updates the material
+    void addSpawnedRays(size_t material, int entity, size_t shadow, size_t bounce);
+
     void beginSection(SectionType type);
     void endSection(SectionType type);
 
@@ -107,9 +120,19 @@ public:
         mQuantities[(size_t)quantity] += value;
     }
 
+    [[nodiscard]] inline uint64 quantity(Quantity quantity) const
+    {
+        return mQuantities[(size_t)quantity];
+    }
+
     void add(const Statistics& other);
 
-    [[nodiscard]] std::string dump(size_t totalMS, size_t iter, bool verbose) const;
+    [[nodiscard]] std::string dump(size_t totalMS, size_t iter, bool verbose, const StatisticNames* names = nullptr) const;
+    /// Machine readable variant of dump() including all per material and per entity entries
+    [[nodiscard]] std::string dumpJSON(size_t totalMS, size_t iter, const StatisticNames* names = nullptr) const;
+
+    [[nodiscard]] static std::string_view getShaderTypeName(ShaderType type);
+    [[nodiscard]] static std::string_view getSectionTypeName(SectionType type);
 
 private:
     using duration_t = Timer::duration;
@@ -120,6 +143,8 @@ private:
         size_t workload     = 0; // This might overflow, but who cares for statistical stuff after that huge number of iterations
         size_t max_workload = 0;
         size_t min_workload = std::numeric_limits<size_t>::max();
+        size_t shadow_rays  = 0;
+        size_t bounce_rays  = 0;
 
         ShaderStats& operator+=(const ShaderStats& other);
     };
@@ -143,6 +168,7 @@ private:
     std::map<size_t, ShaderStats> mAdvancedShadowHitStats;
     std::map<size_t, ShaderStats> mAdvancedShadowMissStats;
     std::map<size_t, ShaderStats> mCallbackStats;
+    std::map<size_t, ShaderStats> mEntityStats;
     ShaderStats mImageInfoStats;
     ShaderStats mTonemapStats;
     ShaderStats mBakeStats;
@@ -0,0 +1,218 @@
+#include "Timeline.h"
+#include "Logger.h"
+
+#include <fstream>
+
+namespace IG {
+Timeline& Timeline::instance()
+{
+    static Timeline timeline;
+    return timeline;
+}
+
+Timeline::Timeline()
+    : mEnabled(false)
+    , mStart()
+    , mStarted(false)
+{
+}
+
+Timeline::~Timeline()
+{
+}
+
+void Timeline::enable()
+{
+    std::lock_guard<std::mutex> guard(mTrackMutex);
+    if (!mStarted) {
+        mStart   = clock::now();
+        mStarted = true;
+    }
+    mEnabled = true;
+}
+
+void Timeline::disable()
+{
+    mEnabled = false;
+}
+
+Timeline::clock::duration Timeline::since(const time_point& point) const
+{
+    return point - mStart;
+}
+
+Timeline::Track* Timeline::currentThreadTrack()
+{
+    // Tracks are owned by the timeline, which outlives all threads
+    static thread_local Track* tlTrack = nullptr;
+    if (tlTrack)
+        return tlTrack;
+
+    std::lock_guard<std::mutex> guard(mTrackMutex);
+    auto track  = std::make_unique<Track>();
+    track->ID   = mTracks.size() + 1;
+    track->Name = "Thread " + std::to_string(track->ID);
+    tlTrack     = track.get();
+    mTracks.emplace_back(std::move(track));
+    return tlTrack;
+}
+
+Timeline::Track* Timeline::namedTrack(const std::string& name)
+{
+    std::lock_guard<std::mutex> guard(mTrackMutex);
+    for (const auto& track : mTracks) {
+        if (track->Name == name)
+            return track.get();
+    }
+
+    auto track   = std::make_unique<Track>();
+    track->ID    = mTracks.size() + 1;
+    track->Name  = name;
+    track->Named = true;
+    mTracks.emplace_back(std::move(track));
+    return mTracks.back().get();
+}
+
+void Timeline::begin(const std::string_view& category, const std::string_view& name)
+{
+    if (!isEnabled())
+        return;
+
+    const auto timestamp = since(clock::now());
+    Track* track         = currentThreadTrack();
+
+    std::lock_guard<std::mutex> guard(track->Mutex);
+    track->Events.emplace_back(Event{ std::string(name), std::string(category), 'B', timestamp, clock::duration::zero(), track->ID });
+}
+
+void Timeline::end(const std::string_view& category, const std::string_view& name)
+{
+    // An event which began while recording has to be closed even if the recording was disabled in the meantime
+    if (!mStarted)
+        return;
+
+    const auto timestamp = since(clock::now());
+    Track* track         = currentThreadTrack();
+
+    std::lock_guard<std::mutex> guard(track->Mutex);
+    track->Events.emplace_back(Event{ std::string(name), std::string(category), 'E', timestamp, clock::duration::zero(), track->ID });
+}
+
+void Timeline::complete(const std::string_view& category, const std::string_view& name, const time_point& start, const time_point& end, const std::string& trackName)
+{
+    if (!isEnabled())
+        return;
+
+    Track* track = namedTrack(trackName);
+
+    std::lock_guard<std::mutex> guard(track->Mutex);
+    track->Events.emplace_back(Event{ std::string(name), std::string(category), 'X', since(start), end - start, track->ID });
+}
+
+void Timeline::setThreadName(const std::string& name, bool keepExisting)
+{
+    if (!isEnabled())
+        return;
+
+    Track* track = currentThreadTrack();
+
+    // The name is looked up by namedTrack, therefore it is guarded by the track list mutex and not by the track mutex
+    std::lock_guard<std::mutex> guard(mTrackMutex);
+    if (keepExisting && track->Named)
+        return;
+
+    track->Name  = name;
+    track->Named = true;
+}
+
+void Timeline::clear()
+{
+    std::lock_guard<std::mutex> guard(mTrackMutex);
+    for (const auto& track : mTracks) {
+        std::lock_guard<std::mutex> trackGuard(track->Mutex);
+        track->Events.clear();
+    }
+}
+
+static void writeEscaped(std::ostream& stream, const std::string& str)
+{
+    stream << '"';
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            stream << "\\\"";
+            break;
+        case '\\':
+            stream << "\\\\";
+            break;
+        case '\n':
+            stream << "\\n";
+            break;
+        case '\t':
+            stream << "\\t";
+            break;
+        default:
+            if ((unsigned char)c < 0x20)
+                stream << ' ';
+            else
+                stream << c;
+            break;
+        }
+    }
+    stream << '"';
+}
+
+static inline double toMicroseconds(const Timeline::clock::duration& dur)
+{
+    return std::chrono::duration<double, std::micro>(dur).count();
+}
+
+bool Timeline::write(const Path& path) const
+{
+    std::ofstream stream(path);
+    if (!stream) {
+        IG_LOG(L_ERROR) << "Could not open " << path << " for writing the timeline" << std::endl;
+        return false;
+    }
+
+    stream << std::fixed;
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+
+    bool first = true;
+    const auto separate = [&]() {
+        if (!first)
+            stream << "," << std::endl;
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> guard(mTrackMutex);
+    separate();
+    stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Ignis\"}}";
+
+    for (const auto& track : mTracks) {
+        std::lock_guard<std::mutex> trackGuard(track->Mutex);
+
+        separate();
+        stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track->ID << ",\"args\":{\"name\":";
+        writeEscaped(stream, track->Name);
+        stream << "}}";
+
+        for (const auto& event : track->Events) {
+            separate();
+            stream << "{\"name\":";
+            writeEscaped(stream, event.Name);
+            stream << ",\"cat\":";
+            writeEscaped(stream, event.Category);
+            stream << ",\"ph\":\"" << event.Phase << "\",\"ts\":" << toMicroseconds(event.Timestamp);
+            if (event.Phase == 'X')
+                stream << ",\"dur\":" << toMicroseconds(event.Duration);
+            stream << ",\"pid\":1,\"tid\":" << event.Track << "}";
+        }
+    }
+
+    stream << std::endl
+           << "]}" << std::endl;
+
+    return stream.good();
+}
+} // namespace IG
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "IG_Config.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace IG {
+/// Process wide recorder of begin/end events, written in the Chrome trace event format which can be inspected with Perfetto or chrome://tracing.
+/// Recording is disabled by default and costs a single atomic load per event site in that case.
+class IG_LIB Timeline {
+public:
+    using clock      = std::chrono::steady_clock;
+    using time_point = clock::time_point;
+
+    [[nodiscard]] static Timeline& instance();
+
+    /// Start recording. Timestamps are relative to the first call
+    void enable();
+    /// Stop recording. Already recorded events are kept
+    void disable();
+    [[nodiscard]] inline bool isEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+    /// Begin an event on the calling thread. Events on a thread have to be properly nested
+    void begin(const std::string_view& category, const std::string_view& name);
+    /// End the most recent event on the calling thread
+    void end(const std::string_view& category, const std::string_view& name);
+    /// Add an event with explicit time points on a virtual track, e.g., for work done by external processes
+    void complete(const std::string_view& category, const std::string_view& name, const time_point& start, const time_point& end, const std::string& track);
+
+    /// Name the calling thread in the timeline. An existing name is kept if requested
+    void setThreadName(const std::string& name, bool keepExisting = false);
+
+    void clear();
+    bool write(const Path& path) const;
+
+    class Scope {
+    public:
+        inline Scope(const std::string_view& category, const std::string& name)
+            : mCategory(category)
+            , mName()
+            , mActive(Timeline::instance().isEnabled())
+        {
+            if (mActive) {
+                mName = name;
+                Timeline::instance().begin(mCategory, mName);
+            }
+        }
+
+        inline ~Scope()
+        {
+            if (mActive)
+                Timeline::instance().end(mCategory, mName);
+        }
+
+        IG_CLASS_NON_COPYABLE(Scope);
+        IG_CLASS_NON_MOVEABLE(Scope);
+
+    private:
+        const std::string_view mCategory;
+        std::string mName;
+        const bool mActive;
+    };
+
+private:
+    Timeline();
+    ~Timeline();
+
+    struct Event {
+        std::string Name;
+        std::string Category;
+        char Phase;
+        clock::duration Timestamp;
+        clock::duration Duration;
+        size_t Track;
+    };
+
+    struct Track {
+        size_t ID;
+        std::string Name;   // Guarded by mTrackMutex
+        bool Named = false; // Guarded by mTrackMutex
+        std::vector<Event> Events;
+        mutable std::mutex Mutex; // Guards the events. Only contended while writing
+    };
+
+    Track* currentThreadTrack();
+    Track* namedTrack(const std::string& name);
+    [[nodiscard]] clock::duration since(const time_point& point) const;
+
+    std::atomic<bool> mEnabled;
+    time_point mStart;
+    std::atomic<bool> mStarted;
+
+    mutable std::mutex mTrackMutex;
+    std::vector<std::unique_ptr<Track>> mTracks;
+};
+} // namespace IG
+
+#define _IG_TIMELINE_CONCAT2(a, b) a##b
+#define _IG_TIMELINE_CONCAT(a, b) _IG_TIMELINE_CONCAT2(a, b)
+
+/// Record an event lasting until the end of the current scope. The name is only constructed if the timeline is enabled
+#define IG_TIMELINE_SCOPE(category, name)                                                     \
+    const IG::Timeline::Scope _IG_TIMELINE_CONCAT(_timelineScope, __LINE__)(                  \
+        (category), IG::Timeline::instance().isEnabled() ? std::string(name) : std::string())
@@ -20,11 +20,14 @@ static KlemsExportedData setup_klems(const std::string& name, const std::shared_
 
     const std::string exported_id = "_klems_" + filename.generic_string();
 
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
     const auto data = ctx.Cache->ExportedData.find(exported_id);
     if (data != ctx.Cache->ExportedData.end())
         return std::any_cast<KlemsExportedData>(data->second);
 
-    const Path path = ctx.CacheManager->directory() / ("klems_" + LoaderUtils::escapeIdentifier(name) + ".bin");
+    // Buffers are cached by file name, therefore the source has to be part of it to pick up a changed source on reload
+    const std::string source_hash = std::to_string(std::hash<std::string>{}(filename.generic_string()));
+    const Path path               = ctx.CacheManager->directory() / ("klems_" + LoaderUtils::escapeIdentifier(name) + "_" + source_hash + ".bin");
 
     KlemsSpecification spec{};
     if (!KlemsLoader::prepare(filename, path, spec))
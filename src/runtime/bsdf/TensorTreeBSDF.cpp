@@ -19,11 +19,14 @@ static TTExportedData setup_tensortree(const std::string& name, const std::share
 
     const std::string exported_id = "_tt_" + filename.generic_string();
 
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
     const auto data = ctx.Cache->ExportedData.find(exported_id);
     if (data != ctx.Cache->ExportedData.end())
         return std::any_cast<TTExportedData>(data->second);
 
-    const Path path = ctx.CacheManager->directory() / ("tt_" + LoaderUtils::escapeIdentifier(name) + ".bin");
+    // Buffers are cached by file name, therefore the source has to be part of it to pick up a changed source on reload
+    const std::string source_hash = std::to_string(std::hash<std::string>{}(filename.generic_string()));
+    const Path path               = ctx.CacheManager->directory() / ("tt_" + LoaderUtils::escapeIdentifier(name) + "_" + source_hash + ".bin");
 
     TensorTreeSpecification spec{};
     if (!TensorTreeLoader::prepare(filename, path, spec))
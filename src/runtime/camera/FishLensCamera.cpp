@@ -47,9 +47,9 @@ void FishLensCamera::serialize(const SerializationInput& input) const
     }
 
     // The following variables are modified by `igview` to allow interactive control
-    input.Context.GlobalRegistry.VectorParameters["__camera_eye"] = orientation.Eye;
-    input.Context.GlobalRegistry.VectorParameters["__camera_dir"] = orientation.Dir;
-    input.Context.GlobalRegistry.VectorParameters["__camera_up"]  = orientation.Up;
+    input.Context.globalRegistry().VectorParameters["__camera_eye"] = orientation.Eye;
+    input.Context.globalRegistry().VectorParameters["__camera_dir"] = orientation.Dir;
+    input.Context.globalRegistry().VectorParameters["__camera_up"]  = orientation.Up;
 
     input.Stream << "  let camera_eye = registry::get_global_parameter_vec3(\"__camera_eye\", vec3_expand(0));" << std::endl
                  << "  let camera_dir = registry::get_global_parameter_vec3(\"__camera_dir\", vec3_expand(0));" << std::endl
@@ -24,10 +24,10 @@ void OrthogonalCamera::serialize(const SerializationInput& input) const
     CameraOrientation orientation = getOrientation(input.Context);
 
     // The following variables are modified by `igview` to allow interactive control
-    input.Context.GlobalRegistry.VectorParameters["__camera_eye"]  = orientation.Eye;
-    input.Context.GlobalRegistry.VectorParameters["__camera_dir"]  = orientation.Dir;
-    input.Context.GlobalRegistry.VectorParameters["__camera_up"]   = orientation.Up;
-    input.Context.GlobalRegistry.FloatParameters["__camera_scale"] = mScale;
+    input.Context.globalRegistry().VectorParameters["__camera_eye"]  = orientation.Eye;
+    input.Context.globalRegistry().VectorParameters["__camera_dir"]  = orientation.Dir;
+    input.Context.globalRegistry().VectorParameters["__camera_up"]   = orientation.Up;
+    input.Context.globalRegistry().FloatParameters["__camera_scale"] = mScale;
 
     std::string aspect_ratio = "(settings.width as f32 / settings.height as f32)";
     if (mAspectRatio.has_value())
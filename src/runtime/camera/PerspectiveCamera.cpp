@@ -28,9 +28,9 @@ void PerspectiveCamera::serialize(const SerializationInput& input) const
     CameraOrientation orientation = getOrientation(input.Context);
 
     // The following variables are modified by `igview` to allow interactive control
-    input.Context.GlobalRegistry.VectorParameters["__camera_eye"] = orientation.Eye;
-    input.Context.GlobalRegistry.VectorParameters["__camera_dir"] = orientation.Dir;
-    input.Context.GlobalRegistry.VectorParameters["__camera_up"]  = orientation.Up;
+    input.Context.globalRegistry().VectorParameters["__camera_eye"] = orientation.Eye;
+    input.Context.globalRegistry().VectorParameters["__camera_dir"] = orientation.Dir;
+    input.Context.globalRegistry().VectorParameters["__camera_up"]  = orientation.Up;
 
     // Dump camera control (above is just defaults)
     input.Stream << "  let camera_eye = registry::get_global_parameter_vec3(\"__camera_eye\", vec3_expand(0));" << std::endl
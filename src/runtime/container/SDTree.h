@@ -0,0 +1,252 @@
+#pragma once
+
+#include "math/BoundingBox.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace IG {
+// Spatial-directional tree (SD-tree) as proposed in "Practical Path Guiding for Efficient Light-Transport Simulation" by Müller et al.
+// See PathGuiding for the training procedure and the layout of the serialized tree
+
+/// Directional quadtree over the canonical square. Each node stores the energy of all its four quadrants
+class DTree {
+public:
+    struct Node {
+        std::array<float, 4> Energy   = { 0, 0, 0, 0 };
+        std::array<uint32, 4> Children = { 0, 0, 0, 0 }; // Zero marks a leaf, as the root is never a child
+    };
+
+    /// Maximum depth of the quadtree, which limits the resolution of the directional distribution
+    static constexpr size_t MaxDepth = 20;
+
+    inline DTree()
+        : mNodes(1)
+        , mRecordCount(0)
+    {
+    }
+
+    inline void record(Vector2f p, float value)
+    {
+        uint32 node = 0;
+        while (true) {
+            const int dx = p.x() >= 0.5f ? 1 : 0;
+            const int dy = p.y() >= 0.5f ? 1 : 0;
+            const int c  = dx + 2 * dy;
+
+            mNodes[node].Energy[c] += value;
+            node = mNodes[node].Children[c];
+            if (node == 0)
+                break;
+
+            p = Vector2f(2 * p.x() - dx, 2 * p.y() - dy);
+        }
+        ++mRecordCount;
+    }
+
+    [[nodiscard]] inline float total() const
+    {
+        const auto& e = mNodes[0].Energy;
+        return e[0] + e[1] + e[2] + e[3];
+    }
+
+    /// Empty tree with quadrants subdivided if they hold more than the given fraction of the total energy.
+    /// Leaves are expected to distribute their energy uniformly
+    [[nodiscard]] inline DTree refined(float threshold) const
+    {
+        const float total = this->total();
+        if (total <= 0)
+            return cleared();
+
+        struct Entry {
+            uint32 Source; // Only valid if SourceEnergy is negative
+            float SourceEnergy;
+            uint32 Target;
+            size_t Depth;
+        };
+
+        DTree tree;
+        std::vector<Entry> stack = { Entry{ 0, -1, 0, 1 } };
+        while (!stack.empty()) {
+            const Entry entry = stack.back();
+            stack.pop_back();
+
+            for (int c = 0; c < 4; ++c) {
+                const bool fromLeaf = entry.SourceEnergy >= 0;
+                const float energy  = fromLeaf ? entry.SourceEnergy / 4 : mNodes[entry.Source].Energy[c];
+                if (entry.Depth >= MaxDepth || energy / total <= threshold)
+                    continue;
+
+                const uint32 child                    = (uint32)tree.mNodes.size();
+                tree.mNodes[entry.Target].Children[c] = child;
+                tree.mNodes.emplace_back();
+
+                const uint32 sourceChild = fromLeaf ? 0 : mNodes[entry.Source].Children[c];
+                if (sourceChild != 0)
+                    stack.push_back(Entry{ sourceChild, -1, child, entry.Depth + 1 });
+                else
+                    stack.push_back(Entry{ 0, energy, child, entry.Depth + 1 });
+            }
+        }
+
+        return tree;
+    }
+
+    /// Same structure without any energy
+    [[nodiscard]] inline DTree cleared() const
+    {
+        DTree tree = *this;
+        for (auto& node : tree.mNodes)
+            node.Energy = { 0, 0, 0, 0 };
+        tree.mRecordCount = 0;
+        return tree;
+    }
+
+    [[nodiscard]] inline const std::vector<Node>& nodes() const { return mNodes; }
+    [[nodiscard]] inline size_t recordCount() const { return mRecordCount; }
+    inline void setRecordCount(size_t count) { mRecordCount = count; }
+
+private:
+    std::vector<Node> mNodes;
+    size_t mRecordCount;
+};
+
+/// Binary tree subdividing the scene bounding box at the midpoint, cycling through the axes
+class SDTree {
+public:
+    struct Node {
+        int32 Axis      = -1; // Negative for leaves
+        uint32 Children = 0;  // Index of the first child, the second child follows directly
+        DTree Sampling;       // Only valid for leaves
+        DTree Building;       // Only valid for leaves
+    };
+
+    /// Number of entries in front of the spatial nodes of the serialized tree
+    static constexpr size_t HeaderSize = 8;
+    /// Maximum depth of the binary tree
+    static constexpr size_t MaxDepth = 48;
+
+    inline explicit SDTree(const BoundingBox& bbox)
+        : mBoundingBox(bbox)
+        , mNodes(1)
+    {
+    }
+
+    [[nodiscard]] inline Node& lookup(const Vector3f& pos)
+    {
+        Vector3f lo = mBoundingBox.min;
+        Vector3f hi = mBoundingBox.max;
+
+        uint32 node = 0;
+        while (mNodes[node].Axis >= 0) {
+            const int32 axis = mNodes[node].Axis;
+            const float mid  = (lo[axis] + hi[axis]) / 2;
+            if (pos[axis] < mid) {
+                hi[axis] = mid;
+                node     = mNodes[node].Children;
+            } else {
+                lo[axis] = mid;
+                node     = mNodes[node].Children + 1;
+            }
+        }
+        return mNodes[node];
+    }
+
+    /// Finish a training pass: The learned distributions are used for sampling and the tree is refined for the next pass
+    inline void refine(float spatialThreshold, float directionalThreshold)
+    {
+        // Split leaves with enough records. Children inherit the distributions of the parent and half of its records, which allows splitting them further
+        struct Entry {
+            uint32 Node;
+            size_t Depth;
+        };
+        std::vector<Entry> stack = { Entry{ 0, 0 } };
+        while (!stack.empty()) {
+            const Entry entry = stack.back();
+            stack.pop_back();
+
+            if (mNodes[entry.Node].Axis >= 0) {
+                stack.push_back(Entry{ mNodes[entry.Node].Children, entry.Depth + 1 });
+                stack.push_back(Entry{ mNodes[entry.Node].Children + 1, entry.Depth + 1 });
+                continue;
+            }
+
+            mNodes[entry.Node].Sampling = mNodes[entry.Node].Building;
+            if (entry.Depth >= MaxDepth || (float)mNodes[entry.Node].Building.recordCount() <= spatialThreshold)
+                continue;
+
+            const uint32 children = (uint32)mNodes.size();
+            mNodes.resize(mNodes.size() + 2); // Invalidates references
+
+            Node& node = mNodes[entry.Node];
+            node.Building.setRecordCount(node.Building.recordCount() / 2);
+            for (uint32 i = 0; i < 2; ++i) {
+                mNodes[children + i].Sampling = node.Building;
+                mNodes[children + i].Building = node.Building;
+                stack.push_back(Entry{ children + i, entry.Depth + 1 });
+            }
+
+            node.Axis     = (int32)(entry.Depth % 3);
+            node.Children = children;
+            node.Sampling = DTree();
+            node.Building = DTree();
+        }
+
+        for (auto& node : mNodes) {
+            if (node.Axis < 0)
+                node.Building = node.Building.refined(directionalThreshold);
+        }
+    }
+
+    /// Flatten the sampling distributions to the layout expected by artic/sampler/path_guiding.art
+    [[nodiscard]] inline std::vector<int32> serialize() const
+    {
+        std::vector<int32> data(HeaderSize + 2 * mNodes.size(), 0);
+
+        const auto setFloat = [&](size_t i, float v) { std::memcpy(&data[i], &v, sizeof(float)); };
+        for (int i = 0; i < 3; ++i) {
+            setFloat(i, mBoundingBox.min[i]);
+            setFloat(4 + i, mBoundingBox.max[i]);
+        }
+        data[3] = 1; // Valid
+
+        // Directional nodes start at an offset aligned to four entries, allowing vectorized loads
+        data.resize((data.size() + 3) & ~size_t(3), 0);
+
+        for (size_t i = 0; i < mNodes.size(); ++i) {
+            const Node& node         = mNodes[i];
+            data[HeaderSize + 2 * i] = node.Axis;
+            if (node.Axis >= 0) {
+                data[HeaderSize + 2 * i + 1] = (int32)(HeaderSize + 2 * node.Children);
+                continue;
+            }
+
+            const size_t root            = data.size();
+            data[HeaderSize + 2 * i + 1] = (int32)root;
+
+            const auto& dnodes = node.Sampling.nodes();
+            data.resize(root + 8 * dnodes.size(), 0);
+            for (size_t j = 0; j < dnodes.size(); ++j) {
+                for (size_t c = 0; c < 4; ++c) {
+                    setFloat(root + 8 * j + c, dnodes[j].Energy[c]);
+                    data[root + 8 * j + 4 + c] = dnodes[j].Children[c] == 0 ? 0 : (int32)(root + 8 * dnodes[j].Children[c]);
+                }
+            }
+        }
+
+        return data;
+    }
+
+    [[nodiscard]] inline const std::vector<Node>& nodes() const { return mNodes; }
+    [[nodiscard]] inline const BoundingBox& boundingBox() const { return mBoundingBox; }
+
+    [[nodiscard]] inline size_t leafCount() const
+    {
+        return std::count_if(mNodes.begin(), mNodes.end(), [](const Node& node) { return node.Axis < 0; });
+    }
+
+private:
+    const BoundingBox mBoundingBox;
+    std::vector<Node> mNodes;
+};
+} // namespace IG
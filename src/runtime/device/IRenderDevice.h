@@ -1,5 +1,6 @@
 #pragma once
 
+#include "MemoryUsage.h"
 #include "RuntimeStructs.h"
 #include "device/Target.h"
 #include "technique/TechniqueInfo.h"
@@ -13,6 +14,9 @@ struct SceneDatabase;
 
 class IG_LIB IRenderDevice {
 public:
+    /// AOV containing the render time in microseconds, the number of traced rays and the number of shaded rays per pixel. Only available on the CPU
+    static constexpr const char* CostAOV = "Cost";
+
     struct SetupSettings {
         Target target;
         bool AcquireStats  = false;
@@ -28,13 +32,13 @@ public:
     };
 
     struct RenderSettings {
-        const Ray* rays  = nullptr; // If non-null, width contains the number of rays and height is set to 1
-        size_t spi       = 8;
-        size_t width     = 0;
-        size_t height    = 0;
-        size_t iteration = 0;
-        size_t frame     = 0;
-        size_t user_seed = 0;
+        const RayBatch* rays = nullptr; // If non-null, width contains the number of rays and height is set to 1
+        size_t spi           = 8;
+        size_t width         = 0;
+        size_t height        = 0;
+        size_t iteration     = 0;
+        size_t frame         = 0;
+        size_t user_seed     = 0;
         TechniqueVariantInfo info;
     };
 
@@ -70,8 +74,13 @@ public:
     [[nodiscard]] virtual size_t getBufferSizeInBytes(const std::string& name)                             = 0;
     [[nodiscard]] virtual bool copyBufferToHost(const std::string& name, void* buffer, size_t maxSizeByte) = 0;
     [[nodiscard]] virtual BufferAccessor getBufferForDevice(const std::string& name)                       = 0;
+    virtual void copyBufferFromHost(const std::string& name, const void* buffer, size_t sizeInBytes)       = 0;
 
     [[nodiscard]] virtual const Statistics* getStatistics() = 0;
+    /// Accumulated workload of the hit shaders per material id over all technique variants. Always available, even without statistics being acquired
+    [[nodiscard]] virtual std::vector<size_t> getMaterialWorkloads() = 0;
+    /// Current memory allocated by the device, including host memory used for framebuffers and ray streams
+    [[nodiscard]] virtual MemoryUsage getMemoryUsage() = 0;
 
     virtual void tonemap(uint32_t*, const TonemapSettings&)                                                           = 0;
     [[nodiscard]] virtual ImageInfoOutput imageinfo(const ImageInfoSettings&)                                         = 0;
@@ -3,6 +3,12 @@
 #include "Runtime.h"
 #include "device/IRenderDevice.h"
 
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+
 #ifdef IG_HAS_DENOISER
 #include "OpenImageDenoise/oidn.hpp"
 #endif
@@ -19,15 +25,74 @@ static void errorFunc(void* userPtr, oidn::Error code, const char* message)
         IG_LOG(IG::L_ERROR) << "OIDN: " << message << std::endl;
 }
 
+// Input and output of the denoiser in host memory
+struct HostFrame {
+    const float* Color  = nullptr;
+    const float* Normal = nullptr;
+    const float* Albedo = nullptr;
+    float* Output       = nullptr;
+    size_t Width        = 0;
+    size_t Height       = 0;
+};
+
+// The normal and albedo AOVs are only written in the first iteration after a reset.
+// Therefore, the (prefiltered) auxiliary buffers can be reused for all following iterations until the next reset.
+// Filters are constructed with the OIDN internal memory limit, which makes OIDN process the image in overlapping tiles itself.
+static inline void applyMemoryLimit(oidn::FilterRef& filter, const DenoiserSettings& settings)
+{
+    if (settings.MaxMemoryMB > 0)
+        filter.set("maxMemoryMB", (int)std::min<size_t>(settings.MaxMemoryMB / 2, std::numeric_limits<int>::max()));
+}
+
 #if OIDN_VERSION_MAJOR >= 2
+// Tiles overlap, such that the result matches the result of the full frame. Only the inner part of a tile is written to the output
+struct TileLayout {
+    size_t Width   = 0; // Size of a tile including the overlap
+    size_t Height  = 0;
+    size_t Inner   = 0; // Size of the inner part of a tile
+    size_t Overlap = 0;
+    size_t CountX  = 1;
+    size_t CountY  = 1;
+
+    [[nodiscard]] inline bool isSingle() const { return CountX == 1 && CountY == 1; }
+};
+
+struct TileRegion {
+    size_t X = 0, Y = 0; // Origin of the tile including the overlap
+    size_t InnerX0 = 0, InnerY0 = 0, InnerX1 = 0, InnerY1 = 0;
+};
+
+static inline TileRegion computeTileRegion(const TileLayout& layout, size_t tx, size_t ty, size_t width, size_t height)
+{
+    TileRegion region;
+    region.InnerX0 = tx * layout.Inner;
+    region.InnerY0 = ty * layout.Inner;
+    region.InnerX1 = std::min(width, region.InnerX0 + layout.Inner);
+    region.InnerY1 = std::min(height, region.InnerY0 + layout.Inner);
+
+    // Tiles at the border are shifted inwards, such that all tiles have the same size and the filter has to be committed only once
+    region.X = std::min(region.InnerX0 - std::min(region.InnerX0, layout.Overlap), width - layout.Width);
+    region.Y = std::min(region.InnerY0 - std::min(region.InnerY0, layout.Overlap), height - layout.Height);
+    return region;
+}
+
+constexpr size_t DefaultTileOverlap   = 128;
+constexpr size_t DefaultTileAlignment = 16;
+constexpr size_t MinTileInner         = 256;
+
 class OIDNContext {
 public:
-    OIDNContext(bool prefilter, bool highQuality)
-        : mPrefilter(prefilter)
-        , mHighQuality(highQuality)
-        , mWidth(0)
-        , mHeight(0)
+    explicit OIDNContext(const DenoiserSettings& settings)
+        : mSettings(settings)
         , mDeviceType()
+        , mFrameWidth(0)
+        , mFrameHeight(0)
+        , mTileWidth(0)
+        , mTileHeight(0)
+        , mOverlap(DefaultTileOverlap)
+        , mAlignment(DefaultTileAlignment)
+        , mAuxValid(false)
+        , mIsDeviceSetup(false)
     {
         mDevice = oidn::newDevice(oidn::DeviceType::Default);
 
@@ -89,20 +154,35 @@ public:
         }
     }
 
+    inline void invalidateAux() { mAuxValid = false; }
+
     inline void filter(IRenderDevice* device)
     {
-        if (isSameDevice(device->target()))
+        if (isSameDevice(device->target())) {
             filterDevice(device);
-        else
-            filterHost(device);
+        } else {
+            const auto output = device->getFramebufferForHost("Denoised", false);
+            IG_ASSERT(output.Data, "Expected valid output data for denoiser");
+
+            filterHost(HostFrame{
+                .Color  = device->getFramebufferForHost({}).Data,
+                .Normal = device->getFramebufferForHost("Normals").Data,
+                .Albedo = device->getFramebufferForHost("Albedo").Data,
+                .Output = output.Data,
+                .Width  = device->framebufferWidth(),
+                .Height = device->framebufferHeight() });
+
+            device->syncFramebufferHostToDevice("Denoised");
+        }
     }
 
-    inline void filterHost(IRenderDevice* device)
+    /// Filter directly on the buffers of the render device without any copies
+    inline void filterDevice(IRenderDevice* device)
     {
-        const auto color  = device->getFramebufferForHost({});
-        const auto normal = device->getFramebufferForHost("Normals");
-        const auto albedo = device->getFramebufferForHost("Albedo");
-        const auto output = device->getFramebufferForHost("Denoised", false);
+        const auto color  = device->getFramebufferForDevice({});
+        const auto normal = device->getFramebufferForDevice("Normals");
+        const auto albedo = device->getFramebufferForDevice("Albedo");
+        const auto output = device->getFramebufferForDevice("Denoised");
 
         IG_ASSERT(color.Data, "Expected valid color data for denoiser");
         IG_ASSERT(normal.Data, "Expected valid normal data for denoiser");
@@ -112,60 +192,205 @@ public:
         const size_t width  = device->framebufferWidth();
         const size_t height = device->framebufferHeight();
 
-        if (mWidth != width || mHeight != height)
-            setupHost(width, height);
-
-        const size_t framebufferSize = 3 * width * height;
-        mColorBuffer.write(0, sizeof(float) * framebufferSize, color.Data);
-        mNormalBuffer.write(0, sizeof(float) * framebufferSize, normal.Data);
-        mAlbedoBuffer.write(0, sizeof(float) * framebufferSize, albedo.Data);
+        if (!mIsDeviceSetup || mFrameWidth != width || mFrameHeight != height) {
+            setupDevice(color.Data, normal.Data, albedo.Data, output.Data, width, height);
+            mAuxValid = false;
+        }
 
-        if (mPrefilter) {
+        // The auxiliary buffers are prefiltered in place
+        if (mSettings.Prefilter && !mAuxValid) {
             mNormalFilter.execute();
             mAlbedoFilter.execute();
         }
-        mMainFilter.execute();
+        mAuxValid = true;
 
-        mOutputBuffer.read(0, sizeof(float) * framebufferSize, output.Data);
-        device->syncFramebufferHostToDevice("Denoised");
+        mMainFilter.execute();
+        updateMemoryUsage();
     }
 
-    inline void filterDevice(IRenderDevice* device)
+    /// Filter the given host data. If a memory limit is given, the data is transferred and filtered in tiles
+    inline void filterHost(const HostFrame& frame)
     {
-        const auto color  = device->getFramebufferForDevice({});
-        const auto normal = device->getFramebufferForDevice("Normals");
-        const auto albedo = device->getFramebufferForDevice("Albedo");
-        const auto output = device->getFramebufferForDevice("Denoised");
+        IG_ASSERT(frame.Color, "Expected valid color data for denoiser");
+        IG_ASSERT(frame.Normal, "Expected valid normal data for denoiser");
+        IG_ASSERT(frame.Albedo, "Expected valid albedo data for denoiser");
+        IG_ASSERT(frame.Output, "Expected valid output data for denoiser");
+
+        if (mFrameWidth != frame.Width || mFrameHeight != frame.Height) {
+            mFrameWidth  = frame.Width;
+            mFrameHeight = frame.Height;
+            mAuxValid    = false;
+        }
 
-        IG_ASSERT(color.Data, "Expected valid color data for denoiser");
-        IG_ASSERT(normal.Data, "Expected valid normal data for denoiser");
-        IG_ASSERT(albedo.Data, "Expected valid albedo data for denoiser");
-        IG_ASSERT(output.Data, "Expected valid output data for denoiser");
+        TileLayout layout = computeLayout(frame.Width, frame.Height);
+        if (mIsDeviceSetup || layout.Width != mTileWidth || layout.Height != mTileHeight) {
+            setupHost(layout.Width, layout.Height);
+            mAuxValid = false;
 
-        const size_t width  = device->framebufferWidth();
-        const size_t height = device->framebufferHeight();
+            // The overlap and alignment are only known after the first filter was committed. Make sure the very first frame uses them as well
+            const TileLayout actual = computeLayout(frame.Width, frame.Height);
+            if (actual.Width != layout.Width || actual.Height != layout.Height)
+                setupHost(actual.Width, actual.Height);
+            layout = actual;
+        }
 
-        if (mWidth != width || mHeight != height)
-            setupDevice(color.Data, normal.Data, albedo.Data, output.Data, width, height);
+        if (layout.isSingle()) {
+            // The auxiliary buffers stay in the filter buffers between calls
+            const TileRegion full = computeTileRegion(layout, 0, 0, frame.Width, frame.Height);
+            if (!mAuxValid) {
+                upload(mNormalBuffer, frame.Normal, full);
+                upload(mAlbedoBuffer, frame.Albedo, full);
+                if (mSettings.Prefilter) {
+                    mNormalFilter.execute();
+                    mAlbedoFilter.execute();
+                }
+                mAuxValid = true;
+            }
+
+            upload(mColorBuffer, frame.Color, full);
+            mMainFilter.execute();
+            download(mOutputBuffer, frame.Output, full);
+            updateMemoryUsage();
+            return;
+        }
 
-        if (mPrefilter) {
-            mNormalFilter.execute();
-            mAlbedoFilter.execute();
+        // The prefiltered auxiliary buffers have to be available for the overlap of each tile, therefore prefilter all tiles first
+        if (mSettings.Prefilter && !mAuxValid) {
+            mNormalCache.resize(frame.Width * frame.Height * 3);
+            mAlbedoCache.resize(frame.Width * frame.Height * 3);
+            forEachTile(layout, [&](const TileRegion& region) {
+                upload(mNormalBuffer, frame.Normal, region);
+                upload(mAlbedoBuffer, frame.Albedo, region);
+                mNormalFilter.execute();
+                mAlbedoFilter.execute();
+                download(mNormalBuffer, mNormalCache.data(), region);
+                download(mAlbedoBuffer, mAlbedoCache.data(), region);
+            });
         }
-        mMainFilter.execute();
+        mAuxValid = true;
+
+        forEachTile(layout, [&](const TileRegion& region) {
+            upload(mColorBuffer, frame.Color, region);
+            upload(mNormalBuffer, mSettings.Prefilter ? mNormalCache.data() : frame.Normal, region);
+            upload(mAlbedoBuffer, mSettings.Prefilter ? mAlbedoCache.data() : frame.Albedo, region);
+            mMainFilter.execute();
+            download(mOutputBuffer, frame.Output, region);
+        });
+        updateMemoryUsage();
+    }
+
+    /// Might be called from another thread than the one filtering
+    inline void addMemoryUsage(MemoryUsage& usage) const
+    {
+        usage.add(MemoryCategory::Denoiser, MemoryLocation::Host, mHostBytes);
+        usage.add(MemoryCategory::Denoiser, MemoryLocation::Device, mDeviceBytes);
     }
 
 private:
+    inline void updateMemoryUsage()
+    {
+        // Buffers set up for the device framebuffer are shared and not owned by the denoiser
+        const size_t bufferBytes = mIsDeviceSetup ? 0 : 4 * 3 * sizeof(float) * mTileWidth * mTileHeight;
+        const size_t hostBytes   = sizeof(float) * (mStaging.capacity() + mNormalCache.capacity() + mAlbedoCache.capacity());
+        const bool onHost        = mDeviceType == oidn::DeviceType::Default || mDeviceType == oidn::DeviceType::CPU;
+
+        mHostBytes   = hostBytes + (onHost ? bufferBytes : 0);
+        mDeviceBytes = onHost ? 0 : bufferBytes;
+    }
+
+    template <typename Func>
+    inline void forEachTile(const TileLayout& layout, Func func)
+    {
+        for (size_t ty = 0; ty < layout.CountY; ++ty) {
+            for (size_t tx = 0; tx < layout.CountX; ++tx)
+                func(computeTileRegion(layout, tx, ty, mFrameWidth, mFrameHeight));
+        }
+    }
+
+    inline TileLayout computeLayout(size_t width, size_t height) const
+    {
+        TileLayout layout;
+        layout.Width  = width;
+        layout.Height = height;
+        layout.Inner  = std::max(width, height);
+
+        if (mSettings.MaxMemoryMB == 0)
+            return layout;
+
+        // Half of the budget is given to OIDN, the other half is used for the tile buffers and the cached auxiliary buffers
+        const size_t budget        = mSettings.MaxMemoryMB * 1024 * 1024 / 2;
+        const size_t bytesPerPixel = 3 * sizeof(float);
+        const size_t cacheSize     = mSettings.Prefilter ? 2 * bytesPerPixel * width * height : 0;
+        const size_t tileBudget    = budget > cacheSize ? budget - cacheSize : 0;
+
+        // Four images and the staging buffer per tile
+        const size_t tilePixels = tileBudget / (5 * bytesPerPixel);
+        if (tilePixels >= width * height)
+            return layout;
+
+        const size_t side  = (size_t)std::sqrt((double)tilePixels);
+        const size_t inner = std::max(MinTileInner, side > 2 * mOverlap ? (side - 2 * mOverlap) / mAlignment * mAlignment : 0);
+
+        layout.Width   = std::min(width, inner + 2 * mOverlap);
+        layout.Height  = std::min(height, inner + 2 * mOverlap);
+        layout.Inner   = inner;
+        layout.Overlap = mOverlap;
+        layout.CountX  = (width + inner - 1) / inner;
+        layout.CountY  = (height + inner - 1) / inner;
+        return layout;
+    }
+
+    // Copy the tile from the frame to the filter buffer
+    inline void upload(oidn::BufferRef& buffer, const float* src, const TileRegion& region)
+    {
+        const size_t tileSize = 3 * mTileWidth * mTileHeight;
+        if (mTileWidth == mFrameWidth) {
+            // Rows are contiguous
+            buffer.write(0, sizeof(float) * tileSize, src + 3 * region.Y * mFrameWidth);
+            return;
+        }
+
+        mStaging.resize(tileSize);
+        for (size_t y = 0; y < mTileHeight; ++y)
+            std::memcpy(mStaging.data() + 3 * y * mTileWidth, src + 3 * ((region.Y + y) * mFrameWidth + region.X), sizeof(float) * 3 * mTileWidth);
+        buffer.write(0, sizeof(float) * tileSize, mStaging.data());
+    }
+
+    // Copy the inner part of the tile from the filter buffer to the frame
+    inline void download(oidn::BufferRef& buffer, float* dst, const TileRegion& region)
+    {
+        const size_t tileSize = 3 * mTileWidth * mTileHeight;
+        if (mTileWidth == mFrameWidth && mTileHeight == mFrameHeight) {
+            buffer.read(0, sizeof(float) * tileSize, dst);
+            return;
+        }
+
+        mStaging.resize(tileSize);
+        buffer.read(0, sizeof(float) * tileSize, mStaging.data());
+
+        const size_t innerWidth = region.InnerX1 - region.InnerX0;
+        for (size_t y = region.InnerY0; y < region.InnerY1; ++y)
+            std::memcpy(dst + 3 * (y * mFrameWidth + region.InnerX0), mStaging.data() + 3 * ((y - region.Y) * mTileWidth + region.InnerX0 - region.X), sizeof(float) * 3 * innerWidth);
+    }
+
     inline void setupHost(size_t width, size_t height)
     {
-        const size_t framebufferSize = 3 * width * height;
+        const size_t tileSize = 3 * width * height;
 
-        mColorBuffer  = mDevice.newBuffer(sizeof(float) * framebufferSize);
-        mNormalBuffer = mDevice.newBuffer(sizeof(float) * framebufferSize);
-        mAlbedoBuffer = mDevice.newBuffer(sizeof(float) * framebufferSize);
-        mOutputBuffer = mDevice.newBuffer(sizeof(float) * framebufferSize);
+        mColorBuffer  = mDevice.newBuffer(sizeof(float) * tileSize);
+        mNormalBuffer = mDevice.newBuffer(sizeof(float) * tileSize);
+        mAlbedoBuffer = mDevice.newBuffer(sizeof(float) * tileSize);
+        mOutputBuffer = mDevice.newBuffer(sizeof(float) * tileSize);
 
         setup(width, height);
+
+        mTileWidth     = width;
+        mTileHeight    = height;
+        mIsDeviceSetup = false;
+
+        // The actual overlap required by the network is only known after committing
+        mOverlap   = std::max<size_t>(mOverlap, (size_t)std::max(0, mMainFilter.get<int>("tileOverlap")));
+        mAlignment = std::max<size_t>(1, (size_t)std::max(0, mMainFilter.get<int>("tileAlignment")));
     }
 
     inline void setupDevice(const float* color, const float* normal, const float* albedo, float* output,
@@ -179,6 +404,12 @@ private:
         mOutputBuffer = mDevice.newBuffer(output, sizeof(float) * framebufferSize);
 
         setup(width, height);
+
+        mFrameWidth    = width;
+        mFrameHeight   = height;
+        mTileWidth     = 0;
+        mTileHeight    = 0;
+        mIsDeviceSetup = true;
     }
 
     inline void setup(size_t width, size_t height)
@@ -190,23 +421,25 @@ private:
         mMainFilter.setImage("albedo", mAlbedoBuffer, oidn::Format::Float3, width, height);
         mMainFilter.setImage("output", mOutputBuffer, oidn::Format::Float3, width, height);
 
-        if (!mHighQuality)
+        if (!mSettings.HighQuality)
             mMainFilter.set("quality", oidn::Quality::Balanced);
 
         mMainFilter.set("hdr", true);
-        if (mPrefilter)
+        if (mSettings.Prefilter)
             mMainFilter.set("cleanAux", true);
+        applyMemoryLimit(mMainFilter, mSettings);
         mMainFilter.commit();
 
-        if (mPrefilter) {
+        if (mSettings.Prefilter) {
             // Normal
             mNormalFilter = mDevice.newFilter("RT");
             mNormalFilter.setImage("normal", mNormalBuffer, oidn::Format::Float3, width, height);
             mNormalFilter.setImage("output", mNormalBuffer, oidn::Format::Float3, width, height);
 
-            if (!mHighQuality)
+            if (!mSettings.HighQuality)
                 mNormalFilter.set("quality", oidn::Quality::Balanced);
 
+            applyMemoryLimit(mNormalFilter, mSettings);
             mNormalFilter.commit();
 
             // Albedo
@@ -214,42 +447,52 @@ private:
             mAlbedoFilter.setImage("albedo", mAlbedoBuffer, oidn::Format::Float3, width, height);
             mAlbedoFilter.setImage("output", mAlbedoBuffer, oidn::Format::Float3, width, height);
 
-            if (!mHighQuality)
+            if (!mSettings.HighQuality)
                 mAlbedoFilter.set("quality", oidn::Quality::Balanced);
 
+            applyMemoryLimit(mAlbedoFilter, mSettings);
             mAlbedoFilter.commit();
         }
-
-        mWidth  = width;
-        mHeight = height;
     }
 
-    const bool mPrefilter;
-    const bool mHighQuality;
+    const DenoiserSettings mSettings;
 
-    size_t mWidth;
-    size_t mHeight;
     oidn::DeviceType mDeviceType;
     oidn::DeviceRef mDevice;
 
+    size_t mFrameWidth;
+    size_t mFrameHeight;
+    size_t mTileWidth;
+    size_t mTileHeight;
+    size_t mOverlap;
+    size_t mAlignment;
+    bool mAuxValid;
+    bool mIsDeviceSetup;
+    std::atomic<size_t> mHostBytes   = 0;
+    std::atomic<size_t> mDeviceBytes = 0;
+
     oidn::BufferRef mColorBuffer;
     oidn::BufferRef mNormalBuffer;
     oidn::BufferRef mAlbedoBuffer;
     oidn::BufferRef mOutputBuffer;
 
+    std::vector<float> mStaging;
+    std::vector<float> mNormalCache; // Prefiltered normals if tiled
+    std::vector<float> mAlbedoCache; // Prefiltered albedo if tiled
+
     oidn::FilterRef mMainFilter;
     oidn::FilterRef mNormalFilter;
     oidn::FilterRef mAlbedoFilter;
 };
 #else
-// Old, CPU only version
+// Old, CPU only version. The host data is shared with the filter, OIDN handles the tiling internally
 class OIDNContext {
 public:
-    OIDNContext(bool prefilter, bool highQuality)
-        : mPrefilter(prefilter)
-        , mHighQuality(highQuality)
+    explicit OIDNContext(const DenoiserSettings& settings)
+        : mSettings(settings)
         , mWidth(0)
         , mHeight(0)
+        , mAuxValid(false)
     {
         mDevice = oidn::newDevice(oidn::DeviceType::CPU);
 
@@ -262,43 +505,61 @@ public:
         IG_LOG(IG::L_INFO) << "Using OpenImageDenoise " << versionMajor << "." << versionMinor << "." << versionPatch << std::endl;
     }
 
+    inline bool isSameDevice(Target target) { return target.isCPU(); }
+
+    /// The buffers are shared with the given frame, therefore nothing is allocated besides the internal scratch memory
+    inline void addMemoryUsage(MemoryUsage&) const {}
+
+    inline void invalidateAux() { mAuxValid = false; }
+
     inline void filter(IRenderDevice* device)
     {
-        const auto color  = device->getFramebufferForHost({});
-        const auto normal = device->getFramebufferForHost("Normals");
-        const auto albedo = device->getFramebufferForHost("Albedo");
         const auto output = device->getFramebufferForHost("Denoised", false);
 
-        IG_ASSERT(color.Data, "Expected valid color data for denoiser");
-        IG_ASSERT(normal.Data, "Expected valid normal data for denoiser");
-        IG_ASSERT(albedo.Data, "Expected valid albedo data for denoiser");
-        IG_ASSERT(output.Data, "Expected valid output data for denoiser");
+        filterHost(HostFrame{
+            .Color  = device->getFramebufferForHost({}).Data,
+            .Normal = device->getFramebufferForHost("Normals").Data,
+            .Albedo = device->getFramebufferForHost("Albedo").Data,
+            .Output = output.Data,
+            .Width  = device->framebufferWidth(),
+            .Height = device->framebufferHeight() });
 
-        const size_t width  = device->framebufferWidth();
-        const size_t height = device->framebufferHeight();
+        device->syncFramebufferHostToDevice("Denoised");
+    }
 
-        if (mWidth != width || mHeight != height)
-            setup(color.Data, normal.Data, albedo.Data, output.Data, width, height);
+    inline void filterHost(const HostFrame& frame)
+    {
+        IG_ASSERT(frame.Color, "Expected valid color data for denoiser");
+        IG_ASSERT(frame.Normal, "Expected valid normal data for denoiser");
+        IG_ASSERT(frame.Albedo, "Expected valid albedo data for denoiser");
+        IG_ASSERT(frame.Output, "Expected valid output data for denoiser");
+
+        if (mWidth != frame.Width || mHeight != frame.Height || mColor != frame.Color || mNormal != frame.Normal || mAlbedo != frame.Albedo || mOutput != frame.Output) {
+            setup(frame);
+            mAuxValid = false;
+        }
 
-        if (mPrefilter) {
+        // The auxiliary buffers are prefiltered in place
+        if (mSettings.Prefilter && !mAuxValid) {
             mNormalFilter.execute();
             mAlbedoFilter.execute();
         }
-        mMainFilter.execute();
+        mAuxValid = true;
 
-        device->syncFramebufferHostToDevice("Denoised");
+        mMainFilter.execute();
     }
 
 private:
-    inline void setup(const float* color, const float* normal, const float* albedo, float* output,
-                      size_t width, size_t height)
+    inline void setup(const HostFrame& frame)
     {
+        const size_t width           = frame.Width;
+        const size_t height          = frame.Height;
         const size_t framebufferSize = 3 * width * height;
 
-        mColorBuffer  = mDevice.newBuffer(const_cast<float*>(color), sizeof(float) * framebufferSize);
-        mNormalBuffer = mDevice.newBuffer(const_cast<float*>(normal), sizeof(float) * framebufferSize);
-        mAlbedoBuffer = mDevice.newBuffer(const_cast<float*>(albedo), sizeof(float) * framebufferSize);
-        mOutputBuffer = mDevice.newBuffer(output, sizeof(float) * framebufferSize);
+        mColorBuffer  = mDevice.newBuffer(const_cast<float*>(frame.Color), sizeof(float) * framebufferSize);
+        mNormalBuffer = mDevice.newBuffer(const_cast<float*>(frame.Normal), sizeof(float) * framebufferSize);
+        mAlbedoBuffer = mDevice.newBuffer(const_cast<float*>(frame.Albedo), sizeof(float) * framebufferSize);
+        mOutputBuffer = mDevice.newBuffer(frame.Output, sizeof(float) * framebufferSize);
 
         // Main
         mMainFilter = mDevice.newFilter("RT");
@@ -308,33 +569,45 @@ private:
         mMainFilter.setImage("output", mOutputBuffer, oidn::Format::Float3, width, height);
 
         mMainFilter.set("hdr", true);
-        if (mPrefilter)
+        if (mSettings.Prefilter)
             mMainFilter.set("cleanAux", true);
+        applyMemoryLimit(mMainFilter, mSettings);
         mMainFilter.commit();
 
-        if (mPrefilter) {
+        if (mSettings.Prefilter) {
             // Normal
             mNormalFilter = mDevice.newFilter("RT");
             mNormalFilter.setImage("normal", mNormalBuffer, oidn::Format::Float3, width, height);
             mNormalFilter.setImage("output", mNormalBuffer, oidn::Format::Float3, width, height);
+            applyMemoryLimit(mNormalFilter, mSettings);
             mNormalFilter.commit();
 
             // Albedo
             mAlbedoFilter = mDevice.newFilter("RT");
             mAlbedoFilter.setImage("albedo", mAlbedoBuffer, oidn::Format::Float3, width, height);
             mAlbedoFilter.setImage("output", mAlbedoBuffer, oidn::Format::Float3, width, height);
+            applyMemoryLimit(mAlbedoFilter, mSettings);
             mAlbedoFilter.commit();
         }
 
         mWidth  = width;
         mHeight = height;
+        mColor  = frame.Color;
+        mNormal = frame.Normal;
+        mAlbedo = frame.Albedo;
+        mOutput = frame.Output;
     }
 
-    const bool mPrefilter;
-    const bool mHighQuality;
+    const DenoiserSettings mSettings;
 
     size_t mWidth;
     size_t mHeight;
+    const float* mColor  = nullptr;
+    const float* mNormal = nullptr;
+    const float* mAlbedo = nullptr;
+    float* mOutput       = nullptr;
+    bool mAuxValid;
+
     oidn::DeviceRef mDevice;
 
     oidn::BufferRef mColorBuffer;
@@ -348,14 +621,159 @@ private:
 };
 #endif
 
-#else // IG_HAS_DENOISER
-class OIDNContext {
+// Denoises copies of the framebuffer in a background thread, such that rendering can continue in the meantime.
+// Only a single job is active at a time, intermediate requests are skipped
+class AsyncDenoiser {
+public:
+    explicit AsyncDenoiser(OIDNContext& context)
+        : mContext(context)
+        , mGeneration(0)
+        , mJobGeneration(0)
+        , mJobIteration(0)
+        , mAuxCopied(false)
+        , mHasResult(false)
+    {
+    }
+
+    ~AsyncDenoiser()
+    {
+        if (mJob.valid())
+            mJob.wait();
+    }
+
+    inline void reset()
+    {
+        ++mGeneration;
+        mAuxCopied = false;
+        mHasResult = false;
+    }
+
+    inline void run(IRenderDevice* device, size_t iteration)
+    {
+        const size_t width  = device->framebufferWidth();
+        const size_t height = device->framebufferHeight();
+        const size_t size   = 3 * width * height;
+
+        // Publish finished job
+        if (mJob.valid() && mJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            publish(width, height);
+
+        if (mHasResult)
+            writeResult(device, iteration);
+
+        if (mJob.valid())
+            return; // Still busy
+
+        // The data is copied, as the framebuffer will change while the job is running
+        if (!mAuxCopied || mFrame.Width != width || mFrame.Height != height) {
+            const float* normal = device->getFramebufferForHost("Normals").Data;
+            const float* albedo = device->getFramebufferForHost("Albedo").Data;
+            mNormal.assign(normal, normal + size);
+            mAlbedo.assign(albedo, albedo + size);
+            mAuxCopied = true;
+            mContext.invalidateAux();
+        }
+
+        const float* color = device->getFramebufferForHost({}).Data;
+        mColor.assign(color, color + size);
+        mJobOutput.resize(size);
+
+        mFrame = HostFrame{
+            .Color  = mColor.data(),
+            .Normal = mNormal.data(),
+            .Albedo = mAlbedo.data(),
+            .Output = mJobOutput.data(),
+            .Width  = width,
+            .Height = height
+        };
+        mJobGeneration = mGeneration;
+        mJobIteration  = iteration;
+
+        mJob = std::async(std::launch::async, [this]() { mContext.filterHost(mFrame); });
+    }
+
+    /// Wait for the running job and make sure the denoised AOV matches the given iteration.
+    /// If the latest result is based on an older iteration, the current framebuffer is denoised synchronously
+    inline void finish(IRenderDevice* device, size_t iteration)
+    {
+        if (mJob.valid()) {
+            mJob.wait();
+            publish(device->framebufferWidth(), device->framebufferHeight());
+        }
+
+        if (mHasResult && mResultIteration == iteration)
+            writeResult(device, iteration);
+        else
+            mContext.filter(device);
+    }
+
+    inline void addMemoryUsage(MemoryUsage& usage) const
+    {
+        const size_t copies = mColor.capacity() + mNormal.capacity() + mAlbedo.capacity() + mJobOutput.capacity() + mResult.capacity();
+        usage.add(MemoryCategory::Denoiser, MemoryLocation::Host, sizeof(float) * copies);
+        mContext.addMemoryUsage(usage);
+    }
+
+private:
+    inline void publish(size_t width, size_t height)
+    {
+        mJob.get();
+        if (mJobGeneration == mGeneration && mFrame.Width == width && mFrame.Height == height) {
+            mResult.swap(mJobOutput);
+            mResultIteration = mJobIteration;
+            mHasResult       = true;
+        }
+    }
+
+    inline void writeResult(IRenderDevice* device, size_t iteration)
+    {
+        // The denoised AOV is normalized by the current iteration count, but the result is based on less iterations
+        float* output     = device->getFramebufferForHost("Denoised", false).Data;
+        const float scale = iteration / (float)mResultIteration;
+        for (size_t i = 0; i < mResult.size(); ++i)
+            output[i] = mResult[i] * scale;
+        device->syncFramebufferHostToDevice("Denoised");
+    }
+
+    OIDNContext& mContext;
+
+    size_t mGeneration;
+    size_t mJobGeneration;
+    size_t mJobIteration;
+    size_t mResultIteration = 0;
+    bool mAuxCopied;
+    bool mHasResult;
+
+    HostFrame mFrame;
+    std::vector<float> mColor;
+    std::vector<float> mNormal;
+    std::vector<float> mAlbedo;
+    std::vector<float> mJobOutput;
+    std::vector<float> mResult;
+
+    std::future<void> mJob;
+};
+
+class OIDNInternal {
+public:
+    explicit OIDNInternal(const DenoiserSettings& settings)
+        : Context(settings)
+        , Async(settings.Async ? std::make_unique<AsyncDenoiser>(Context) : nullptr)
+    {
+    }
+
+    OIDNContext Context;
+    std::unique_ptr<AsyncDenoiser> Async;
+    size_t LastIteration = 0; // Iteration of the last synchronous run
+};
+#else  // IG_HAS_DENOISER
+class OIDNInternal {
 };
 #endif
 
 OIDN::OIDN(Runtime* runtime)
 #ifdef IG_HAS_DENOISER
-    : mInternal(std::make_unique<OIDNContext>(runtime->options().Denoiser.Prefilter, runtime->options().Denoiser.HighQuality))
+    : mInternal(std::make_unique<OIDNInternal>(runtime->options().Denoiser))
 #else
     : mInternal()
 #endif
@@ -367,12 +785,72 @@ OIDN::~OIDN()
 {
 }
 
-void OIDN::run(IRenderDevice* device)
+void OIDN::run(IRenderDevice* device, size_t iteration)
 {
 #ifdef IG_HAS_DENOISER
-    mInternal->filter(device);
+    if (mInternal->Async)
+        mInternal->Async->run(device, iteration);
+    else {
+        mInternal->Context.filter(device);
+        mInternal->LastIteration = iteration;
+    }
 #else
-    IG_UNUSED(device);
+    IG_UNUSED(device, iteration);
+#endif
+}
+
+void OIDN::finish(IRenderDevice* device, size_t iteration)
+{
+#ifdef IG_HAS_DENOISER
+    if (mInternal->Async) {
+        mInternal->Async->finish(device, iteration);
+    } else if (mInternal->LastIteration != iteration) {
+        mInternal->Context.filter(device);
+        mInternal->LastIteration = iteration;
+    }
+#else
+    IG_UNUSED(device, iteration);
+#endif
+}
+
+void OIDN::addMemoryUsage(MemoryUsage& usage) const
+{
+#ifdef IG_HAS_DENOISER
+    if (mInternal->Async)
+        mInternal->Async->addMemoryUsage(usage);
+    else
+        mInternal->Context.addMemoryUsage(usage);
+#else
+    IG_UNUSED(usage);
+#endif
+}
+
+void OIDN::reset()
+{
+#ifdef IG_HAS_DENOISER
+    if (mInternal->Async)
+        mInternal->Async->reset();
+    else
+        mInternal->Context.invalidateAux();
+    mInternal->LastIteration = 0;
+#endif
+}
+
+bool OIDN::denoise(const DenoiserSettings& settings, const float* color, const float* normal, const float* albedo, float* output, size_t width, size_t height)
+{
+#ifdef IG_HAS_DENOISER
+    OIDNContext context(settings);
+    context.filterHost(HostFrame{
+        .Color  = color,
+        .Normal = normal,
+        .Albedo = albedo,
+        .Output = output,
+        .Width  = width,
+        .Height = height });
+    return true;
+#else
+    IG_UNUSED(settings, color, normal, albedo, output, width, height);
+    return false;
 #endif
 }
 
@@ -393,4 +871,4 @@ bool OIDN::hasGPU()
     return false;
 #endif
 }
-} // namespace IG
\ No newline at end of file
+} // namespace IG
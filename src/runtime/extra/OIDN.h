@@ -1,6 +1,7 @@
 #pragma once
 
-#include "IG_Config.h"
+#include "MemoryUsage.h"
+#include "RuntimeSettings.h"
 
 namespace IG {
 class Runtime;
@@ -11,12 +12,25 @@ public:
     OIDN(Runtime* runtime);
     ~OIDN();
 
-    void run(IRenderDevice* device);
+    /// Denoise the current framebuffer into the "Denoised" AOV. The iteration count includes the current iteration
+    void run(IRenderDevice* device, size_t iteration);
+
+    /// Make sure the "Denoised" AOV matches the given iteration. Blocks until a pending asynchronous job is done
+    void finish(IRenderDevice* device, size_t iteration);
+
+    /// Has to be called if the framebuffer was reset, as the auxiliary buffers are cached
+    void reset();
+
+    /// Add the buffers allocated by the denoiser, excluding its internal scratch memory
+    void addMemoryUsage(MemoryUsage& usage) const;
+
+    /// Denoise the given rgb host images with the given settings. Returns false if no denoiser is available
+    static bool denoise(const DenoiserSettings& settings, const float* color, const float* normal, const float* albedo, float* output, size_t width, size_t height);
 
     [[nodiscard]] static bool isAvailable();
     [[nodiscard]] static bool hasGPU();
 
 private:
-    std::unique_ptr<class OIDNContext> mInternal;
+    std::unique_ptr<class OIDNInternal> mInternal;
 };
 } // namespace IG
\ No newline at end of file
@@ -42,14 +42,17 @@ void EnvironmentLight::serialize(const SerializationInput& input) const
     input.Tree.beginClosure(name());
 
     ShadingTree::BakeOutputTexture baked;
-    const std::string exported_id = "_light_" + name();
-    const auto cache_data         = input.Tree.context().Cache->ExportedData.find(exported_id);
-    if (cache_data != input.Tree.context().Cache->ExportedData.end()) {
-        baked = std::any_cast<ShadingTree::BakeOutputTexture>(cache_data->second);
-    } else {
-        baked = input.Tree.bakeTexture("radiance", *mLight, Vector3f::Ones(), ShadingTree::TextureBakeOptions{ 0, 0, 1024, 512, true });
+    {
+        std::lock_guard<std::recursive_mutex> guard(input.Tree.context().Cache->ExportMutex);
+        const std::string exported_id = "_light_" + name();
+        const auto cache_data         = input.Tree.context().Cache->ExportedData.find(exported_id);
+        if (cache_data != input.Tree.context().Cache->ExportedData.end()) {
+            baked = std::any_cast<ShadingTree::BakeOutputTexture>(cache_data->second);
+        } else {
+            baked = input.Tree.bakeTexture("radiance", *mLight, Vector3f::Ones(), ShadingTree::TextureBakeOptions{ 0, 0, 1024, 512, true });
 
-        input.Tree.context().Cache->ExportedData[exported_id] = baked;
+            input.Tree.context().Cache->ExportedData[exported_id] = baked;
+        }
     }
 
     input.Tree.addColor("scale", *mLight, Vector3f::Ones());
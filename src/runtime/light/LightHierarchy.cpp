@@ -87,25 +87,36 @@ Path LightHierarchy::setup(const std::vector<std::shared_ptr<Light>>& lights, Sh
     // Check if already setup
     const std::string exported_id = "_light_hierarchy_";
 
+    std::lock_guard<std::recursive_mutex> guard(tree.context().Cache->ExportMutex);
     const auto data = tree.context().Cache->ExportedData.find(exported_id);
     if (data != tree.context().Cache->ExportedData.end())
         return std::any_cast<Path>(data->second);
 
-    // Setup bvh
-    LightBvh bvh;
+    std::vector<Input> inputs;
+    inputs.reserve(lights.size());
     for (const auto& l : lights) {
         const auto p = l->position();
         IG_ASSERT(p.has_value(), "Expected all finite lights to return a valid position");
-        const bool has_dir = l->direction().has_value();
-        const Vector3f dir = l->direction().value_or(Vector3f::UnitZ());
-        const float flux   = l->computeFlux(tree);
-
-        bvh.store(LightEntry(p.value(), dir, has_dir ? flux : -flux, (int32)l->id()));
+        inputs.push_back(Input{ p.value(), l->direction().value_or(Vector3f::UnitZ()), l->computeFlux(tree), l->direction().has_value(), (int32)l->id() });
     }
 
+    const Path path = tree.context().CacheManager->directory() / "light_hierarchy.bin";
+    build(inputs, path);
+
+    tree.context().Cache->ExportedData[exported_id] = path;
+    return path;
+}
+
+void LightHierarchy::build(const std::vector<Input>& inputs, const Path& path)
+{
+    // Setup bvh
+    LightBvh bvh;
+    for (const auto& input : inputs)
+        bvh.store(LightEntry(input.Position, input.Direction, input.HasDirection ? input.Flux : -input.Flux, input.ID));
+
     // Compute flux and average direction for inner nodes
     std::vector<LightEntry> innerNodes(bvh.innerNodes().size());
-    std::vector<uint32> codes(lights.size(), 0);
+    std::vector<uint32> codes(inputs.size(), 0);
     populateInnerNodes(0, 0, 0, bvh, innerNodes, codes);
 
     if (L_DEBUG == IG_LOGGER.verbosity()) {
@@ -117,14 +128,9 @@ Path LightHierarchy::setup(const std::vector<std::shared_ptr<Light>>& lights, Sh
         //     IG_LOG(L_DEBUG) << code << std::endl;
     }
 
-    const Path path = tree.context().CacheManager->directory() / "light_hierarchy.bin";
-
     FileSerializer serializer(path, false);
     serializer.write(codes, true); // Codes are used to backtrack for the pdf. TODO: Currently this is limited to max depth 32!
     serializer.writeAlignmentPad(sizeof(float) * 4);
     serializer.write(innerNodes, true);
-
-    tree.context().Cache->ExportedData[exported_id] = path;
-    return path;
 }
 } // namespace IG
\ No newline at end of file
@@ -5,8 +5,19 @@
 namespace IG {
 class Light;
 class ShadingTree;
-class LightHierarchy {
+class IG_LIB LightHierarchy {
 public:
+    struct Input {
+        Vector3f Position;
+        Vector3f Direction;
+        float Flux;
+        bool HasDirection;
+        int32 ID;
+    };
+
     static Path setup(const std::vector<std::shared_ptr<Light>>& lights, ShadingTree& tree);
+
+    /// Build the hierarchy for the given finite lights and write it to `path`. IDs have to be in [0, inputs.size())
+    static void build(const std::vector<Input>& inputs, const Path& path);
 };
 } // namespace IG
\ No newline at end of file
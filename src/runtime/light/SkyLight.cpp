@@ -31,6 +31,7 @@ static Path setup_sky(LoaderContext& ctx, const std::string& name, const std::sh
 {
     const std::string exported_id = "_sky_" + name;
 
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
     const auto data = ctx.Cache->ExportedData.find(exported_id);
     if (data != ctx.Cache->ExportedData.end())
         return std::any_cast<Path>(data->second);
@@ -9,6 +9,7 @@
 #include "LoaderTexture.h"
 #include "Logger.h"
 #include "ParameterDescSet.h"
+#include "Timeline.h"
 #include "shader/AdvancedShadowShader.h"
 #include "shader/DeviceShader.h"
 #include "shader/HitShader.h"
@@ -17,8 +18,13 @@
 #include "shader/TraversalShader.h"
 #include "shader/UtilityShader.h"
 
+#include <cctype>
 #include <chrono>
 #include <functional>
+#include <unordered_set>
+
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 namespace IG {
 static ParameterDescSet handleUserParameters(const LoaderOptions& opts)
@@ -81,6 +87,107 @@ static ParameterDescSet handleUserParameters(const LoaderOptions& opts)
     return params;
 }
 
+struct ShaderTask {
+    std::string Name;
+    std::string Function; // Entry point to start compiling right away. Empty if the shader is not compiled
+    std::function<std::string()> Generator;
+    ShaderOutput<std::string>* Output;
+    LoaderContext::ShaderState State;
+};
+
+static inline void addShaderTask(std::vector<ShaderTask>& tasks, size_t variant, const std::string& name, const std::string& function, const std::function<std::string()>& func, ShaderOutput<std::string>& output)
+{
+    tasks.push_back(ShaderTask{ .Name = name, .Function = function, .Generator = func, .Output = &output, .State = LoaderContext::ShaderState{ .Variant = variant } });
+}
+
+/// Add tasks for the hit, advanced shadow and callback shaders of the given variant. Only materials accepted by the filter get new hit and advanced shadow shaders
+static void addMaterialShaderTasks(LoaderContext& ctx, size_t i, std::vector<ShaderTask>& tasks, const std::function<bool(size_t)>& filter)
+{
+    auto& variant    = ctx.TechniqueVariants[i];
+    const auto& info = ctx.Technique->info().Variants[i];
+
+    // Generate hit shaders. The outputs are referenced by the tasks, therefore the vectors must not grow afterwards
+    variant.HitShaders.resize(ctx.Materials.size());
+    for (size_t j = 0; j < ctx.Materials.size(); ++j) {
+        if (!filter(j))
+            continue;
+        addShaderTask(
+            tasks, i, "hit " + std::to_string(j), "ig_hit_shader", [&ctx, j]() { return HitShader::setup(j, ctx); }, variant.HitShaders[j]);
+    }
+
+    // Generate advanced shadow shaders if requested
+    if (info.ShadowHandlingMode != ShadowHandlingMode::Simple) {
+        const size_t max_materials = info.ShadowHandlingMode == ShadowHandlingMode::Advanced ? 1 : ctx.Materials.size();
+        variant.AdvancedShadowHitShaders.resize(max_materials);
+        variant.AdvancedShadowMissShaders.resize(max_materials);
+
+        // A single shader handles all materials, therefore it is affected by every material
+        bool anyMaterial = false;
+        for (size_t j = 0; j < ctx.Materials.size() && !anyMaterial; ++j)
+            anyMaterial = filter(j);
+
+        const auto accept = [&](size_t j) { return max_materials == 1 ? anyMaterial : filter(j); };
+
+        for (size_t j = 0; j < max_materials; ++j) {
+            if (!accept(j))
+                continue;
+            addShaderTask(
+                tasks, i, "advanced shadow hit " + std::to_string(j), "ig_advanced_shadow_shader", [&ctx, j]() { return AdvancedShadowShader::setup(true, j, ctx); }, variant.AdvancedShadowHitShaders[j]);
+        }
+        for (size_t j = 0; j < max_materials; ++j) {
+            if (!accept(j))
+                continue;
+            addShaderTask(
+                tasks, i, "advanced shadow miss " + std::to_string(j), "ig_advanced_shadow_shader", [&ctx, j]() { return AdvancedShadowShader::setup(false, j, ctx); }, variant.AdvancedShadowMissShaders[j]);
+        }
+    }
+
+    // Generate callback shaders if requested
+    for (size_t j = 0; j < info.CallbackGenerators.size(); ++j) {
+        if (info.CallbackGenerators.at(j) != nullptr) {
+            addShaderTask(
+                tasks, i, "callback " + std::to_string(j), "ig_callback_shader", [&ctx, &info, j]() { return info.CallbackGenerators.at(j)(ctx); }, variant.CallbackShaders[j]);
+        }
+    }
+}
+
+/// Generate the shaders of all tasks in parallel. Global parameters set by the generators are merged into the given registry
+static void generateShaders(LoaderContext& ctx, std::vector<ShaderTask>& tasks, ParameterSet& globalRegistry)
+{
+    IG_LOG(L_DEBUG) << "Generating " << tasks.size() << " shaders in parallel" << std::endl;
+    tbb::parallel_for(size_t(0), tasks.size(), [&](size_t k) {
+        auto& task           = tasks[k];
+        const size_t variant = task.State.Variant;
+
+        // Do not pick up other shader tasks while waiting inside a generator (e.g., while exporting data), as the waiting task might hold locks
+        tbb::this_task_arena::isolate([&]() {
+            LoaderContext::ShaderScope scope(ctx, task.State);
+            try {
+                IG_TIMELINE_SCOPE("loader", "Generate " + task.Name + " shader (v" + std::to_string(variant) + ")");
+                IG_LOG(L_DEBUG) << "Generating " << task.Name << " shader for variant " << variant << std::endl;
+                task.Output->Exec = task.Generator();
+                if (task.Output->Exec.empty())
+                    throw std::runtime_error("Constructed empty " + task.Name + " shader.");
+                task.Output->LocalRegistry = std::make_shared<ParameterSet>(std::move(task.State.LocalRegistry));
+            } catch (const std::exception& e) {
+                IG_LOG(L_ERROR) << "Exception in " << task.Name << " shader for variant " << variant << ": " << e.what() << std::endl;
+                task.State.HasError = true;
+            }
+        });
+
+        // Let the caller start compiling while other shaders are still generated
+        if (ctx.Options.ShaderCallback && !task.State.HasError && !task.Function.empty())
+            ctx.Options.ShaderCallback(variant, task.Name, task.Function, task.Output->Exec);
+    });
+
+    // Merge in task order to be independent of the scheduling
+    for (const auto& task : tasks) {
+        globalRegistry.mergeFrom(task.State.GlobalRegistry, true);
+        if (task.State.HasError)
+            ctx.signalError();
+    }
+}
+
 std::optional<LoaderContext> Loader::load(const LoaderOptions& opts)
 {
     LoaderContext ctx;
@@ -102,25 +209,37 @@ std::optional<LoaderContext> Loader::load(const LoaderOptions& opts)
 
     ctx.CacheManager->sync();
 
-    ctx.Shapes->prepare(ctx);
-    ctx.Entities->prepare(ctx);
-    ctx.Textures->prepare(ctx);
-    ctx.Lights->prepare(ctx);
-    ctx.BSDFs->prepare(ctx);
-    ctx.Media->prepare(ctx);
+    {
+        IG_TIMELINE_SCOPE("loader", "Prepare");
+        ctx.Shapes->prepare(ctx);
+        ctx.Entities->prepare(ctx);
+        ctx.Textures->prepare(ctx);
+        ctx.Lights->prepare(ctx);
+        ctx.BSDFs->prepare(ctx);
+        ctx.Media->prepare(ctx);
+    }
 
     // Load content
 
     ctx.CacheManager->sync();
-    if (!ctx.Shapes->load(ctx))
-        return std::nullopt;
+    {
+        IG_TIMELINE_SCOPE("loader", "Load shapes");
+        if (!ctx.Shapes->load(ctx))
+            return std::nullopt;
+    }
 
     ctx.CacheManager->sync();
-    if (!ctx.Entities->load(ctx))
-        return std::nullopt;
+    {
+        IG_TIMELINE_SCOPE("loader", "Load entities");
+        if (!ctx.Entities->load(ctx))
+            return std::nullopt;
+    }
 
     ctx.CacheManager->sync();
-    ctx.Lights->setup(ctx);
+    {
+        IG_TIMELINE_SCOPE("loader", "Setup lights");
+        ctx.Lights->setup(ctx);
+    }
 
     ctx.CacheManager->sync();
 
@@ -146,6 +265,7 @@ std::optional<LoaderContext> Loader::load(const LoaderOptions& opts)
     if (!ctx.Camera->hasCamera())
         return std::nullopt;
 
+    IG_TIMELINE_SCOPE("loader", "Generate shaders");
     ctx.Technique->setup(ctx);
     if (!ctx.Technique->hasTechnique())
         return std::nullopt;
@@ -160,77 +280,39 @@ std::optional<LoaderContext> Loader::load(const LoaderOptions& opts)
     else
         IG_LOG(L_DEBUG) << "Generating shaders for " << ctx.Technique->info().Variants.size() << " variants" << std::endl;
 
+    // Collect all shaders first and generate them in parallel afterwards
+    std::vector<ShaderTask> tasks;
+
+    const auto add = [&](size_t variant, const std::string& name, const std::string& function, const std::function<std::string()>& func, ShaderOutput<std::string>& output) {
+        addShaderTask(tasks, variant, name, function, func, output);
+    };
+
     ctx.TechniqueVariants.resize(ctx.Technique->info().Variants.size());
     for (size_t i = 0; i < ctx.Technique->info().Variants.size(); ++i) {
-        const auto setup = [&](const std::string& name, const std::function<std::string()>& func, ShaderOutput<std::string>& output) {
-            try {
-                ctx.resetLocalRegistry();
-                IG_LOG(L_DEBUG) << "Generating " << name << " shader for variant " << i << std::endl;
-                output.Exec = func();
-                if (output.Exec.empty())
-                    throw std::runtime_error("Constructed empty " + name + " shader.");
-                output.LocalRegistry = std::make_shared<ParameterSet>(std::move(ctx.LocalRegistry));
-            } catch (const std::exception& e) {
-                IG_LOG(L_ERROR) << "Exception in " << name << " shader for variant " << i << ": " << e.what() << std::endl;
-                ctx.signalError();
-            }
-        };
-
-        auto& variant                   = ctx.TechniqueVariants[i];
-        const auto& info                = ctx.Technique->info().Variants[i];
-        ctx.CurrentTechniqueVariant     = i;
-        ctx.Options.SamplesPerIteration = info.GetSPI(opts.SamplesPerIteration);
+        auto& variant    = ctx.TechniqueVariants[i];
+        const auto& info = ctx.Technique->info().Variants[i];
 
         // Generate shaders
-        setup(
-            "device", [&]() { return DeviceShader::setup(ctx); }, variant.DeviceShader);
-        setup(
-            "tonemap", [&]() { return UtilityShader::setupTonemap(ctx); }, variant.TonemapShader);
-        setup(
-            "imageinfo", [&]() { return UtilityShader::setupImageinfo(ctx); }, variant.ImageinfoShader);
-        setup(
-            "primary traversal", [&]() { return TraversalShader::setupPrimary(ctx); }, variant.PrimaryTraversalShader);
-        setup(
-            "secondary traversal", [&]() { return TraversalShader::setupSecondary(ctx); }, variant.SecondaryTraversalShader);
-        setup(
-            "ray generation", [&]() { return info.OverrideCameraGenerator ? info.OverrideCameraGenerator(ctx) : RayGenerationShader::setup(ctx); }, variant.RayGenerationShader);
-        setup(
-            "miss", [&]() { return MissShader::setup(ctx); }, variant.MissShader);
-
-        // Generate hit shaders
-        for (size_t j = 0; j < ctx.Materials.size(); ++j) {
-            ShaderOutput<std::string> output;
-            setup(
-                "hit " + std::to_string(j), [&]() { return HitShader::setup(j, ctx); }, output);
-            variant.HitShaders.emplace_back(std::move(output));
-        }
-
-        // Generate advanced shadow shaders if requested
-        if (info.ShadowHandlingMode != ShadowHandlingMode::Simple) {
-            const size_t max_materials = info.ShadowHandlingMode == ShadowHandlingMode::Advanced ? 1 : ctx.Materials.size();
-            for (size_t j = 0; j < max_materials; ++j) {
-                ShaderOutput<std::string> output;
-                setup(
-                    "advanced shadow hit " + std::to_string(j), [&]() { return AdvancedShadowShader::setup(true, j, ctx); }, output);
-                variant.AdvancedShadowHitShaders.emplace_back(std::move(output));
-            }
-            for (size_t j = 0; j < max_materials; ++j) {
-                ShaderOutput<std::string> output;
-                setup(
-                    "advanced shadow miss " + std::to_string(j), [&]() { return AdvancedShadowShader::setup(false, j, ctx); }, output);
-                variant.AdvancedShadowMissShaders.emplace_back(std::move(output));
-            }
-        }
-
-        // Generate callback shaders if requested
-        for (size_t j = 0; j < info.CallbackGenerators.size(); ++j) {
-            if (info.CallbackGenerators.at(j) != nullptr) {
-                setup(
-                    "callback " + std::to_string(j), [&]() { return info.CallbackGenerators.at(j)(ctx); }, variant.CallbackShaders[j]);
-            }
-        }
+        add(
+            i, "device", "ig_callback_shader", [&]() { return DeviceShader::setup(ctx); }, variant.DeviceShader);
+        add(
+            i, "tonemap", opts.EnableTonemapping ? "ig_tonemap_shader" : "", [&]() { return UtilityShader::setupTonemap(ctx); }, variant.TonemapShader);
+        add(
+            i, "imageinfo", opts.EnableTonemapping ? "ig_imageinfo_shader" : "", [&]() { return UtilityShader::setupImageinfo(ctx); }, variant.ImageinfoShader);
+        add(
+            i, "primary traversal", "ig_traversal_shader", [&]() { return TraversalShader::setupPrimary(ctx); }, variant.PrimaryTraversalShader);
+        add(
+            i, "secondary traversal", "ig_traversal_shader", [&]() { return TraversalShader::setupSecondary(ctx); }, variant.SecondaryTraversalShader);
+        add(
+            i, "ray generation", "ig_ray_generation_shader", [&]() { return info.OverrideCameraGenerator ? info.OverrideCameraGenerator(ctx) : RayGenerationShader::setup(ctx); }, variant.RayGenerationShader);
+        add(
+            i, "miss", "ig_miss_shader", [&]() { return MissShader::setup(ctx); }, variant.MissShader);
+
+        addMaterialShaderTasks(ctx, i, tasks, [](size_t) { return true; });
     }
 
+    generateShaders(ctx, tasks, ctx.GlobalRegistry);
+
     // Put some information into the registry
     ctx.GlobalRegistry.IntParameters["__entity_count"]        = (int)ctx.Entities->entityCount();
     ctx.GlobalRegistry.IntParameters["__shape_count"]         = (int)ctx.Shapes->shapeCount();
@@ -248,6 +330,182 @@ std::optional<LoaderContext> Loader::load(const LoaderOptions& opts)
     }
 }
 
+using ObjectMap = std::unordered_map<std::string, std::shared_ptr<SceneObject>>;
+
+static inline bool isSameObject(const std::shared_ptr<SceneObject>& a, const std::shared_ptr<SceneObject>& b)
+{
+    if (!a || !b)
+        return a == b;
+    return a->isEqual(*b);
+}
+
+static bool isSameObjectMap(const ObjectMap& a, const ObjectMap& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (const auto& pair : a) {
+        const auto it = b.find(pair.first);
+        if (it == b.end() || !isSameObject(pair.second, it->second))
+            return false;
+    }
+    return true;
+}
+
+/// Names of objects which were added, removed or changed
+static std::unordered_set<std::string> getChangedObjects(const ObjectMap& prev, const ObjectMap& next)
+{
+    std::unordered_set<std::string> changed;
+    for (const auto& pair : next) {
+        const auto it = prev.find(pair.first);
+        if (it == prev.end() || !isSameObject(pair.second, it->second))
+            changed.insert(pair.first);
+    }
+    for (const auto& pair : prev) {
+        if (next.count(pair.first) == 0)
+            changed.insert(pair.first);
+    }
+    return changed;
+}
+
+/// True if a string property of the object names one of the given objects, either directly or as an identifier inside an expression.
+/// This is conservative, as not every identifier inside an expression has to be a texture
+static bool referencesAny(const SceneObject& obj, const std::unordered_set<std::string>& names)
+{
+    if (names.empty())
+        return false;
+
+    for (const auto& pair : obj.properties()) {
+        if (pair.second.type() != SceneProperty::PT_STRING)
+            continue;
+
+        const std::string& str = pair.second.getString();
+        if (names.count(str) > 0)
+            return true;
+
+        for (size_t start = 0; start < str.size();) {
+            size_t end = start;
+            while (end < str.size() && (std::isalnum(static_cast<unsigned char>(str[end])) || str[end] == '_'))
+                ++end;
+
+            if (end > start && names.count(str.substr(start, end - start)) > 0)
+                return true;
+            start = end + 1;
+        }
+    }
+    return false;
+}
+
+Loader::ReloadResult Loader::reload(LoaderContext& ctx, const Scene* scene, ParameterSet& globalRegistry)
+{
+    IG_ASSERT(scene != nullptr, "Expected a valid scene");
+    const Scene* previous = ctx.Options.Scene;
+
+    const auto fullReload = [](const std::string& reason) {
+        IG_LOG(L_INFO) << reason << ", which requires a full reload" << std::endl;
+        return ReloadResult::FullReloadRequired;
+    };
+
+    // Only bsdfs and textures can be updated incrementally
+    if (!isSameObject(previous->technique(), scene->technique()))
+        return fullReload("The technique changed");
+    if (!isSameObject(previous->camera(), scene->camera()))
+        return fullReload("The camera changed");
+    if (!isSameObject(previous->film(), scene->film()))
+        return fullReload("The film changed");
+    if (!isSameObjectMap(previous->shapes(), scene->shapes()))
+        return fullReload("The shapes changed");
+    if (!isSameObjectMap(previous->entities(), scene->entities()))
+        return fullReload("The entities changed");
+    if (!isSameObjectMap(previous->lights(), scene->lights()))
+        return fullReload("The lights changed");
+    if (!isSameObjectMap(previous->media(), scene->media()))
+        return fullReload("The media changed");
+    if (!isSameObjectMap(previous->parameters(), scene->parameters()))
+        return fullReload("The scene parameters changed");
+
+    auto textures = getChangedObjects(previous->textures(), scene->textures());
+    auto bsdfs    = getChangedObjects(previous->bsdfs(), scene->bsdfs());
+    for (const auto& name : bsdfs) {
+        if (scene->bsdf(name) == nullptr)
+            return fullReload("The bsdf '" + name + "' was removed");
+    }
+
+    // Propagate changes to all textures and bsdfs referencing changed ones, directly or indirectly
+    for (bool grown = true; grown;) {
+        grown = false;
+        for (const auto& pair : scene->textures()) {
+            if (textures.count(pair.first) == 0 && referencesAny(*pair.second, textures)) {
+                textures.insert(pair.first);
+                grown = true;
+            }
+        }
+        for (const auto& pair : scene->bsdfs()) {
+            if (bsdfs.count(pair.first) == 0 && (referencesAny(*pair.second, textures) || referencesAny(*pair.second, bsdfs))) {
+                bsdfs.insert(pair.first);
+                grown = true;
+            }
+        }
+    }
+
+    // Other shaders are kept, therefore nothing else is allowed to depend on the changes
+    const auto dependsOnChanges = [&](const std::shared_ptr<SceneObject>& obj) {
+        return obj && (referencesAny(*obj, textures) || referencesAny(*obj, bsdfs));
+    };
+    for (const auto& pair : scene->lights()) {
+        if (dependsOnChanges(pair.second))
+            return fullReload("The light '" + pair.first + "' depends on changed textures");
+    }
+    for (const auto& pair : scene->media()) {
+        if (dependsOnChanges(pair.second))
+            return fullReload("The medium '" + pair.first + "' depends on changed textures");
+    }
+    if (dependsOnChanges(scene->technique()) || dependsOnChanges(scene->camera()) || dependsOnChanges(scene->film()))
+        return fullReload("The technique, camera or film depends on changed textures");
+
+    IG_LOG(L_DEBUG) << "Reloading " << bsdfs.size() << " bsdfs and " << textures.size() << " textures" << std::endl;
+
+    // Keep the previous state to restore it on failure
+    auto previousTextures = ctx.Textures;
+    auto previousBSDFs    = std::move(ctx.BSDFs);
+    auto previousVariants = ctx.TechniqueVariants;
+
+    ctx.Options.Scene = scene;
+    ctx.Textures      = std::make_shared<LoaderTexture>();
+    ctx.BSDFs         = std::make_unique<LoaderBSDF>();
+    ctx.Textures->prepare(ctx);
+    ctx.BSDFs->prepare(ctx);
+
+    // Computed expressions might depend on changed textures
+    if (!textures.empty()) {
+        ctx.Cache->ExprComputation.clear();
+        ctx.Cache->ExprResolution.clear();
+    }
+
+    std::vector<ShaderTask> tasks;
+    for (size_t i = 0; i < ctx.TechniqueVariants.size(); ++i)
+        addMaterialShaderTasks(ctx, i, tasks, [&](size_t j) { return bsdfs.count(ctx.Materials[j].BSDF) > 0; });
+
+    ParameterSet registry;
+    {
+        IG_TIMELINE_SCOPE("loader", "Regenerate shaders");
+        generateShaders(ctx, tasks, registry);
+    }
+
+    if (ctx.HasError) {
+        IG_LOG(L_ERROR) << "Aborting reload due to previous errors." << std::endl;
+        ctx.Options.Scene     = previous;
+        ctx.Textures          = std::move(previousTextures);
+        ctx.BSDFs             = std::move(previousBSDFs);
+        ctx.TechniqueVariants = std::move(previousVariants);
+        ctx.HasError          = false;
+        return ReloadResult::Failed;
+    }
+
+    globalRegistry.mergeFrom(registry, true);
+    return ReloadResult::Updated;
+}
+
 std::vector<std::string> Loader::getAvailableTechniqueTypes()
 {
     return LoaderTechnique::getAvailableTypes();
@@ -10,6 +10,17 @@ class Loader {
 public:
     static std::optional<LoaderContext> load(const LoaderOptions& opts);
 
+    enum class ReloadResult {
+        Updated,            // Affected shaders were regenerated in the technique variants of the context
+        FullReloadRequired, // The scene changed in a way which can not be handled incrementally. The context is unchanged
+        Failed              // Generating the affected shaders failed. The context is unchanged
+    };
+
+    /// Regenerate only the hit, advanced shadow and callback shaders affected by changed bsdfs and textures of the given scene.
+    /// The scene has to outlive the context and replaces the scene the context was loaded with on success.
+    /// Global parameters set while generating are put into the given registry
+    [[nodiscard]] static ReloadResult reload(LoaderContext& ctx, const Scene* scene, ParameterSet& globalRegistry);
+
     /// Get a list of all available techniques
     static std::vector<std::string> getAvailableTechniqueTypes();
 
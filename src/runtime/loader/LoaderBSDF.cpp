@@ -48,7 +48,10 @@ std::string LoaderBSDF::generate(const std::string& name, ShadingTree& tree)
         return stream.str();
     }
 
-    mGeneratedBSDFs.insert(name);
+    {
+        std::lock_guard<std::mutex> guard(mGeneratedMutex);
+        mGeneratedBSDFs.insert(name);
+    }
 
     it->second->serialize(BSDF::SerializationInput{ stream, tree });
 
@@ -2,6 +2,7 @@
 
 #include "IG_Config.h"
 
+#include <mutex>
 #include <unordered_set>
 
 namespace IG {
@@ -16,7 +17,11 @@ public:
 
     [[nodiscard]] std::string generate(const std::string& name, ShadingTree& tree);
 
-    [[nodiscard]] inline bool checkIfGenerated(const std::string& name) const { return mGeneratedBSDFs.count(name) > 0; }
+    [[nodiscard]] inline bool checkIfGenerated(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> guard(mGeneratedMutex);
+        return mGeneratedBSDFs.count(name) > 0;
+    }
     [[nodiscard]] inline size_t bsdfCount() const { return mAvailableBSDFs.size(); }
 
     using RegisterBSDFCallback = std::shared_ptr<BSDF> (*)(const std::string&, const std::shared_ptr<SceneObject>&);
@@ -25,6 +30,7 @@ public:
 private:
     std::unordered_map<std::string, std::shared_ptr<BSDF>> mAvailableBSDFs; // All available bsdfs, not necessarily the ones loaded at the end!
     std::unordered_set<std::string> mGeneratedBSDFs;                        // Lookup table to check if material was loaded or not
+    mutable std::mutex mGeneratedMutex;                                     // BSDFs are generated in parallel shader generation tasks
 };
 
 template <typename T>
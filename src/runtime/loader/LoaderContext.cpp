@@ -16,6 +16,28 @@
 
 namespace IG {
 
+// Shader scopes active on the calling thread. A thread might work on another task while waiting, therefore the most recent scope for a context wins
+static thread_local std::vector<std::pair<const LoaderContext*, LoaderContext::ShaderState*>> sShaderScopes;
+
+LoaderContext::ShaderScope::ShaderScope(const LoaderContext& ctx, ShaderState& state)
+{
+    sShaderScopes.emplace_back(&ctx, &state);
+}
+
+LoaderContext::ShaderScope::~ShaderScope()
+{
+    sShaderScopes.pop_back();
+}
+
+LoaderContext::ShaderState* LoaderContext::findShaderState() const
+{
+    for (auto it = sShaderScopes.rbegin(); it != sShaderScopes.rend(); ++it) {
+        if (it->first == this)
+            return it->second;
+    }
+    return nullptr;
+}
+
 LoaderContext::LoaderContext()                           = default;
 LoaderContext::LoaderContext(LoaderContext&&)            = default;
 LoaderContext& LoaderContext::operator=(LoaderContext&&) = default;
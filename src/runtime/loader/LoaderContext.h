@@ -12,6 +12,7 @@
 
 #include <any>
 #include <filesystem>
+#include <mutex>
 #include <vector>
 
 namespace IG {
@@ -25,6 +26,16 @@ struct Material {
     size_t Count = 1;   // Number of entities using this material, this is ignored in the equal operator
     inline bool hasEmission() const { return !Entity.empty(); }
     inline bool hasMediumInterface() const { return MediumInner >= 0 || MediumOuter >= 0; }
+    /// Unique among all materials of a scene, as the medium interface and the emissive entity are part of it. Used to identify materials in profiles
+    inline std::string name() const
+    {
+        std::string name = BSDF;
+        if (hasMediumInterface())
+            name += " <" + std::to_string(MediumInner) + "|" + std::to_string(MediumOuter) + ">";
+        if (hasEmission())
+            name += " [" + Entity + "]";
+        return name;
+    }
 };
 
 inline bool operator==(const Material& a, const Material& b)
@@ -36,6 +47,12 @@ struct LoaderCache {
     std::unordered_map<std::string, std::any> ExportedData;                    // Cache with already exported data and auxillary info
     std::unordered_map<std::string, std::any> ExprComputation;                 // Cache with already computed expressions
     std::unordered_map<std::string, std::pair<size_t, size_t>> ExprResolution; // Cache with already approximative expression resolutions
+
+    // Shaders are generated in parallel, therefore all shared data has to be guarded
+    std::recursive_mutex ExportMutex; // Held while exporting data, as exports write to the cache directory and might export other data
+    std::mutex ExprMutex;             // Guards ExprComputation and ExprResolution
+    std::mutex BakeMutex;             // Serializes baking on the device
+    std::mutex ResourceMutex;         // Guards the registered resources of all contexts sharing this cache
 };
 
 class IG_LIB LoaderContext {
@@ -66,16 +83,47 @@ public:
     SceneDatabase Database;
     std::vector<TechniqueVariant> TechniqueVariants; // TODO: Refactor this out, as no loader requires this, but will produce it...
 
-    size_t CurrentTechniqueVariant;
-    [[nodiscard]] inline const IG::TechniqueVariantInfo CurrentTechniqueVariantInfo() const { return Technique->info().Variants.at(CurrentTechniqueVariant); }
+    /// State of a single shader generation task. Everything a shader generator writes to is local to the task, as shaders are generated in parallel
+    struct ShaderState {
+        size_t Variant = 0;
+        ParameterSet LocalRegistry{};  // Local registry for the given shader
+        ParameterSet GlobalRegistry{}; // Global parameters set while generating, merged into the global registry afterwards
+        bool HasError = false;
+    };
+
+    /// Makes the given state current for this context on the calling thread until the scope is left
+    class IG_LIB ShaderScope {
+        IG_CLASS_NON_COPYABLE(ShaderScope);
+        IG_CLASS_NON_MOVEABLE(ShaderScope);
+
+    public:
+        ShaderScope(const LoaderContext& ctx, ShaderState& state);
+        ~ShaderScope();
+    };
+
+    [[nodiscard]] inline size_t currentTechniqueVariant() const
+    {
+        const ShaderState* state = findShaderState();
+        return state ? state->Variant : 0;
+    }
+    [[nodiscard]] inline const IG::TechniqueVariantInfo CurrentTechniqueVariantInfo() const { return Technique->info().Variants.at(currentTechniqueVariant()); }
 
     ParameterDescSet SceneParameterDesc;
 
     ParameterSet GlobalRegistry; // Global registry, will be merged with the user registry at the end (user preceding over)
-    ParameterSet LocalRegistry;  // Current local registry for given shader
-    inline void resetLocalRegistry()
+
+    /// Registry to put global parameters in while generating a shader. Outside a shader scope this is the global registry itself
+    [[nodiscard]] inline ParameterSet& globalRegistry()
     {
-        LocalRegistry = ParameterSet();
+        ShaderState* state = findShaderState();
+        return state ? state->GlobalRegistry : GlobalRegistry;
+    }
+
+    /// Current local registry for the shader generated on the calling thread
+    [[nodiscard]] inline ParameterSet& localRegistry()
+    {
+        ShaderState* state = findShaderState();
+        return state ? state->LocalRegistry : mLocalRegistry;
     }
 
     std::vector<Material> Materials;
@@ -89,6 +137,8 @@ public:
     std::unordered_map<std::string, size_t> RegisteredResources;
     inline size_t registerExternalResource(const Path& path)
     {
+        std::lock_guard<std::mutex> guard(Cache->ResourceMutex);
+
         // TODO: Ensure canonical paths?
         auto it = RegisteredResources.find(path.generic_string());
         if (it != RegisteredResources.end())
@@ -100,6 +150,8 @@ public:
 
     [[nodiscard]] inline std::vector<std::string> generateResourceMap() const
     {
+        std::lock_guard<std::mutex> guard(Cache->ResourceMutex);
+
         std::vector<std::string> map(RegisteredResources.size());
         for (const auto& p : RegisteredResources) {
             IG_ASSERT(p.second < map.size(), "Access should be always in bound");
@@ -113,8 +165,16 @@ public:
     /// Use this function to mark the loading process as failed
     inline void signalError()
     {
-        HasError = true;
+        if (ShaderState* state = findShaderState())
+            state->HasError = true;
+        else
+            HasError = true;
     }
+
+private:
+    [[nodiscard]] ShaderState* findShaderState() const;
+
+    ParameterSet mLocalRegistry; // Used outside of shader scopes, e.g., for baking
 };
 
 } // namespace IG
\ No newline at end of file
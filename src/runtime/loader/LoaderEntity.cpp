@@ -99,6 +99,7 @@ bool LoaderEntity::load(LoaderContext& ctx)
     // Load entities in the order of their material
     std::unordered_map<ShapeProvider*, std::vector<EntityObject>> in_objs;
     mEntityCount = 0;
+    mEntityNames.clear();
     for (size_t materialID = 0; materialID < material_groups.size(); ++materialID) {
         for (const auto& pair : material_groups.at(materialID)) {
             const auto child = pair.second;
@@ -173,6 +174,7 @@ bool LoaderEntity::load(LoaderContext& ctx)
             obj.Flags      = entity_flags; // Only added to bvh
 
             in_objs[shape.Provider].emplace_back(obj);
+            mEntityNames.push_back(pair.first);
             mEntityCount++;
         }
     }
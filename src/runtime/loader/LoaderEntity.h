@@ -34,11 +34,14 @@ public:
     bool load(LoaderContext& ctx);
 
     [[nodiscard]] inline size_t entityCount() const { return mEntityCount; }
+    /// Names of all loaded entities, indexed by entity id
+    [[nodiscard]] inline const std::vector<std::string>& entityNames() const { return mEntityNames; }
 
     [[nodiscard]] std::optional<Entity> getEmissiveEntity(const std::string& name) const;
 
 private:
     size_t mEntityCount = 0;
+    std::vector<std::string> mEntityNames;
     std::unordered_map<std::string, Entity> mEmissiveEntities;
 };
 } // namespace IG
\ No newline at end of file
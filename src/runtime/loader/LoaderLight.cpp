@@ -399,6 +399,7 @@ void LoaderLight::embedLights(ShadingTree& tree)
     if (!isEmbedding())
         return;
 
+    std::lock_guard<std::mutex> guard(mEmbedMutex);
     for (const auto& p : mEmbedClassCounter) {
         const auto embedClass = p.first;
 
@@ -456,6 +457,7 @@ Path LoaderLight::generateLightSelectionCDF(ShadingTree& tree)
 {
     const std::string exported_id = "_light_cdf_";
 
+    std::lock_guard<std::recursive_mutex> guard(tree.context().Cache->ExportMutex);
     const auto data = tree.context().Cache->ExportedData.find(exported_id);
     if (data != tree.context().Cache->ExportedData.end())
         return std::any_cast<Path>(data->second);
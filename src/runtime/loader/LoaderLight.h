@@ -52,5 +52,7 @@ private:
     std::unordered_map<std::string, size_t> mEmbedClassCounter;
     size_t mTotalEmbedCount;
     std::unordered_map<std::string, size_t> mAreaLights; // Name of entities being area lights
+
+    std::mutex mEmbedMutex; // Lights are embedded on first use, which might happen in multiple shader generation tasks
 };
 } // namespace IG
\ No newline at end of file
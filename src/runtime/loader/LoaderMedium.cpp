@@ -3,6 +3,7 @@
 #include "LoaderUtils.h"
 #include "Logger.h"
 #include "ShadingTree.h"
+#include "medium/GridMedium.h"
 #include "medium/HomogeneousMedium.h"
 #include "medium/VacuumMedium.h"
 
@@ -13,6 +14,11 @@ static std::shared_ptr<Medium> medium_homogeneous(const std::string& name, const
     return std::make_shared<HomogeneousMedium>(name, medium);
 }
 
+static std::shared_ptr<Medium> medium_grid(const std::string& name, const std::shared_ptr<SceneObject>& medium, LoaderContext&)
+{
+    return std::make_shared<GridMedium>(name, medium);
+}
+
 // It is recommended to not define the medium, instead of using vacuum
 static std::shared_ptr<Medium> medium_vacuum(const std::string& name, const std::shared_ptr<SceneObject>&, LoaderContext&)
 {
@@ -26,6 +32,8 @@ static const struct {
 } _generators[] = {
     { "homogeneous", medium_homogeneous },
     { "constant", medium_homogeneous },
+    { "grid", medium_grid },
+    { "heterogeneous", medium_grid },
     { "vacuum", medium_vacuum },
     { "", nullptr }
 };
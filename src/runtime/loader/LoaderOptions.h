@@ -4,9 +4,12 @@
 #include "RuntimeSettings.h"
 #include "Scene.h"
 
+#include <functional>
+
 namespace IG {
 class ScriptCompiler;
 class IRenderDevice;
+class SpecializationProfile;
 
 struct LoaderOptions {
     Path FilePath;
@@ -25,8 +28,15 @@ struct LoaderOptions {
     bool EnableCache;
     bool DisableStandardAOVs; // Disable Normal & Albedo output
     DenoiserSettings Denoiser;
+    AdaptiveSamplingSettings AdaptiveSampling;
 
     ScriptCompiler* Compiler;
     IRenderDevice* Device;
+
+    /// Profile recorded by a previous run. Only available if the specialization mode is Profile and a profile exists
+    std::shared_ptr<const SpecializationProfile> Profile;
+
+    /// Optional callback to start compiling a shader (variant, name, function, script) as soon as it is generated. Called from multiple threads
+    std::function<void(size_t, const std::string&, const std::string&, const std::string&)> ShaderCallback;
 };
 } // namespace IG
\ No newline at end of file
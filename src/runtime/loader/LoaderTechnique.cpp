@@ -18,6 +18,7 @@
 #include "technique/PathTechnique.h"
 #include "technique/PhotonMappingTechnique.h"
 #include "technique/Technique.h"
+#include "technique/VCMTechnique.h"
 #include "technique/VolumePathTechnique.h"
 #include "technique/WireframeTechnique.h"
 
@@ -61,6 +62,14 @@ static std::shared_ptr<Technique> ppm_loader(const std::shared_ptr<SceneObject>&
 {
     return std::make_shared<PhotonMappingTechnique>(*obj);
 }
+static std::shared_ptr<Technique> vcm_loader(const std::shared_ptr<SceneObject>& obj)
+{
+    return std::make_shared<VCMTechnique>(*obj, true);
+}
+static std::shared_ptr<Technique> bdpt_loader(const std::shared_ptr<SceneObject>& obj)
+{
+    return std::make_shared<VCMTechnique>(*obj, false);
+}
 static std::shared_ptr<Technique> vpt_loader(const std::shared_ptr<SceneObject>& obj)
 {
     return std::make_shared<VolumePathTechnique>(*obj);
@@ -87,6 +96,8 @@ static const struct TechniqueEntry {
     { "photonmapper", ppm_loader },
     { "lt", lt_loader },
     { "lighttracer", lt_loader },
+    { "vcm", vcm_loader },
+    { "bdpt", bdpt_loader },
     { "wireframe", wf_loader },
     { "lightvisibility", lv_loader },
     { "camera_check", cc_loader },
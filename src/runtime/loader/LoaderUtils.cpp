@@ -114,6 +114,7 @@ LoaderUtils::CDF2DData LoaderUtils::setup_cdf2d(LoaderContext& ctx, const Path&
 
 LoaderUtils::CDF2DData LoaderUtils::setup_cdf2d(LoaderContext& ctx, const std::string& name, const Image& image, bool premultiplySin, bool compensate)
 {
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
     const std::string exported_id = "_cdf2d_" + name;
     const auto data               = ctx.Cache->ExportedData.find(exported_id);
     if (data != ctx.Cache->ExportedData.end())
@@ -140,6 +141,7 @@ LoaderUtils::CDF2DSATData LoaderUtils::setup_cdf2d_sat(LoaderContext& ctx, const
 
 LoaderUtils::CDF2DSATData LoaderUtils::setup_cdf2d_sat(LoaderContext& ctx, const std::string& name, const Image& image, bool premultiplySin, bool compensate)
 {
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
     const std::string exported_id = "_cdf2dsat_" + name;
     const auto data               = ctx.Cache->ExportedData.find(exported_id);
     if (data != ctx.Cache->ExportedData.end())
@@ -167,6 +169,7 @@ LoaderUtils::CDF2DHierachicalData LoaderUtils::setup_cdf2d_hierachical(LoaderCon
 
 LoaderUtils::CDF2DHierachicalData LoaderUtils::setup_cdf2d_hierachical(LoaderContext& ctx, const std::string& name, const Image& image, bool premultiplySin, bool compensate)
 {
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
     const std::string exported_id = "_cdf2dhierachical_" + name;
     const auto data               = ctx.Cache->ExportedData.find(exported_id);
     if (data != ctx.Cache->ExportedData.end())
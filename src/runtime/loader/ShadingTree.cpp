@@ -3,6 +3,7 @@
 #include "LoaderTexture.h"
 #include "LoaderUtils.h"
 #include "Logger.h"
+#include "SpecializationProfile.h"
 #include "StringUtils.h"
 #include "device/IRenderDevice.h"
 #include "shader/BakeShader.h"
@@ -29,34 +30,54 @@ void ShadingTree::signalError()
 
 void ShadingTree::setupGlobalParameters()
 {
-    auto& reg = mContext.GlobalRegistry;
-    // Register all available user parameters
+    auto& reg = mContext.globalRegistry();
+    // Register all available user parameters. The definitions are emitted with the first header, as the specialization might change until then
     for (const auto& pair : mContext.Options.Scene->parameters()) {
         const auto param       = pair.second;
         const std::string type = param->pluginType();
 
         if (type == "number" || type == "int" || type == "integer") {
             const auto prop                 = param->property("value");
-            reg.FloatParameters[pair.first] = handleGlobalParameterNumber(pair.first, prop);
+            const float value               = handleGlobalParameterNumber(pair.first, prop);
+            reg.FloatParameters[pair.first] = value;
             const std::string param_name    = "param_f32_" + whitespace_escaped(pair.first);
-            mHeaderLines.push_back("  let " + param_name + " = registry::get_global_parameter_f32(\"" + pair.first + "\", 0); maybe_unused(" + param_name + ");\n");
+            mGlobalParameters.push_back(GlobalParameter{
+                .Name     = pair.first,
+                .Dynamic  = "  let " + param_name + " = registry::get_global_parameter_f32(\"" + pair.first + "\", 0); maybe_unused(" + param_name + ");\n",
+                .Constant = "  let " + param_name + " = " + std::to_string(value) + ":f32; maybe_unused(" + param_name + ");\n" });
             mTranspiler.registerCustomVariableNumber(pair.first, param_name);
         } else if (type == "vector") {
             const auto prop                  = param->property("value");
-            reg.VectorParameters[pair.first] = handleGlobalParameterVector(pair.first, prop);
+            const Vector3f value             = handleGlobalParameterVector(pair.first, prop);
+            reg.VectorParameters[pair.first] = value;
             const std::string param_name     = "param_vec3_" + whitespace_escaped(pair.first);
-            mHeaderLines.push_back("  let " + param_name + " = registry::get_global_parameter_vec3(\"" + pair.first + "\", vec3_expand(0)); maybe_unused(" + param_name + ");\n");
+            mGlobalParameters.push_back(GlobalParameter{
+                .Name     = pair.first,
+                .Dynamic  = "  let " + param_name + " = registry::get_global_parameter_vec3(\"" + pair.first + "\", vec3_expand(0)); maybe_unused(" + param_name + ");\n",
+                .Constant = "  let " + param_name + " = " + LoaderUtils::inlineVector(value) + "; maybe_unused(" + param_name + ");\n" });
             mTranspiler.registerCustomVariableVector(pair.first, param_name);
         } else if (type == "color") {
             const auto prop                 = param->property("value");
-            reg.ColorParameters[pair.first] = handleGlobalParameterColor(pair.first, prop);
+            const Vector4f value            = handleGlobalParameterColor(pair.first, prop);
+            reg.ColorParameters[pair.first] = value;
             const std::string param_name    = "param_color_" + whitespace_escaped(pair.first);
-            mHeaderLines.push_back("  let " + param_name + " = registry::get_global_parameter_color(\"" + pair.first + "\", color_builtins::black); maybe_unused(" + param_name + ");\n");
+            mGlobalParameters.push_back(GlobalParameter{
+                .Name     = pair.first,
+                .Dynamic  = "  let " + param_name + " = registry::get_global_parameter_color(\"" + pair.first + "\", color_builtins::black); maybe_unused(" + param_name + ");\n",
+                .Constant = "  let " + param_name + " = make_color(" + std::to_string(value.x()) + ", " + std::to_string(value.y()) + ", " + std::to_string(value.z()) + ", " + std::to_string(value.w()) + "); maybe_unused(" + param_name + ");\n" });
             mTranspiler.registerCustomVariableColor(pair.first, param_name);
         }
     }
 }
 
+bool ShadingTree::checkIfEmbedGlobalParameter(const std::string& name) const
+{
+    // Global parameters are only embedded into specialized shaders if a previous run has shown that they do not change
+    return mSpecialization == RuntimeOptions::SpecializationMode::Force
+           && mContext.Options.Profile
+           && !mContext.Options.Profile->isVaryingParameter(name);
+}
+
 float ShadingTree::handleGlobalParameterNumber(const std::string& name, const SceneProperty& prop)
 {
     float value = 0;
@@ -499,11 +520,17 @@ std::pair<size_t, size_t> ShadingTree::computeTextureResolution(const std::strin
         return { 1, 1 };
     case SceneProperty::PT_STRING: {
         const std::string expr = prop.getString();
-        if (const auto it = mContext.Cache->ExprResolution.find(expr); it != mContext.Cache->ExprResolution.end())
-            return it->second;
+        {
+            std::lock_guard<std::mutex> guard(mContext.Cache->ExprMutex);
+            if (const auto it = mContext.Cache->ExprResolution.find(expr); it != mContext.Cache->ExprResolution.end())
+                return it->second;
+        }
 
+        // Computed without holding the lock. Another task might compute the same resolution, which is fine as it is deterministic
         IG_LOG(L_DEBUG) << "Computing resolution of property '" << name << "'" << std::endl;
-        const auto res                       = computeTextureResolution(name, expr);
+        const auto res = computeTextureResolution(name, expr);
+
+        std::lock_guard<std::mutex> guard(mContext.Cache->ExprMutex);
         mContext.Cache->ExprResolution[expr] = res;
         return res;
     }
@@ -625,7 +652,9 @@ Image ShadingTree::computeImage(const std::string& name, const Transpiler::Resul
 
     Image image          = Image::createSolidImage(Vector4f::Zero(), width, height);
     const auto resources = mContext.generateResourceMap();
-    mContext.Options.Device->bake(ShaderOutput<void*>{ shader, std::make_shared<ParameterSet>(mContext.LocalRegistry) }, &resources, image.pixels.get());
+
+    std::lock_guard<std::mutex> guard(mContext.Cache->BakeMutex);
+    mContext.Options.Device->bake(ShaderOutput<void*>{ shader, std::make_shared<ParameterSet>(mContext.localRegistry()) }, &resources, image.pixels.get());
     return image;
 }
 
@@ -658,10 +687,8 @@ ShadingTree::BakeOutputColor ShadingTree::bakeTextureExpressionAverage(const std
 {
     const std::string expr_key = expr + "_avg";
 
-    if (const auto it = mContext.Cache->ExprComputation.find(expr_key); it != mContext.Cache->ExprComputation.end()) {
-        const auto output = std::any_cast<BakeOutputColor>(it->second);
-        return BakeOutputColor{ output.Value, output.WasConstant };
-    }
+    if (const auto cached = lookupComputation(expr_key); cached.has_value())
+        return cached.value();
 
     auto copyCtx  = mContext.copyForBake();
     auto copyTree = ShadingTree(copyCtx);
@@ -676,15 +703,15 @@ ShadingTree::BakeOutputColor ShadingTree::bakeTextureExpressionAverage(const std
         if (result.isSimple()) {
             const auto color = BakeOutputColor::AsConstant(copyTree.computeConstantColor(name, result));
 
-            mContext.Cache->ExprComputation[expr_key] = color;
+            storeComputation(expr_key, color);
             return color;
         } else if (options.SkipTextures) {
             return BakeOutputColor::AsConstant(def);
         } else {
-            const Image image                         = copyTree.computeImage(name, result, TextureBakeOptions{ 0, 0, 1, 1, true });
-            const Vector4f average                    = image.computeAverage();
-            const auto color                          = BakeOutputColor::AsConstant(average.block<3, 1>(0, 0));
-            mContext.Cache->ExprComputation[expr_key] = color;
+            const Image image      = copyTree.computeImage(name, result, TextureBakeOptions{ 0, 0, 1, 1, true });
+            const Vector4f average = image.computeAverage();
+            const auto color       = BakeOutputColor::AsConstant(average.block<3, 1>(0, 0));
+            storeComputation(expr_key, color);
             return color;
         }
     }
@@ -694,8 +721,8 @@ std::optional<float> ShadingTree::bakeSimpleNumber(const std::string& name, cons
 {
     const std::string expr_key = expr + "_num";
 
-    if (const auto it = mContext.Cache->ExprComputation.find(expr_key); it != mContext.Cache->ExprComputation.end())
-        return std::any_cast<BakeOutputColor>(it->second).Value.mean();
+    if (const auto cached = lookupComputation(expr_key); cached.has_value())
+        return cached.value().Value.mean();
 
     auto copyCtx  = mContext.copyForBake();
     auto copyTree = ShadingTree(copyCtx);
@@ -710,7 +737,7 @@ std::optional<float> ShadingTree::bakeSimpleNumber(const std::string& name, cons
         if (result.isSimple()) {
             const auto color = BakeOutputColor::AsConstant(copyTree.computeConstantColor(name, result));
 
-            mContext.Cache->ExprComputation[expr_key] = color;
+            storeComputation(expr_key, color);
             return color.Value.mean();
         } else {
             return std::nullopt;
@@ -722,8 +749,8 @@ std::optional<Vector3f> ShadingTree::bakeSimpleColor(const std::string& name, co
 {
     const std::string expr_key = expr + "_color";
 
-    if (const auto it = mContext.Cache->ExprComputation.find(expr_key); it != mContext.Cache->ExprComputation.end())
-        return std::any_cast<BakeOutputColor>(it->second).Value;
+    if (const auto cached = lookupComputation(expr_key); cached.has_value())
+        return cached.value().Value;
 
     auto copyCtx  = mContext.copyForBake();
     auto copyTree = ShadingTree(copyCtx);
@@ -738,7 +765,7 @@ std::optional<Vector3f> ShadingTree::bakeSimpleColor(const std::string& name, co
         if (result.isSimple()) {
             const auto color = BakeOutputColor::AsConstant(copyTree.computeConstantColor(name, result));
 
-            mContext.Cache->ExprComputation[expr_key] = color;
+            storeComputation(expr_key, color);
             return color.Value;
         } else {
             return std::nullopt;
@@ -746,6 +773,20 @@ std::optional<Vector3f> ShadingTree::bakeSimpleColor(const std::string& name, co
     }
 }
 
+std::optional<ShadingTree::BakeOutputColor> ShadingTree::lookupComputation(const std::string& key) const
+{
+    std::lock_guard<std::mutex> guard(mContext.Cache->ExprMutex);
+    if (const auto it = mContext.Cache->ExprComputation.find(key); it != mContext.Cache->ExprComputation.end())
+        return std::any_cast<BakeOutputColor>(it->second);
+    return std::nullopt;
+}
+
+void ShadingTree::storeComputation(const std::string& key, const BakeOutputColor& color)
+{
+    std::lock_guard<std::mutex> guard(mContext.Cache->ExprMutex);
+    mContext.Cache->ExprComputation[key] = color;
+}
+
 void ShadingTree::beginClosure(const std::string& name)
 {
     mClosures.emplace_back(Closure{ name, getClosureID(name), {} });
@@ -760,6 +801,10 @@ void ShadingTree::endClosure()
 std::string ShadingTree::pullHeader()
 {
     std::stringstream stream;
+    for (const auto& param : mGlobalParameters)
+        stream << (checkIfEmbedGlobalParameter(param.Name) ? param.Constant : param.Dynamic);
+    mGlobalParameters.clear();
+
     for (const auto& lines : mHeaderLines)
         stream << lines;
     mHeaderLines.clear();
@@ -935,8 +980,8 @@ std::string ShadingTree::acquireInteger(const std::string& prop_name, int number
     if (checkIfEmbed(number, options)) {
         return std::to_string(number);
     } else {
-        const std::string id                     = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
-        mContext.LocalRegistry.IntParameters[id] = number;
+        const std::string id                       = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
+        mContext.localRegistry().IntParameters[id] = number;
 
         mHeaderLines.push_back("  let var_int_" + id + " = registry::get_local_parameter_i32(\"" + id + "\", 0);\n");
         return "var_int_" + id;
@@ -948,8 +993,8 @@ std::string ShadingTree::acquireNumber(const std::string& prop_name, float numbe
     if (checkIfEmbed(number, options)) {
         return std::to_string(number);
     } else {
-        const std::string id                       = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
-        mContext.LocalRegistry.FloatParameters[id] = number;
+        const std::string id                         = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
+        mContext.localRegistry().FloatParameters[id] = number;
 
         mHeaderLines.push_back("  let var_num_" + id + " = registry::get_local_parameter_f32(\"" + id + "\", 0);\n");
         return "var_num_" + id;
@@ -961,8 +1006,8 @@ std::string ShadingTree::acquireColor(const std::string& prop_name, const Vector
     if (checkIfEmbed(color, options)) {
         return "make_color(" + std::to_string(color.x()) + ", " + std::to_string(color.y()) + ", " + std::to_string(color.z()) + ", 1)";
     } else {
-        const std::string id                       = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
-        mContext.LocalRegistry.ColorParameters[id] = Vector4f(color.x(), color.y(), color.z(), 1);
+        const std::string id                         = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
+        mContext.localRegistry().ColorParameters[id] = Vector4f(color.x(), color.y(), color.z(), 1);
 
         mHeaderLines.push_back("  let var_color_" + id + " = registry::get_local_parameter_color(\"" + id + "\", color_builtins::black);\n");
         return "var_color_" + id;
@@ -974,8 +1019,8 @@ std::string ShadingTree::acquireVector(const std::string& prop_name, const Vecto
     if (checkIfEmbed(vec, options)) {
         return "make_vec3(" + std::to_string(vec.x()) + ", " + std::to_string(vec.y()) + ", " + std::to_string(vec.z()) + ")";
     } else {
-        const std::string id                        = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
-        mContext.LocalRegistry.VectorParameters[id] = vec;
+        const std::string id                          = currentClosureID() + "_" + LoaderUtils::escapeIdentifier(prop_name);
+        mContext.localRegistry().VectorParameters[id] = vec;
 
         mHeaderLines.push_back("  let var_vec_" + id + " = registry::get_local_parameter_vec3(\"" + id + "\", vec3_expand(0));\n");
         return "var_vec_" + id;
@@ -193,6 +193,7 @@ private:
     bool checkIfEmbed(float val, const NumberOptions& options) const;
     bool checkIfEmbed(const Vector3f& color, const ColorOptions& options) const;
     bool checkIfEmbed(const Vector3f& vec, const VectorOptions& options) const;
+    bool checkIfEmbedGlobalParameter(const std::string& name) const;
 
     std::pair<size_t, size_t> computeTextureResolution(const std::string& name, const std::string& expr);
     BakeOutputTexture bakeTextureExpression(const std::string& name, const std::string& expr, const TextureBakeOptions& options);
@@ -203,9 +204,19 @@ private:
     Image computeImage(const std::string& name, const Transpiler::Result& result, const TextureBakeOptions& options);
     std::string loadTexture(const std::string& tex_name);
 
+    // Access to the expression cache shared by all shader generation tasks
+    std::optional<BakeOutputColor> lookupComputation(const std::string& key) const;
+    void storeComputation(const std::string& key, const BakeOutputColor& color);
+
     LoaderContext& mContext;
 
-    std::vector<std::string> mHeaderLines; // The order matters
+    struct GlobalParameter {
+        std::string Name;
+        std::string Dynamic;  // Definition reading the value from the global registry
+        std::string Constant; // Definition embedding the current value
+    };
+    std::vector<GlobalParameter> mGlobalParameters; // Definitions not yet emitted
+    std::vector<std::string> mHeaderLines;          // The order matters
     std::unordered_set<std::string> mLoadedTextures;
 
     std::vector<Closure> mClosures;
@@ -42,23 +42,24 @@ ConsoleLogListener::ConsoleLogListener(bool useAnsi)
 #endif
 }
 
-void ConsoleLogListener::startEntry(LogLevel level)
+void ConsoleLogListener::writeEntry(const LogMessage& msg)
 {
     std::cout << "[";
     if (mUseAnsi)
-        startColoring(level);
+        startColoring(msg.Level);
 
-    std::cout << Logger::levelString(level);
+    std::cout << Logger::levelString(msg.Level);
 
     if (mUseAnsi)
         stopColoring();
 
     std::cout << "] ";
+    std::cout.write(msg.Message.data(), msg.Message.size());
 }
 
-void ConsoleLogListener::writeEntry(char c)
+void ConsoleLogListener::flush()
 {
-    std::cout.put(c);
+    std::cout.flush();
 }
 
 void ConsoleLogListener::startColoring(LogLevel level)
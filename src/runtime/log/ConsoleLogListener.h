@@ -9,8 +9,8 @@ public:
     ConsoleLogListener(bool useAnsi = true);
     virtual ~ConsoleLogListener() = default;
 
-    virtual void startEntry(LogLevel level) override;
-    virtual void writeEntry(char c) override;
+    virtual void writeEntry(const LogMessage& msg) override;
+    virtual void flush() override;
 
     inline void enableAnsi(bool b = true) { mUseAnsi = b; }
     inline bool isUsingAnsi() const { return mUseAnsi; }
@@ -2,7 +2,6 @@
 
 #include <ctime>
 #include <iomanip>
-#include <thread>
 
 namespace IG {
 FileLogListener::FileLogListener()
@@ -22,10 +21,11 @@ void FileLogListener::open(const std::string& file)
     mStream.open(file.c_str(), std::ios::out);
 }
 
-void FileLogListener::startEntry(LogLevel level)
+void FileLogListener::writeEntry(const LogMessage& msg)
 {
-    time_t t  = time(nullptr);
-    clock_t c = clock();
+    // Time and thread are captured when the entry was created, not when it is written
+    const time_t t  = std::chrono::system_clock::to_time_t(msg.Time);
+    const auto msec = std::chrono::duration_cast<std::chrono::milliseconds>(msg.Time.time_since_epoch()).count() % 1000;
 
     struct tm ptm{};
 #ifndef IG_OS_WINDOWS
@@ -36,13 +36,14 @@ void FileLogListener::startEntry(LogLevel level)
     mStream << std::setw(2) << std::setfill('0') << ptm.tm_hour
             << ":" << std::setw(2) << ptm.tm_min << ":"
             << std::setw(2) << ptm.tm_sec
-            << "(" << c << ")> {"
-            << std::this_thread::get_id() << "} ["
-            << Logger::levelString(level) << "] ";
+            << "." << std::setw(3) << msec << "> {"
+            << msg.Thread << "} ["
+            << Logger::levelString(msg.Level) << "] ";
+    mStream.write(msg.Message.data(), msg.Message.size());
 }
 
-void FileLogListener::writeEntry(char c)
+void FileLogListener::flush()
 {
-    mStream.put(c);
+    mStream.flush();
 }
 } // namespace IG
@@ -11,8 +11,8 @@ public:
 
     void open(const std::string& file);
 
-    virtual void startEntry(LogLevel level) override;
-    virtual void writeEntry(char c) override;
+    virtual void writeEntry(const LogMessage& msg) override;
+    virtual void flush() override;
 
 private:
     std::fstream mStream;
@@ -9,7 +9,9 @@ public:
     LogListener()          = default;
     virtual ~LogListener() = default;
 
-    virtual void startEntry(LogLevel level) = 0;
-    virtual void writeEntry(char c)         = 0;
+    /// Called with a complete entry. Listeners are called from a single thread at a time
+    virtual void writeEntry(const LogMessage& msg) = 0;
+    /// Called whenever no further entries are pending
+    virtual void flush() {}
 };
 } // namespace IG
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Logger.h"
+
+#include <future>
+
+namespace IG {
+/// Entry passed from the producers to the background thread of the logger
+struct LogEntry {
+    enum class EntryType {
+        Message,
+        Flush, // Signal the producer after all previous entries were written
+        Stop   // Stop the background thread
+    };
+
+    std::atomic<LogEntry*> Next = nullptr;
+    EntryType Type              = EntryType::Message;
+    LogLevel Level              = L_INFO;
+    std::chrono::system_clock::time_point Time;
+    std::thread::id Thread;
+    std::string Message;
+    std::promise<void> Done; // Only used by Flush entries
+};
+
+/// Intrusive multi-producer single-consumer queue based on the design by Dmitry Vyukov.
+/// Pushing is wait-free, popping is only done by the background thread
+class LogQueue {
+public:
+    inline LogQueue()
+        : mHead(&mStub)
+        , mTail(&mStub)
+    {
+    }
+
+    inline void push(LogEntry* entry)
+    {
+        entry->Next.store(nullptr, std::memory_order_relaxed);
+        LogEntry* prev = mHead.exchange(entry, std::memory_order_acq_rel);
+        prev->Next.store(entry, std::memory_order_release);
+    }
+
+    /// Returns nullptr if the queue is empty or a producer is still in the middle of a push
+    inline LogEntry* pop()
+    {
+        LogEntry* tail = mTail;
+        LogEntry* next = tail->Next.load(std::memory_order_acquire);
+        if (tail == &mStub) {
+            if (next == nullptr)
+                return nullptr;
+            mTail = next;
+            tail  = next;
+            next  = next->Next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            mTail = next;
+            return tail;
+        }
+
+        if (tail != mHead.load(std::memory_order_acquire))
+            return nullptr;
+
+        push(&mStub);
+        next = tail->Next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            mTail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+private:
+    std::atomic<LogEntry*> mHead;
+    LogEntry* mTail;
+    LogEntry mStub;
+};
+} // namespace IG
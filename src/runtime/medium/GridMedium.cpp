@@ -0,0 +1,219 @@
+#include "GridMedium.h"
+#include "Logger.h"
+#include "loader/LoaderContext.h"
+#include "loader/LoaderUtils.h"
+#include "loader/Parser.h"
+#include "loader/ShadingTree.h"
+#include "serialization/FileSerializer.h"
+
+#include <fstream>
+
+namespace IG {
+struct GridSpecification {
+    Vector3i Size;
+    Vector3i MajorantSize;
+    size_t MajorantOffset;
+    BoundingBox BBox;
+};
+
+struct DensityGrid {
+    Vector3i Size;
+    BoundingBox BBox;
+    std::vector<float> Data;
+
+    [[nodiscard]] inline float at(int x, int y, int z) const
+    {
+        return Data[(size_t)x + (size_t)Size.x() * ((size_t)y + (size_t)Size.y() * (size_t)z)];
+    }
+};
+
+// Mitsuba style volume file: 'VOL' + version(3) + encoding(int32) + xres + yres + zres + channels + bbox(6xfloat) + data
+static bool load_vol_file(const Path& path, DensityGrid& grid)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        IG_LOG(L_ERROR) << "Could not open volume file " << path << std::endl;
+        return false;
+    }
+
+    char header[4];
+    stream.read(header, 4);
+    if (!stream || header[0] != 'V' || header[1] != 'O' || header[2] != 'L' || header[3] != 3) {
+        IG_LOG(L_ERROR) << "Could not load volume file " << path << ": Invalid header" << std::endl;
+        return false;
+    }
+
+    int32 encoding = 0;
+    int32 res[3]   = { 0, 0, 0 };
+    int32 channels = 0;
+    float bbox[6]  = { 0, 0, 0, 0, 0, 0 };
+    stream.read(reinterpret_cast<char*>(&encoding), sizeof(encoding));
+    stream.read(reinterpret_cast<char*>(res), sizeof(res));
+    stream.read(reinterpret_cast<char*>(&channels), sizeof(channels));
+    stream.read(reinterpret_cast<char*>(bbox), sizeof(bbox));
+
+    if (!stream || encoding != 1) {
+        IG_LOG(L_ERROR) << "Could not load volume file " << path << ": Only float32 encoding is supported" << std::endl;
+        return false;
+    }
+
+    if (res[0] <= 0 || res[1] <= 0 || res[2] <= 0 || channels <= 0) {
+        IG_LOG(L_ERROR) << "Could not load volume file " << path << ": Invalid resolution" << std::endl;
+        return false;
+    }
+
+    if (channels != 1)
+        IG_LOG(L_WARNING) << "Volume file " << path << " has " << channels << " channels. Only the first one is used as density" << std::endl;
+
+    const size_t voxels = (size_t)res[0] * (size_t)res[1] * (size_t)res[2];
+    std::vector<float> data(voxels * channels);
+    stream.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(float));
+    if (!stream) {
+        IG_LOG(L_ERROR) << "Could not load volume file " << path << ": Unexpected end of file" << std::endl;
+        return false;
+    }
+
+    grid.Size = Vector3i(res[0], res[1], res[2]);
+    grid.BBox = BoundingBox(Vector3f(bbox[0], bbox[1], bbox[2]), Vector3f(bbox[3], bbox[4], bbox[5]));
+    grid.Data.resize(voxels);
+    for (size_t i = 0; i < voxels; ++i) {
+        const float v = data[i * channels];
+        grid.Data[i]  = std::isfinite(v) ? std::max(0.0f, v) : 0.0f;
+    }
+
+    if (grid.BBox.isEmpty())
+        grid.BBox = BoundingBox(Vector3f::Zero(), Vector3f::Ones());
+
+    return true;
+}
+
+/// Compute the maximum density per majorant cell. The range is dilated by one voxel to account for trilinear interpolation
+static std::vector<float> compute_majorants(const DensityGrid& grid, const Vector3i& size)
+{
+    std::vector<float> majorants((size_t)size.x() * (size_t)size.y() * (size_t)size.z(), 0.0f);
+
+    const auto range = [&](int cell, int cells, int voxels) {
+        const float lo = (cell / (float)cells) * voxels - 0.5f;
+        const float hi = ((cell + 1) / (float)cells) * voxels - 0.5f;
+        return std::make_pair(std::clamp((int)std::floor(lo), 0, voxels - 1), std::clamp((int)std::ceil(hi), 0, voxels - 1));
+    };
+
+    for (int mz = 0; mz < size.z(); ++mz) {
+        const auto rz = range(mz, size.z(), grid.Size.z());
+        for (int my = 0; my < size.y(); ++my) {
+            const auto ry = range(my, size.y(), grid.Size.y());
+            for (int mx = 0; mx < size.x(); ++mx) {
+                const auto rx = range(mx, size.x(), grid.Size.x());
+
+                float maximum = 0;
+                for (int z = rz.first; z <= rz.second; ++z)
+                    for (int y = ry.first; y <= ry.second; ++y)
+                        for (int x = rx.first; x <= rx.second; ++x)
+                            maximum = std::max(maximum, grid.at(x, y, z));
+
+                majorants[(size_t)mx + (size_t)size.x() * ((size_t)my + (size_t)size.y() * (size_t)mz)] = maximum;
+            }
+        }
+    }
+
+    return majorants;
+}
+
+using GridExportedData = std::pair<Path, GridSpecification>;
+static GridExportedData setup_grid(const std::string& name, const std::shared_ptr<SceneObject>& medium, LoaderContext& ctx)
+{
+    auto filename = ctx.getPath(*medium, "filename");
+
+    const int majorant_res = std::max<int>(1, medium->property("majorant_resolution").getInteger(16));
+
+    // The majorant grid depends on the resolution, therefore media sharing a file can only share the data if the resolution matches
+    const std::string exported_id = "_grid_" + filename.generic_string() + "_" + std::to_string(majorant_res);
+
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
+    const auto data = ctx.Cache->ExportedData.find(exported_id);
+    if (data != ctx.Cache->ExportedData.end())
+        return std::any_cast<GridExportedData>(data->second);
+
+    const Path path = ctx.CacheManager->directory() / ("grid_" + LoaderUtils::escapeIdentifier(name) + ".bin");
+
+    GridSpecification spec{};
+    DensityGrid grid;
+    if (!load_vol_file(filename, grid)) {
+        ctx.signalError();
+        // Fallback to a single empty voxel
+        grid.Size = Vector3i::Ones();
+        grid.BBox = BoundingBox(Vector3f::Zero(), Vector3f::Ones());
+        grid.Data = { 0.0f };
+    }
+
+    spec.Size           = grid.Size;
+    spec.MajorantSize   = grid.Size.cwiseMin(Vector3i::Constant(majorant_res));
+    spec.MajorantOffset = grid.Data.size();
+    spec.BBox           = grid.BBox;
+
+    const auto majorants = compute_majorants(grid, spec.MajorantSize);
+
+    // Note: Order matters!
+    FileSerializer serializer(path, false);
+    serializer.write(grid.Data, true);
+    serializer.write(majorants, true);
+
+    const GridExportedData res           = { path, spec };
+    ctx.Cache->ExportedData[exported_id] = res;
+    return res;
+}
+
+static inline std::string inline_size(const Vector3i& size)
+{
+    std::stringstream stream;
+    stream << "(" << size.x() << ", " << size.y() << ", " << size.z() << ")";
+    return stream.str();
+}
+
+static inline std::string inline_mat34(const Eigen::Matrix<float, 3, 4>& mat)
+{
+    std::stringstream stream;
+    stream << "make_mat3x4(" << LoaderUtils::inlineVector(mat.col(0)) << ", " << LoaderUtils::inlineVector(mat.col(1))
+           << ", " << LoaderUtils::inlineVector(mat.col(2)) << ", " << LoaderUtils::inlineVector(mat.col(3)) << ")";
+    return stream.str();
+}
+
+GridMedium::GridMedium(const std::string& name, const std::shared_ptr<SceneObject>& medium)
+    : Medium(name, "grid")
+    , mMedium(medium)
+{
+    handleReferenceEntity(*medium);
+}
+
+void GridMedium::serialize(const SerializationInput& input) const
+{
+    input.Tree.beginClosure(name());
+
+    input.Tree.addColor("albedo", *mMedium, Vector3f::Ones());
+    input.Tree.addNumber("scale", *mMedium, 1.0f);
+    input.Tree.addNumber("g", *mMedium, 0.0f);
+
+    const auto data = setup_grid(name(), mMedium, input.Tree.context());
+
+    const Path buffer_path       = std::get<0>(data);
+    const GridSpecification spec = std::get<1>(data);
+
+    // Maps from world space to the normalized [0,1]^3 grid space
+    const Transformf transform = mMedium->property("transform").getTransform();
+    const Vector3f extent      = spec.BBox.diameter().cwiseMax(Vector3f::Constant(FltEps));
+    const Transformf to_grid   = Eigen::Scaling(extent.cwiseInverse()) * Eigen::Translation3f(-spec.BBox.min) * transform.inverse();
+
+    size_t res_id              = input.Tree.context().registerExternalResource(buffer_path);
+    const std::string media_id  = input.Tree.currentClosureID();
+    input.Stream << input.Tree.pullHeader()
+                 << "  let grid_" << media_id << " = make_density_grid(device.load_buffer_by_id(" << res_id << "), "
+                 << inline_size(spec.Size) << ", " << inline_size(spec.MajorantSize) << ", " << spec.MajorantOffset << ", "
+                 << inline_mat34(to_grid.matrix().block<3, 4>(0, 0)) << ");" << std::endl
+                 << "  let medium_" << media_id << " : MediumGenerator = @|ctx| { maybe_unused(ctx); make_grid_medium(grid_" << media_id
+                 << ", " << input.Tree.getInline("scale")
+                 << ", " << input.Tree.getInline("albedo")
+                 << ", make_henyeygreenstein_phase(" << input.Tree.getInline("g") << ")) };" << std::endl;
+
+    input.Tree.endClosure();
+}
+} // namespace IG
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Medium.h"
+
+namespace IG {
+/// Heterogeneous medium defined by a dense density grid with a coarse majorant grid for tracking
+class GridMedium : public Medium {
+public:
+    GridMedium(const std::string& name, const std::shared_ptr<SceneObject>& medium);
+    void serialize(const SerializationInput& input) const override;
+
+private:
+    std::shared_ptr<SceneObject> mMedium;
+};
+} // namespace IG
@@ -54,7 +54,7 @@ void ImagePattern::serialize(const SerializationInput& input) const
     const std::string tex_id = input.Tree.getClosureID(name());
 
     // Anonymize lookup by using the local registry
-    input.Tree.context().LocalRegistry.IntParameters["img_" + tex_id] = (int32)res_id;
+    input.Tree.context().localRegistry().IntParameters["img_" + tex_id] = (int32)res_id;
 
     const size_t channel_count = Image::loadResolution(filename).Channels == 1 ? 1 : 4;
 
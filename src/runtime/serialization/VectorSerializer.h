@@ -3,7 +3,7 @@
 #include "Serializer.h"
 
 namespace IG {
-class VectorSerializer : public Serializer {
+class IG_LIB VectorSerializer : public Serializer {
 public:
     VectorSerializer(std::vector<uint8>& data, bool readmode);
     virtual ~VectorSerializer() = default;
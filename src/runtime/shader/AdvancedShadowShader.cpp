@@ -18,6 +18,8 @@ std::string AdvancedShadowShader::setup(bool is_hit, size_t mat_id, LoaderContex
     std::stringstream stream;
 
     ShadingTree tree(ctx);
+    if (ctx.CurrentTechniqueVariantInfo().ShadowHandlingMode == ShadowHandlingMode::AdvancedWithMaterials)
+        ShaderUtils::applySpecializationProfile(tree, mat_id);
 
     stream << "#[export] fn ig_advanced_shadow_shader(settings: &Settings, mat_id: i32, first: i32, last: i32) -> () {" << std::endl
            << ShaderUtils::constructDevice(ctx.Options) << std::endl
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string_view>
+
+namespace IG {
+/// Messages exchanged with a compiler started via `igc --server`.
+/// A request is a line `<command> <size>` followed by size bytes of payload, sent to stdin of the server.
+/// The standard library is sent once with the library command and prepended to all scripts sent with the compile command afterwards.
+/// Each compile request is answered by a line `<status> <size>` followed by size bytes of build log on stdout.
+/// The compiled script is stored in the JIT cache, such that the runtime can load it without compiling the script again.
+/// Closing stdin stops the server.
+struct CompilerServerProtocol {
+    static constexpr std::string_view LibraryCommand = "library";
+    static constexpr std::string_view CompileCommand = "compile";
+    static constexpr std::string_view SuccessStatus  = "ok";
+    static constexpr std::string_view ErrorStatus    = "error";
+
+    /// Header line of a message with the given payload
+    static inline std::string header(const std::string_view& command, size_t size)
+    {
+        return std::string(command) + " " + std::to_string(size) + "\n";
+    }
+};
+} // namespace IG
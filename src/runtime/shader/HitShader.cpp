@@ -27,6 +27,8 @@ std::string HitShader::setup(size_t mat_id, LoaderContext& ctx)
     stream << ShaderUtils::inlineScene(ctx, false);
 
     ShadingTree tree(ctx);
+    ShaderUtils::applySpecializationProfile(tree, mat_id);
+
     const bool requireLights = ctx.CurrentTechniqueVariantInfo().UsesLights;
     if (requireLights)
         stream << ctx.Lights->generate(tree, false) << std::endl;
@@ -1,4 +1,6 @@
 #include "RayGenerationShader.h"
+#include "AdaptiveSampler.h"
+#include "BlueNoise.h"
 #include "Logger.h"
 #include "ShaderUtils.h"
 #include "loader/Loader.h"
@@ -33,6 +35,39 @@ std::string RayGenerationShader::end(const std::string_view& emitterName, bool s
     return stream.str();
 }
 
+constexpr size_t BlueNoiseSize = 64;
+
+static Path setupBlueNoise(const LoaderContext& ctx)
+{
+    std::lock_guard<std::recursive_mutex> guard(ctx.Cache->ExportMutex);
+    const std::string exported_id = "_bluenoise_";
+    const auto data               = ctx.Cache->ExportedData.find(exported_id);
+    if (data != ctx.Cache->ExportedData.end())
+        return std::any_cast<Path>(data->second);
+
+    const Path path = ctx.CacheManager->directory() / ("bluenoise_" + std::to_string(BlueNoiseSize) + ".bin");
+
+    // The mask is deterministic and only depends on its size. Void-and-cluster is expensive, therefore reuse masks from previous runs
+    std::error_code ec;
+    const uintmax_t expectedSize = BlueNoiseSize * BlueNoiseSize * 2 * sizeof(float);
+    if (std::filesystem::file_size(path, ec) == expectedSize && !ec) {
+        IG_LOG(L_DEBUG) << "Using cached blue-noise mask " << path << std::endl;
+    } else {
+        IG_LOG(L_DEBUG) << "Generating blue-noise mask" << std::endl;
+
+        // Write to a temporary file first, such that other processes never see a partial mask
+        Path tmp_path = path;
+        tmp_path += ".tmp";
+        BlueNoise::computeMask(BlueNoiseSize, tmp_path);
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec)
+            IG_LOG(L_ERROR) << "Could not write blue-noise mask " << path << ": " << ec.message() << std::endl;
+    }
+
+    ctx.Cache->ExportedData[exported_id] = path;
+    return path;
+}
+
 std::string RayGenerationShader::generatePixelSampler(const LoaderContext& ctx, const std::string_view& varName)
 {
     std::stringstream stream;
@@ -42,6 +77,14 @@ std::string RayGenerationShader::generatePixelSampler(const LoaderContext& ctx,
                << "  let " << varName << " = make_halton_pixel_sampler(halton_setup);" << std::endl;
     } else if (ctx.Options.PixelSamplerType == "mjitt") {
         stream << "  let " << varName << " = make_mjitt_pixel_sampler(4, 4);" << std::endl;
+    } else if (ctx.Options.PixelSamplerType == "sobol") {
+        stream << "  let " << varName << " = make_sobol_pixel_sampler(settings.seed);" << std::endl;
+    } else if (ctx.Options.PixelSamplerType == "zsobol") {
+        stream << "  let " << varName << " = make_zsobol_pixel_sampler(settings.width, settings.height, settings.seed);" << std::endl;
+    } else if (ctx.Options.PixelSamplerType == "bluenoise") {
+        const Path path = setupBlueNoise(ctx);
+        stream << "  let blue_noise = device.load_buffer(\"" << path.generic_string() << "\");" << std::endl
+               << "  let " << varName << " = make_bluenoise_pixel_sampler(blue_noise, " << BlueNoiseSize << ", settings.seed);" << std::endl;
     } else {
         stream << "  let " << varName << " = make_uniform_pixel_sampler();" << std::endl;
     }
@@ -49,6 +92,17 @@ std::string RayGenerationShader::generatePixelSampler(const LoaderContext& ctx,
     return stream.str();
 }
 
+std::string RayGenerationShader::generateAdaptiveEmitter(const LoaderContext& ctx, const std::string_view& varName)
+{
+    IG_UNUSED(ctx);
+
+    std::stringstream stream;
+    stream << "  let adaptive_mask = device.request_buffer(\"" << AdaptiveSampler::MaskBufferName << "\", settings.width * settings.height, 0);" << std::endl
+           << "  let " << varName << " = make_adaptive_emitter(" << varName << ", adaptive_mask);" << std::endl;
+
+    return stream.str();
+}
+
 std::string RayGenerationShader::setup(LoaderContext& ctx)
 {
     std::stringstream stream;
@@ -62,6 +116,9 @@ std::string RayGenerationShader::setup(LoaderContext& ctx)
         stream << ctx.Camera->generate(ctx) << std::endl // Will set `camera`
                << generatePixelSampler(ctx) << std::endl // Will set `pixel_sampler`
                << "  let emitter = make_camera_emitter(camera, render_config, pixel_sampler, init_raypayload);" << std::endl;
+
+        if (ctx.Options.AdaptiveSampling.Enabled)
+            stream << generateAdaptiveEmitter(ctx, "emitter") << std::endl; // Will shadow `emitter`
     }
 
     stream << end();
@@ -12,6 +12,9 @@ struct RayGenerationShader {
     /// Will generate the default pixel sampler. Expected to be called between begin & end
     static std::string generatePixelSampler(const LoaderContext& ctx, const std::string_view& varName = "pixel_sampler");
 
+    /// Will wrap the given emitter such that pixels marked as converged by the adaptive sampler are skipped. Expected to be called between begin & end
+    static std::string generateAdaptiveEmitter(const LoaderContext& ctx, const std::string_view& varName = "emitter");
+
     /// Will generate the default complete shader. Will call begin & end internally
     static std::string setup(LoaderContext& ctx);
 };
@@ -3,12 +3,16 @@
 #include "RuntimeInfo.h"
 #include "device/ICompilerDevice.h"
 #include <fstream>
+#include <mutex>
 
 // Will be populated by api_collector
 extern const char* ig_api[];
 extern const char* ig_api_paths[];
 
 namespace IG {
+// AnyDSL has no support for multi-threaded compile process, not even with separate compiler devices
+static std::mutex sCompileMutex;
+
 ScriptCompiler::ScriptCompiler(const std::shared_ptr<ICompilerDevice>& compiler)
     : mCompiler(compiler)
     , mStdLibOverride()
@@ -23,8 +27,7 @@ ScriptCompiler::~ScriptCompiler()
 
 void* ScriptCompiler::compile(const std::string& script, const std::string& function) const
 {
-    // AnyDSL has no support for multi-threaded compile process :/
-    std::lock_guard<std::mutex> _guard(mCompileMutex);
+    std::lock_guard<std::mutex> _guard(sCompileMutex);
 
     return mCompiler->compileAndGet(
         ICompilerDevice::Settings{
@@ -33,18 +36,22 @@ void* ScriptCompiler::compile(const std::string& script, const std::string& func
         script, function);
 }
 
-std::string ScriptCompiler::prepare(const std::string& script) const
+std::string ScriptCompiler::library() const
 {
+    if (!mStdLibOverride.empty())
+        return mStdLibOverride;
+
     std::stringstream source;
+    for (int i = 0; ig_api[i]; ++i)
+        source << ig_api[i];
 
-    if (mStdLibOverride.empty()) {
-        for (int i = 0; ig_api[i]; ++i)
-            source << ig_api[i];
-    } else {
-        source << mStdLibOverride;
-    }
+    return source.str();
+}
 
-    source << std::endl;
+std::string ScriptCompiler::prepare(const std::string& script) const
+{
+    std::stringstream source;
+    source << library() << std::endl;
     source << script;
 
     return source.str();
@@ -18,6 +18,8 @@ public:
     inline void setVerbose(bool verbose) { mVerbose = verbose; }
     inline bool isVerbose() const { return mVerbose; }
 
+    /// Standard library prepended to all scripts by prepare
+    std::string library() const;
     std::string prepare(const std::string& script) const;
     void* compile(const std::string& script, const std::string& function) const;
     void loadStdLibFromDirectory(const Path& dir);
@@ -28,7 +30,5 @@ private:
     std::string mStdLibOverride;
     size_t mOptimizationLevel;
     bool mVerbose;
-
-    mutable std::mutex mCompileMutex;
 };
 } // namespace IG
\ No newline at end of file
@@ -5,9 +5,37 @@
 #include "ShaderTaskManager.h"
 
 namespace IG {
-bool ShaderManager::compile(ScriptCompiler* compiler, size_t threads, ShaderDumpVerbosity verbosity)
+ShaderManager::ShaderManager(ScriptCompiler* compiler, size_t threads, ShaderDumpVerbosity verbosity)
+    : mManager(std::make_unique<ShaderTaskManager>(compiler, threads, verbosity))
+    , mThreadCount(threads)
 {
-    ShaderTaskManager manager(compiler, threads, verbosity);
+}
+
+ShaderManager::~ShaderManager()
+{
+}
+
+bool ShaderManager::markSubmitted(const std::string& group_id)
+{
+    std::lock_guard<std::mutex> guard(mSubmitMutex);
+    return mSubmitted.insert(group_id).second;
+}
+
+void ShaderManager::submit(const std::string& name, const std::string& script, const std::string& function)
+{
+    if (mThreadCount == 1)
+        return;
+
+    const std::string group_id = ShaderReducer().getGroupID(script, function);
+    if (markSubmitted(group_id)) {
+        IG_LOG(L_DEBUG) << "Submitting '" << name << "' for early compilation" << std::endl;
+        mManager->add(group_id, name, script, function);
+    }
+}
+
+bool ShaderManager::compile()
+{
+    auto& manager = *mManager;
     ShaderReducer reducer;
 
     // Reduce the number of shaders
@@ -25,7 +53,8 @@ bool ShaderManager::compile(ScriptCompiler* compiler, size_t threads, ShaderDump
     for (auto it = groups.begin(); it != groups.end();) {
         const auto key             = it->first;
         const std::string group_id = reducer.getGroupID(std::get<0>(key), std::get<1>(key));
-        manager.add(group_id, it->second, std::get<0>(key), std::get<1>(key));
+        if (markSubmitted(group_id)) // Might be submitted already while generating the shaders
+            manager.add(group_id, it->second, std::get<0>(key), std::get<1>(key));
 
         // Skip other elements with the same key
         while (++it != groups.end() && it->first == key)
@@ -35,11 +64,11 @@ bool ShaderManager::compile(ScriptCompiler* compiler, size_t threads, ShaderDump
     manager.finalize();
 
     if (!IG_LOGGER.isQuiet() && IG_LOGGER.verbosity() == L_INFO /* Do not use the progressbar with debug or above info outputs as it might clutter the console */) {
-        ShaderProgressBar pb(IG_LOGGER.isUsingAnsiTerminal(), 2, numberOfUniqueEntries);
+        ShaderProgressBar pb(IG_LOGGER.isUsingAnsiTerminal(), 2, mSubmitted.size());
         pb.begin();
         while (!manager.isFinished()) {
             pb.update(manager.numFinishedTasks());
-            std::this_thread::yield();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
         pb.end();
     }
@@ -3,9 +3,12 @@
 #include "technique/TechniqueVariant.h"
 #include "ShaderDumpVerbosity.h"
 
+#include <mutex>
+#include <unordered_set>
+
 namespace IG {
 class ScriptCompiler;
-
+class ShaderTaskManager;
 
 class ShaderManager {
 public:
@@ -15,15 +18,30 @@ public:
         ShaderOutput<void*>* Compiled;
     };
 
+    ShaderManager(ScriptCompiler* compiler, size_t threads, ShaderDumpVerbosity verbosity = ShaderDumpVerbosity::None);
+    ~ShaderManager();
+
     inline void add(const std::string& id, const ShaderEntry& entry)
     {
         mEntries[id] = entry;
     }
 
-    [[nodiscard]] bool compile(ScriptCompiler* compiler, size_t threads, ShaderDumpVerbosity verbosity = ShaderDumpVerbosity::None);
+    /// Start compiling the given script before it is registered via add(). Can be called from multiple threads.
+    /// Only has an effect if multiple threads are used for compiling, as the internal compiler would block the caller
+    void submit(const std::string& name, const std::string& script, const std::string& function);
+
+    [[nodiscard]] bool compile();
 
 private:
+    /// Returns true if the group was not submitted before
+    bool markSubmitted(const std::string& group_id);
+
+    std::unique_ptr<ShaderTaskManager> mManager;
+    const size_t mThreadCount;
     std::unordered_map<std::string, ShaderEntry> mEntries;
+
+    std::mutex mSubmitMutex;
+    std::unordered_set<std::string> mSubmitted; // Group ids already handed to the task manager
 };
 
-} // namespace IG
\ No newline at end of file
+} // namespace IG
@@ -1,8 +1,10 @@
 #include "ShaderTaskManager.h"
+#include "CompilerServerProtocol.h"
 #include "ExternalProcess.h"
 #include "Logger.h"
 #include "RuntimeInfo.h"
 #include "StringUtils.h"
+#include "Timeline.h"
 
 #include <fstream>
 
@@ -20,12 +22,15 @@ static inline void dumpShader(const Path& filename, const std::string& shader)
     }
 }
 
+static std::atomic<size_t> sManagerCounter = 0;
+
 class ShaderTaskManagerInternal {
 public:
     struct Work {
         std::string ID;
         std::string Name;
-        std::string Script;
+        std::string Script; // Including the standard library
+        std::string Shader; // Without the standard library, which is only sent once to each compiler server
         std::string Function;
 
         inline std::string reasonableID() const { return Name + "_" + ID; }
@@ -36,33 +41,41 @@ public:
         void* Ptr;
     };
 
-    struct RunningProcess {
-        ExternalProcess* Proc;
-        std::chrono::time_point<std::chrono::steady_clock> Start;
-        ShaderTaskManagerInternal::Work Work;
+    /// Long-lived compiler process, which compiles the work of a single worker one after another
+    struct CompilerServer {
+        std::unique_ptr<ExternalProcess> Proc;
+        size_t Slot = 0; // Used to group the compilations into tracks of the timeline
     };
 
     ScriptCompiler* mInternalCompiler;
     const size_t mThreadCount;
+    const size_t mManagerID; // Unique within the process
 
-    tbb::concurrent_queue<Work> mWorkQueue;
+    tbb::concurrent_bounded_queue<Work> mWorkQueue; // Work with an empty id stops a worker
     std::unordered_map<std::string, Result> mResultMap;
     std::mutex mWorkMutex;
-    std::thread mWorkThread;
+    std::vector<std::thread> mWorkThreads;
     std::atomic<bool> mThreadRunning;
     std::atomic<bool> mThreadRequestFinish;
+    std::atomic<bool> mThreadRequestAbort;
+    std::atomic<size_t> mRunningWorkers;
 
     Path igcPath;
     std::vector<std::string> igcParameters;
+    std::string mLibrary;
 
     ShaderTaskManagerInternal(ScriptCompiler* compiler, size_t threads)
         : mInternalCompiler(compiler)
         , mThreadCount(threads)
+        , mManagerID(sManagerCounter.fetch_add(1))
         , mThreadRunning(false)
         , mThreadRequestFinish(false)
+        , mThreadRequestAbort(false)
+        , mRunningWorkers(0)
     {
         igcPath = RuntimeInfo::igcPath();
 
+        igcParameters.push_back("--server");
         igcParameters.push_back("--no-color");
         igcParameters.push_back("--no-logo");
 
@@ -75,136 +88,193 @@ public:
 
         igcParameters.push_back("-O");
         igcParameters.push_back(std::to_string(mInternalCompiler->optimizationLevel()));
+
+        if (threads > 1)
+            mLibrary = mInternalCompiler->library();
     }
 
-    void run()
+    void run(size_t slot)
     {
-        std::vector<RunningProcess> processes(mThreadCount);
-
-        while (mThreadRunning) {
-            // Check all processes
-            for (auto& p : processes) {
-                if (!p.Proc || !p.Proc->isRunning()) {
-                    handleExit(p);
-
-                    // Check if there is work todo
-                    if (mWorkQueue.try_pop(p.Work)) {
-                        startProcess(p);
-                        break; // Start the parent loop anew
-                    }
-                }
-            }
-
-            if (mWorkQueue.empty() && mThreadRequestFinish)
+        CompilerServer server;
+        server.Slot = slot;
+
+        // Block until work arrives instead of polling, the compilation itself is done by the server process
+        Work work;
+        while (true) {
+            mWorkQueue.pop(work);
+            if (work.ID.empty() || mThreadRequestAbort)
                 break;
 
-            std::this_thread::yield();
+            compile(server, work);
         }
 
-        // Get all the process states
-        for (auto& p : processes)
-            handleExit(p);
+        stopServer(server);
 
-        mThreadRunning = false;
+        if (--mRunningWorkers == 0)
+            mThreadRunning = false;
     }
 
     void start()
     {
-        if (!mThreadRunning.exchange(true))
-            mWorkThread = std::move(std::thread([this]() { this->run(); }));
+        if (mThreadRunning.exchange(true))
+            return;
+
+        mRunningWorkers = mThreadCount;
+        for (size_t i = 0; i < mThreadCount; ++i)
+            mWorkThreads.emplace_back([this, i]() { this->run(i); });
     }
 
     void stop()
     {
-        mThreadRunning = false;
-        mWorkThread.join();
+        // Queued work is skipped by the workers
+        mThreadRequestAbort = true;
+        finalize();
+        join();
     }
 
     void finalize()
     {
-        mThreadRequestFinish = true;
+        if (mThreadRequestFinish.exchange(true))
+            return;
+
+        // Workers stop after all work queued before is done
+        for (size_t i = 0; i < mThreadCount; ++i)
+            mWorkQueue.push(Work{});
     }
 
     void stopWhenFinished()
     {
         finalize();
-        mWorkThread.join();
+        join();
     }
 
-private:
-    void startProcess(RunningProcess& proc)
+    void join()
     {
-        if (proc.Proc)
-            delete proc.Proc;
-
-        IG_LOG(L_DEBUG) << "Starting compilation of '" << proc.Work.Name << "' for group '" << proc.Work.ID << "'" << std::endl;
+        for (auto& thread : mWorkThreads) {
+            if (thread.joinable())
+                thread.join();
+        }
+        mWorkThreads.clear();
+    }
 
-        const Path logFile = std::filesystem::temp_directory_path() / "Ignis" / (whitespace_escaped(proc.Work.reasonableID()) + ".log");
+private:
+    bool startServer(CompilerServer& server)
+    {
+        IG_LOG(L_DEBUG) << "Starting compiler server " << server.Slot << std::endl;
 
-        proc.Start = std::chrono::steady_clock::now();
-        proc.Proc  = new ExternalProcess(proc.Work.Name + "_" + proc.Work.ID, igcPath, igcParameters, logFile);
+        // Multiple runtimes and processes might compile at the same time, therefore the log has to be unique for this manager
+        const std::string name = "compiler_" + std::to_string(RuntimeInfo::processID()) + "_" + std::to_string(mManagerID) + "_" + std::to_string(server.Slot);
+        const Path logFile     = std::filesystem::temp_directory_path() / "Ignis" / (name + ".log");
 
-        if (!proc.Proc->start()) {
+        server.Proc = std::make_unique<ExternalProcess>(name, igcPath, igcParameters, logFile, true);
+        if (!server.Proc->start()) {
             IG_LOG(L_ERROR) << "Compilation failed with compiler due to a startup error" << std::endl;
-            delete proc.Proc;
-            proc.Proc = nullptr;
-            return;
+            server.Proc.reset();
+            return false;
         }
 
-        proc.Proc->waitForInit();
+        server.Proc->waitForInit();
 
-        if (!proc.Proc->isRunning()) {
-            IG_LOG(L_ERROR) << "Compilation failed with compiler early terminating with " << proc.Proc->exitCode() << std::endl;
-            IG_LOG(L_DEBUG) << proc.Proc->receiveOnce();
-            delete proc.Proc;
-            proc.Proc = nullptr;
-            return;
+        if (!server.Proc->isRunning()) {
+            IG_LOG(L_ERROR) << "Compilation failed with compiler early terminating with " << server.Proc->exitCode() << std::endl;
+            IG_LOG(L_DEBUG) << server.Proc->receiveOnce();
+            server.Proc.reset();
+            return false;
         }
 
-        if (!proc.Proc->sendOnce(proc.Work.Script)) {
+        // The standard library is the same for all scripts, therefore it is only transferred once
+        if (!server.Proc->send(CompilerServerProtocol::header(CompilerServerProtocol::LibraryCommand, mLibrary.size()) + mLibrary)) {
             IG_LOG(L_ERROR) << "Compilation failed due to failing to establish communication with compiler" << std::endl;
-            IG_LOG(L_DEBUG) << proc.Proc->receiveOnce();
-            delete proc.Proc;
-            proc.Proc = nullptr;
-            return;
+            IG_LOG(L_DEBUG) << server.Proc->receiveOnce();
+            server.Proc.reset();
+            return false;
         }
+
+        return true;
     }
 
-    void handleExit(RunningProcess& proc)
+    void stopServer(CompilerServer& server)
     {
-        if (proc.Work.ID.empty() || !proc.Proc)
+        if (!server.Proc)
             return;
 
-        proc.Proc->waitForFinish();
-        const std::string log = proc.Proc->receiveOnce();
-        const int exitCode    = proc.Proc->exitCode();
+        server.Proc->closeInput();
+        server.Proc->waitForFinish();
+        server.Proc.reset();
+    }
+
+    /// Send the work to the server and wait for the status. Returns false if the communication failed
+    bool request(CompilerServer& server, const Work& work, bool& success, std::string& log)
+    {
+        if (!server.Proc->send(CompilerServerProtocol::header(CompilerServerProtocol::CompileCommand, work.Shader.size()) + work.Shader))
+            return false;
+
+        std::string status;
+        if (!server.Proc->receiveLine(status))
+            return false;
+
+        const auto sep = status.find(' ');
+        if (sep == std::string::npos)
+            return false;
+
+        size_t size = 0;
+        try {
+            size = std::stoull(status.substr(sep + 1));
+        } catch (...) {
+            return false;
+        }
+
+        success = std::string_view(status).substr(0, sep) == CompilerServerProtocol::SuccessStatus;
+        return server.Proc->receive(size, log);
+    }
+
+    void compile(CompilerServer& server, const Work& work)
+    {
+        IG_LOG(L_DEBUG) << "Starting compilation of '" << work.Name << "' for group '" << work.ID << "'" << std::endl;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        bool success = false;
+        std::string log;
+        int exitCode = EXIT_SUCCESS;
+        if (server.Proc || startServer(server)) {
+            if (!request(server, work, success, log)) {
+                // The server terminated unexpectedly, most likely due to this script. A new server is started for the next work
+                server.Proc->waitForFinish();
+                exitCode = server.Proc->exitCode();
+                log      = server.Proc->receiveOnce();
+                success  = false;
+                server.Proc.reset();
+            }
+        }
+
+        const auto end = std::chrono::steady_clock::now();
+        const auto dur = end - start;
 
-        const auto dur = std::chrono::steady_clock::now() - proc.Start;
+        if (Timeline::instance().isEnabled())
+            Timeline::instance().complete("compile", work.Name + " (" + work.ID + ")", start, end, "Compiler " + std::to_string(server.Slot));
 
         void* ptr = nullptr;
-        if (exitCode == EXIT_SUCCESS) {
-            IG_LOG(L_DEBUG) << "Finished compilation of '" << proc.Work.Name << "' for group '" << proc.Work.ID << "' (" << dur << ")" << std::endl;
+        if (success) {
+            IG_LOG(L_DEBUG) << "Finished compilation of '" << work.Name << "' for group '" << work.ID << "' (" << dur << ")" << std::endl;
 
-            // All good -> recompile to get data from cache!
-            ptr = mInternalCompiler->compile(proc.Work.Script, proc.Work.Function);
+            // All good -> The server stored the result in the cache, which is loaded without compiling again
+            ptr = mInternalCompiler->compile(work.Script, work.Function);
         }
 
         mWorkMutex.lock();
-        mResultMap[proc.Work.ID] = Result{
+        mResultMap[work.ID] = Result{
             .Log = log,
             .Ptr = ptr
         };
         mWorkMutex.unlock();
 
-        delete proc.Proc;
-        proc.Proc = nullptr;
-
-        if (exitCode != EXIT_SUCCESS) {
+        if (!success) {
             // Dump shader into tmp folder
-            const Path tmpFile = std::filesystem::temp_directory_path() / "Ignis" / (whitespace_escaped(proc.Work.reasonableID()) + ".art");
-            dumpShader(tmpFile, proc.Work.Script);
+            const Path tmpFile = std::filesystem::temp_directory_path() / "Ignis" / (whitespace_escaped(work.reasonableID()) + ".art");
+            dumpShader(tmpFile, work.Script);
 
-            IG_LOG(L_ERROR) << "Finished compilation of '" << proc.Work.Name << "' for group '" << proc.Work.ID << "' with exit code " << exitCode << " (" << dur << ")." << std::endl
+            IG_LOG(L_ERROR) << "Finished compilation of '" << work.Name << "' for group '" << work.ID << "' with exit code " << exitCode << " (" << dur << ")." << std::endl
                             << "Dump of shader is available at " << tmpFile << std::endl;
         }
     }
@@ -220,6 +290,9 @@ ShaderTaskManager::ShaderTaskManager(ScriptCompiler* compiler, size_t threads, S
 
 ShaderTaskManager::~ShaderTaskManager()
 {
+    // Tasks might have been added without waiting for them, e.g., if loading failed while shaders were compiled already
+    if (!mInternal->mWorkThreads.empty())
+        mInternal->stop();
 }
 
 void ShaderTaskManager::add(const std::string& id, const std::string& name, const std::string& script, const std::string& function)
@@ -235,6 +308,7 @@ void ShaderTaskManager::add(const std::string& id, const std::string& name, cons
     if (mThreadCount == 1) {
         // Fallback internal compilation
         IG_LOG(L_DEBUG) << "Compiling '" << name << "' for group '" << id << "'" << std::endl;
+        IG_TIMELINE_SCOPE("compile", name + " (" + id + ")");
         void* ptr                 = mInternal->mInternalCompiler->compile(full_script, function);
         mInternal->mResultMap[id] = ShaderTaskManagerInternal::Result{
             .Log = {}, // TODO
@@ -245,6 +319,7 @@ void ShaderTaskManager::add(const std::string& id, const std::string& name, cons
             .ID       = id,
             .Name     = name,
             .Script   = full_script,
+            .Shader   = script,
             .Function = function });
 
         // Start threads
@@ -281,9 +356,9 @@ bool ShaderTaskManager::waitForFinish()
     if (mThreadCount != 1 && mInternal->mThreadRunning)
         mInternal->stopWhenFinished();
 
-    // Join dangling thread
-    if (mThreadCount != 1 && mInternal->mWorkThread.joinable())
-        mInternal->mWorkThread.join();
+    // Join dangling threads
+    if (mThreadCount != 1)
+        mInternal->join();
 
     return !hasError();
 }
@@ -12,6 +12,7 @@ public:
     ShaderTaskManager(ScriptCompiler* compiler, size_t threads, ShaderDumpVerbosity dumpLevel = ShaderDumpVerbosity::None);
     ~ShaderTaskManager();
 
+    /// Can be called from multiple threads, except if only a single thread is used, as the script is compiled by the caller
     void add(const std::string& id, const std::string& name, const std::string& script, const std::string& function);
     /// After this no tasks are expected to arrive
     void finalize(); 
@@ -1,4 +1,5 @@
 #include "ShaderUtils.h"
+#include "SpecializationProfile.h"
 #include "loader/LoaderBSDF.h"
 #include "loader/LoaderEntity.h"
 #include "loader/LoaderLight.h"
@@ -126,7 +127,7 @@ std::string ShaderUtils::generateMaterialShader(ShadingTree& tree, size_t mat_id
     if (isLight && requireLights) {
         const size_t light_id = tree.context().Lights->getAreaLightID(material.Entity);
 
-        tree.context().LocalRegistry.IntParameters["_light_id"] = (int)light_id;
+        tree.context().localRegistry().IntParameters["_light_id"] = (int)light_id;
 
         stream << "  let light_id = registry::get_local_parameter_i32(\"_light_id\", 0);" << std::endl
                << "  let " << output_var << " : MaterialShader = @|ctx| make_emissive_material(mat_id, bsdf_" << bsdf_id << "(ctx), medium_interface,"
@@ -140,6 +141,20 @@ std::string ShaderUtils::generateMaterialShader(ShadingTree& tree, size_t mat_id
     return stream.str();
 }
 
+void ShaderUtils::applySpecializationProfile(ShadingTree& tree, size_t mat_id)
+{
+    const auto& ctx = tree.context();
+    if (ctx.Options.Specialization != RuntimeOptions::SpecializationMode::Profile || !ctx.Options.Profile)
+        return;
+
+    // Cold materials share the same shader code if nothing is embedded, which reduces the number of shaders to compile
+    const Material& material = ctx.Materials.at(mat_id);
+    if (ctx.Options.Profile->isHotMaterial(material.name()))
+        tree.setSpecialization(RuntimeOptions::SpecializationMode::Force);
+    else
+        tree.setSpecialization(RuntimeOptions::SpecializationMode::Disable);
+}
+
 std::string ShaderUtils::beginCallback(const LoaderContext& ctx)
 {
     std::stringstream stream;
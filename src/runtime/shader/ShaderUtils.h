@@ -13,6 +13,8 @@ public:
     static std::string generateShapeLookup(const LoaderContext& ctx);
     static std::string generateShapeLookup(const std::string& varname, ShapeProvider* provider, const LoaderContext& ctx);
     static std::string generateMaterialShader(ShadingTree& tree, size_t mat_id, bool requireLights, const std::string_view& output_var);
+    /// Specialize the tree if the material is hot in the recorded profile, else keep it generic. Has no effect without a profile
+    static void applySpecializationProfile(ShadingTree& tree, size_t mat_id);
 
     /// Will generate technique predefinition, function specification and device
     static std::string beginCallback(const LoaderContext& ctx);
@@ -78,12 +78,12 @@ TechniqueInfo AdaptiveEnvPathTechnique::getInfo(const LoaderContext&) const
 
 void AdaptiveEnvPathTechnique::generateBody(const SerializationInput& input) const
 {
-    const bool is_learning_pass = input.Context.CurrentTechniqueVariant == 0;
+    const bool is_learning_pass = input.Context.currentTechniqueVariant() == 0;
 
     // Insert config into global registry
-    input.Context.GlobalRegistry.IntParameters["__tech_max_depth"] = (int)mMaxDepth;
-    input.Context.GlobalRegistry.IntParameters["__tech_min_depth"] = (int)mMinDepth;
-    input.Context.GlobalRegistry.FloatParameters["__tech_clamp"]   = mClamp;
+    input.Context.globalRegistry().IntParameters["__tech_max_depth"] = (int)mMaxDepth;
+    input.Context.globalRegistry().IntParameters["__tech_min_depth"] = (int)mMinDepth;
+    input.Context.globalRegistry().FloatParameters["__tech_clamp"]   = mClamp;
 
     // Load registry information
     if (mMaxDepth < 2 && input.Context.Options.Specialization != RuntimeOptions::SpecializationMode::Disable) // 0 & 1 can be an optimization
@@ -54,9 +54,9 @@ TechniqueInfo LightTracerTechnique::getInfo(const LoaderContext&) const
 void LightTracerTechnique::generateBody(const SerializationInput& input) const
 {
     // Insert config into global registry
-    input.Context.GlobalRegistry.IntParameters["__tech_max_depth"] = (int)mMaxLightDepth;
-    input.Context.GlobalRegistry.IntParameters["__tech_min_depth"] = (int)mMinLightDepth;
-    input.Context.GlobalRegistry.FloatParameters["__tech_clamp"]   = mClamp;
+    input.Context.globalRegistry().IntParameters["__tech_max_depth"] = (int)mMaxLightDepth;
+    input.Context.globalRegistry().IntParameters["__tech_min_depth"] = (int)mMinLightDepth;
+    input.Context.globalRegistry().FloatParameters["__tech_clamp"]   = mClamp;
 
     if (mMaxLightDepth < 2 && input.Context.Options.Specialization != RuntimeOptions::SpecializationMode::Disable) // 0 & 1 can be an optimization
         input.Stream << "  let tech_max_depth = " << mMaxLightDepth << ":i32;" << std::endl;
@@ -27,8 +27,8 @@ TechniqueInfo LightVisibilityTechnique::getInfo(const LoaderContext&) const
 void LightVisibilityTechnique::generateBody(const SerializationInput& input) const
 {
     // Insert config into global registry
-    input.Context.GlobalRegistry.IntParameters["__tech_max_depth"]       = (int)mMaxDepth;
-    input.Context.GlobalRegistry.FloatParameters["__tech_no_connection"] = mNoConnectionFactor;
+    input.Context.globalRegistry().IntParameters["__tech_max_depth"]       = (int)mMaxDepth;
+    input.Context.globalRegistry().FloatParameters["__tech_no_connection"] = mNoConnectionFactor;
 
     if (mMaxDepth < 2 && input.Context.Options.Specialization != RuntimeOptions::SpecializationMode::Disable) // 0 & 1 can be an optimization
         input.Stream << "  let tech_max_depth = " << mMaxDepth << ":i32;" << std::endl;
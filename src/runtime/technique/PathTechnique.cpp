@@ -3,6 +3,7 @@
 #include "loader/LoaderLight.h"
 #include "loader/Parser.h"
 #include "loader/ShadingTree.h"
+#include "shader/ShaderUtils.h"
 
 namespace IG {
 PathTechnique::PathTechnique(SceneObject& obj)
@@ -14,9 +15,40 @@ PathTechnique::PathTechnique(SceneObject& obj)
     mClamp         = obj.property("clamp").getNumber(0.0f);
     mEnableNEE     = obj.property("nee").getBool(true);
     mMISAOVs       = obj.property("aov_mis").getBool(false);
+
+    mEnableGuiding                      = obj.property("guiding").getBool(false);
+    mGuidingBSDFFraction                = std::clamp(obj.property("guiding_bsdf_fraction").getNumber(0.5f), 0.0f, 1.0f);
+    mGuidingSettings.TrainingIterations = (uint32)obj.property("guiding_training_iterations").getInteger(mGuidingSettings.TrainingIterations);
+    mGuidingSettings.TrainingPaths      = (uint32)std::max(1, obj.property("guiding_training_paths").getInteger(mGuidingSettings.TrainingPaths));
+    mGuidingSettings.MaxDepth           = (uint32)std::max(1, obj.property("guiding_max_depth").getInteger(mGuidingSettings.MaxDepth));
+
+    mEnableReSTIR     = obj.property("restir").getBool(false);
+    mReSTIRCandidates = (size_t)std::max(1, obj.property("restir_candidates").getInteger(8));
+    mReSTIRTemporal   = obj.property("restir_temporal").getBool(true);
+    mReSTIRSpatial    = (size_t)std::max(0, obj.property("restir_spatial").getInteger(2));
+    mReSTIRUnbiased   = obj.property("restir_unbiased").getBool(false);
+
+    mEnableEARS   = obj.property("ears").getBool(false);
+    mEARSMaxSplit = (size_t)std::max(1, obj.property("ears_max_split").getInteger(4));
+}
+
+static std::string ears_before_iteration_generator(LoaderContext& ctx)
+{
+    std::stringstream stream;
+
+    stream << ShaderUtils::beginCallback(ctx) << std::endl
+           << "  ears_handle_before_iteration(device, settings.width, settings.height, settings.iter);" << std::endl
+           << ShaderUtils::endCallback() << std::endl;
+
+    return stream.str();
+}
+
+bool PathTechnique::isGuidingEnabled(const LoaderContext& ctx) const
+{
+    return mEnableGuiding && !ctx.Options.IsTracer;
 }
 
-TechniqueInfo PathTechnique::getInfo(const LoaderContext&) const
+TechniqueInfo PathTechnique::getInfo(const LoaderContext& ctx) const
 {
     TechniqueInfo info;
 
@@ -29,15 +61,38 @@ TechniqueInfo PathTechnique::getInfo(const LoaderContext&) const
     info.Variants[0].UsesLights                = true;
     info.Variants[0].PrimaryPayloadCount       = 6;
     info.Variants[0].EmitterPayloadInitializer = "make_simple_payload_initializer(init_pt_raypayload)";
+
+    if (isGuidingEnabled(ctx)) {
+        // The training slot is stored in the primary payload, the vertex receiving the light in the secondary payload
+        info.Variants[0].PrimaryPayloadCount       = 7;
+        info.Variants[0].SecondaryPayloadCount     = 1;
+        info.Variants[0].ShadowHandlingMode        = ShadowHandlingMode::Advanced;
+        info.Variants[0].EmitterPayloadInitializer = "make_pt_guiding_payload_initializer(make_path_guiding(device), settings.spi, settings.width * settings.height * settings.spi)";
+        info.PathGuiding                           = mGuidingSettings;
+    }
+
+    // Reservoirs are stored per pixel, therefore only a single sample per pixel is allowed in each iteration
+    if (mEnableNEE && mEnableReSTIR && (mReSTIRTemporal || mReSTIRSpatial > 0))
+        info.Variants[0].OverrideSPI = 1;
+
+    // The image estimate is updated before each iteration
+    if (mEnableEARS)
+        info.Variants[0].CallbackGenerators[(int)CallbackType::BeforeIteration] = ears_before_iteration_generator;
+
     return info;
 }
 
 void PathTechnique::generateBody(const SerializationInput& input) const
 {
     // Insert config into global registry
-    input.Context.GlobalRegistry.IntParameters["__tech_max_depth"] = (int)mMaxDepth;
-    input.Context.GlobalRegistry.IntParameters["__tech_min_depth"] = (int)mMinDepth;
-    input.Context.GlobalRegistry.FloatParameters["__tech_clamp"]   = mClamp;
+    input.Context.globalRegistry().IntParameters["__tech_max_depth"] = (int)mMaxDepth;
+    input.Context.globalRegistry().IntParameters["__tech_min_depth"] = (int)mMinDepth;
+    input.Context.globalRegistry().FloatParameters["__tech_clamp"]   = mClamp;
+
+    const bool restir  = mEnableNEE && mEnableReSTIR;
+    const bool guiding = isGuidingEnabled(input.Context);
+    if (restir)
+        input.Context.globalRegistry().IntParameters["__tech_restir_candidates"] = (int)mReSTIRCandidates;
 
     if (mMaxDepth < 2 && input.Context.Options.Specialization != RuntimeOptions::SpecializationMode::Disable) // 0 & 1 can be an optimization // TODO: Unlikely an optimization. Maybe get rid of it
         input.Stream << "  let tech_max_depth = " << mMaxDepth << ":i32;" << std::endl;
@@ -72,10 +127,31 @@ void PathTechnique::generateBody(const SerializationInput& input) const
                  << "    }" << std::endl
                  << "  };" << std::endl;
 
+    if (guiding)
+        input.Stream << "  let guiding = make_path_guiding(device);" << std::endl;
+    else
+        input.Stream << "  let guiding = make_null_path_guiding();" << std::endl;
+
+    if (restir)
+        input.Stream << "  let restir = make_restir(device, settings.width, settings.height, settings.iter, registry::get_global_parameter_i32(\"__tech_restir_candidates\", 8), "
+                     << (mReSTIRTemporal ? "true" : "false") << ", " << mReSTIRSpatial << ", " << (mReSTIRUnbiased ? "true" : "false") << ");" << std::endl;
+    else
+        input.Stream << "  let restir = make_null_restir();" << std::endl;
+
+    // Splitting is only supported by the CPU driver. It also interferes with the per path training slots of the path guiding
+    const size_t max_split = (input.Context.Options.Target.isCPU() && !guiding) ? mEARSMaxSplit : 1;
+    if (mEnableEARS)
+        input.Stream << "  let ears = make_ears(device, settings.width, settings.height, settings.iter, " << max_split << ");" << std::endl;
+    else
+        input.Stream << "  let ears = make_null_ears();" << std::endl;
+
     ShadingTree tree(input.Context);
     input.Stream << input.Context.Lights->generateLightSelector(mLightSelector, tree)
                  << "  let technique = make_path_renderer(tech_max_depth, tech_min_depth, light_selector, aovs, tech_clamp,"
-                 << (mEnableNEE ? "true" : "false") << ");" << std::endl;
+                 << (mEnableNEE ? "true" : "false") << ", "
+                 << (guiding ? "true" : "false") << ", guiding, " << mGuidingBSDFFraction << ":f32, "
+                 << (restir ? "true" : "false") << ", restir, "
+                 << (mEnableEARS ? "true" : "false") << ", ears);" << std::endl;
 }
 
 } // namespace IG
\ No newline at end of file
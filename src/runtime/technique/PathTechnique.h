@@ -12,11 +12,27 @@ public:
     void generateBody(const SerializationInput& input) const override;
 
 private:
+    /// Guiding requires the training buffers of the runtime, which are not available while tracing single rays
+    bool isGuidingEnabled(const LoaderContext& ctx) const;
+
     size_t mMaxDepth;
     size_t mMinDepth;
     std::string mLightSelector;
     float mClamp;
     bool mEnableNEE;
     bool mMISAOVs;
+
+    bool mEnableGuiding;
+    float mGuidingBSDFFraction;
+    PathGuidingSettings mGuidingSettings;
+
+    bool mEnableReSTIR;
+    size_t mReSTIRCandidates;
+    bool mReSTIRTemporal;
+    size_t mReSTIRSpatial;
+    bool mReSTIRUnbiased;
+
+    bool mEnableEARS;
+    size_t mEARSMaxSplit;
 };
 } // namespace IG
\ No newline at end of file
@@ -43,7 +43,7 @@ static std::string ppm_before_iteration_generator(LoaderContext& ctx)
 
     stream << ShaderUtils::beginCallback(ctx) << std::endl
            << "  let tech_photons = registry::get_global_parameter_i32(\"__tech_photon_count\", 1000);" << std::endl
-           << "  ppm_handle_before_iteration(device, settings.iter, " << ctx.CurrentTechniqueVariant << ", tech_photons, scene_bbox);" << std::endl
+           << "  ppm_handle_before_iteration(device, settings.iter, " << ctx.currentTechniqueVariant() << ", tech_photons, scene_bbox);" << std::endl
            << ShaderUtils::endCallback() << std::endl;
 
     return stream.str();
@@ -87,15 +87,15 @@ TechniqueInfo PhotonMappingTechnique::getInfo(const LoaderContext&) const
 
 void PhotonMappingTechnique::generateBody(const SerializationInput& input) const
 {
-    const bool is_light_pass = input.Context.CurrentTechniqueVariant == 0;
+    const bool is_light_pass = input.Context.currentTechniqueVariant() == 0;
 
     // Insert config into global registry
-    input.Context.GlobalRegistry.IntParameters["__tech_max_camera_depth"] = (int)mMaxCameraDepth;
-    input.Context.GlobalRegistry.IntParameters["__tech_min_camera_depth"] = (int)mMinCameraDepth;
-    input.Context.GlobalRegistry.IntParameters["__tech_max_light_depth"]  = (int)mMaxLightDepth;
-    input.Context.GlobalRegistry.IntParameters["__tech_photon_count"]     = (int)mPhotonCount;
-    input.Context.GlobalRegistry.FloatParameters["__tech_radius"]         = mMergeRadius * input.Context.SceneDiameter;
-    input.Context.GlobalRegistry.FloatParameters["__tech_clamp"]          = mClamp;
+    input.Context.globalRegistry().IntParameters["__tech_max_camera_depth"] = (int)mMaxCameraDepth;
+    input.Context.globalRegistry().IntParameters["__tech_min_camera_depth"] = (int)mMinCameraDepth;
+    input.Context.globalRegistry().IntParameters["__tech_max_light_depth"]  = (int)mMaxLightDepth;
+    input.Context.globalRegistry().IntParameters["__tech_photon_count"]     = (int)mPhotonCount;
+    input.Context.globalRegistry().FloatParameters["__tech_radius"]         = mMergeRadius * input.Context.SceneDiameter;
+    input.Context.globalRegistry().FloatParameters["__tech_clamp"]          = mClamp;
 
     // Load registry information
     input.Stream << "  let tech_photons = registry::get_global_parameter_i32(\"__tech_photon_count\", 1000);" << std::endl;
@@ -86,6 +86,14 @@ struct TechniqueVariantInfo {
     }
 };
 
+struct PathGuidingSettings {
+    uint32 TrainingIterations  = 63;    // Iterations spent on training. Training passes last 1, 2, 4, ... iterations
+    uint32 TrainingPaths       = 65536; // Maximum number of paths per iteration recording their vertices
+    uint32 MaxDepth            = 8;     // Maximum number of vertices recorded per path
+    float SpatialThreshold     = 2000;  // Records per spatial leaf required to split it, scaled by the square root of the pass length
+    float DirectionalThreshold = 0.01f; // Fraction of the energy a directional quadrant requires to be subdivided
+};
+
 struct TechniqueInfo {
     /// The AOVs enabled in the current runtime. This option is shared across all variants
     std::vector<std::string> EnabledAOVs;
@@ -96,6 +104,9 @@ struct TechniqueInfo {
     /// Callback to select the active variants for a specific iteration. If nullptr, all variants will be called sequentially
     TechniqueVariantSelector VariantSelector = nullptr;
 
+    /// The technique learns a path guiding distribution across iterations. See PathGuiding for details
+    std::optional<PathGuidingSettings> PathGuiding;
+
     [[nodiscard]] inline size_t ComputeSPI(size_t iter, size_t hintSPI) const
     {
         if (VariantSelector) {
@@ -0,0 +1,144 @@
+#include "VCMTechnique.h"
+#include "loader/LoaderContext.h"
+#include "loader/LoaderLight.h"
+#include "loader/Parser.h"
+#include "loader/ShadingTree.h"
+#include "shader/RayGenerationShader.h"
+#include "shader/ShaderUtils.h"
+
+namespace IG {
+VCMTechnique::VCMTechnique(SceneObject& obj, bool merging)
+    : Technique(merging ? "vcm" : "bdpt")
+{
+    mLightPaths    = (size_t)std::max(1, obj.property("light_paths").getInteger(262144));
+    mMaxDepth      = (size_t)obj.property("max_depth").getInteger(DefaultMaxRayDepth);
+    mMinDepth      = (size_t)obj.property("min_depth").getInteger(DefaultMinRayDepth);
+    mLightSelector = obj.property("light_selector").getString();
+    mMergeRadius   = obj.property("radius").getNumber(0.01f);
+    mClamp         = obj.property("clamp").getNumber(0.0f);
+    mMerging       = merging && obj.property("merging").getBool(true); // bdpt never merges
+}
+
+// Light paths, the iteration dependent options and the light cache are shared by all shaders
+static std::string vcm_setup()
+{
+    std::stringstream stream;
+
+    stream << "  let tech_light_paths = vcm_light_path_count(settings.width, settings.height, registry::get_global_parameter_i32(\"__tech_light_paths\", 262144));" << std::endl
+           << "  let tech_max_depth   = registry::get_global_parameter_i32(\"__tech_max_depth\", 64);" << std::endl
+           << "  let tech_merging     = registry::get_global_parameter_i32(\"__tech_merging\", 1) != 0;" << std::endl
+           << "  let tech_capacity    = vcm_light_cache_capacity(tech_light_paths, tech_max_depth);" << std::endl;
+
+    return stream.str();
+}
+
+static std::string vcm_light_camera_generator(LoaderContext& ctx, const std::string& light_selector)
+{
+    std::stringstream stream;
+
+    stream << RayGenerationShader::begin(ctx) << std::endl
+           << ShaderUtils::generateDatabase(ctx) << std::endl;
+
+    ShadingTree tree(ctx);
+    stream << ctx.Lights->generate(tree, false) << std::endl
+           << ctx.Lights->generateLightSelector(light_selector, tree)
+           << vcm_setup()
+           << "  let tech_radius = registry::get_global_parameter_f32(\"__tech_radius\", 0);" << std::endl
+           << "  let vcm_options = make_vcm_options(tech_light_paths, ppm_compute_radius(tech_radius, settings.iter), tech_merging);" << std::endl
+           << "  let emitter = make_vcm_light_emitter(light_selector, render_config, tech_light_paths, vcm_options);" << std::endl
+           << RayGenerationShader::end();
+
+    return stream.str();
+}
+
+static std::string vcm_before_iteration_generator(LoaderContext& ctx)
+{
+    std::stringstream stream;
+
+    stream << ShaderUtils::beginCallback(ctx) << std::endl
+           << vcm_setup()
+           << "  vcm_handle_before_iteration(device, " << ctx.currentTechniqueVariant() << ", tech_capacity, tech_merging, scene_bbox);" << std::endl
+           << ShaderUtils::endCallback() << std::endl;
+
+    return stream.str();
+}
+
+TechniqueInfo VCMTechnique::getInfo(const LoaderContext&) const
+{
+    TechniqueInfo info;
+
+    // We got two passes. (0 -> Light paths with connections to the camera, 1 -> Camera paths with connections and merging)
+    info.Variants.resize(2);
+    info.Variants[0].UsesLights = false; // Light paths make no use of other lights (but start on one)
+    info.Variants[1].UsesLights = true;
+
+    info.Variants[0].PrimaryPayloadCount   = 9;
+    info.Variants[1].PrimaryPayloadCount   = 9;
+    info.Variants[0].SecondaryPayloadCount = 2; // Pixel of the camera connection
+    info.Variants[1].SecondaryPayloadCount = 4; // Light vertex and MIS quantities of the connection
+
+    info.Variants[1].EmitterPayloadInitializer = "make_simple_payload_initializer(init_vcm_raypayload)";
+
+    // To start from a light source, we do have to override the standard camera generator
+    info.Variants[0].OverrideCameraGenerator = [&](LoaderContext& ctx) { return vcm_light_camera_generator(ctx, mLightSelector); };
+
+    // Each pass makes use of pre-iteration setups
+    info.Variants[0].CallbackGenerators[(int)CallbackType::BeforeIteration] = vcm_before_iteration_generator; // Reset light cache
+    info.Variants[1].CallbackGenerators[(int)CallbackType::BeforeIteration] = vcm_before_iteration_generator; // Construct query structure
+
+    // Both passes require the camera model to compute the MIS weights
+    info.Variants[0].RequiresExplicitCamera = true;
+    info.Variants[1].RequiresExplicitCamera = true;
+
+    // The light vertices of connections are shaded in the shadow shader with their respective material
+    info.Variants[0].ShadowHandlingMode = ShadowHandlingMode::Advanced;
+    info.Variants[1].ShadowHandlingMode = ShadowHandlingMode::AdvancedWithMaterials;
+
+    // The light paths are traced with the framebuffer size, but only a subset emits a path. The light tracing contributions are splatted directly
+    info.Variants[0].OverrideSPI     = 1;
+    info.Variants[1].OverrideSPI     = 1; // All light paths are shared by the camera paths of a single iteration
+    info.Variants[0].LockFramebuffer = true;
+
+    return info;
+}
+
+void VCMTechnique::generateBody(const SerializationInput& input) const
+{
+    const bool is_light_pass = input.Context.currentTechniqueVariant() == 0;
+
+    // Insert config into global registry
+    input.Context.globalRegistry().IntParameters["__tech_light_paths"] = (int)mLightPaths;
+    input.Context.globalRegistry().IntParameters["__tech_max_depth"]   = (int)mMaxDepth;
+    input.Context.globalRegistry().IntParameters["__tech_min_depth"]   = (int)mMinDepth;
+    input.Context.globalRegistry().IntParameters["__tech_merging"]     = mMerging ? 1 : 0;
+    input.Context.globalRegistry().FloatParameters["__tech_radius"]    = mMergeRadius * input.Context.SceneDiameter;
+    input.Context.globalRegistry().FloatParameters["__tech_clamp"]     = mClamp;
+
+    // Load registry information
+    input.Stream << vcm_setup();
+
+    if (mMinDepth < 2 && input.Context.Options.Specialization != RuntimeOptions::SpecializationMode::Disable) // 0 & 1 can be an optimization
+        input.Stream << "  let tech_min_depth = " << mMinDepth << ":i32;" << std::endl;
+    else
+        input.Stream << "  let tech_min_depth = registry::get_global_parameter_i32(\"__tech_min_depth\", 2);" << std::endl;
+
+    if (mClamp <= 0 && input.Context.Options.Specialization != RuntimeOptions::SpecializationMode::Disable) // 0 is a special case
+        input.Stream << "  let tech_clamp = " << mClamp << ":f32;" << std::endl;
+    else
+        input.Stream << "  let tech_clamp = registry::get_global_parameter_f32(\"__tech_clamp\", 0);" << std::endl;
+
+    input.Stream << "  let tech_radius = registry::get_global_parameter_f32(\"__tech_radius\", 0);" << std::endl
+                 << "  let vcm_options = make_vcm_options(tech_light_paths, ppm_compute_radius(tech_radius, settings.iter), tech_merging);" << std::endl
+                 << "  let light_cache = make_vcm_light_cache(device, tech_capacity, scene_bbox);" << std::endl;
+
+    if (is_light_pass) {
+        input.Stream << "  let framebuffer = device.load_aov_image(\"\", spi);" << std::endl
+                     << "  let technique = make_vcm_light_renderer(camera, framebuffer, settings.width, settings.height, tech_max_depth, tech_min_depth, tech_clamp, vcm_options, light_cache);" << std::endl;
+    } else {
+        ShadingTree tree(input.Context);
+        input.Stream << input.Context.Lights->generateLightSelector(mLightSelector, tree)
+                     << "  let technique = make_vcm_path_renderer(camera, settings.width, settings.height, tech_max_depth, tech_min_depth, light_selector, tech_clamp, vcm_options, light_cache);" << std::endl;
+    }
+}
+
+} // namespace IG
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Technique.h"
+
+namespace IG {
+/// Vertex connection and merging. Without merging this is a bidirectional path tracer
+class VCMTechnique : public Technique {
+public:
+    VCMTechnique(SceneObject& obj, bool merging);
+    ~VCMTechnique() = default;
+
+    TechniqueInfo getInfo(const LoaderContext& ctx) const override;
+    void generateBody(const SerializationInput& input) const override;
+
+private:
+    size_t mLightPaths;
+    size_t mMaxDepth;
+    size_t mMinDepth;
+    std::string mLightSelector;
+    float mMergeRadius;
+    float mClamp;
+    bool mMerging;
+};
+} // namespace IG
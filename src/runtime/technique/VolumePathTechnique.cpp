@@ -29,9 +29,9 @@ TechniqueInfo VolumePathTechnique::getInfo(const LoaderContext&) const
 void VolumePathTechnique::generateBody(const SerializationInput& input) const
 {
     // Insert config into global registry
-    input.Context.GlobalRegistry.IntParameters["__tech_max_depth"] = (int)mMaxDepth;
-    input.Context.GlobalRegistry.IntParameters["__tech_min_depth"] = (int)mMinDepth;
-    input.Context.GlobalRegistry.FloatParameters["__tech_clamp"]   = mClamp;
+    input.Context.globalRegistry().IntParameters["__tech_max_depth"] = (int)mMaxDepth;
+    input.Context.globalRegistry().IntParameters["__tech_min_depth"] = (int)mMinDepth;
+    input.Context.globalRegistry().FloatParameters["__tech_clamp"]   = mClamp;
 
     if (mMaxDepth < 2 && input.Context.Options.Specialization != RuntimeOptions::SpecializationMode::Disable) // 0 & 1 can be an optimization
         input.Stream << "  let tech_max_depth = " << mMaxDepth << ":i32;" << std::endl;
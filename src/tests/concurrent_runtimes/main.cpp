@@ -0,0 +1,82 @@
+#include "Logger.h"
+#include "Runtime.h"
+
+#include <thread>
+
+using namespace IG;
+
+// This application tests if multiple runtimes can render different scenes at the same time in a single process.
+// Each scene is rendered alone first and afterwards all scenes are rendered concurrently (multiple times).
+// The test is passed if the concurrent results match the sequential ones, which would not be the case if device state leaks between runtimes
+constexpr int SPP         = 8;
+constexpr int Repetitions = 2;
+
+static bool render(const char* scene, double& average)
+{
+    std::unique_ptr<Runtime> runtime;
+    try {
+        RuntimeOptions opts = RuntimeOptions::makeDefault();
+        opts.Target         = Target::pickCPU();
+        opts.Seed           = 42;
+
+        runtime = std::make_unique<Runtime>(opts);
+    } catch (const std::exception& e) {
+        IG_LOG(L_ERROR) << e.what() << std::endl;
+        return false;
+    }
+
+    if (!runtime->loadFromFile(scene)) {
+        IG_LOG(L_ERROR) << "Failed loading " << scene << std::endl;
+        return false;
+    }
+
+    while (runtime->currentSampleCount() < SPP)
+        runtime->step();
+
+    const size_t size  = runtime->framebufferWidth() * runtime->framebufferHeight() * 3;
+    const float* color = runtime->getFramebufferForHost({}).Data;
+
+    double sum = 0;
+    for (size_t i = 0; i < size; ++i)
+        sum += color[i];
+    average = sum / (double)(size * runtime->currentIterationCount());
+    return std::isfinite(average);
+}
+
+int main(int argc, char** argv)
+{
+    const size_t count = (size_t)argc - 1;
+
+    std::vector<double> expected(count, 0.0);
+    for (size_t k = 0; k < count; ++k) {
+        IG_LOG(L_INFO) << "Rendering scene " << argv[k + 1] << " alone" << std::endl;
+        if (!render(argv[k + 1], expected[k]))
+            return EXIT_FAILURE;
+    }
+
+    std::vector<double> results(count * Repetitions, 0.0);
+    std::vector<int> success(count * Repetitions, 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < count * Repetitions; ++i) {
+        threads.emplace_back([&, i]() {
+            success[i] = render(argv[i % count + 1], results[i]) ? 1 : 0;
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    bool passed = true;
+    for (size_t i = 0; i < count * Repetitions; ++i) {
+        const size_t k = i % count;
+        if (!success[i]) {
+            IG_LOG(L_ERROR) << "Concurrent rendering of scene " << argv[k + 1] << " failed" << std::endl;
+            passed = false;
+        } else if (std::abs(results[i] - expected[k]) > 1e-4 * std::max(1.0, std::abs(expected[k]))) {
+            IG_LOG(L_ERROR) << "Concurrent rendering of scene " << argv[k + 1] << " has average " << results[i] << " but expected " << expected[k] << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
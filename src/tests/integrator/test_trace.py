@@ -0,0 +1,66 @@
+from common import load_api, create_flat_scene
+import numpy as np
+import json
+
+
+def _create_scene():
+    scene = create_flat_scene()
+    scene["lights"].append(
+        {"type": "point", "name": "_light", "position": [0, 0, -0.5], "intensity": [1, 1, 1]})
+    return json.dumps(scene)
+
+
+def _create_rays(count, towards_plane):
+    # The plane is at z = 0 and faces the camera at z = -1
+    rays = np.zeros((count, 6), dtype=np.float32)
+    rays[:, 0] = np.linspace(-0.5, 0.5, count)
+    rays[:, 2] = -1
+    rays[:, 5] = 1 if towards_plane else -1
+    return rays
+
+
+def test_trace_copy():
+    ignis = load_api()
+    opts = ignis.RuntimeOptions.makeDefault(trace=True)
+    with ignis.loadFromString(_create_scene(), opts) as runtime:
+        hit = runtime.trace(_create_rays(16, True))
+        miss = runtime.trace(_create_rays(16, False))
+
+        assert hit.shape == (16, 3)
+        assert np.all(hit > 0)
+        assert np.all(miss == 0)
+
+        # The default result is a copy, therefore not affected by the following trace
+        assert np.all(hit > 0)
+
+
+def test_trace_view():
+    ignis = load_api()
+    opts = ignis.RuntimeOptions.makeDefault(trace=True)
+    with ignis.loadFromString(_create_scene(), opts) as runtime:
+        view = runtime.trace(_create_rays(16, True), copy=False)
+        expected = np.copy(view)
+        assert np.all(expected > 0)
+
+        # The view aliases the framebuffer, which is overwritten by the next trace
+        runtime.trace(_create_rays(16, False))
+        assert np.all(view == 0)
+
+        runtime.trace(_create_rays(16, True), copy=False)
+        np.testing.assert_array_equal(view, expected)
+
+
+def test_trace_separate_arrays():
+    ignis = load_api()
+    opts = ignis.RuntimeOptions.makeDefault(trace=True)
+    with ignis.loadFromString(_create_scene(), opts) as runtime:
+        rays = _create_rays(16, True)
+        origins = np.ascontiguousarray(rays[:, 0:3])
+        directions = np.ascontiguousarray(rays[:, 3:6])
+
+        full = runtime.trace(origins, directions)
+        np.testing.assert_array_equal(full, runtime.trace(rays))
+
+        # The plane is one unit away, therefore nothing is hit with a shorter range
+        ranges = np.tile(np.array([0, 0.5], dtype=np.float32), (16, 1))
+        assert np.all(runtime.trace(origins, directions, ranges) == 0)
@@ -0,0 +1,258 @@
+#include "AdaptiveSampler.h"
+#include "device/IRenderDevice.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+using namespace IG;
+
+// Host only device providing the framebuffers and buffers used by the adaptive sampler
+class FakeDevice : public IRenderDevice {
+public:
+    FakeDevice(size_t width, size_t height)
+        : mWidth(width)
+        , mHeight(height)
+    {
+        for (const std::string name : { "", AdaptiveSampler::VarianceAOV, AdaptiveSampler::SampleCountAOV })
+            Framebuffers[name].assign(width * height * 3, 0.0f);
+    }
+
+    void assignScene(const SceneSettings&) override {}
+    void render(const TechniqueVariantShaderSet&, const RenderSettings&, ParameterSet*) override {}
+    void resize(size_t width, size_t height) override
+    {
+        mWidth  = width;
+        mHeight = height;
+        for (auto& [_, data] : Framebuffers)
+            data.assign(width * height * 3, 0.0f);
+    }
+
+    void releaseAll() override {}
+
+    [[nodiscard]] Target target() const override { return Target::pickCPU(); }
+    [[nodiscard]] size_t framebufferWidth() const override { return mWidth; }
+    [[nodiscard]] size_t framebufferHeight() const override { return mHeight; }
+    [[nodiscard]] bool isInteractive() const override { return false; }
+
+    [[nodiscard]] AOVAccessor getFramebufferForHost(const std::string& name, bool) override
+    {
+        const auto it = Framebuffers.find(name);
+        return AOVAccessor{ it != Framebuffers.end() ? it->second.data() : nullptr };
+    }
+    [[nodiscard]] AOVAccessor getFramebufferForDevice(const std::string& name, bool sync) override { return getFramebufferForHost(name, sync); }
+    void clearFramebuffer(const std::string& name) override { std::fill(Framebuffers[name].begin(), Framebuffers[name].end(), 0.0f); }
+    void clearAllFramebuffer() override
+    {
+        for (auto& [_, data] : Framebuffers)
+            std::fill(data.begin(), data.end(), 0.0f);
+    }
+    void syncFramebufferHostToDevice(const std::string&) override {}
+    void syncAllFramebufferHostToDevice() override {}
+
+    [[nodiscard]] size_t getBufferSizeInBytes(const std::string& name) override { return Buffers[name].size(); }
+    [[nodiscard]] bool copyBufferToHost(const std::string& name, void* buffer, size_t maxSizeByte) override
+    {
+        const auto& data = Buffers[name];
+        std::memcpy(buffer, data.data(), std::min(maxSizeByte, data.size()));
+        return true;
+    }
+    [[nodiscard]] BufferAccessor getBufferForDevice(const std::string& name) override { return BufferAccessor{ Buffers[name].data(), Buffers[name].size() }; }
+    void copyBufferFromHost(const std::string& name, const void* buffer, size_t sizeInBytes) override
+    {
+        const auto* ptr = reinterpret_cast<const uint8*>(buffer);
+        Buffers[name].assign(ptr, ptr + sizeInBytes);
+    }
+
+    [[nodiscard]] const Statistics* getStatistics() override { return nullptr; }
+    [[nodiscard]] std::vector<size_t> getMaterialWorkloads() override { return {}; }
+    [[nodiscard]] MemoryUsage getMemoryUsage() override { return MemoryUsage(); }
+
+    void tonemap(uint32_t*, const TonemapSettings&) override {}
+    [[nodiscard]] ImageInfoOutput imageinfo(const ImageInfoSettings&) override { return ImageInfoOutput{}; }
+    void bake(const ShaderOutput<void*>&, const std::vector<std::string>*, float*) override {}
+    void runPass(const ShaderOutput<void*>&) override {}
+
+    /// Non-zero entries mark converged pixels
+    [[nodiscard]] std::vector<int32> mask()
+    {
+        const auto& data = Buffers[AdaptiveSampler::MaskBufferName];
+        std::vector<int32> mask(data.size() / sizeof(int32));
+        std::memcpy(mask.data(), data.data(), data.size());
+        return mask;
+    }
+
+    [[nodiscard]] float pixel(const std::string& name, size_t x, size_t y) const
+    {
+        return Framebuffers.at(name)[3 * (y * mWidth + x)];
+    }
+
+    std::unordered_map<std::string, std::vector<float>> Framebuffers;
+    std::unordered_map<std::string, std::vector<uint8>> Buffers;
+
+private:
+    size_t mWidth;
+    size_t mHeight;
+};
+
+constexpr size_t SPI = 4;
+
+// Accumulates a grey estimate for all active pixels, like the adaptive emitter does, and updates the sampler afterwards
+static void renderIteration(FakeDevice& device, AdaptiveSampler& sampler, size_t iteration, const std::function<float(size_t, size_t, size_t)>& estimate)
+{
+    const size_t width            = device.framebufferWidth();
+    const std::vector<int32> mask = device.mask();
+    auto& color                   = device.Framebuffers[""];
+    for (size_t y = 0; y < device.framebufferHeight(); ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            const size_t i = y * width + x;
+            if (mask[i] != 0)
+                continue;
+            const float v = estimate(x, y, iteration);
+            for (size_t c = 0; c < 3; ++c)
+                color[3 * i + c] += v;
+        }
+    }
+
+    sampler.update(&device, iteration, SPI, {});
+}
+
+static AdaptiveSamplingSettings makeSettings(uint32 minIterations, uint32 tileSize)
+{
+    AdaptiveSamplingSettings settings;
+    settings.Enabled       = true;
+    settings.TargetError   = 0.01f;
+    settings.MinIterations = minIterations;
+    settings.TileSize      = tileSize;
+    return settings;
+}
+
+// Left tile is constant, right tile alternates between 0 and 2 and never converges
+static float halfNoisy(size_t x, size_t, size_t iteration)
+{
+    if (x < 2)
+        return 1;
+    return iteration % 2 == 0 ? 2.0f : 0.0f;
+}
+
+TEST_CASE("Constant tiles converge", "[AdaptiveSampler]")
+{
+    FakeDevice device(4, 2);
+    AdaptiveSampler sampler(makeSettings(2, 2), 4, 2);
+    sampler.reset(&device, 4, 2);
+
+    CHECK(device.mask() == std::vector<int32>(8, 0));
+
+    // A single iteration does not allow to estimate the error
+    renderIteration(device, sampler, 1, halfNoisy);
+    CHECK(sampler.activePixelCount() == 8);
+    CHECK_FALSE(sampler.isConverged());
+
+    renderIteration(device, sampler, 2, halfNoisy);
+    CHECK(sampler.activePixelCount() == 4);
+    CHECK(device.mask() == std::vector<int32>{ 1, 1, 0, 0, 1, 1, 0, 0 });
+    CHECK(sampler.maxError() == 1); // Mean 1, variance of the mean 1
+    CHECK(device.pixel(AdaptiveSampler::VarianceAOV, 0, 0) == 0);
+    CHECK(device.pixel(AdaptiveSampler::VarianceAOV, 3, 1) == 1);
+
+    // Skipped pixels are filled with their mean, active pixels keep sampling
+    renderIteration(device, sampler, 3, halfNoisy);
+    CHECK(device.pixel("", 0, 0) == 3);
+    CHECK(device.pixel("", 1, 1) == 3);
+    CHECK(device.pixel("", 3, 0) == 2);
+    CHECK(device.pixel(AdaptiveSampler::SampleCountAOV, 0, 0) == 2 * SPI);
+    CHECK(device.pixel(AdaptiveSampler::SampleCountAOV, 3, 0) == 3 * SPI);
+
+    // Converged tiles stay converged
+    CHECK(device.mask() == std::vector<int32>{ 1, 1, 0, 0, 1, 1, 0, 0 });
+    CHECK_FALSE(sampler.isConverged());
+}
+
+TEST_CASE("Tiles converge after the minimum iteration count only", "[AdaptiveSampler]")
+{
+    FakeDevice device(4, 4);
+    AdaptiveSampler sampler(makeSettings(4, 2), 4, 4);
+    sampler.reset(&device, 4, 4);
+
+    const auto constant = [](size_t, size_t, size_t) { return 0.5f; };
+    for (size_t iteration = 1; iteration < 4; ++iteration) {
+        renderIteration(device, sampler, iteration, constant);
+        CHECK(sampler.activePixelCount() == 16);
+    }
+
+    renderIteration(device, sampler, 4, constant);
+    CHECK(sampler.activePixelCount() == 0);
+    CHECK(sampler.isConverged());
+    CHECK(sampler.maxError() == 0);
+}
+
+TEST_CASE("Border tiles cover the remaining pixels", "[AdaptiveSampler]")
+{
+    FakeDevice device(3, 3);
+    AdaptiveSampler sampler(makeSettings(2, 2), 3, 3);
+    sampler.reset(&device, 3, 3);
+
+    // Only the bottom right pixel is noisy, which is a 1x1 tile
+    const auto estimate = [](size_t x, size_t y, size_t iteration) {
+        if (x == 2 && y == 2)
+            return iteration % 2 == 0 ? 2.0f : 0.0f;
+        return 1.0f;
+    };
+
+    renderIteration(device, sampler, 1, estimate);
+    renderIteration(device, sampler, 2, estimate);
+    CHECK(sampler.activePixelCount() == 1);
+    CHECK(device.mask() == std::vector<int32>{ 1, 1, 1, 1, 1, 1, 1, 1, 0 });
+}
+
+TEST_CASE("A single noisy pixel keeps its tile active", "[AdaptiveSampler]")
+{
+    FakeDevice device(4, 2);
+    AdaptiveSampler sampler(makeSettings(2, 2), 4, 2);
+    sampler.reset(&device, 4, 2);
+
+    const auto estimate = [](size_t x, size_t y, size_t iteration) {
+        if (x == 1 && y == 1)
+            return iteration % 2 == 0 ? 2.0f : 0.0f;
+        return 1.0f;
+    };
+
+    renderIteration(device, sampler, 1, estimate);
+    renderIteration(device, sampler, 2, estimate);
+    CHECK(sampler.activePixelCount() == 4);
+    CHECK(device.mask() == std::vector<int32>{ 0, 0, 1, 1, 0, 0, 1, 1 });
+}
+
+TEST_CASE("Disabled sampler never converges", "[AdaptiveSampler]")
+{
+    FakeDevice device(2, 2);
+    AdaptiveSampler sampler(makeSettings(2, 1), 2, 2);
+    sampler.reset(&device, 2, 2);
+    sampler.disable();
+
+    const auto constant = [](size_t, size_t, size_t) { return 1.0f; };
+    for (size_t iteration = 1; iteration <= 4; ++iteration)
+        renderIteration(device, sampler, iteration, constant);
+
+    CHECK(sampler.activePixelCount() == 4);
+    CHECK_FALSE(sampler.isConverged());
+}
+
+TEST_CASE("Resized framebuffer resets the estimates", "[AdaptiveSampler]")
+{
+    FakeDevice device(2, 2);
+    AdaptiveSampler sampler(makeSettings(2, 1), 2, 2);
+    sampler.reset(&device, 2, 2);
+
+    const auto constant = [](size_t, size_t, size_t) { return 1.0f; };
+    renderIteration(device, sampler, 1, constant);
+    renderIteration(device, sampler, 2, constant);
+    CHECK(sampler.isConverged());
+
+    device.resize(3, 2);
+    sampler.update(&device, 1, SPI, {});
+    CHECK(sampler.activePixelCount() == 6);
+    CHECK(device.mask() == std::vector<int32>(6, 0));
+}
@@ -0,0 +1,156 @@
+#include "Checkpoint.h"
+#include "Runtime.h"
+#include "serialization/VectorSerializer.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+
+using namespace IG;
+
+static const char* SceneSource = R"({
+    "technique": { "type": "path", "max_depth": 2 },
+    "camera": { "type": "perspective", "fov": 90, "near_clip": 0.01, "far_clip": 100, "transform": [1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, -1] },
+    "film": { "size": [64, 48] },
+    "bsdfs": [ { "type": "diffuse", "name": "ground", "reflectance": [0.8, 0.5, 0.2] } ],
+    "shapes": [ { "type": "rectangle", "name": "Bottom", "width": 2, "height": 2, "flip_normals": true } ],
+    "entities": [ { "name": "Bottom", "shape": "Bottom", "bsdf": "ground" } ],
+    "lights": [ { "type": "point", "name": "Light", "position": [0, 0, -0.5], "intensity": [1, 1, 1] } ]
+})";
+
+static std::unique_ptr<Runtime> createRuntime(size_t seed)
+{
+    RuntimeOptions opts = RuntimeOptions::makeDefault();
+    opts.Target         = Target::pickCPU();
+    opts.Seed           = seed;
+
+    auto runtime = std::make_unique<Runtime>(opts);
+    REQUIRE(runtime->loadFromString(SceneSource, {}));
+    return runtime;
+}
+
+static std::vector<float> copyFramebuffer(const Runtime& runtime)
+{
+    const size_t size = runtime.framebufferWidth() * runtime.framebufferHeight() * 3;
+    const float* data = runtime.getFramebufferForHost({}).Data;
+    REQUIRE(data != nullptr);
+    return std::vector<float>(data, data + size);
+}
+
+static Checkpoint makeCheckpoint()
+{
+    Checkpoint checkpoint;
+    checkpoint.Width       = 5;
+    checkpoint.Height      = 3;
+    checkpoint.Iteration   = 17;
+    checkpoint.SampleCount = 68;
+    checkpoint.Frame       = 2;
+    checkpoint.Seed        = 1234;
+    checkpoint.Technique   = "path";
+    checkpoint.Camera      = "perspective";
+
+    for (const std::string name : { "", "Normals" }) {
+        std::vector<float> buffer(checkpoint.Width * checkpoint.Height * 3);
+        for (size_t i = 0; i < buffer.size(); ++i)
+            buffer[i] = (float)i * 0.25f + (float)name.size();
+        checkpoint.Buffers[name] = std::move(buffer);
+    }
+    return checkpoint;
+}
+
+static void checkEqual(const Checkpoint& a, const Checkpoint& b)
+{
+    CHECK(a.Width == b.Width);
+    CHECK(a.Height == b.Height);
+    CHECK(a.Iteration == b.Iteration);
+    CHECK(a.SampleCount == b.SampleCount);
+    CHECK(a.Frame == b.Frame);
+    CHECK(a.Seed == b.Seed);
+    CHECK(a.Technique == b.Technique);
+    CHECK(a.Camera == b.Camera);
+    CHECK(a.Buffers == b.Buffers);
+}
+
+TEST_CASE("Checkpoint survives a file round trip", "[Checkpoint]")
+{
+    const Checkpoint expected = makeCheckpoint();
+    const Path path           = std::filesystem::temp_directory_path() / "ig_test_checkpoint.igck";
+
+    REQUIRE(expected.save(path));
+
+    Checkpoint loaded;
+    REQUIRE(loaded.load(path));
+    checkEqual(expected, loaded);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Invalid checkpoints are rejected", "[Checkpoint]")
+{
+    const Checkpoint expected = makeCheckpoint();
+    const Path path           = std::filesystem::temp_directory_path() / "ig_test_invalid_checkpoint.igck";
+
+    std::vector<uint8> data;
+    {
+        VectorSerializer serializer(data, false);
+        expected.write(serializer);
+    }
+
+    const auto writeFile = [&]() {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(data.data()), (std::streamsize)data.size());
+    };
+
+    SECTION("Wrong magic")
+    {
+        data[0] ^= 0xFF;
+        writeFile();
+        Checkpoint loaded;
+        CHECK_FALSE(loaded.load(path));
+    }
+
+    SECTION("Wrong buffer size")
+    {
+        // Header layout: magic, version, width
+        data[8] += 1;
+        writeFile();
+        Checkpoint loaded;
+        CHECK_FALSE(loaded.load(path));
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Runtime resumes from a checkpoint", "[Checkpoint]")
+{
+    constexpr size_t Seed = 42;
+
+    auto original = createRuntime(Seed);
+    original->step();
+    original->step();
+
+    const Path path = std::filesystem::temp_directory_path() / "ig_test_runtime_checkpoint.igck";
+    REQUIRE(original->createCheckpoint().save(path));
+
+    Checkpoint checkpoint;
+    REQUIRE(checkpoint.load(path));
+    std::filesystem::remove(path);
+
+    CHECK(checkpoint.Iteration == 2);
+    CHECK(checkpoint.Seed == Seed);
+
+    auto resumed = createRuntime(Seed);
+    REQUIRE(resumed->restoreCheckpoint(checkpoint));
+
+    CHECK(resumed->currentIterationCount() == original->currentIterationCount());
+    CHECK(resumed->currentSampleCount() == original->currentSampleCount());
+    CHECK(resumed->seed() == original->seed());
+    CHECK(copyFramebuffer(*resumed) == copyFramebuffer(*original));
+
+    // Continuing both runtimes has to give the same result, as the seeds are derived from the restored iteration counter
+    original->step();
+    resumed->step();
+
+    CHECK(resumed->currentIterationCount() == 3);
+    CHECK(copyFramebuffer(*resumed) == copyFramebuffer(*original));
+}
@@ -0,0 +1,83 @@
+#include "extra/OIDN.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace IG;
+
+// Large enough to be split into multiple tiles with a small memory budget
+constexpr size_t Width  = 900;
+constexpr size_t Height = 700;
+
+static void generateFrame(std::vector<float>& color, std::vector<float>& normal, std::vector<float>& albedo)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> noise(0.0f, 1.0f);
+
+    color.resize(3 * Width * Height);
+    normal.resize(3 * Width * Height);
+    albedo.resize(3 * Width * Height);
+    for (size_t y = 0; y < Height; ++y) {
+        for (size_t x = 0; x < Width; ++x) {
+            const size_t i = 3 * (y * Width + x);
+
+            // Smooth gradient with a few edges and noise on top
+            const float base = ((x / 128 + y / 96) % 2 == 0 ? 0.8f : 0.2f) + 0.2f * std::sin(x * 0.01f) * std::cos(y * 0.013f);
+            for (size_t c = 0; c < 3; ++c) {
+                color[i + c]  = std::max(0.0f, base * (0.5f + noise(gen)) * (1 + 0.1f * c));
+                albedo[i + c] = base;
+            }
+            normal[i + 0] = 0;
+            normal[i + 1] = 0;
+            normal[i + 2] = 1;
+        }
+    }
+}
+
+TEST_CASE("Tiled denoising matches full frame", "[Denoiser]")
+{
+    if (!OIDN::isAvailable())
+        SKIP("No denoiser available");
+
+    const bool prefilter = GENERATE(false, true);
+
+    std::vector<float> color, normal, albedo;
+    generateFrame(color, normal, albedo);
+
+    DenoiserSettings fullSettings;
+    fullSettings.Prefilter = prefilter;
+
+    // The budget is below the requirements of the full frame, which enforces tiling
+    DenoiserSettings tiledSettings = fullSettings;
+    tiledSettings.MaxMemoryMB      = 32;
+
+    // The auxiliary buffers are prefiltered in place by some configurations, therefore use copies
+    std::vector<float> full(color.size());
+    {
+        std::vector<float> n = normal, a = albedo;
+        REQUIRE(OIDN::denoise(fullSettings, color.data(), n.data(), a.data(), full.data(), Width, Height));
+    }
+
+    std::vector<float> tiled(color.size());
+    {
+        std::vector<float> n = normal, a = albedo;
+        REQUIRE(OIDN::denoise(tiledSettings, color.data(), n.data(), a.data(), tiled.data(), Width, Height));
+    }
+
+    double error     = 0;
+    double maxError  = 0;
+    double reference = 0;
+    for (size_t i = 0; i < full.size(); ++i) {
+        const double diff = std::abs((double)full[i] - (double)tiled[i]);
+        error += diff;
+        maxError = std::max(maxError, diff);
+        reference += std::abs(full[i]);
+    }
+
+    CHECK(error / reference < 1e-2);
+    CHECK(maxError < 0.1);
+}
@@ -0,0 +1,119 @@
+#include "Distributed.h"
+#include "ProgramOptions.h"
+#include "Runtime.h"
+#include "Socket.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+#include <thread>
+
+using namespace IG;
+
+static const char* SceneSource = R"({
+    "technique": { "type": "path", "max_depth": 2 },
+    "camera": { "type": "perspective", "fov": 90, "near_clip": 0.01, "far_clip": 100, "transform": [1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, -1] },
+    "film": { "size": [64, 48] },
+    "bsdfs": [ { "type": "diffuse", "name": "ground", "reflectance": [0.8, 0.5, 0.2] } ],
+    "shapes": [ { "type": "rectangle", "name": "Bottom", "width": 2, "height": 2, "flip_normals": true } ],
+    "entities": [ { "name": "Bottom", "shape": "Bottom", "bsdf": "ground" } ],
+    "lights": [ { "type": "point", "name": "Light", "position": [0, 0, -0.5], "intensity": [1, 1, 1] } ]
+})";
+
+constexpr size_t Iterations = 8;
+constexpr size_t Workers    = 2;
+
+static std::unique_ptr<Runtime> createRuntime()
+{
+    RuntimeOptions opts = RuntimeOptions::makeDefault();
+    opts.Target         = Target::pickCPU();
+    opts.Seed           = 42;
+
+    auto runtime = std::make_unique<Runtime>(opts);
+    REQUIRE(runtime->loadFromString(SceneSource, {}));
+    return runtime;
+}
+
+static std::vector<float> copyFramebuffer(const Runtime& runtime)
+{
+    const size_t size = runtime.framebufferWidth() * runtime.framebufferHeight() * 3;
+    const float* data = runtime.getFramebufferForHost({}).Data;
+    REQUIRE(data != nullptr);
+    return std::vector<float>(data, data + size);
+}
+
+// Ask the system for a free port. The port might be taken in between, which is unlikely enough for a test
+static uint16 findFreePort()
+{
+    Socket socket = Socket::listen(0);
+    REQUIRE(socket.isValid());
+    return socket.port();
+}
+
+TEST_CASE("Coordinator merges the work of remote workers", "[Distributed]")
+{
+    // The program options require an existing scene file, even though the runtimes are setup directly
+    const Path scenePath = std::filesystem::temp_directory_path() / "ig_test_distributed.json";
+    {
+        std::ofstream stream(scenePath);
+        stream << SceneSource;
+    }
+
+    const uint16 port         = findFreePort();
+    const std::string portArg = std::to_string(port);
+    std::string sceneArg      = scenePath.generic_string();
+
+    char programName[] = "igcli";
+    char portOption[]  = "--port";
+    char* argv[]       = { programName, sceneArg.data(), portOption, const_cast<char*>(portArg.c_str()) };
+    const int argc     = 4;
+
+    ProgramOptions cmd(argc, argv, ApplicationType::CLI, "Test");
+    REQUIRE_FALSE(cmd.ShouldExit);
+    REQUIRE(cmd.DistributedPort == port);
+    cmd.DistributedChunkSPP = 1; // A single iteration per work item, such that the work is distributed over all workers
+    cmd.DistributedTimeout  = 60;
+
+    auto reference = createRuntime();
+    for (size_t i = 0; i < Iterations; ++i)
+        reference->step(true);
+
+    // Each worker uses its own runtime and connects via loopback. The runtimes are created beforehand, as assertions are only allowed on the main thread
+    std::vector<std::unique_ptr<Runtime>> workerRuntimes;
+    for (size_t i = 0; i < Workers; ++i)
+        workerRuntimes.emplace_back(createRuntime());
+
+    std::vector<int> workerResults(Workers, 0);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < Workers; ++i) {
+        workers.emplace_back([&, i]() {
+            workerResults[i] = runDistributedWorker(*workerRuntimes[i], "127.0.0.1:" + portArg) ? 1 : 0;
+        });
+    }
+
+    auto coordinator   = createRuntime();
+    size_t lastSamples = 0;
+    const bool success = runDistributedCoordinator(*coordinator, cmd, Iterations, argc, argv, [&](size_t samples) { lastSamples = samples; });
+
+    for (auto& worker : workers)
+        worker.join();
+    std::filesystem::remove(scenePath);
+
+    REQUIRE(success);
+    for (int result : workerResults)
+        CHECK(result == 1);
+
+    CHECK(coordinator->currentIterationCount() == Iterations);
+    CHECK(coordinator->currentSampleCount() == reference->currentSampleCount());
+    CHECK(lastSamples == reference->currentSampleCount());
+
+    // The ranges are merged in arbitrary order, therefore the sums can differ slightly
+    const auto expected = copyFramebuffer(*reference);
+    const auto merged   = copyFramebuffer(*coordinator);
+    REQUIRE(expected.size() == merged.size());
+
+    float maxError = 0;
+    for (size_t i = 0; i < expected.size(); ++i)
+        maxError = std::max(maxError, std::abs(expected[i] - merged[i]) / std::max(1.0f, std::abs(expected[i])));
+    CHECK(maxError < 1e-4f);
+}
@@ -0,0 +1,150 @@
+#include "Logger.h"
+#include "log/LogListener.h"
+#include "log/LogQueue.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+using namespace IG;
+
+static LogEntry* makeEntry(const std::string& message)
+{
+    LogEntry* entry = new LogEntry();
+    entry->Message  = message;
+    return entry;
+}
+
+class RecordingLogListener : public LogListener {
+public:
+    void writeEntry(const LogMessage& msg) override
+    {
+        // Listeners are only called from a single thread at a time
+        Messages.emplace_back(msg.Message);
+    }
+
+    std::vector<std::string> Messages;
+};
+
+TEST_CASE("Log queue keeps single producer order", "[Logger]")
+{
+    LogQueue queue;
+    CHECK(queue.pop() == nullptr);
+
+    constexpr int Count = 1000;
+    for (int i = 0; i < Count; ++i)
+        queue.push(makeEntry(std::to_string(i)));
+
+    for (int i = 0; i < Count; ++i) {
+        LogEntry* entry = queue.pop();
+        REQUIRE(entry != nullptr);
+        CHECK(entry->Message == std::to_string(i));
+        delete entry;
+    }
+
+    CHECK(queue.pop() == nullptr);
+}
+
+TEST_CASE("Log queue keeps order per producer", "[Logger]")
+{
+    constexpr int Producers = 4;
+    constexpr int Count     = 10000;
+
+    LogQueue queue;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < Producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < Count; ++i)
+                queue.push(makeEntry(std::to_string(p) + ":" + std::to_string(i)));
+        });
+    }
+
+    // Pop concurrently to the producers. A pop might fail while a producer is in the middle of a push
+    std::vector<int> next(Producers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < Producers * Count) {
+        LogEntry* entry = queue.pop();
+        if (entry == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const size_t sep = entry->Message.find(':');
+        const int p      = std::stoi(entry->Message.substr(0, sep));
+        const int i      = std::stoi(entry->Message.substr(sep + 1));
+        ordered          = ordered && next[p] == i;
+        next[p]          = i + 1;
+        ++received;
+        delete entry;
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    CHECK(ordered);
+    CHECK(queue.pop() == nullptr);
+    for (int p = 0; p < Producers; ++p)
+        CHECK(next[p] == Count);
+}
+
+TEST_CASE("Flush writes all pending entries", "[Logger]")
+{
+    auto listener = std::make_shared<RecordingLogListener>();
+
+    const LogLevel verbosity = IG_LOGGER.verbosity();
+    const bool quiet         = IG_LOGGER.isQuiet();
+    IG_LOGGER.setVerbosity(L_INFO);
+    IG_LOGGER.setQuiet(true);
+    IG_LOGGER.addListener(listener);
+
+    constexpr int Threads = 4;
+    constexpr int Count   = 500;
+
+    SECTION("Single thread")
+    {
+        for (int i = 0; i < Count; ++i)
+            IG_LOG(L_INFO) << i;
+        IG_LOGGER.flush();
+
+        REQUIRE(listener->Messages.size() == Count);
+        for (int i = 0; i < Count; ++i)
+            CHECK(listener->Messages[i] == std::to_string(i));
+    }
+
+    SECTION("Multiple threads")
+    {
+        // Each thread flushes on its own. A flush has to cover at least the entries of the calling thread
+        std::vector<std::thread> threads;
+        std::vector<int> written(Threads, 0);
+        for (int t = 0; t < Threads; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < Count; ++i)
+                    IG_LOG(L_INFO) << "Thread " << t;
+                IG_LOGGER.flush();
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        IG_LOGGER.flush();
+
+        REQUIRE(listener->Messages.size() == Threads * Count);
+        for (const auto& msg : listener->Messages)
+            ++written[std::stoi(msg.substr(7))];
+        for (int t = 0; t < Threads; ++t)
+            CHECK(written[t] == Count);
+    }
+
+    SECTION("Synchronous")
+    {
+        IG_LOGGER.setAsynchronous(false);
+        IG_LOG(L_INFO) << "Direct";
+        CHECK(listener->Messages.size() == 1); // Written without a flush
+        IG_LOGGER.flush();
+        IG_LOGGER.setAsynchronous(true);
+    }
+
+    IG_LOGGER.removeListener(listener);
+    IG_LOGGER.setQuiet(quiet);
+    IG_LOGGER.setVerbosity(verbosity);
+}
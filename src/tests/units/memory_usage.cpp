@@ -0,0 +1,95 @@
+#include "MemoryUsage.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace IG;
+
+TEST_CASE("Memory usage is accumulated per category and location", "[MemoryUsage]")
+{
+    MemoryUsage usage;
+    CHECK(usage.total() == 0);
+    for (size_t i = 0; i < (size_t)MemoryCategory::_COUNT; ++i) {
+        CHECK(usage.get((MemoryCategory)i, MemoryLocation::Host) == 0);
+        CHECK(usage.get((MemoryCategory)i, MemoryLocation::Device) == 0);
+    }
+
+    usage.add(MemoryCategory::Images, MemoryLocation::Host, 100);
+    usage.add(MemoryCategory::Images, MemoryLocation::Host, 20);
+    usage.add(MemoryCategory::Images, MemoryLocation::Device, 300);
+    usage.add(MemoryCategory::Framebuffer, MemoryLocation::Device, 4000);
+
+    CHECK(usage.get(MemoryCategory::Images, MemoryLocation::Host) == 120);
+    CHECK(usage.get(MemoryCategory::Images, MemoryLocation::Device) == 300);
+    CHECK(usage.get(MemoryCategory::Framebuffer, MemoryLocation::Host) == 0);
+    CHECK(usage.get(MemoryCategory::Framebuffer, MemoryLocation::Device) == 4000);
+    CHECK(usage.get(MemoryCategory::BVH, MemoryLocation::Device) == 0);
+
+    CHECK(usage.total(MemoryLocation::Host) == 120);
+    CHECK(usage.total(MemoryLocation::Device) == 4300);
+    CHECK(usage.total() == 4420);
+}
+
+TEST_CASE("Memory usage of multiple sources can be merged", "[MemoryUsage]")
+{
+    MemoryUsage a;
+    a.add(MemoryCategory::SceneTables, MemoryLocation::Host, 10);
+    a.add(MemoryCategory::Denoiser, MemoryLocation::Device, 20);
+
+    MemoryUsage b;
+    b.add(MemoryCategory::SceneTables, MemoryLocation::Host, 5);
+    b.add(MemoryCategory::Streams, MemoryLocation::Device, 7);
+
+    a += b;
+    CHECK(a.get(MemoryCategory::SceneTables, MemoryLocation::Host) == 15);
+    CHECK(a.get(MemoryCategory::Denoiser, MemoryLocation::Device) == 20);
+    CHECK(a.get(MemoryCategory::Streams, MemoryLocation::Device) == 7);
+    CHECK(a.total() == 42);
+
+    // The source is not modified
+    CHECK(b.total() == 12);
+}
+
+TEST_CASE("Peak memory usage is tracked per entry", "[MemoryUsage]")
+{
+    MemoryUsage peak;
+
+    MemoryUsage first;
+    first.add(MemoryCategory::Buffers, MemoryLocation::Device, 1000);
+    first.add(MemoryCategory::Images, MemoryLocation::Host, 50);
+    peak.max(first);
+
+    // Buffers were released, but images grew
+    MemoryUsage second;
+    second.add(MemoryCategory::Buffers, MemoryLocation::Device, 200);
+    second.add(MemoryCategory::Images, MemoryLocation::Host, 80);
+    peak.max(second);
+
+    CHECK(peak.get(MemoryCategory::Buffers, MemoryLocation::Device) == 1000);
+    CHECK(peak.get(MemoryCategory::Images, MemoryLocation::Host) == 80);
+    CHECK(peak.get(MemoryCategory::Images, MemoryLocation::Device) == 0);
+
+    // The peak of each entry is kept, the totals never occurred together
+    CHECK(peak.total() == 1080);
+    CHECK(peak.total() >= first.total());
+    CHECK(peak.total() >= second.total());
+}
+
+TEST_CASE("Scene tables containing bvhs are accounted as bvh", "[MemoryUsage]")
+{
+    CHECK(MemoryUsage::getTableCategory("trimesh_primbvh") == MemoryCategory::BVH);
+    CHECK(MemoryUsage::getTableCategory("bvh") == MemoryCategory::BVH);
+    CHECK(MemoryUsage::getTableCategory("shapes") == MemoryCategory::SceneTables);
+    CHECK(MemoryUsage::getTableCategory("entities") == MemoryCategory::SceneTables);
+}
+
+TEST_CASE("Memory usage dump contains all categories", "[MemoryUsage]")
+{
+    MemoryUsage usage;
+    usage.add(MemoryCategory::BVH, MemoryLocation::Device, 2048);
+
+    const std::string dump = usage.dump(&usage);
+    for (size_t i = 0; i < (size_t)MemoryCategory::_COUNT; ++i)
+        CHECK(dump.find(MemoryUsage::getCategoryName((MemoryCategory)i)) != std::string::npos);
+    CHECK(dump.find("Total") != std::string::npos);
+    CHECK(dump.find("Peak") != std::string::npos);
+}
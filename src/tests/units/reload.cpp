@@ -0,0 +1,114 @@
+#include "Runtime.h"
+#include "loader/Parser.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace IG;
+
+static std::string makeSceneSource(const std::string& reflectance, const std::string& lightPosition)
+{
+    return R"({
+    "technique": { "type": "path", "max_depth": 2 },
+    "camera": { "type": "perspective", "fov": 90, "near_clip": 0.01, "far_clip": 100, "transform": [1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, -1] },
+    "film": { "size": [64, 48] },
+    "bsdfs": [ { "type": "diffuse", "name": "ground", "reflectance": )"
+           + reflectance + R"( } ],
+    "shapes": [ { "type": "rectangle", "name": "Bottom", "width": 2, "height": 2, "flip_normals": true } ],
+    "entities": [ { "name": "Bottom", "shape": "Bottom", "bsdf": "ground" } ],
+    "lights": [ { "type": "point", "name": "Light", "position": )"
+           + lightPosition + R"(, "intensity": [1, 1, 1] } ]
+})";
+}
+
+static const std::string DefaultReflectance = "[0.8, 0.5, 0.2]";
+static const std::string DefaultPosition    = "[0, 0, -0.5]";
+
+static std::shared_ptr<Scene> parseScene(const std::string& reflectance, const std::string& lightPosition)
+{
+    SceneParser parser;
+    auto scene = parser.loadFromString(makeSceneSource(reflectance, lightPosition), {});
+    REQUIRE(scene != nullptr);
+    return scene;
+}
+
+static std::unique_ptr<Runtime> createRuntime(const Scene& scene, bool hotReload)
+{
+    RuntimeOptions opts  = RuntimeOptions::makeDefault();
+    opts.Target          = Target::pickCPU();
+    opts.Seed            = 42;
+    opts.EnableHotReload = hotReload;
+
+    auto runtime = std::make_unique<Runtime>(opts);
+    REQUIRE(runtime->loadFromScene(&scene));
+    return runtime;
+}
+
+// Render a single iteration from scratch and return the result
+static std::vector<float> render(Runtime& runtime)
+{
+    runtime.reset();
+    runtime.step();
+
+    const size_t size = runtime.framebufferWidth() * runtime.framebufferHeight() * 3;
+    const float* data = runtime.getFramebufferForHost({}).Data;
+    REQUIRE(data != nullptr);
+    return std::vector<float>(data, data + size);
+}
+
+TEST_CASE("Reloading an unchanged scene keeps the result", "[Reload]")
+{
+    const auto scene    = parseScene(DefaultReflectance, DefaultPosition);
+    auto runtime        = createRuntime(*scene, true);
+    const auto expected = render(*runtime);
+
+    const auto same = parseScene(DefaultReflectance, DefaultPosition);
+    REQUIRE(runtime->reloadFromScene(same.get()));
+    CHECK(render(*runtime) == expected);
+}
+
+TEST_CASE("Reloading a changed material updates the result", "[Reload]")
+{
+    const auto scene    = parseScene(DefaultReflectance, DefaultPosition);
+    auto runtime        = createRuntime(*scene, true);
+    const auto previous = render(*runtime);
+
+    const auto changed = parseScene("[0.2, 0.5, 0.8]", DefaultPosition);
+    REQUIRE(runtime->reloadFromScene(changed.get()));
+
+    // The reloaded runtime has to match a runtime which loaded the changed scene from scratch
+    auto reference      = createRuntime(*changed, false);
+    const auto reloaded = render(*runtime);
+    CHECK(reloaded != previous);
+    CHECK(reloaded == render(*reference));
+}
+
+TEST_CASE("Reloading an unsupported change keeps the previous scene", "[Reload]")
+{
+    const auto scene = parseScene(DefaultReflectance, DefaultPosition);
+
+    SECTION("Without hot reload")
+    {
+        auto runtime        = createRuntime(*scene, false);
+        const auto expected = render(*runtime);
+
+        const auto changed = parseScene("[0.2, 0.5, 0.8]", DefaultPosition);
+        CHECK_FALSE(runtime->reloadFromScene(changed.get()));
+        CHECK(render(*runtime) == expected);
+    }
+
+    SECTION("Changed light")
+    {
+        auto runtime        = createRuntime(*scene, true);
+        const auto expected = render(*runtime);
+
+        // Lights are not updated incrementally and require a full reload
+        const auto changed = parseScene(DefaultReflectance, "[0, 0.5, -0.5]");
+        CHECK_FALSE(runtime->reloadFromScene(changed.get()));
+        CHECK(render(*runtime) == expected);
+
+        // The runtime is still able to reload supported changes afterwards
+        const auto material = parseScene("[0.2, 0.5, 0.8]", DefaultPosition);
+        CHECK(runtime->reloadFromScene(material.get()));
+        CHECK(render(*runtime) != expected);
+    }
+}
@@ -0,0 +1,162 @@
+#include "RenderQueue.h"
+#include "Runtime.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+using namespace IG;
+
+static const char* SceneSource = R"({
+    "technique": { "type": "path", "max_depth": 2 },
+    "camera": { "type": "perspective", "fov": 90, "near_clip": 0.01, "far_clip": 100, "transform": [1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, -1] },
+    "film": { "size": [64, 64] },
+    "bsdfs": [ { "type": "diffuse", "name": "ground", "reflectance": [1, 1, 1] } ],
+    "shapes": [ { "type": "rectangle", "name": "Bottom", "width": 2, "height": 2, "flip_normals": true } ],
+    "entities": [ { "name": "Bottom", "shape": "Bottom", "bsdf": "ground" } ],
+    "lights": []
+})";
+
+static std::unique_ptr<Runtime> createRuntime(bool load)
+{
+    RuntimeOptions opts = RuntimeOptions::makeDefault();
+    opts.Target         = Target::pickCPU();
+    opts.Seed           = 42;
+
+    auto runtime = std::make_unique<Runtime>(opts);
+    if (load)
+        REQUIRE(runtime->loadFromString(SceneSource, {}));
+    return runtime;
+}
+
+template <typename T>
+static bool isBroken(std::future<T>& future)
+{
+    try {
+        future.get();
+    } catch (const std::future_error& e) {
+        return e.code() == std::future_errc::broken_promise;
+    }
+    return false;
+}
+
+// Blocks the worker until released, such that the following work is guaranteed to be pending
+struct Blocker {
+    std::promise<void> Started;
+    std::promise<void> Release;
+
+    std::function<void(Runtime&)> task()
+    {
+        return [this](Runtime&) {
+            Started.set_value();
+            Release.get_future().wait();
+        };
+    }
+};
+
+TEST_CASE("Work is executed in submission order", "[RenderQueue]")
+{
+    auto runtime = createRuntime(true);
+    RenderQueue queue(*runtime);
+
+    std::vector<int> order;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 8; ++i)
+        futures.emplace_back(queue.submit([&order, i](Runtime&) { order.push_back(i); }));
+
+    // Snapshots are taken in between the queued iterations
+    auto step1     = queue.step(2);
+    auto snapshot1 = queue.snapshot();
+    auto step2     = queue.step(1);
+    auto snapshot2 = queue.snapshot();
+
+    queue.wait();
+    CHECK(queue.isIdle());
+
+    for (auto& future : futures)
+        future.get();
+    CHECK(order == std::vector<int>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+
+    step1.get();
+    step2.get();
+    CHECK(snapshot1.get().Iteration == 2);
+    CHECK(snapshot2.get().Iteration == 3);
+    CHECK(runtime->currentIterationCount() == 3);
+}
+
+TEST_CASE("Exceptions are forwarded to the future", "[RenderQueue]")
+{
+    auto runtime = createRuntime(false);
+    RenderQueue queue(*runtime);
+
+    auto failing = queue.submit([](Runtime&) { throw std::runtime_error("Failure"); });
+    auto next    = queue.submit([](Runtime&) {});
+
+    CHECK_THROWS_AS(failing.get(), std::runtime_error);
+    CHECK_NOTHROW(next.get()); // The worker keeps running
+}
+
+TEST_CASE("Cancel drops pending work only", "[RenderQueue]")
+{
+    auto runtime = createRuntime(false);
+    RenderQueue queue(*runtime);
+
+    Blocker blocker;
+    auto running = queue.submit(blocker.task());
+    blocker.Started.get_future().wait();
+
+    int executed = 0;
+    std::vector<std::future<void>> dropped;
+    for (int i = 0; i < 4; ++i)
+        dropped.emplace_back(queue.submit([&executed](Runtime&) { ++executed; }));
+    CHECK(queue.pendingCount() == 5);
+
+    queue.cancel();
+    CHECK(queue.pendingCount() == 1); // The running task is not affected
+
+    blocker.Release.set_value();
+    queue.wait();
+
+    CHECK_NOTHROW(running.get());
+    for (auto& future : dropped)
+        CHECK(isBroken(future));
+    CHECK(executed == 0);
+
+    // The queue is still usable afterwards
+    auto after = queue.submit([&executed](Runtime&) { ++executed; });
+    queue.wait();
+    after.get();
+    CHECK(executed == 1);
+}
+
+TEST_CASE("Stop waits for the running task and rejects further work", "[RenderQueue]")
+{
+    auto runtime = createRuntime(false);
+    RenderQueue queue(*runtime);
+
+    Blocker blocker;
+    auto running = queue.submit(blocker.task());
+    blocker.Started.get_future().wait();
+
+    bool executed = false;
+    auto dropped  = queue.submit([&executed](Runtime&) { executed = true; });
+
+    std::thread stopper([&]() { queue.stop(); });
+
+    // Stop drops the pending work first and then waits for the running task
+    while (queue.pendingCount() != 1)
+        std::this_thread::yield();
+    blocker.Release.set_value();
+    stopper.join();
+
+    CHECK(queue.isIdle());
+    CHECK_NOTHROW(running.get());
+    CHECK(isBroken(dropped));
+    CHECK_FALSE(executed);
+
+    auto rejected = queue.submit([&executed](Runtime&) { executed = true; });
+    CHECK(isBroken(rejected));
+    CHECK_FALSE(executed);
+
+    queue.wait(); // Must not block on a stopped queue
+}
@@ -0,0 +1,93 @@
+#include "ResolutionController.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+using namespace IG;
+using namespace std::chrono_literals;
+
+using Clock = ResolutionController::Clock;
+
+TEST_CASE("Disabled controller keeps full resolution", "[ResolutionController]")
+{
+    ResolutionController controller(0, 0.25f);
+    CHECK_FALSE(controller.isEnabled());
+
+    const auto now = Clock::now();
+    controller.notifyMotion(now);
+    controller.reportIteration(1, 1000);
+    CHECK(controller.scale(now) == 1);
+}
+
+TEST_CASE("Full resolution is kept if the target is reached", "[ResolutionController]")
+{
+    ResolutionController controller(50, 0.25f);
+    CHECK(controller.isEnabled());
+
+    const auto now = Clock::now();
+    controller.notifyMotion(now);
+    controller.reportIteration(1, 40);
+    CHECK(controller.scale(now) == 1);
+}
+
+TEST_CASE("Resolution is reduced while moving", "[ResolutionController]")
+{
+    ResolutionController controller(25, 0.25f);
+
+    const auto now = Clock::now();
+    controller.reportIteration(1, 100);
+
+    // No motion yet
+    CHECK(controller.scale(now) == 1);
+
+    controller.notifyMotion(now);
+    // sqrt(25/100) = 0.5. Quantized scales are exact, therefore no tolerance is needed
+    CHECK(controller.scale(now) == 0.5f);
+    CHECK(controller.scale(now + 100ms) == 0.5f);
+
+    // Full resolution is restored after standing still for a while
+    CHECK(controller.scale(now + 1s) == 1);
+}
+
+TEST_CASE("Scale is quantized and clamped", "[ResolutionController]")
+{
+    const auto now = Clock::now();
+
+    SECTION("Quantized")
+    {
+        ResolutionController controller(30, 0.05f);
+        controller.notifyMotion(now);
+        controller.reportIteration(1, 100);
+
+        // sqrt(0.3) = 0.547..., which is floored to 8/16
+        CHECK(controller.scale(now) == 0.5f);
+    }
+
+    SECTION("Clamped")
+    {
+        ResolutionController controller(1, 0.25f);
+        controller.notifyMotion(now);
+        controller.reportIteration(1, 10000);
+        CHECK(controller.scale(now) == 0.25f);
+    }
+}
+
+TEST_CASE("Iterations are normalized to full resolution", "[ResolutionController]")
+{
+    ResolutionController controller(25, 0.05f);
+
+    const auto now = Clock::now();
+    controller.notifyMotion(now);
+
+    // An iteration at half resolution costs a quarter of the full iteration
+    controller.reportIteration(0.5f, 25);
+    CHECK(controller.scale(now) == 0.5f);
+
+    // Invalid reports are ignored
+    controller.reportIteration(0, 1000);
+    controller.reportIteration(1, 0);
+    CHECK(controller.scale(now) == 0.5f);
+
+    // The estimate is smoothed over multiple iterations: 0.7 * 100 + 0.3 * 400 = 190
+    controller.reportIteration(1, 400);
+    CHECK(controller.scale(now) == 5.0f / 16);
+}
@@ -0,0 +1,201 @@
+#include "container/SDTree.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+
+using namespace IG;
+
+static inline float getFloat(const std::vector<int32>& data, size_t i)
+{
+    float v;
+    std::memcpy(&v, &data[i], sizeof(float));
+    return v;
+}
+
+// Same traversal as the lookup in artic/sampler/path_guiding.art. Returns the offset of the directional root
+static int32 lookupSerialized(const std::vector<int32>& data, const Vector3f& pos)
+{
+    Vector3f lo = Vector3f(getFloat(data, 0), getFloat(data, 1), getFloat(data, 2));
+    Vector3f hi = Vector3f(getFloat(data, 4), getFloat(data, 5), getFloat(data, 6));
+
+    int32 node = (int32)SDTree::HeaderSize;
+    while (data[node] >= 0) {
+        const int32 axis  = data[node];
+        const int32 child = data[node + 1];
+        const float mid   = (lo[axis] + hi[axis]) / 2;
+        if (pos[axis] < mid) {
+            hi[axis] = mid;
+            node     = child;
+        } else {
+            lo[axis] = mid;
+            node     = child + 2;
+        }
+    }
+    return data[node + 1];
+}
+
+// Check the serialized directional quadtree at the given offset against the given tree
+static void checkSerializedDTree(const std::vector<int32>& data, int32 root, const DTree& tree)
+{
+    REQUIRE(root > 0);
+    CHECK(root % 4 == 0); // Aligned for vectorized loads
+    REQUIRE((size_t)root + 8 * tree.nodes().size() <= data.size());
+
+    for (size_t j = 0; j < tree.nodes().size(); ++j) {
+        const auto& node = tree.nodes()[j];
+        for (size_t c = 0; c < 4; ++c) {
+            CHECK(getFloat(data, root + 8 * j + c) == node.Energy[c]);
+            CHECK(data[root + 8 * j + 4 + c] == (node.Children[c] == 0 ? 0 : (int32)(root + 8 * node.Children[c])));
+        }
+    }
+}
+
+static BoundingBox unitBox()
+{
+    return BoundingBox(Vector3f::Zero(), Vector3f::Ones());
+}
+
+TEST_CASE("Directional tree records into the correct quadrant", "[SDTree]")
+{
+    DTree tree;
+    tree.record(Vector2f(0.1f, 0.1f), 1);
+    tree.record(Vector2f(0.9f, 0.1f), 2);
+    tree.record(Vector2f(0.1f, 0.9f), 3);
+    tree.record(Vector2f(0.9f, 0.9f), 4);
+
+    REQUIRE(tree.nodes().size() == 1);
+    CHECK(tree.nodes()[0].Energy == std::array<float, 4>{ 1, 2, 3, 4 });
+    CHECK(tree.total() == 10);
+    CHECK(tree.recordCount() == 4);
+}
+
+TEST_CASE("Directional tree is refined by energy", "[SDTree]")
+{
+    DTree tree;
+    for (int i = 0; i < 10; ++i)
+        tree.record(Vector2f(0.1f, 0.1f), 1);
+
+    SECTION("Only quadrants above the threshold are subdivided")
+    {
+        // The first quadrant holds all energy. Its children hold a quarter each, which is not above the threshold
+        const DTree refined = tree.refined(0.25f);
+        REQUIRE(refined.nodes().size() == 2);
+        CHECK(refined.nodes()[0].Children == std::array<uint32, 4>{ 1, 0, 0, 0 });
+        CHECK(refined.nodes()[1].Children == std::array<uint32, 4>{ 0, 0, 0, 0 });
+        CHECK(refined.total() == 0);
+        CHECK(refined.recordCount() == 0);
+    }
+
+    SECTION("Leaves distribute their energy uniformly")
+    {
+        const DTree refined = tree.refined(0.2f);
+        REQUIRE(refined.nodes().size() == 6);
+        CHECK(refined.nodes()[0].Children == std::array<uint32, 4>{ 1, 0, 0, 0 });
+        for (uint32 c : refined.nodes()[1].Children)
+            CHECK(c > 1);
+    }
+
+    SECTION("Empty tree keeps its structure")
+    {
+        const DTree refined = tree.refined(0.2f);
+        CHECK(refined.refined(0.2f).nodes().size() == refined.nodes().size());
+    }
+
+    SECTION("Records descend into the refined structure")
+    {
+        DTree refined = tree.refined(0.2f);
+        refined.record(Vector2f(0.1f, 0.1f), 1);
+        CHECK(refined.nodes()[0].Energy[0] == 1);
+        CHECK(refined.nodes()[1].Energy[0] == 1); // (0.2, 0.2) in the first quadrant
+    }
+}
+
+TEST_CASE("Spatial tree is split by record count", "[SDTree]")
+{
+    const Vector3f pos = Vector3f(0.25f, 0.5f, 0.75f);
+
+    SECTION("Below the threshold")
+    {
+        SDTree tree(unitBox());
+        for (int i = 0; i < 10; ++i)
+            tree.lookup(pos).Building.record(Vector2f(0.1f, 0.1f), 1);
+
+        tree.refine(10, 0.2f);
+        CHECK(tree.leafCount() == 1);
+        CHECK(tree.lookup(pos).Sampling.total() == 10);
+        CHECK(tree.lookup(pos).Building.total() == 0);
+        CHECK(tree.lookup(pos).Building.nodes().size() == 6);
+    }
+
+    SECTION("Above the threshold")
+    {
+        SDTree tree(unitBox());
+        for (int i = 0; i < 100; ++i)
+            tree.lookup(pos).Building.record(Vector2f(0.1f, 0.1f), 1);
+
+        // Children inherit half of the records: 100 -> 50 -> 25 -> 12 -> 6
+        tree.refine(10, 0.2f);
+        CHECK(tree.leafCount() == 16);
+        CHECK(tree.nodes()[0].Axis == 0);
+        CHECK(tree.nodes()[tree.nodes()[0].Children].Axis == 1);
+
+        // All leaves inherit the learned distribution
+        for (const auto& node : tree.nodes()) {
+            if (node.Axis < 0)
+                CHECK(node.Sampling.total() == 100);
+        }
+
+        // Positions in different octants end up in different leaves
+        CHECK(&tree.lookup(pos) != &tree.lookup(Vector3f(0.75f, 0.5f, 0.75f)));
+        CHECK(&tree.lookup(pos) == &tree.lookup(pos + Vector3f::Constant(0.01f)));
+    }
+
+}
+
+TEST_CASE("Serialized tree matches the layout of the device", "[SDTree]")
+{
+    SDTree tree(BoundingBox(Vector3f(-1, -2, -3), Vector3f(1, 2, 3)));
+
+    const std::vector<Vector3f> positions = { Vector3f(-0.5f, -1, -1.5f), Vector3f(0.5f, 1, 1.5f), Vector3f(0.5f, -1, 1.5f) };
+    for (int i = 0; i < 64; ++i) {
+        for (size_t k = 0; k < positions.size(); ++k)
+            tree.lookup(positions[k]).Building.record(Vector2f(0.1f + 0.3f * k, 0.8f), 1 + (float)k);
+    }
+
+    // Two passes, such that the sampling distributions are refined as well
+    tree.refine(32, 0.1f);
+    for (int i = 0; i < 64; ++i) {
+        for (size_t k = 0; k < positions.size(); ++k)
+            tree.lookup(positions[k]).Building.record(Vector2f(0.1f + 0.3f * k, 0.8f), 1 + (float)k);
+    }
+    tree.refine(32, 0.1f);
+    REQUIRE(tree.leafCount() > 1);
+
+    const std::vector<int32> data = tree.serialize();
+    REQUIRE(data.size() >= SDTree::HeaderSize + 2 * tree.nodes().size());
+
+    // Header
+    CHECK(getFloat(data, 0) == -1);
+    CHECK(getFloat(data, 1) == -2);
+    CHECK(getFloat(data, 2) == -3);
+    CHECK(data[3] == 1);
+    CHECK(getFloat(data, 4) == 1);
+    CHECK(getFloat(data, 5) == 2);
+    CHECK(getFloat(data, 6) == 3);
+
+    // Spatial nodes
+    for (size_t i = 0; i < tree.nodes().size(); ++i) {
+        const auto& node = tree.nodes()[i];
+        CHECK(data[SDTree::HeaderSize + 2 * i] == node.Axis);
+        if (node.Axis >= 0)
+            CHECK(data[SDTree::HeaderSize + 2 * i + 1] == (int32)(SDTree::HeaderSize + 2 * node.Children));
+    }
+
+    // Directional trees reached by the device traversal
+    for (const auto& pos : positions) {
+        const SDTree::Node& leaf = tree.lookup(pos);
+        CHECK(leaf.Sampling.nodes().size() > 1);
+        checkSerializedDTree(data, lookupSerialized(data, pos), leaf.Sampling);
+    }
+}
@@ -0,0 +1,136 @@
+#include "Timeline.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace IG;
+
+// The timeline is process wide, therefore every test uses its own event and track names
+static std::string writeTimeline()
+{
+    const Path path = std::filesystem::temp_directory_path() / "ig_test_timeline.json";
+    REQUIRE(Timeline::instance().write(path));
+
+    std::ifstream stream(path);
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    stream.close();
+
+    std::filesystem::remove(path);
+    return buffer.str();
+}
+
+static size_t countOccurrences(const std::string& str, const std::string& pattern)
+{
+    size_t count = 0;
+    for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + pattern.size()))
+        ++count;
+    return count;
+}
+
+static std::string nameArgument(const std::string& name)
+{
+    return "\"args\":{\"name\":\"" + name + "\"}";
+}
+
+TEST_CASE("Events are written in the trace event format", "[Timeline]")
+{
+    Timeline& timeline = Timeline::instance();
+    timeline.clear();
+    timeline.enable();
+
+    {
+        IG_TIMELINE_SCOPE("test", "scoped_event");
+    }
+
+    const auto start = Timeline::clock::now();
+    timeline.complete("test", "external_event", start, start + std::chrono::milliseconds(2), "External Track");
+    timeline.disable();
+
+    const std::string json = writeTimeline();
+    CHECK(json.starts_with("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    CHECK(countOccurrences(json, "{\"name\":\"scoped_event\",\"cat\":\"test\",\"ph\":\"B\"") == 1);
+    CHECK(countOccurrences(json, "{\"name\":\"scoped_event\",\"cat\":\"test\",\"ph\":\"E\"") == 1);
+    CHECK(countOccurrences(json, "{\"name\":\"external_event\",\"cat\":\"test\",\"ph\":\"X\"") == 1);
+    CHECK(countOccurrences(json, ",\"dur\":2000.") == 1);
+    CHECK(countOccurrences(json, nameArgument("External Track")) == 1);
+}
+
+TEST_CASE("Disabled timeline records nothing", "[Timeline]")
+{
+    Timeline& timeline = Timeline::instance();
+    timeline.clear();
+    timeline.disable();
+
+    {
+        IG_TIMELINE_SCOPE("test", "disabled_event");
+    }
+
+    const auto start = Timeline::clock::now();
+    timeline.complete("test", "disabled_external_event", start, start, "Disabled Track");
+
+    const std::string json = writeTimeline();
+    CHECK(countOccurrences(json, "disabled_event") == 0);
+    CHECK(countOccurrences(json, "disabled_external_event") == 0);
+    CHECK(countOccurrences(json, "Disabled Track") == 0);
+}
+
+TEST_CASE("Thread names are kept if requested", "[Timeline]")
+{
+    Timeline& timeline = Timeline::instance();
+    timeline.clear();
+    timeline.enable();
+
+    std::thread thread([&]() {
+        timeline.setThreadName("Named Thread");
+        timeline.setThreadName("Ignored Thread", true);
+        IG_TIMELINE_SCOPE("test", "named_thread_event");
+    });
+    thread.join();
+
+    // Named tracks share the track of a thread with the same name
+    const auto start = Timeline::clock::now();
+    timeline.complete("test", "named_track_event", start, start, "Named Thread");
+    timeline.disable();
+
+    const std::string json = writeTimeline();
+    CHECK(countOccurrences(json, nameArgument("Named Thread")) == 1);
+    CHECK(countOccurrences(json, "Ignored Thread") == 0);
+    CHECK(countOccurrences(json, "named_thread_event") == 2);
+    CHECK(countOccurrences(json, "named_track_event") == 1);
+}
+
+TEST_CASE("Threads can be named while named tracks are looked up", "[Timeline]")
+{
+    Timeline& timeline = Timeline::instance();
+    timeline.clear();
+    timeline.enable();
+
+    constexpr int ThreadCount = 4;
+    constexpr int EventCount  = 2000;
+
+    // Renaming a thread and looking up a named track access the same names concurrently
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads.emplace_back([&timeline, t]() {
+            for (int i = 0; i < EventCount; ++i) {
+                timeline.setThreadName("Concurrent Worker " + std::to_string(t) + "." + std::to_string(i % 2));
+
+                const auto start = Timeline::clock::now();
+                timeline.complete("test", "concurrent_event", start, start, "Concurrent Track");
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    timeline.disable();
+
+    const std::string json = writeTimeline();
+    CHECK(countOccurrences(json, nameArgument("Concurrent Track")) == 1);
+    CHECK(countOccurrences(json, "concurrent_event") == ThreadCount * EventCount);
+    for (int t = 0; t < ThreadCount; ++t)
+        CHECK(countOccurrences(json, nameArgument("Concurrent Worker " + std::to_string(t) + ".1")) == 1);
+}